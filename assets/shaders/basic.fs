@@ -5,39 +5,58 @@ in vec2 TexCoords;
 
 out vec4 FragColor;
 
-// ライト情報
-uniform vec3 lightPos;
-uniform vec3 lightColor;
-uniform vec3 viewPos;
+// ライト情報などフレームで共通の定数（FrameUniforms、全プログラムで1つのUBOの範囲を共有）
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;     // xyz: カメラ位置
+    vec4 lightPos;    // xyz: ライト位置
+    vec4 lightColor;  // rgb: ライトの色
+};
 
-// マテリアル情報
-uniform vec3 objectColor;
-uniform float ambientStrength;
-uniform float specularStrength;
-uniform int shininess;
+#ifdef INDIRECT_DRAW
+// マテリアル情報（間接描画では indirect.vs が描画ごとのデータから渡す）
+flat in vec4 MaterialColor;     // rgb: objectColor, a: opacity
+flat in vec3 MaterialLighting;  // x: ambientStrength, y: specularStrength, z: shininess
+#define objectColor MaterialColor.rgb
+#define opacity MaterialColor.a
+#define ambientStrength MaterialLighting.x
+#define specularStrength MaterialLighting.y
+#define shininess MaterialLighting.z
+#else
+// マテリアル情報（MaterialUniforms、マテリアルごとにUBOの範囲を切り替える）
+layout (std140) uniform MaterialData {
+    vec3 objectColor;
+    float opacity;  // 半透明パス以外ではブレンドしないため使われない
+    float ambientStrength;
+    float specularStrength;
+    float shininess;
+    float materialPadding;  // ブロックの大きさを16バイトの倍数にする
+};
+#endif
 
 void main() {
     // 環境光（アンビエント）
-    vec3 ambient = ambientStrength * lightColor;
+    vec3 ambient = ambientStrength * lightColor.rgb;
     
     // 拡散光（ディフューズ）- 法線の視覚化も追加
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 lightDir = normalize(lightPos.xyz - FragPos);
     float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * lightColor;
+    vec3 diffuse = diff * lightColor.rgb;
     
     // 法線を視覚化するためのカラー (法線の方向をRGBカラーとして表現)
     vec3 normalColor = norm * 0.5 + 0.5; // [-1,1] から [0,1] の範囲に変換
     
     // 鏡面反射光（スペキュラー）
-    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
     vec3 reflectDir = reflect(-lightDir, norm);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
-    vec3 specular = specularStrength * spec * lightColor;
+    vec3 specular = specularStrength * spec * lightColor.rgb;
     
     // 合成 (50%法線可視化、50%ライティング)
     vec3 lighting = (ambient + diffuse + specular) * objectColor;
     vec3 result = mix(lighting, normalColor, 0.5); // 法線可視化とライティングを50%ずつ混合
     
-    FragColor = vec4(result, 1.0);
+    FragColor = vec4(result, opacity);
 }
\ No newline at end of file
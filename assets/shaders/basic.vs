@@ -10,15 +10,50 @@ out vec2 TexCoords;
 
 // 変換行列
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// フレームで共通の定数（FrameUniforms、全プログラムで1つのUBOの範囲を共有）
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;     // xyz: カメラ位置
+    vec4 lightPos;    // xyz: ライト位置
+    vec4 lightColor;  // rgb: ライトの色
+};
+
+// 法線行列（モデル行列の3x3部分の逆転置、TransformSystem がオブジェクトごとに計算）
+// COMPUTE_NORMAL_MATRIX を定義したバリアントは比較用に頂点ごとに逆行列から求める
+#ifndef COMPUTE_NORMAL_MATRIX
+uniform mat3 normalMatrix;
+#endif
+
+// 量子化頂点の復元パラメータ（Mesh::draw が設定、量子化していない場合は恒等変換）
+uniform vec3 positionBias;   // AABBの最小点
+uniform vec3 positionScale;  // AABBの大きさ
+uniform int normalEncoding;  // 0: そのまま, 1: 八面体マッピング
+
+// 八面体マッピングした法線を復元
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
 
 void main() {
+    // 頂点属性の復元
+    vec3 position = positionBias + aPos * positionScale;
+    vec3 normal = normalEncoding == 1 ? decodeOctahedral(aNormal.xy) : aNormal;
+    
     // 頂点位置を計算
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * model * vec4(position, 1.0);
     
     // フラグメントシェーダーに渡す値
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal; // 法線変換（非均一スケーリング対応）
+    FragPos = vec3(model * vec4(position, 1.0));
+#ifdef COMPUTE_NORMAL_MATRIX
+    Normal = mat3(transpose(inverse(model))) * normal; // 法線変換（非均一スケーリング対応）
+#else
+    Normal = normalMatrix * normal; // 法線変換（非均一スケーリング対応、CPUで計算済み）
+#endif
     TexCoords = aTexCoords;
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+// 出力値
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+
+// マテリアルの定数（描画ごとに一定、basic.fs の INDIRECT_DRAW バリアントが読む）
+flat out vec4 MaterialColor;     // rgb: objectColor, a: opacity
+flat out vec3 MaterialLighting;  // x: ambientStrength, y: specularStrength, z: shininess
+
+// フレームで共通の定数（FrameUniforms、全プログラムで1つのUBOの範囲を共有）
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;     // xyz: カメラ位置
+    vec4 lightPos;    // xyz: ライト位置
+    vec4 lightColor;  // rgb: ライトの色
+};
+
+// 描画ごとのデータ（IndirectDrawBuffer::DrawData、std430）
+struct DrawData {
+    mat4 model;
+    mat3 normalMatrix;  // 列は16バイトに揃えられる（CPUで計算済み）
+    vec3 objectColor;
+    float opacity;
+    float ambientStrength;
+    float specularStrength;
+    float shininess;
+    float materialPadding;
+};
+
+// glMultiDrawElementsIndirect の呼び出しごとに先頭を合わせた範囲（DRAW_DATA_BINDING）
+layout (std430, binding = 0) readonly buffer DrawBuffer {
+    DrawData draws[];
+};
+
+void main() {
+    // 共有のバッファのメッシュは量子化しないため、頂点属性はそのまま使う
+    DrawData draw = draws[gl_DrawIDARB];
+
+    // 頂点位置を計算
+    vec4 worldPosition = draw.model * vec4(aPos, 1.0);
+    gl_Position = projection * view * worldPosition;
+
+    // フラグメントシェーダーに渡す値
+    FragPos = vec3(worldPosition);
+    Normal = draw.normalMatrix * aNormal;
+    TexCoords = aTexCoords;
+    MaterialColor = vec4(draw.objectColor, draw.opacity);
+    MaterialLighting = vec3(draw.ambientStrength, draw.specularStrength, draw.shininess);
+}
@@ -0,0 +1,51 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+// インスタンスごとの属性（InstanceBuffer が設定、除数1）
+layout (location = 3) in mat4 aModel;         // モデル行列（ロケーション3〜6）
+layout (location = 7) in mat3 aNormalMatrix;  // 法線行列（ロケーション7〜9、CPUで計算済み）
+
+// 出力値
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+
+// フレームで共通の定数（FrameUniforms、全プログラムで1つのUBOの範囲を共有）
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;     // xyz: カメラ位置
+    vec4 lightPos;    // xyz: ライト位置
+    vec4 lightColor;  // rgb: ライトの色
+};
+
+// 量子化頂点の復元パラメータ（Mesh::drawInstanced が設定、量子化していない場合は恒等変換）
+uniform vec3 positionBias;   // AABBの最小点
+uniform vec3 positionScale;  // AABBの大きさ
+uniform int normalEncoding;  // 0: そのまま, 1: 八面体マッピング
+
+// 八面体マッピングした法線を復元
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main() {
+    // 頂点属性の復元
+    vec3 position = positionBias + aPos * positionScale;
+    vec3 normal = normalEncoding == 1 ? decodeOctahedral(aNormal.xy) : aNormal;
+
+    // 頂点位置を計算
+    vec4 worldPosition = aModel * vec4(position, 1.0);
+    gl_Position = projection * view * worldPosition;
+
+    // フラグメントシェーダーに渡す値（法線行列は頂点ごとに逆行列を求めず属性から読む）
+    FragPos = vec3(worldPosition);
+    Normal = aNormalMatrix * normal;
+    TexCoords = aTexCoords;
+}
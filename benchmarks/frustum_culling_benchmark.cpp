@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "renderer/frustum_culler.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief 処理を繰り返し実行し、1回あたりの最短時間（秒）を返す
+ */
+template <typename F>
+double measureSeconds(int repeatCount, F&& function) {
+    double best = 1e30;
+    for (int i = 0; i < repeatCount; ++i) {
+        auto start = Clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        best = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace claude_gl;
+
+    const std::size_t objectCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    constexpr int REPEAT_COUNT = 20;
+
+    // 一辺200の立方体内にランダムな大きさ・向きのメッシュを配置する
+    std::mt19937 random(12345);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.1f, 2.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+    std::vector<BoundingVolume> bounds(objectCount);
+    std::vector<glm::mat4> transforms(objectCount);
+    for (std::size_t i = 0; i < objectCount; ++i) {
+        glm::vec3 extents(size(random), size(random), size(random));
+        bounds[i].boundsMin = -extents;
+        bounds[i].boundsMax = extents;
+        bounds[i].radius = glm::length(extents) * 0.9f;
+
+        glm::mat4 world(1.0f);
+        world = glm::translate(world, glm::vec3(position(random), position(random),
+                                                position(random)));
+        world = glm::rotate(world, angle(random), glm::vec3(0.0f, 1.0f, 0.0f));
+        transforms[i] = world;
+    }
+
+    // 原点から+Z方向を見るカメラ（全体の一部だけが視錐台に入る）
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, -120.0f), glm::vec3(0.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+    glm::mat4 viewProjection = projection * view;
+
+    FrustumCuller culler;
+    culler.reserve(objectCount);
+
+    // 境界の登録（ワールド変換を含む）
+    double addSeconds = measureSeconds(REPEAT_COUNT, [&]() {
+        culler.clear();
+        for (std::size_t i = 0; i < objectCount; ++i) {
+            culler.addObject(bounds[i], transforms[i]);
+        }
+    });
+
+    // スカラー版とSIMD版の判定
+    double scalarSeconds = measureSeconds(REPEAT_COUNT, [&]() {
+        culler.cullScalar(viewProjection);
+    });
+    std::vector<std::uint32_t> scalarVisible = culler.getVisibleIndices();
+
+    double simdSeconds = measureSeconds(REPEAT_COUNT, [&]() {
+        culler.cull(viewProjection);
+    });
+    const FrustumCuller::Stats& stats = culler.getStats();
+    bool identical = scalarVisible == culler.getVisibleIndices();
+
+    double millions = static_cast<double>(objectCount) / 1e6;
+    std::cout << "Objects: " << objectCount << " (visible " << stats.visible() << ", culled "
+              << stats.culled << ")" << std::endl;
+    std::cout << "addObject:       " << addSeconds * 1000.0 << " ms ("
+              << millions / addSeconds << " M objects/s)" << std::endl;
+    std::cout << "cull (Scalar):   " << scalarSeconds * 1000.0 << " ms ("
+              << millions / scalarSeconds << " M objects/s)" << std::endl;
+    std::cout << "cull (" << FrustumCuller::getInstructionSet() << "):      "
+              << simdSeconds * 1000.0 << " ms (" << millions / simdSeconds
+              << " M objects/s)" << std::endl;
+    std::cout << "Results identical: " << (identical ? "yes" : "no") << std::endl;
+    return identical ? 0 : 1;
+}
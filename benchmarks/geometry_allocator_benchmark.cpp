@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+#include "renderer/geometry_allocator.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using claude_gl::GeometryAllocator;
+
+/**
+ * @brief 処理を繰り返し実行し、1回あたりの最短時間（秒）を返す
+ */
+template <typename F>
+double measureSeconds(int repeatCount, F&& function) {
+    double best = 1e30;
+    for (int i = 0; i < repeatCount; ++i) {
+        auto start = Clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        best = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+/**
+ * @brief 割り当てか解放の操作（解放は生存中のブロックの番号を value % 生存数 で選ぶ）
+ */
+struct Operation {
+    bool allocate;
+    std::uint32_t value;
+};
+
+/**
+ * @brief メッシュの読み込みと破棄を模した操作列を生成する
+ *
+ * 大きさは100〜20000要素の対数一様分布で、生存数が targetLive の前後に留まるよう
+ * 下回っている間は割り当てを、上回っている間は解放を多めにします。
+ */
+std::vector<Operation> makeOperations(std::size_t count, std::size_t targetLive) {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> logSize(std::log(100.0), std::log(20000.0));
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<Operation> operations(count);
+    std::size_t live = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        double allocateRatio = live < targetLive ? 0.6 : 0.4;
+        bool allocate = live == 0 || unit(random) < allocateRatio;
+        operations[i].allocate = allocate;
+        operations[i].value = allocate ? static_cast<std::uint32_t>(std::exp(logSize(random)))
+                                       : static_cast<std::uint32_t>(random());
+        live += allocate ? 1 : std::size_t(0) - 1;
+    }
+    return operations;
+}
+
+/**
+ * @brief 比較用: オフセット順の std::map で空きブロックを管理する先頭適合（first fit）
+ */
+class FirstFitAllocator {
+public:
+    explicit FirstFitAllocator(std::uint32_t capacity) {
+        freeBlocks[0] = capacity;
+    }
+
+    std::uint32_t allocate(std::uint32_t size) {
+        for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it) {
+            if (it->second >= size) {
+                std::uint32_t offset = it->first;
+                std::uint32_t rest = it->second - size;
+                freeBlocks.erase(it);
+                if (rest > 0) {
+                    freeBlocks[offset + size] = rest;
+                }
+                return offset;
+            }
+        }
+        return GeometryAllocator::INVALID_BLOCK;
+    }
+
+    void free(std::uint32_t offset, std::uint32_t size) {
+        auto next = freeBlocks.lower_bound(offset);
+        if (next != freeBlocks.end() && next->first == offset + size) {
+            size += next->second;
+            next = freeBlocks.erase(next);
+        }
+        if (next != freeBlocks.begin()) {
+            auto previous = std::prev(next);
+            if (previous->first + previous->second == offset) {
+                previous->second += size;
+                return;
+            }
+        }
+        freeBlocks[offset] = size;
+    }
+
+    std::size_t getFreeBlockCount() const {
+        return freeBlocks.size();
+    }
+
+private:
+    std::map<std::uint32_t, std::uint32_t> freeBlocks;  ///< オフセット -> 大きさ
+};
+
+/**
+ * @brief 割り当て中のブロックが重ならず、統計の使用量と一致するか確認する
+ */
+bool verify(const GeometryAllocator& allocator,
+            const std::vector<GeometryAllocator::BlockId>& live) {
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges;
+    std::size_t used = 0;
+    for (GeometryAllocator::BlockId block : live) {
+        ranges.emplace_back(allocator.getOffset(block), allocator.getSize(block));
+        used += allocator.getSize(block);
+    }
+    std::sort(ranges.begin(), ranges.end());
+    for (std::size_t i = 1; i < ranges.size(); ++i) {
+        if (ranges[i - 1].first + ranges[i - 1].second > ranges[i].first) {
+            return false;
+        }
+    }
+    bool inside = ranges.empty() || ranges.back().first + ranges.back().second <=
+                                        allocator.getCapacity();
+    GeometryAllocator::Stats stats = allocator.getStats();
+    return inside && stats.used == used && stats.allocations == live.size();
+}
+
+/**
+ * @brief 計測結果を1行出力する
+ */
+void printRow(const char* label, double seconds, std::size_t count, double baselineSeconds) {
+    std::cout << "  " << std::left << std::setw(26) << label << std::right << std::fixed
+              << std::setprecision(3) << std::setw(9) << seconds * 1000.0 << " ms"
+              << std::setw(9) << seconds * 1e9 / static_cast<double>(count) << " ns/op"
+              << std::setw(8) << std::setprecision(1) << baselineSeconds / seconds << "x"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t operationCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    constexpr int REPEAT_COUNT = 5;
+    // 4M 頂点（Mesh::Vertex で128MB）相当の領域
+    constexpr std::uint32_t CAPACITY = 4u << 20;
+
+    // 平均約3700要素のブロックが800個前後（使用率7割程度）で推移する
+    std::vector<Operation> operations = makeOperations(operationCount, 800);
+
+    // TLSF
+    GeometryAllocator allocator(CAPACITY);
+    std::vector<GeometryAllocator::BlockId> live;
+    std::size_t tlsfFailures = 0;
+    double tlsfSeconds = measureSeconds(REPEAT_COUNT, [&]() {
+        allocator = GeometryAllocator(CAPACITY);
+        live.clear();
+        tlsfFailures = 0;
+        for (const Operation& operation : operations) {
+            if (operation.allocate) {
+                GeometryAllocator::BlockId block = allocator.allocate(operation.value);
+                if (block == GeometryAllocator::INVALID_BLOCK) {
+                    ++tlsfFailures;
+                    continue;
+                }
+                live.push_back(block);
+            }
+            else if (!live.empty()) {
+                std::size_t index = operation.value % live.size();
+                allocator.free(live[index]);
+                live[index] = live.back();
+                live.pop_back();
+            }
+        }
+    });
+    bool valid = verify(allocator, live);
+    GeometryAllocator::Stats before = allocator.getStats();
+
+    // 先頭適合
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> firstFitLive;
+    std::size_t firstFitFailures = 0;
+    std::size_t firstFitFreeBlocks = 0;
+    double firstFitSeconds = measureSeconds(REPEAT_COUNT, [&]() {
+        FirstFitAllocator firstFit(CAPACITY);
+        firstFitLive.clear();
+        firstFitFailures = 0;
+        for (const Operation& operation : operations) {
+            if (operation.allocate) {
+                std::uint32_t offset = firstFit.allocate(operation.value);
+                if (offset == GeometryAllocator::INVALID_BLOCK) {
+                    ++firstFitFailures;
+                    continue;
+                }
+                firstFitLive.emplace_back(offset, operation.value);
+            }
+            else if (!firstFitLive.empty()) {
+                std::size_t index = operation.value % firstFitLive.size();
+                firstFit.free(firstFitLive[index].first, firstFitLive[index].second);
+                firstFitLive[index] = firstFitLive.back();
+                firstFitLive.pop_back();
+            }
+        }
+        firstFitFreeBlocks = firstFit.getFreeBlockCount();
+    });
+
+    // 断片化の解消（移動後も番号で参照でき、空きが1つにまとまること）
+    auto defragmentStart = Clock::now();
+    std::vector<GeometryAllocator::Move> moves = allocator.defragment();
+    double defragmentSeconds =
+        std::chrono::duration<double>(Clock::now() - defragmentStart).count();
+    GeometryAllocator::Stats after = allocator.getStats();
+    std::size_t movedElements = 0;
+    for (const GeometryAllocator::Move& move : moves) {
+        movedElements += move.size;
+        valid = valid && move.to < move.from;
+    }
+    valid = valid && verify(allocator, live) && after.freeBlocks <= 1 &&
+            after.getFragmentation() == 0.0 && after.used == before.used;
+
+    std::cout << "Operations: " << operations.size() << ", capacity: " << CAPACITY
+              << " elements" << std::endl;
+    printRow("first fit (std::map)", firstFitSeconds, operations.size(), firstFitSeconds);
+    printRow("TLSF", tlsfSeconds, operations.size(), firstFitSeconds);
+    std::cout << std::setprecision(1) << "  Failed allocations: first fit " << firstFitFailures
+              << ", TLSF " << tlsfFailures << std::endl;
+    std::cout << "  Free blocks: first fit " << firstFitFreeBlocks << ", TLSF "
+              << before.freeBlocks << std::endl;
+    std::cout << "  TLSF utilization " << before.getUtilization() * 100.0 << "%, fragmentation "
+              << before.getFragmentation() * 100.0 << "% (largest free " << before.largestFree
+              << " of " << before.capacity - before.used << ")" << std::endl;
+    std::cout << std::setprecision(3) << "  Defragment: " << moves.size() << " moves, "
+              << movedElements << " elements in " << defragmentSeconds * 1000.0
+              << " ms, fragmentation " << after.getFragmentation() * 100.0 << "%" << std::endl;
+    std::cout << "  Allocations valid: " << (valid ? "yes" : "no") << std::endl;
+    return valid ? 0 : 1;
+}
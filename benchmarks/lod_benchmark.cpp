@@ -0,0 +1,187 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "renderer/mesh_simplifier.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief 処理を繰り返し実行し、1回あたりの最短時間（秒）を返す
+ */
+template <typename F>
+double measureSeconds(int repeatCount, F&& function) {
+    double best = 1e30;
+    for (int i = 0; i < repeatCount; ++i) {
+        auto start = Clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        best = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+/**
+ * @brief 凹凸のある球のメッシュを生成する（経度0の継ぎ目と極はテクスチャ座標で分かれる）
+ */
+void makeBumpySphere(int segments, std::vector<claude_gl::Mesh::Vertex>& vertices,
+                     std::vector<unsigned int>& indices) {
+    int rings = segments / 2;
+    for (int ring = 0; ring <= rings; ++ring) {
+        float v = static_cast<float>(ring) / rings;
+        float theta = v * glm::pi<float>();
+        for (int segment = 0; segment <= segments; ++segment) {
+            float u = static_cast<float>(segment) / segments;
+            float phi = u * 2.0f * glm::pi<float>();
+            glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta),
+                             std::sin(theta) * std::sin(phi));
+            float bump = 1.0f + 0.03f * std::sin(theta * 12.0f) * std::sin(phi * 9.0f);
+            vertices.push_back({normal * bump, normal, glm::vec2(u, v)});
+        }
+    }
+    unsigned int stride = static_cast<unsigned int>(segments + 1);
+    for (int ring = 0; ring < rings; ++ring) {
+        for (int segment = 0; segment < segments; ++segment) {
+            unsigned int a = ring * stride + segment;
+            unsigned int b = a + stride;
+            if (ring > 0) {
+                indices.insert(indices.end(), {a, a + 1, b});
+            }
+            if (ring < rings - 1) {
+                indices.insert(indices.end(), {a + 1, b + 1, b});
+            }
+        }
+    }
+}
+
+/**
+ * @brief シーンの実行結果
+ */
+struct SceneResult {
+    double trianglesPerFrame = 0.0;  ///< 1フレームあたりの三角形数（平均）
+    std::size_t switches = 0;        ///< 段階が変わった回数（全フレームの合計）
+};
+
+/**
+ * @brief カメラを移動しながら全インスタンスの段階を選び、描画する三角形数と切り替え数を数える
+ */
+SceneResult runScene(const std::vector<claude_gl::Mesh::LodLevel>& levels,
+                     const claude_gl::BoundingVolume& bounds,
+                     const std::vector<glm::mat4>& worlds, claude_gl::LodView view,
+                     int frameCount, bool useLod) {
+    using namespace claude_gl;
+    SceneResult result;
+    std::vector<std::uint8_t> current(worlds.size(), 0);
+    std::size_t triangles = 0;
+    for (int frame = 0; frame < frameCount; ++frame) {
+        // 前進しながら小刻みに前後に揺れる（閾値の付近で段階が行き来しやすい動き）
+        float z = -10.0f + frame * 0.25f + 0.5f * std::sin(frame * 2.5f);
+        view.cameraPosition = glm::vec3(0.0f, 2.0f, z);
+        for (std::size_t i = 0; i < worlds.size(); ++i) {
+            std::size_t level = 0;
+            if (useLod) {
+                float pixelsPerUnit = MeshSimplifier::getPixelsPerUnit(view, worlds[i], bounds);
+                level = MeshSimplifier::selectLod(levels.data(), levels.size(), pixelsPerUnit,
+                                                  current[i], view.thresholdPixels,
+                                                  view.hysteresis);
+            }
+            result.switches += level != current[i] ? 1 : 0;
+            current[i] = static_cast<std::uint8_t>(level);
+            triangles += levels[level].indexCount / 3;
+        }
+    }
+    result.trianglesPerFrame = static_cast<double>(triangles) / frameCount;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace claude_gl;
+
+    const int gridSize = argc > 1 ? std::atoi(argv[1]) : 100;
+    constexpr int SEGMENTS = 256;
+    constexpr int REPEAT_COUNT = 5;
+    constexpr int FRAME_COUNT = 400;
+    constexpr float SPACING = 4.0f;
+
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<unsigned int> indices;
+    makeBumpySphere(SEGMENTS, vertices, indices);
+    BoundingVolume bounds = {glm::vec3(-1.1f), glm::vec3(1.1f), 1.1f};
+
+    // 元のメッシュから段階を生成する（誤差の上限は半径の 5%、属性の重みは半径の 2%）
+    MeshSimplifier::LodOptions options;
+    options.levelCount = 6;
+    options.maxError = 0.05f;
+    options.simplify.normalWeight = 0.02f;
+    options.simplify.texCoordWeight = 0.02f;
+    std::vector<unsigned int> chain;
+    std::vector<Mesh::LodLevel> levels;
+    double buildSeconds = measureSeconds(REPEAT_COUNT, [&]() {
+        chain = indices;
+        levels = MeshSimplifier::buildLodChain(vertices.data(), vertices.size(), chain, options);
+    });
+    std::cout << "Mesh: " << vertices.size() << " vertices, " << indices.size() / 3
+              << " triangles" << std::endl;
+    std::cout << "LOD chain: " << levels.size() << " levels in " << buildSeconds * 1000.0
+              << " ms" << std::endl;
+
+    bool valid = levels.size() > 1;
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        const Mesh::LodLevel& level = levels[i];
+        std::cout << "  level " << i << ": " << level.indexCount / 3 << " triangles, error "
+                  << level.error << std::endl;
+        valid = valid && level.indexCount % 3 == 0 &&
+                level.firstIndex + level.indexCount <= chain.size();
+        if (i > 0) {
+            valid = valid && level.indexCount < levels[i - 1].indexCount &&
+                    level.error >= levels[i - 1].error;
+        }
+    }
+    for (unsigned int index : chain) {
+        valid = valid && index < vertices.size();
+    }
+
+    // 格子状に並べたインスタンスの間をカメラが進む
+    std::vector<glm::mat4> worlds;
+    for (int x = 0; x < gridSize; ++x) {
+        for (int z = 0; z < gridSize; ++z) {
+            glm::vec3 position((x - gridSize / 2) * SPACING, 0.0f, z * SPACING);
+            worlds.push_back(glm::translate(glm::mat4(1.0f), position));
+        }
+    }
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    LodView view = LodView::make(glm::vec3(0.0f), projection, 1080.0f, 1.0f);
+
+    SceneResult full = runScene(levels, bounds, worlds, view, FRAME_COUNT, false);
+    SceneResult lod;
+    double selectSeconds = measureSeconds(REPEAT_COUNT, [&]() {
+        lod = runScene(levels, bounds, worlds, view, FRAME_COUNT, true);
+    });
+    LodView noHysteresis = view;
+    noHysteresis.hysteresis = 0.0f;
+    SceneResult flicker = runScene(levels, bounds, worlds, noHysteresis, FRAME_COUNT, true);
+
+    double selections = static_cast<double>(worlds.size()) * FRAME_COUNT;
+    std::cout << "Instances: " << worlds.size() << ", frames: " << FRAME_COUNT << std::endl;
+    std::cout << "  triangles/frame without LOD: " << full.trianglesPerFrame << std::endl;
+    std::cout << "  triangles/frame with LOD:    " << lod.trianglesPerFrame << " ("
+              << full.trianglesPerFrame / lod.trianglesPerFrame << "x fewer)" << std::endl;
+    std::cout << "  level switches: " << lod.switches << " with hysteresis, " << flicker.switches
+              << " without" << std::endl;
+    std::cout << "  selection: " << selectSeconds / selections * 1e9 << " ns/instance"
+              << std::endl;
+
+    bool fewerTriangles = lod.trianglesPerFrame < full.trianglesPerFrame;
+    bool stable = lod.switches <= flicker.switches;
+    std::cout << "LOD chain valid: " << (valid ? "yes" : "no") << std::endl;
+    std::cout << "Fewer triangles: " << (fewerTriangles ? "yes" : "no") << std::endl;
+    std::cout << "Hysteresis stable: " << (stable ? "yes" : "no") << std::endl;
+    return valid && fewerTriangles && stable ? 0 : 1;
+}
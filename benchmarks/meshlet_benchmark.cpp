@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "renderer/cluster_culler.h"
+#include "renderer/frustum_culler.h"
+#include "renderer/meshlet_builder.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief 処理を繰り返し実行し、1回あたりの最短時間（秒）を返す
+ */
+template <typename F>
+double measureSeconds(int repeatCount, F&& function) {
+    double best = 1e30;
+    for (int i = 0; i < repeatCount; ++i) {
+        auto start = Clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        best = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+/**
+ * @brief 凹凸のある球のメッシュを生成する（経度0の継ぎ目と極はテクスチャ座標で分かれる）
+ */
+void makeBumpySphere(int segments, std::vector<claude_gl::Mesh::Vertex>& vertices,
+                     std::vector<unsigned int>& indices) {
+    int rings = segments / 2;
+    for (int ring = 0; ring <= rings; ++ring) {
+        float v = static_cast<float>(ring) / rings;
+        float theta = v * glm::pi<float>();
+        for (int segment = 0; segment <= segments; ++segment) {
+            float u = static_cast<float>(segment) / segments;
+            float phi = u * 2.0f * glm::pi<float>();
+            glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta),
+                             std::sin(theta) * std::sin(phi));
+            float bump = 1.0f + 0.03f * std::sin(theta * 12.0f) * std::sin(phi * 9.0f);
+            vertices.push_back({normal * bump, normal, glm::vec2(u, v)});
+        }
+    }
+    // 外から見て反時計回りになる向きで三角形を並べる
+    unsigned int stride = static_cast<unsigned int>(segments + 1);
+    for (int ring = 0; ring < rings; ++ring) {
+        for (int segment = 0; segment < segments; ++segment) {
+            unsigned int a = ring * stride + segment;
+            unsigned int b = a + stride;
+            if (ring > 0) {
+                indices.insert(indices.end(), {a, a + 1, b});
+            }
+            if (ring < rings - 1) {
+                indices.insert(indices.end(), {a + 1, b + 1, b});
+            }
+        }
+    }
+}
+
+/**
+ * @brief 三角形を回転させて最小の番号から始まる形にそろえる（並べ替えの比較用）
+ */
+std::array<unsigned int, 3> canonicalTriangle(const unsigned int* triangle) {
+    int first = 0;
+    for (int k = 1; k < 3; ++k) {
+        first = triangle[k] < triangle[first] ? k : first;
+    }
+    return {triangle[first], triangle[(first + 1) % 3], triangle[(first + 2) % 3]};
+}
+
+/**
+ * @brief シーンの実行結果
+ */
+struct SceneResult {
+    double trianglesPerFrame = 0.0;  ///< 1フレームあたりの描画する三角形数（平均）
+    double clustersPerFrame = 0.0;   ///< 1フレームあたりの判定したクラスタ数（平均）
+};
+
+/**
+ * @brief カメラを移動しながら視錐台と交差するインスタンスを選び、描画する三角形数を数える
+ *
+ * clusters が nullptr の場合はメッシュ単位で描画する。
+ */
+SceneResult runScene(const std::vector<claude_gl::Mesh::Meshlet>& meshlets,
+                     std::size_t triangleCount, float meshRadius,
+                     const std::vector<glm::mat4>& worlds, const glm::mat4& projection,
+                     int frameCount, claude_gl::ClusterCuller* clusters) {
+    using namespace claude_gl;
+    SceneResult result;
+    std::vector<std::uint32_t> visible;
+    std::size_t triangles = 0;
+    std::size_t tested = 0;
+    for (int frame = 0; frame < frameCount; ++frame) {
+        glm::vec3 camera(0.0f, 2.0f, -10.0f + frame * 0.25f);
+        glm::mat4 view = glm::lookAt(camera, camera + glm::vec3(0.3f, -0.1f, 1.0f),
+                                     glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 viewProjection = projection * view;
+        if (clusters) {
+            clusters->beginFrame(viewProjection, camera);
+        }
+        for (const glm::mat4& world : worlds) {
+            glm::vec4 planes[6];
+            FrustumCuller::extractPlanes(viewProjection * world, planes);
+            Mesh::Meshlet whole;
+            whole.radius = meshRadius;
+            if (ClusterCuller::isOutsideFrustum(whole, planes)) {
+                continue;
+            }
+            if (!clusters) {
+                triangles += triangleCount;
+                continue;
+            }
+            clusters->beginInstance(world);
+            clusters->cull(meshlets.data(), meshlets.size(), visible);
+            tested += meshlets.size();
+            for (std::uint32_t id : visible) {
+                triangles += meshlets[id].indexCount / 3;
+            }
+        }
+    }
+    result.trianglesPerFrame = static_cast<double>(triangles) / frameCount;
+    result.clustersPerFrame = static_cast<double>(tested) / frameCount;
+    return result;
+}
+
+/**
+ * @brief 除いたクラスタが本当に見えないか、全頂点と全三角形で確かめる
+ */
+bool checkConservative(const std::vector<claude_gl::Mesh::Vertex>& vertices,
+                       const std::vector<unsigned int>& indices,
+                       const std::vector<claude_gl::Mesh::Meshlet>& meshlets,
+                       const glm::mat4& viewProjection, const glm::vec3& camera) {
+    using namespace claude_gl;
+    constexpr float TOLERANCE = 1e-4f;
+    glm::vec4 planes[6];
+    FrustumCuller::extractPlanes(viewProjection, planes);
+    for (const Mesh::Meshlet& meshlet : meshlets) {
+        const unsigned int* first = indices.data() + meshlet.firstIndex;
+        if (ClusterCuller::isOutsideFrustum(meshlet, planes)) {
+            // いずれかの平面の外側に全頂点がある
+            bool outside = false;
+            for (int p = 0; p < 6 && !outside; ++p) {
+                outside = true;
+                for (std::uint32_t i = 0; i < meshlet.indexCount && outside; ++i) {
+                    glm::vec3 position = vertices[first[i]].position;
+                    outside = glm::dot(glm::vec3(planes[p]), position) + planes[p].w < 0.0f;
+                }
+            }
+            if (!outside) {
+                return false;
+            }
+        }
+        else if (ClusterCuller::isBackfacing(meshlet, camera)) {
+            // 全三角形の表側にカメラがない
+            for (std::uint32_t i = 0; i < meshlet.indexCount; i += 3) {
+                glm::vec3 a = vertices[first[i]].position;
+                glm::vec3 normal = glm::cross(vertices[first[i + 1]].position - a,
+                                              vertices[first[i + 2]].position - a);
+                float length = glm::length(normal);
+                if (length > 0.0f && glm::dot(normal / length, camera - a) > TOLERANCE) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace claude_gl;
+
+    const int gridSize = argc > 1 ? std::atoi(argv[1]) : 40;
+    constexpr int SEGMENTS = 256;
+    constexpr int REPEAT_COUNT = 5;
+    constexpr int FRAME_COUNT = 100;
+    constexpr float SPACING = 4.0f;
+    constexpr float MESH_RADIUS = 1.1f;
+
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<unsigned int> indices;
+    makeBumpySphere(SEGMENTS, vertices, indices);
+    std::size_t triangleCount = indices.size() / 3;
+
+    MeshletBuilder::Options options;
+    std::vector<unsigned int> reordered;
+    std::vector<Mesh::Meshlet> meshlets;
+    double buildSeconds = measureSeconds(REPEAT_COUNT, [&]() {
+        reordered = indices;
+        meshlets = MeshletBuilder::build(vertices.data(), vertices.size(), reordered.data(),
+                                         reordered.size(), options);
+    });
+    std::cout << "Mesh: " << vertices.size() << " vertices, " << triangleCount << " triangles"
+              << std::endl;
+    std::cout << "Meshlets: " << meshlets.size() << " in " << buildSeconds * 1000.0 << " ms"
+              << std::endl;
+
+    // 範囲が隙間なく並び、上限を守り、三角形の集合が元と同じであること
+    bool valid = !meshlets.empty();
+    std::size_t nextIndex = 0;
+    std::size_t totalVertices = 0;
+    std::size_t coneCount = 0;
+    std::vector<unsigned int> unique;
+    for (const Mesh::Meshlet& meshlet : meshlets) {
+        valid = valid && meshlet.firstIndex == nextIndex && meshlet.indexCount % 3 == 0 &&
+                meshlet.indexCount / 3 <= options.maxTriangles;
+        nextIndex = meshlet.firstIndex + meshlet.indexCount;
+        unique.assign(reordered.begin() + meshlet.firstIndex, reordered.begin() + nextIndex);
+        std::sort(unique.begin(), unique.end());
+        std::size_t vertexCount = std::unique(unique.begin(), unique.end()) - unique.begin();
+        valid = valid && vertexCount <= options.maxVertices;
+        totalVertices += vertexCount;
+        coneCount += meshlet.coneCutoff < 1.0f ? 1 : 0;
+    }
+    valid = valid && nextIndex == indices.size();
+    std::vector<std::array<unsigned int, 3>> sourceTriangles;
+    std::vector<std::array<unsigned int, 3>> builtTriangles;
+    for (std::size_t i = 0; i < indices.size() && valid; i += 3) {
+        sourceTriangles.push_back(canonicalTriangle(&indices[i]));
+        builtTriangles.push_back(canonicalTriangle(&reordered[i]));
+    }
+    std::sort(sourceTriangles.begin(), sourceTriangles.end());
+    std::sort(builtTriangles.begin(), builtTriangles.end());
+    valid = valid && sourceTriangles == builtTriangles;
+    if (!meshlets.empty()) {
+        std::cout << "  average " << static_cast<double>(totalVertices) / meshlets.size()
+                  << " vertices, " << static_cast<double>(triangleCount) / meshlets.size()
+                  << " triangles, " << coneCount << " with normal cones" << std::endl;
+    }
+
+    // 格子状に並べたインスタンスの間をカメラが進む
+    std::vector<glm::mat4> worlds;
+    for (int x = 0; x < gridSize; ++x) {
+        for (int z = 0; z < gridSize; ++z) {
+            glm::vec3 position((x - gridSize / 2) * SPACING, 0.0f, z * SPACING);
+            worlds.push_back(glm::translate(glm::mat4(1.0f), position));
+        }
+    }
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+
+    SceneResult meshLevel = runScene(meshlets, triangleCount, MESH_RADIUS, worlds, projection,
+                                     FRAME_COUNT, nullptr);
+    ClusterCuller frustumOnly;
+    frustumOnly.setConeCulling(false);
+    SceneResult frustum = runScene(meshlets, triangleCount, MESH_RADIUS, worlds, projection,
+                                   FRAME_COUNT, &frustumOnly);
+    ClusterCuller withCone;
+    SceneResult cone;
+    double cullSeconds = measureSeconds(REPEAT_COUNT, [&]() {
+        cone = runScene(meshlets, triangleCount, MESH_RADIUS, worlds, projection, FRAME_COUNT,
+                        &withCone);
+    });
+
+    std::cout << "Instances: " << worlds.size() << ", frames: " << FRAME_COUNT << std::endl;
+    std::cout << "  triangles/frame, mesh frustum culling:    " << meshLevel.trianglesPerFrame
+              << std::endl;
+    std::cout << "  triangles/frame, cluster frustum culling: " << frustum.trianglesPerFrame
+              << std::endl;
+    std::cout << "  triangles/frame, cluster frustum + cone:  " << cone.trianglesPerFrame << " ("
+              << meshLevel.trianglesPerFrame / cone.trianglesPerFrame << "x fewer)"
+              << std::endl;
+    std::cout << "  cluster test: " << cullSeconds / (cone.clustersPerFrame * FRAME_COUNT) * 1e9
+              << " ns/cluster (includes instance culling)" << std::endl;
+
+    // 視錐台の端に掛かる位置と、いくつかの向きから除いたクラスタを確かめる
+    bool conservative = true;
+    const glm::vec3 cameras[] = {glm::vec3(0.0f, 0.0f, -3.0f), glm::vec3(2.5f, 1.0f, 0.5f),
+                                 glm::vec3(-0.5f, -4.0f, 0.2f), glm::vec3(0.0f, 0.3f, 1.3f)};
+    for (const glm::vec3& camera : cameras) {
+        glm::mat4 view = glm::lookAt(camera, glm::vec3(0.4f, 0.2f, 0.0f),
+                                     glm::vec3(0.0f, 1.0f, 0.0f));
+        conservative = conservative && checkConservative(vertices, reordered, meshlets,
+                                                         projection * view, camera);
+    }
+
+    bool fewerTriangles = cone.trianglesPerFrame < frustum.trianglesPerFrame &&
+                          frustum.trianglesPerFrame < meshLevel.trianglesPerFrame;
+    std::cout << "Meshlets valid: " << (valid ? "yes" : "no") << std::endl;
+    std::cout << "Fewer triangles: " << (fewerTriangles ? "yes" : "no") << std::endl;
+    std::cout << "Conservative culling: " << (conservative ? "yes" : "no") << std::endl;
+    return valid && fewerTriangles && conservative ? 0 : 1;
+}
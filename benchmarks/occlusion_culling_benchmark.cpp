@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "renderer/occlusion_culler.h"
+#include "utils/thread_pool.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief 処理を繰り返し実行し、1回あたりの最短時間（秒）を返す
+ */
+template <typename F>
+double measureSeconds(int repeatCount, F&& function) {
+    double best = 1e30;
+    for (int i = 0; i < repeatCount; ++i) {
+        auto start = Clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        best = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace claude_gl;
+
+    const std::size_t objectCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    constexpr int REPEAT_COUNT = 20;
+    constexpr int WALL_COUNT = 8;
+    constexpr float WALL_SPACING = 12.0f;
+    constexpr float FIRST_WALL = 10.0f;
+
+    // 室内を想定し、+Z 方向に一定間隔で出入口のある壁を並べる（出入口は左右に交互にずらす）
+    std::vector<OccluderMesh> walls;
+    for (int i = 0; i < WALL_COUNT; ++i) {
+        float z = FIRST_WALL + i * WALL_SPACING;
+        float door = (i % 2 == 0) ? -6.0f : 6.0f;
+        walls.push_back(OccluderMesh::makeBox(
+            {glm::vec3(-40.0f, -10.0f, z), glm::vec3(door - 1.5f, 10.0f, z + 0.5f)}));
+        walls.push_back(OccluderMesh::makeBox(
+            {glm::vec3(door + 1.5f, -10.0f, z), glm::vec3(40.0f, 10.0f, z + 0.5f)}));
+        walls.push_back(OccluderMesh::makeBox(
+            {glm::vec3(door - 1.5f, 3.0f, z), glm::vec3(door + 1.5f, 10.0f, z + 0.5f)}));
+    }
+
+    // 壁の間に小さな物体を置く（最初の壁より手前のものは必ず見える）
+    std::mt19937 random(12345);
+    std::uniform_real_distribution<float> x(-30.0f, 30.0f);
+    std::uniform_real_distribution<float> y(-8.0f, 8.0f);
+    std::uniform_real_distribution<float> z(2.0f, FIRST_WALL + WALL_COUNT * WALL_SPACING);
+    std::uniform_real_distribution<float> size(0.1f, 1.0f);
+    std::vector<Aabb> boxes(objectCount);
+    for (Aabb& box : boxes) {
+        glm::vec3 center(x(random), y(random), z(random));
+        glm::vec3 extents(size(random));
+        box = {center - extents, center + extents};
+    }
+
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+    glm::mat4 viewProjection = projection * view;
+
+    // 1スレッドと全スレッドで同じ結果になることを確認する
+    unsigned int threadCounts[] = {1, ThreadPool::defaultThreadCount()};
+    std::vector<std::uint8_t> results[2];
+    bool conservative = true;
+    for (int run = 0; run < 2; ++run) {
+        OcclusionCuller culler(320, 192, threadCounts[run]);
+        results[run].resize(objectCount);
+        double renderSeconds = measureSeconds(REPEAT_COUNT, [&]() {
+            culler.beginFrame(viewProjection);
+            for (const OccluderMesh& wall : walls) {
+                culler.addOccluder(wall, glm::mat4(1.0f));
+            }
+            culler.render();
+        });
+        double testSeconds = measureSeconds(REPEAT_COUNT, [&]() {
+            culler.testBoxes(boxes.data(), boxes.size(), results[run].data());
+        });
+
+        std::size_t visible = 0;
+        for (std::size_t i = 0; i < objectCount; ++i) {
+            visible += results[run][i];
+            conservative = conservative && (boxes[i].boundsMax.z >= FIRST_WALL || results[run][i]);
+        }
+        const OcclusionCuller::Stats& stats = culler.getStats();
+        double millions = static_cast<double>(objectCount) / 1e6;
+        std::cout << "Threads: " << culler.getThreadCount() << " (" << culler.getWidth() << "x"
+                  << culler.getHeight() << ", " << stats.rasterizedTriangles << "/"
+                  << stats.occluderTriangles << " occluder triangles rasterized)" << std::endl;
+        std::cout << "  render:     " << renderSeconds * 1000.0 << " ms" << std::endl;
+        std::cout << "  testBoxes:  " << testSeconds * 1000.0 << " ms ("
+                  << millions / testSeconds << " M boxes/s)" << std::endl;
+        std::cout << "  Objects: " << objectCount << " (visible " << visible << ", occluded "
+                  << objectCount - visible << ")" << std::endl;
+    }
+
+    bool identical = results[0] == results[1];
+    std::cout << "Results identical: " << (identical ? "yes" : "no") << std::endl;
+    std::cout << "Unoccluded objects kept: " << (conservative ? "yes" : "no") << std::endl;
+    return identical && conservative ? 0 : 1;
+}
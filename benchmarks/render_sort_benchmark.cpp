@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "renderer/render_sort.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using claude_gl::RenderPass;
+using claude_gl::RenderSort;
+
+/**
+ * @brief 処理を繰り返し実行し、1回あたりの最短時間（秒）を返す
+ */
+template <typename F>
+double measureSeconds(int repeatCount, F&& function) {
+    double best = 1e30;
+    for (int i = 0; i < repeatCount; ++i) {
+        auto start = Clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        best = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+/**
+ * @brief 描画コマンドの状態（ベンチマーク用）
+ */
+struct CommandState {
+    std::uint32_t shader;
+    std::uint32_t material;
+    std::uint32_t mesh;
+    float depth;
+    bool transparent;
+};
+
+/**
+ * @brief 並び順に実行した場合の状態の切り替え数を数える（RenderQueue と同じ数え方）
+ */
+std::size_t countStateChanges(const std::vector<CommandState>& states,
+                              const std::vector<RenderSort::Item>& order) {
+    std::size_t changes = 0;
+    const CommandState* previous = nullptr;
+    for (const RenderSort::Item& item : order) {
+        const CommandState& state = states[item.command];
+        bool shaderChanged = !previous || state.shader != previous->shader;
+        changes += shaderChanged ? 1 : 0;
+        changes += !previous || state.material != previous->material ? 1 : 0;
+        changes += shaderChanged || state.mesh != previous->mesh ? 1 : 0;
+        previous = &state;
+    }
+    return changes;
+}
+
+/**
+ * @brief 計測結果を1行出力する
+ */
+void printRow(const char* label, double seconds, std::size_t count, double baselineSeconds) {
+    std::cout << "  " << std::left << std::setw(34) << label << std::right << std::fixed
+              << std::setprecision(3) << std::setw(9) << seconds * 1000.0 << " ms"
+              << std::setw(9) << seconds * 1e9 / static_cast<double>(count) << " ns/command"
+              << std::setw(8) << std::setprecision(1) << baselineSeconds / seconds << "x"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t commandCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    constexpr int REPEAT_COUNT = 20;
+    constexpr float NEAR_PLANE = 0.1f;
+    constexpr float FAR_PLANE = 100.0f;
+
+    // シェーダー8種・マテリアル64種・メッシュ500種、1割が半透明のコマンドを投入順に並べる
+    std::mt19937 random(12345);
+    std::uniform_int_distribution<std::uint32_t> shader(0, 7);
+    std::uniform_int_distribution<std::uint32_t> material(0, 63);
+    std::uniform_int_distribution<std::uint32_t> mesh(0, 499);
+    std::uniform_real_distribution<float> depth(NEAR_PLANE, FAR_PLANE);
+    std::vector<CommandState> states(commandCount);
+    std::vector<RenderSort::Item> submitted(commandCount);
+    for (std::size_t i = 0; i < commandCount; ++i) {
+        CommandState& state = states[i];
+        state = {shader(random), material(random), mesh(random), depth(random),
+                 random() % 10 == 0};
+        RenderPass pass = state.transparent ? RenderPass::Transparent : RenderPass::Opaque;
+        submitted[i].key =
+            RenderSort::makeKey(pass, state.shader, state.material, state.mesh,
+                                RenderSort::quantizeDepth(state.depth, NEAR_PLANE, FAR_PLANE));
+        submitted[i].command = static_cast<std::uint32_t>(i);
+    }
+
+    // 比較: std::stable_sort
+    auto byKey = [](const RenderSort::Item& a, const RenderSort::Item& b) {
+        return a.key < b.key;
+    };
+    std::vector<RenderSort::Item> expected;
+    double stableSort = measureSeconds(REPEAT_COUNT, [&]() {
+        expected = submitted;
+        std::stable_sort(expected.begin(), expected.end(), byKey);
+    });
+    std::vector<RenderSort::Item> comparison;
+    double stdSort = measureSeconds(REPEAT_COUNT, [&]() {
+        comparison = submitted;
+        std::sort(comparison.begin(), comparison.end(), byKey);
+    });
+
+    // 基数ソート（作業領域はフレームをまたいで再利用する）
+    std::vector<RenderSort::Item> sorted;
+    std::vector<RenderSort::Item> scratch;
+    unsigned passes = 0;
+    double radixSort = measureSeconds(REPEAT_COUNT, [&]() {
+        sorted = submitted;
+        passes = RenderSort::sort(sorted, scratch);
+    });
+    double copyOnly = measureSeconds(REPEAT_COUNT, [&]() { comparison = submitted; });
+
+    bool identical = sorted.size() == expected.size();
+    for (std::size_t i = 0; identical && i < sorted.size(); ++i) {
+        identical = sorted[i].key == expected[i].key && sorted[i].command == expected[i].command;
+    }
+
+    // パスの順と、各パス内の深度の順を確認する
+    bool ordered = true;
+    for (std::size_t i = 1; i < sorted.size(); ++i) {
+        const CommandState& previous = states[sorted[i - 1].command];
+        const CommandState& current = states[sorted[i].command];
+        ordered = ordered && (!previous.transparent || current.transparent);
+        if (previous.transparent && current.transparent) {
+            std::uint32_t previousDepth =
+                RenderSort::quantizeDepth(previous.depth, NEAR_PLANE, FAR_PLANE);
+            std::uint32_t currentDepth =
+                RenderSort::quantizeDepth(current.depth, NEAR_PLANE, FAR_PLANE);
+            ordered = ordered && previousDepth >= currentDepth;
+        }
+    }
+
+    std::cout << "Commands: " << commandCount << std::endl;
+    printRow("std::stable_sort", stableSort - copyOnly, commandCount, stableSort - copyOnly);
+    printRow("std::sort", stdSort - copyOnly, commandCount, stableSort - copyOnly);
+    printRow("RenderSort::sort (radix)", radixSort - copyOnly, commandCount,
+             stableSort - copyOnly);
+    std::cout << "  Radix passes: " << passes << std::endl;
+    std::cout << "  State changes: submission order " << countStateChanges(states, submitted)
+              << ", sorted " << countStateChanges(states, sorted) << std::endl;
+    std::cout << "  Identical to stable_sort: " << (identical ? "yes" : "no")
+              << ", pass/depth order: " << (ordered ? "ok" : "broken") << std::endl;
+    return identical && ordered ? 0 : 1;
+}
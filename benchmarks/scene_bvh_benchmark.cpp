@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "renderer/dynamic_bvh.h"
+#include "renderer/frustum_culler.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using claude_gl::Aabb;
+using claude_gl::DynamicBvh;
+
+/**
+ * @brief 処理を繰り返し実行し、1回あたりの最短時間（秒）を返す
+ */
+template <typename F>
+double measureSeconds(int repeatCount, F&& function) {
+    double best = 1e30;
+    for (int i = 0; i < repeatCount; ++i) {
+        auto start = Clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        best = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+/**
+ * @brief ボックスが視錐台と交差するか判定する（全探索の比較用）
+ */
+bool intersectsFrustum(const Aabb& box, const glm::vec4 planes[6]) {
+    glm::vec3 center = box.getCenter();
+    glm::vec3 extents = box.getExtents();
+    for (int p = 0; p < 6; ++p) {
+        glm::vec3 normal(planes[p]);
+        float distance = glm::dot(normal, center) + planes[p].w;
+        if (distance < -glm::dot(glm::abs(normal), extents)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief レイとボックスの交差距離を求める（交差しなければ maxDistance）
+ */
+float intersectRay(const Aabb& box, const glm::vec3& origin, const glm::vec3& inverseDirection,
+                   float maxDistance) {
+    glm::vec3 t0 = (box.boundsMin - origin) * inverseDirection;
+    glm::vec3 t1 = (box.boundsMax - origin) * inverseDirection;
+    glm::vec3 tNear = glm::min(t0, t1);
+    glm::vec3 tFar = glm::max(t0, t1);
+    float entry = std::fmax(std::fmax(tNear.x, tNear.y), std::fmax(tNear.z, 0.0f));
+    float exit = std::fmin(std::fmin(tFar.x, tFar.y), tFar.z);
+    return entry <= exit && entry < maxDistance ? entry : maxDistance;
+}
+
+/**
+ * @brief 計測結果を1行出力する
+ */
+void printRow(const char* label, double bvhSeconds, double linearSeconds) {
+    std::cout << "  " << std::left << std::setw(22) << label << std::right << std::fixed
+              << std::setprecision(3) << std::setw(10) << bvhSeconds * 1e6 << " us"
+              << std::setw(12) << linearSeconds * 1e6 << " us" << std::setw(9)
+              << std::setprecision(1) << linearSeconds / bvhSeconds << "x" << std::endl;
+}
+
+/**
+ * @brief 指定したインスタンス数で構築・更新・検索を計測する
+ * @return BVHの検索結果が全探索と一致した場合はtrue
+ */
+bool runBenchmark(std::size_t instanceCount) {
+    constexpr int REPEAT_COUNT = 10;
+    constexpr int QUERY_COUNT = 256;
+
+    // 密度が一定になるよう、インスタンス数に応じて配置範囲を広げる
+    float halfSize = 10.0f * std::cbrt(static_cast<float>(instanceCount));
+    std::mt19937 random(12345);
+    std::uniform_real_distribution<float> position(-halfSize, halfSize);
+    std::uniform_real_distribution<float> size(0.2f, 2.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<Aabb> boxes(instanceCount);
+    for (Aabb& box : boxes) {
+        glm::vec3 center(position(random), position(random), position(random));
+        glm::vec3 extents(size(random), size(random), size(random));
+        box = {center - extents, center + extents};
+    }
+
+    // 構築（逐次挿入とSAHによる一括構築）
+    DynamicBvh bvh;
+    std::vector<int> leaves(instanceCount);
+    double insertSeconds = measureSeconds(REPEAT_COUNT, [&]() {
+        bvh.clear();
+        for (std::size_t i = 0; i < instanceCount; ++i) {
+            leaves[i] = bvh.insert(boxes[i], static_cast<std::uint32_t>(i));
+        }
+    });
+    float insertSah = bvh.computeSahCost();
+    double rebuildSeconds = measureSeconds(REPEAT_COUNT, [&]() { bvh.rebuild(); });
+    float rebuildSah = bvh.computeSahCost();
+    int rebuildHeight = bvh.getHeight();
+
+    // 変換の更新（全体の10%を少しずつ動かす）
+    std::size_t movingCount = std::max<std::size_t>(1, instanceCount / 10);
+    std::vector<glm::vec3> velocities(movingCount);
+    for (glm::vec3& velocity : velocities) {
+        velocity = glm::vec3(unit(random), unit(random), unit(random)) * 0.5f;
+    }
+    constexpr int UPDATE_FRAMES = 20;
+    auto updateStart = Clock::now();
+    for (int frame = 0; frame < UPDATE_FRAMES; ++frame) {
+        for (std::size_t i = 0; i < movingCount; ++i) {
+            boxes[i].boundsMin += velocities[i];
+            boxes[i].boundsMax += velocities[i];
+            bvh.update(leaves[i], boxes[i]);
+        }
+    }
+    double updateSeconds = std::chrono::duration<double>(Clock::now() - updateStart).count() /
+                           (static_cast<double>(UPDATE_FRAMES) * movingCount);
+    float updatedSah = bvh.computeSahCost();
+
+    // 検索条件（視錐台はシーンの中央から外向きに、遠方面は固定）
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 60.0f);
+    glm::vec4 planes[6];
+    claude_gl::FrustumCuller::extractPlanes(projection * view, planes);
+
+    std::vector<glm::vec3> rayOrigins(QUERY_COUNT);
+    std::vector<glm::vec3> rayDirections(QUERY_COUNT);
+    std::vector<Aabb> queryBoxes(QUERY_COUNT);
+    for (int i = 0; i < QUERY_COUNT; ++i) {
+        rayOrigins[i] = glm::vec3(position(random), position(random), position(random));
+        rayDirections[i] = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)));
+        glm::vec3 center(position(random), position(random), position(random));
+        queryBoxes[i] = {center - glm::vec3(5.0f), center + glm::vec3(5.0f)};
+    }
+    const float rayLength = halfSize * 4.0f;
+
+    // 視錐台
+    std::vector<std::uint32_t> bvhVisible;
+    std::vector<std::uint32_t> linearVisible;
+    std::size_t nodesVisited = 0;
+    double frustumBvh = measureSeconds(REPEAT_COUNT, [&]() {
+        bvhVisible.clear();
+        nodesVisited = bvh.queryFrustum(planes, [&](std::uint32_t id) {
+            bvhVisible.push_back(id);
+        });
+    });
+    double frustumLinear = measureSeconds(REPEAT_COUNT, [&]() {
+        linearVisible.clear();
+        for (std::size_t i = 0; i < instanceCount; ++i) {
+            if (intersectsFrustum(boxes[i], planes)) {
+                linearVisible.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+    });
+    std::sort(bvhVisible.begin(), bvhVisible.end());
+    bool identical = bvhVisible == linearVisible;
+
+    // レイ（最も近い交差）
+    std::vector<float> bvhDistances(QUERY_COUNT);
+    std::vector<float> linearDistances(QUERY_COUNT);
+    double rayBvh = measureSeconds(REPEAT_COUNT, [&]() {
+        for (int q = 0; q < QUERY_COUNT; ++q) {
+            glm::vec3 inverseDirection = 1.0f / rayDirections[q];
+            bvhDistances[q] = bvh.raycast(rayOrigins[q], rayDirections[q], rayLength,
+                                          [&](std::uint32_t id, float maxDistance) {
+                return intersectRay(boxes[id], rayOrigins[q], inverseDirection, maxDistance);
+            });
+        }
+    }) / QUERY_COUNT;
+    double rayLinear = measureSeconds(REPEAT_COUNT, [&]() {
+        for (int q = 0; q < QUERY_COUNT; ++q) {
+            glm::vec3 inverseDirection = 1.0f / rayDirections[q];
+            float closest = rayLength;
+            for (std::size_t i = 0; i < instanceCount; ++i) {
+                closest = intersectRay(boxes[i], rayOrigins[q], inverseDirection, closest);
+            }
+            linearDistances[q] = closest;
+        }
+    }) / QUERY_COUNT;
+    identical = identical && bvhDistances == linearDistances;
+
+    // AABBの重なり
+    std::size_t bvhOverlaps = 0;
+    std::size_t linearOverlaps = 0;
+    double aabbBvh = measureSeconds(REPEAT_COUNT, [&]() {
+        bvhOverlaps = 0;
+        for (int q = 0; q < QUERY_COUNT; ++q) {
+            bvh.queryAabb(queryBoxes[q], [&](std::uint32_t) { ++bvhOverlaps; });
+        }
+    }) / QUERY_COUNT;
+    double aabbLinear = measureSeconds(REPEAT_COUNT, [&]() {
+        linearOverlaps = 0;
+        for (int q = 0; q < QUERY_COUNT; ++q) {
+            for (std::size_t i = 0; i < instanceCount; ++i) {
+                linearOverlaps += boxes[i].overlaps(queryBoxes[q]) ? 1 : 0;
+            }
+        }
+    }) / QUERY_COUNT;
+    identical = identical && bvhOverlaps == linearOverlaps;
+
+    const DynamicBvh::Stats& stats = bvh.getStats();
+    std::cout << "Instances: " << instanceCount << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  insert (all):  " << insertSeconds * 1000.0 << " ms, SAH cost "
+              << insertSah << std::endl;
+    std::cout << "  rebuild (SAH): " << rebuildSeconds * 1000.0 << " ms, SAH cost "
+              << rebuildSah << ", height " << rebuildHeight << std::endl;
+    std::cout << "  update:        " << std::setprecision(3) << updateSeconds * 1e9
+              << " ns/instance, SAH cost " << std::setprecision(2) << updatedSah << " ("
+              << stats.refits << " refits, " << stats.reinserts << " reinserts, "
+              << stats.rotations << " rotations)" << std::endl;
+    std::cout << "  " << std::left << std::setw(22) << "query" << std::right << std::setw(13)
+              << "BVH" << std::setw(15) << "linear" << std::setw(10) << "speedup" << std::endl;
+    printRow("frustum", frustumBvh, frustumLinear);
+    printRow("ray (closest hit)", rayBvh, rayLinear);
+    printRow("aabb overlap", aabbBvh, aabbLinear);
+    std::cout << "  frustum: " << bvhVisible.size() << " visible, " << nodesVisited
+              << " nodes visited" << std::endl;
+    std::cout << "  Results identical: " << (identical ? "yes" : "no") << std::endl;
+    return identical;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::size_t> instanceCounts;
+    for (int i = 1; i < argc; ++i) {
+        instanceCounts.push_back(std::strtoul(argv[i], nullptr, 10));
+    }
+    if (instanceCounts.empty()) {
+        instanceCounts = {1000, 10000, 100000};
+    }
+
+    bool identical = true;
+    for (std::size_t instanceCount : instanceCounts) {
+        identical = runBenchmark(instanceCount) && identical;
+    }
+    return identical ? 0 : 1;
+}
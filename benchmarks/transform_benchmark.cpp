@@ -0,0 +1,129 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "renderer/transform_system.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using claude_gl::TransformSystem;
+
+/**
+ * @brief 処理を繰り返し実行し、1回あたりの最短時間（秒）を返す
+ */
+template <typename F>
+double measureSeconds(int repeatCount, F&& function) {
+    double best = 1e30;
+    for (int i = 0; i < repeatCount; ++i) {
+        auto start = Clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        best = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+/**
+ * @brief 2つの3x3行列の成分の最大相対誤差を求める
+ */
+float maxRelativeError(const glm::mat3& a, const glm::mat3& b) {
+    float error = 0.0f;
+    for (int c = 0; c < 3; ++c) {
+        for (int r = 0; r < 3; ++r) {
+            float difference = std::fabs(a[c][r] - b[c][r]) / (1.0f + std::fabs(b[c][r]));
+            error = difference > error ? difference : error;
+        }
+    }
+    return error;
+}
+
+/**
+ * @brief 計測結果を1行出力する
+ */
+void printRow(const char* label, double seconds, std::size_t count, double baselineSeconds) {
+    std::cout << "  " << std::left << std::setw(34) << label << std::right << std::fixed
+              << std::setprecision(3) << std::setw(9) << seconds * 1000.0 << " ms"
+              << std::setw(9) << seconds * 1e9 / static_cast<double>(count) << " ns/object"
+              << std::setw(8) << std::setprecision(1) << baselineSeconds / seconds << "x"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t objectCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    constexpr int REPEAT_COUNT = 20;
+
+    // 回転・非均一スケール・平行移動を組み合わせたローカル行列
+    std::mt19937 random(12345);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.2f, 3.0f);
+    std::vector<glm::mat4> locals(objectCount);
+    for (glm::mat4& local : locals) {
+        glm::vec3 axis = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) +
+                                        glm::vec3(0.0f, 0.0f, 2.0f));
+        local = glm::translate(glm::mat4(1.0f),
+                               glm::vec3(unit(random), unit(random), unit(random)) * 100.0f);
+        local = glm::rotate(local, unit(random) * 3.14159f, axis);
+        local = glm::scale(local, glm::vec3(scale(random), scale(random), scale(random)));
+    }
+    glm::mat4 parent = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 2.0f, 3.0f)),
+                                   0.3f, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // ワールド行列
+    std::vector<glm::mat4> worlds(objectCount);
+    double worldLoop = measureSeconds(REPEAT_COUNT, [&]() {
+        for (std::size_t i = 0; i < objectCount; ++i) {
+            worlds[i] = parent * locals[i];
+        }
+    });
+    std::vector<glm::mat4> expectedWorlds = worlds;
+    double worldBatch = measureSeconds(REPEAT_COUNT, [&]() {
+        TransformSystem::computeWorldMatrices(parent, locals.data(), worlds.data(), objectCount);
+    });
+    bool identical = worlds == expectedWorlds;
+
+    // 法線行列（basic.vs が頂点ごとに行っていた4x4逆行列の転置と比較する）
+    std::vector<glm::mat3> inverseNormals(objectCount);
+    std::vector<glm::mat3> scalarNormals(objectCount);
+    std::vector<glm::mat3> batchNormals(objectCount);
+    double normalInverse = measureSeconds(REPEAT_COUNT, [&]() {
+        for (std::size_t i = 0; i < objectCount; ++i) {
+            inverseNormals[i] = glm::mat3(glm::transpose(glm::inverse(worlds[i])));
+        }
+    });
+    double normalScalar = measureSeconds(REPEAT_COUNT, [&]() {
+        for (std::size_t i = 0; i < objectCount; ++i) {
+            scalarNormals[i] = TransformSystem::computeNormalMatrix(worlds[i]);
+        }
+    });
+    double normalBatch = measureSeconds(REPEAT_COUNT, [&]() {
+        TransformSystem::computeNormalMatrices(worlds.data(), batchNormals.data(), objectCount);
+    });
+
+    float maxError = 0.0f;
+    for (std::size_t i = 0; i < objectCount; ++i) {
+        float error = maxRelativeError(batchNormals[i], inverseNormals[i]);
+        maxError = error > maxError ? error : maxError;
+        identical = identical && batchNormals[i] == scalarNormals[i];
+    }
+    bool accurate = maxError < 1e-4f;
+
+    std::cout << "Objects: " << objectCount << " (" << TransformSystem::getInstructionSet() << ")"
+              << std::endl;
+    printRow("world: parent * local (glm)", worldLoop, objectCount, worldLoop);
+    printRow("world: computeWorldMatrices", worldBatch, objectCount, worldLoop);
+    printRow("normal: transpose(inverse(mat4))", normalInverse, objectCount, normalInverse);
+    printRow("normal: computeNormalMatrix", normalScalar, objectCount, normalInverse);
+    printRow("normal: computeNormalMatrices", normalBatch, objectCount, normalInverse);
+    std::cout << "  Max relative error vs inverse: " << std::scientific << std::setprecision(2)
+              << maxError << std::endl;
+    std::cout << "  Results identical to scalar: " << (identical ? "yes" : "no") << std::endl;
+    return identical && accurate ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "renderer/transform_hierarchy.h"
+#include "renderer/transform_system.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using claude_gl::TransformHierarchy;
+using claude_gl::TransformSystem;
+
+/**
+ * @brief 処理を繰り返し実行し、1回あたりの最短時間（秒）を返す
+ */
+template <typename F>
+double measureSeconds(int repeatCount, F&& function) {
+    double best = 1e30;
+    for (int i = 0; i < repeatCount; ++i) {
+        auto start = Clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        best = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+/**
+ * @brief 2つの4x4行列の成分の最大相対誤差を求める
+ */
+float maxRelativeError(const glm::mat4& a, const glm::mat4& b) {
+    float error = 0.0f;
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            float difference = std::fabs(a[c][r] - b[c][r]) / (1.0f + std::fabs(b[c][r]));
+            error = difference > error ? difference : error;
+        }
+    }
+    return error;
+}
+
+/**
+ * @brief 計測結果を1行出力する
+ */
+void printRow(const char* label, double seconds, std::size_t updatedNodes,
+              double baselineSeconds) {
+    std::cout << "  " << std::left << std::setw(34) << label << std::right << std::fixed
+              << std::setprecision(3) << std::setw(9) << seconds * 1000.0 << " ms"
+              << std::setw(9) << updatedNodes << " nodes" << std::setw(8)
+              << std::setprecision(1) << baselineSeconds / seconds << "x" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t nodeCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const std::size_t rootCount = nodeCount / 1000 + 1;
+    constexpr int REPEAT_COUNT = 20;
+
+    // 各ノードの親はそれ以前のノードから無作為に選ぶ（深さは平均で log(n) 程度）
+    std::mt19937 random(12345);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.8f, 1.25f);
+    auto randomRotation = [&]() {
+        glm::vec3 axis = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) +
+                                        glm::vec3(0.0f, 0.0f, 2.0f));
+        return glm::angleAxis(unit(random) * 3.14159f, axis);
+    };
+
+    TransformHierarchy hierarchy;
+    std::vector<TransformHierarchy::NodeId> nodes(nodeCount);
+    std::vector<std::size_t> parents(nodeCount);
+    std::vector<glm::vec3> translations(nodeCount);
+    std::vector<glm::quat> rotations(nodeCount);
+    std::vector<glm::vec3> scales(nodeCount);
+    for (std::size_t i = 0; i < nodeCount; ++i) {
+        parents[i] = i < rootCount ? nodeCount : std::uniform_int_distribution<std::size_t>(
+                                                     0, i - 1)(random);
+        nodes[i] = hierarchy.createNode(parents[i] == nodeCount ? TransformHierarchy::INVALID_NODE
+                                                                : nodes[parents[i]]);
+        translations[i] = glm::vec3(unit(random), unit(random), unit(random)) * 10.0f;
+        rotations[i] = randomRotation();
+        scales[i] = glm::vec3(scale(random), scale(random), scale(random));
+        hierarchy.setLocalTransform(nodes[i], translations[i], rotations[i], scales[i]);
+    }
+    auto start = Clock::now();
+    hierarchy.update();
+    double initialUpdate = std::chrono::duration<double>(Clock::now() - start).count();
+    bool reordered = hierarchy.getStats().reordered;
+
+    // 参照: glm でローカル行列を合成し、親から順にワールド行列を求める
+    std::vector<glm::mat4> expected(nodeCount);
+    auto computeReference = [&]() {
+        for (std::size_t i = 0; i < nodeCount; ++i) {
+            glm::mat4 local = glm::translate(glm::mat4(1.0f), translations[i]);
+            local = local * glm::mat4_cast(rotations[i]);
+            local = glm::scale(local, scales[i]);
+            expected[i] = parents[i] == nodeCount ? local : expected[parents[i]] * local;
+        }
+    };
+    auto verify = [&](float& maxError) {
+        computeReference();
+        for (std::size_t i = 0; i < nodeCount; ++i) {
+            float error = maxRelativeError(hierarchy.getWorldMatrix(nodes[i]), expected[i]);
+            maxError = error > maxError ? error : maxError;
+        }
+    };
+    double reference = measureSeconds(REPEAT_COUNT, computeReference);
+
+    // 全ノードのローカルの変換を変更（ローカル行列の合成とワールド行列の積をすべて行う）
+    for (glm::quat& rotation : rotations) {
+        rotation = randomRotation();
+    }
+    double setAll = measureSeconds(REPEAT_COUNT, [&]() {
+        for (std::size_t i = 0; i < nodeCount; ++i) {
+            hierarchy.setRotation(nodes[i], rotations[i]);
+        }
+    });
+    hierarchy.update();
+    double fullUpdate = measureSeconds(REPEAT_COUNT, [&]() {
+        for (std::size_t i = 0; i < nodeCount; ++i) {
+            hierarchy.setRotation(nodes[i], rotations[i]);
+        }
+        hierarchy.update();
+    }) - setAll;
+    std::size_t fullNodes = hierarchy.getStats().updatedNodes;
+
+    // ルートだけ変更（合成はルートの分だけで、ワールド行列はすべて更新する）
+    double rootUpdate = measureSeconds(REPEAT_COUNT, [&]() {
+        for (std::size_t i = 0; i < rootCount; ++i) {
+            hierarchy.setTranslation(nodes[i], hierarchy.getTranslation(nodes[i]));
+        }
+        hierarchy.update();
+    });
+    std::size_t rootNodes = hierarchy.getStats().updatedNodes;
+
+    // 一部のノードだけ変更（変更された部分木以外には触れない）
+    std::vector<std::size_t> partial;
+    for (std::size_t i = 0; i < nodeCount; i += 97) {
+        partial.push_back(nodeCount - 1 - i);
+    }
+    double partialUpdate = measureSeconds(REPEAT_COUNT, [&]() {
+        for (std::size_t i : partial) {
+            hierarchy.setRotation(nodes[i], rotations[i]);
+        }
+        hierarchy.update();
+    });
+    std::size_t partialNodes = hierarchy.getStats().updatedNodes;
+
+    float maxError = 0.0f;
+    verify(maxError);
+
+    // 親の変更（並びの作り直しを含む）
+    std::size_t reparentCount = 0;
+    double reparent = measureSeconds(5, [&]() {
+        for (std::size_t i = nodeCount - 1; i >= rootCount && i + 100 > nodeCount; --i) {
+            // 子より前のノードを親にすれば循環しない
+            std::size_t parent = std::uniform_int_distribution<std::size_t>(0, i - 1)(random);
+            hierarchy.setParent(nodes[i], nodes[parent]);
+            parents[i] = parent;
+        }
+        hierarchy.update();
+        reparentCount = hierarchy.getStats().updatedNodes;
+    });
+    reordered = reordered && hierarchy.getStats().reordered;
+    verify(maxError);
+    bool accurate = maxError < 1e-4f;
+
+    std::cout << "Nodes: " << nodeCount << ", roots: " << rootCount << " ("
+              << TransformSystem::getInstructionSet() << ")" << std::endl;
+    std::cout << "  Initial update (with reorder): " << std::fixed << std::setprecision(3)
+              << initialUpdate * 1000.0 << " ms" << std::endl;
+    printRow("reference: glm compose + multiply", reference, nodeCount, reference);
+    printRow("update: all locals changed", fullUpdate, fullNodes, reference);
+    printRow("update: roots changed", rootUpdate, rootNodes, reference);
+    printRow("update: 1% of nodes changed", partialUpdate, partialNodes, reference);
+    printRow("update: 100 nodes reparented", reparent, reparentCount, reference);
+    std::cout << "  Max relative error vs glm: " << std::scientific << std::setprecision(2)
+              << maxError << std::endl;
+    return accurate && reordered ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include "renderer/triangle_bvh.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using claude_gl::TriangleBvh;
+
+/**
+ * @brief 経過時間（秒）を求める
+ */
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * @brief 全三角形を順に調べて最も近い交差距離を求める（比較用）
+ */
+float intersectLinear(const std::vector<glm::vec3>& positions,
+                      const std::vector<unsigned int>& indices, const glm::vec3& origin,
+                      const glm::vec3& direction, float maxDistance) {
+    for (std::size_t i = 0; i < indices.size(); i += 3) {
+        const glm::vec3& v0 = positions[indices[i]];
+        glm::vec3 e1 = positions[indices[i + 1]] - v0;
+        glm::vec3 e2 = positions[indices[i + 2]] - v0;
+        glm::vec3 p = glm::cross(direction, e2);
+        float det = glm::dot(e1, p);
+        if (det == 0.0f) {
+            continue;
+        }
+        float inverseDet = 1.0f / det;
+        glm::vec3 s = origin - v0;
+        float u = glm::dot(s, p) * inverseDet;
+        glm::vec3 q = glm::cross(s, e1);
+        float v = glm::dot(direction, q) * inverseDet;
+        float t = glm::dot(e2, q) * inverseDet;
+        if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f && t < maxDistance) {
+            maxDistance = t;
+        }
+    }
+    return maxDistance;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // 起伏のある格子（gridSize × gridSize 個の四角形 = 2 × gridSize² 三角形）
+    const std::size_t gridSize = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    constexpr int RAY_COUNT = 100000;
+    constexpr int LINEAR_RAY_COUNT = 32;
+    constexpr float RAY_LENGTH = 1000.0f;
+
+    std::vector<glm::vec3> positions;
+    positions.reserve((gridSize + 1) * (gridSize + 1));
+    for (std::size_t z = 0; z <= gridSize; ++z) {
+        for (std::size_t x = 0; x <= gridSize; ++x) {
+            float fx = static_cast<float>(x);
+            float fz = static_cast<float>(z);
+            float height = 8.0f * std::sin(fx * 0.05f) * std::cos(fz * 0.07f) +
+                           2.0f * std::sin(fx * 0.31f + fz * 0.17f);
+            positions.emplace_back(fx, height, fz);
+        }
+    }
+    std::vector<unsigned int> indices;
+    indices.reserve(gridSize * gridSize * 6);
+    const unsigned int rowLength = static_cast<unsigned int>(gridSize + 1);
+    for (unsigned int z = 0; z < gridSize; ++z) {
+        for (unsigned int x = 0; x < gridSize; ++x) {
+            unsigned int corner = z * rowLength + x;
+            indices.insert(indices.end(), {corner, corner + rowLength, corner + 1,
+                                           corner + 1, corner + rowLength,
+                                           corner + rowLength + 1});
+        }
+    }
+
+    TriangleBvh bvh;
+    auto buildStart = Clock::now();
+    bvh.build(positions.data(), sizeof(glm::vec3), positions.size(), indices.data(),
+              indices.size());
+    double buildSeconds = secondsSince(buildStart);
+
+    // 上空から斜め下向きのレイ（ピッキング相当）
+    std::mt19937 random(12345);
+    std::uniform_real_distribution<float> across(0.0f, static_cast<float>(gridSize));
+    std::uniform_real_distribution<float> tilt(-0.5f, 0.5f);
+    std::vector<glm::vec3> origins(RAY_COUNT);
+    std::vector<glm::vec3> directions(RAY_COUNT);
+    for (int i = 0; i < RAY_COUNT; ++i) {
+        origins[i] = glm::vec3(across(random), 50.0f, across(random));
+        directions[i] = glm::normalize(glm::vec3(tilt(random), -1.0f, tilt(random)));
+    }
+
+    // 最も近い交差
+    std::vector<float> distances(RAY_COUNT, RAY_LENGTH);
+    std::vector<glm::vec3> hitPoints(RAY_COUNT);
+    int hitCount = 0;
+    auto closestStart = Clock::now();
+    for (int i = 0; i < RAY_COUNT; ++i) {
+        TriangleBvh::Hit hit;
+        if (bvh.intersect(origins[i], directions[i], RAY_LENGTH, hit)) {
+            distances[i] = hit.distance;
+            ++hitCount;
+        }
+    }
+    double closestSeconds = secondsSince(closestStart);
+    for (int i = 0; i < RAY_COUNT; ++i) {
+        hitPoints[i] = origins[i] + directions[i] * distances[i];
+    }
+
+    // 任意の交差（交差点から光源方向への遮蔽判定、自己交差を避けるため少し浮かせる）
+    const glm::vec3 lightDirection = glm::normalize(glm::vec3(1.0f, 0.3f, 0.2f));
+    int occludedCount = 0;
+    auto anyStart = Clock::now();
+    for (int i = 0; i < RAY_COUNT; ++i) {
+        glm::vec3 shadowOrigin = hitPoints[i] + glm::vec3(0.0f, 0.01f, 0.0f);
+        occludedCount += bvh.occluded(shadowOrigin, lightDirection, RAY_LENGTH) ? 1 : 0;
+    }
+    double anySeconds = secondsSince(anyStart);
+
+    // 全探索との比較（一部のレイのみ）
+    int mismatches = 0;
+    auto linearStart = Clock::now();
+    for (int i = 0; i < LINEAR_RAY_COUNT; ++i) {
+        float expected = intersectLinear(positions, indices, origins[i], directions[i],
+                                         RAY_LENGTH);
+        if (std::fabs(expected - distances[i]) > 1e-4f * (1.0f + expected)) {
+            ++mismatches;
+        }
+    }
+    double linearSeconds = secondsSince(linearStart) / LINEAR_RAY_COUNT;
+
+    double closestMicroseconds = closestSeconds * 1e6 / RAY_COUNT;
+    std::cout << "Triangles: " << bvh.getTriangleCount() << ", nodes: " << bvh.getNodeCount()
+              << ", memory: " << bvh.getMemoryBytes() / (1024.0 * 1024.0) << " MB ("
+              << TriangleBvh::getInstructionSet() << ")" << std::endl;
+    std::cout << "Build (binned SAH): " << buildSeconds * 1000.0 << " ms" << std::endl;
+    std::cout << "Closest hit: " << closestMicroseconds << " us/ray (" << hitCount << "/"
+              << RAY_COUNT << " hit)" << std::endl;
+    std::cout << "Any hit:     " << anySeconds * 1e6 / RAY_COUNT << " us/ray (" << occludedCount
+              << "/" << RAY_COUNT << " occluded)" << std::endl;
+    std::cout << "Linear scan: " << linearSeconds * 1e6 << " us/ray ("
+              << linearSeconds * 1e6 / closestMicroseconds << "x slower)" << std::endl;
+    std::cout << "Results identical: " << (mismatches == 0 ? "yes" : "no") << " ("
+              << LINEAR_RAY_COUNT << " rays checked)" << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
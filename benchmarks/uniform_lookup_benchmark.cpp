@@ -0,0 +1,194 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "renderer/uniform_table.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using claude_gl::UniformName;
+using claude_gl::UniformTable;
+
+/**
+ * @brief 処理を繰り返し実行し、1回あたりの最短時間（秒）を返す
+ */
+template <typename F>
+double measureSeconds(int repeatCount, F&& function) {
+    double best = 1e30;
+    for (int i = 0; i < repeatCount; ++i) {
+        auto start = Clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        best = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+// basic.vs / basic.fs の uniform（位置は適当に割り当てる）
+const char* const UNIFORM_NAMES[] = {
+    "model", "view", "projection", "normalMatrix",
+    "positionBias", "positionScale", "normalEncoding",
+    "lightPos", "lightColor", "viewPos",
+    "objectColor", "ambientStrength", "specularStrength", "shininess", "opacity",
+};
+constexpr std::size_t UNIFORM_COUNT = sizeof(UNIFORM_NAMES) / sizeof(UNIFORM_NAMES[0]);
+
+constexpr UniformName MODEL("model");
+constexpr UniformName NORMAL_MATRIX("normalMatrix");
+constexpr UniformName POSITION_BIAS("positionBias");
+constexpr UniformName POSITION_SCALE("positionScale");
+constexpr UniformName NORMAL_ENCODING("normalEncoding");
+constexpr UniformName OBJECT_COLOR("objectColor");
+constexpr UniformName AMBIENT_STRENGTH("ambientStrength");
+constexpr UniformName SPECULAR_STRENGTH("specularStrength");
+constexpr UniformName SHININESS("shininess");
+constexpr UniformName OPACITY("opacity");
+
+/**
+ * @brief glUniform の代わりに値を書き込む領域（ドライバーの処理は含めない）
+ */
+struct UniformStorage {
+    std::vector<float> values = std::vector<float>(UNIFORM_COUNT * 16, 0.0f);
+
+    void upload(int location, const float* value, std::size_t count) {
+        if (location >= 0) {
+            std::memcpy(&values[static_cast<std::size_t>(location) * 16], value,
+                        count * sizeof(float));
+        }
+    }
+
+    double getChecksum() const {
+        double sum = 0.0;
+        for (float value : values) {
+            sum += value;
+        }
+        return sum;
+    }
+};
+
+/**
+ * @brief 従来の Shader::getUniformLocation（名前の文字列をキーにしたキャッシュ）
+ */
+int findByString(std::unordered_map<std::string, int>& cache, const std::string& name) {
+    auto it = cache.find(name);
+    if (it != cache.end()) {
+        return it->second;
+    }
+    int location = -1;
+    for (std::size_t i = 0; i < UNIFORM_COUNT; ++i) {
+        if (name == UNIFORM_NAMES[i]) {
+            location = static_cast<int>(i);
+        }
+    }
+    cache[name] = location;
+    return location;
+}
+
+/**
+ * @brief 1フレーム分の描画の uniform の設定
+ *
+ * 描画ごとに変換行列（2個）とメッシュの復元パラメータ（3個）、4描画ごとにマテリアル（5個）を
+ * 設定します。Locate は名前から位置を求める関数で、比較する方式ごとに差し替えます。
+ */
+template <typename Locate>
+void uploadFrame(std::size_t drawCount, UniformStorage& storage, const float* matrix,
+                 Locate&& locate) {
+    for (std::size_t i = 0; i < drawCount; ++i) {
+        storage.upload(locate(0), matrix, 16);
+        storage.upload(locate(1), matrix, 9);
+        storage.upload(locate(2), matrix, 3);
+        storage.upload(locate(3), matrix, 3);
+        storage.upload(locate(4), matrix, 1);
+        if (i % 4 == 0) {
+            for (int material = 5; material < 10; ++material) {
+                storage.upload(locate(material), matrix, material == 5 ? 3 : 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 計測結果を1行出力する
+ */
+void printRow(const char* label, double seconds, std::size_t count, double baselineSeconds) {
+    std::cout << "  " << std::left << std::setw(34) << label << std::right << std::fixed
+              << std::setprecision(3) << std::setw(9) << seconds * 1000.0 << " ms"
+              << std::setw(9) << seconds * 1e9 / static_cast<double>(count) << " ns/uniform"
+              << std::setw(8) << std::setprecision(1) << baselineSeconds / seconds << "x"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t drawCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    constexpr int REPEAT_COUNT = 20;
+    const std::size_t uniformCount = drawCount * 5 + (drawCount + 3) / 4 * 5;
+
+    UniformTable table;
+    for (std::size_t i = 0; i < UNIFORM_COUNT; ++i) {
+        if (!table.add(UNIFORM_NAMES[i], static_cast<std::int32_t>(i), 0, 1)) {
+            std::cerr << "Hash collision: " << UNIFORM_NAMES[i] << std::endl;
+            return 1;
+        }
+    }
+
+    float matrix[16];
+    for (int i = 0; i < 16; ++i) {
+        matrix[i] = static_cast<float>(i + 1);
+    }
+
+    // 従来: 呼び出しごとに std::string を構築し、文字列のハッシュで探す
+    const char* const literals[] = {
+        "model", "normalMatrix", "positionBias", "positionScale", "normalEncoding",
+        "objectColor", "ambientStrength", "specularStrength", "shininess", "opacity",
+    };
+    std::unordered_map<std::string, int> cache;
+    UniformStorage stringStorage;
+    double stringLookup = measureSeconds(REPEAT_COUNT, [&]() {
+        uploadFrame(drawCount, stringStorage, matrix,
+                    [&](int index) { return findByString(cache, literals[index]); });
+    });
+
+    // UniformName: コンパイル時のハッシュ値で UniformTable を二分探索する
+    const UniformName names[] = {
+        MODEL, NORMAL_MATRIX, POSITION_BIAS, POSITION_SCALE, NORMAL_ENCODING,
+        OBJECT_COLOR, AMBIENT_STRENGTH, SPECULAR_STRENGTH, SHININESS, OPACITY,
+    };
+    UniformStorage tableStorage;
+    double tableLookup = measureSeconds(REPEAT_COUNT, [&]() {
+        uploadFrame(drawCount, tableStorage, matrix, [&](int index) {
+            const UniformTable::Entry* entry = table.find(names[index].getHash());
+            return entry ? entry->location : -1;
+        });
+    });
+
+    // ハンドル: 位置をシェーダーの切り替え時に取得しておく
+    int handles[10];
+    for (int i = 0; i < 10; ++i) {
+        const UniformTable::Entry* entry = table.find(names[i].getHash());
+        handles[i] = entry ? entry->location : -1;
+    }
+    UniformStorage handleStorage;
+    double handleLookup = measureSeconds(REPEAT_COUNT, [&]() {
+        uploadFrame(drawCount, handleStorage, matrix, [&](int index) { return handles[index]; });
+    });
+
+    bool identical = stringStorage.getChecksum() == tableStorage.getChecksum() &&
+                     tableStorage.getChecksum() == handleStorage.getChecksum() &&
+                     handleStorage.getChecksum() != 0.0;
+
+    std::cout << "Draws: " << drawCount << ", uniforms set per frame: " << uniformCount
+              << std::endl;
+    printRow("std::string + unordered_map", stringLookup, uniformCount, stringLookup);
+    printRow("UniformName + UniformTable", tableLookup, uniformCount, stringLookup);
+    printRow("Uniform<T> handle", handleLookup, uniformCount, stringLookup);
+    std::cout << "  Uploaded values identical: " << (identical ? "yes" : "no") << std::endl;
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "model.h"
+
+namespace claude_gl {
+
+class ThreadPool;
+
+/**
+ * @brief モデルをワーカースレッドで準備し、GPUへの転送を1フレームの予算内で行うクラス
+ *
+ * loadModel() はファイルの読み込み・解析・最適化などGLを使わない準備（Model::prepare()）を
+ * ワーカースレッドへ投入し、すぐに ModelHandle を返します。準備が終わったモデルは、
+ * GLのコンテキストを持つスレッドが毎フレーム呼ぶ update() で、転送するバイト数と時間の
+ * 予算の範囲でメッシュごとに転送します。全メッシュを転送したモデルだけがハンドルから
+ * 取得できるため、描画中のシーンに転送途中のモデルが入ることはありません。
+ *
+ * - 予算: 1フレームで少なくとも1つのメッシュを転送し（止まらないように）、それ以降は
+ *   バイト数か時間が予算を超える前に止めます。1つのメッシュは分けて転送しないため、
+ *   予算より大きいメッシュはそのフレームだけ予算を超えます（FrameStats::overBudget）。
+ * - 時間はCPUで計った転送の呼び出しの時間で、GPUでの転送の完了は待ちません。
+ *
+ * 同じファイルを同時に複数回読み込むとメッシュキャッシュの書き出しが競合するため、
+ * ハンドルを共有してください。
+ */
+class AssetLoader {
+public:
+    /**
+     * @brief 読み込みの状態
+     */
+    enum class State {
+        Queued,     ///< ワーカーの空きを待っている
+        Preparing,  ///< ワーカーで準備している
+        Uploading,  ///< GPUへの転送を待っている・転送している
+        Ready,      ///< 全メッシュを転送した
+        Failed      ///< 準備に失敗した
+    };
+
+    /**
+     * @brief 1つのアセットの読み込みの進み具合と所要時間
+     */
+    struct AssetStats {
+        std::size_t meshCount = 0;            ///< メッシュ数（準備が終わるまでは0）
+        std::size_t uploadedMeshes = 0;       ///< 転送したメッシュ数
+        std::size_t uploadBytes = 0;          ///< 転送する頂点とインデックスのバイト数
+        std::size_t uploadedBytes = 0;        ///< 転送したバイト数
+        std::size_t uploadFrames = 0;         ///< 転送に掛かったフレーム数（update() の回数）
+        double queueMilliseconds = 0.0;       ///< 要求からワーカーが準備を始めるまで
+        double prepareMilliseconds = 0.0;     ///< ワーカーでの準備（読み込み・解析・最適化）
+        double uploadWaitMilliseconds = 0.0;  ///< 準備の完了から最初の転送まで
+        double uploadMilliseconds = 0.0;      ///< 転送の呼び出しの合計
+        double latencyMilliseconds = 0.0;     ///< 要求から完了（または失敗）まで
+        bool prepared = false;                ///< 準備が終わったか
+        bool finished = false;                ///< 完了（または失敗）したか
+
+        /**
+         * @brief 進み具合を取得する（準備を前半、転送したバイト数を後半とする）
+         * @return 0〜1（準備中は0、完了は1）
+         */
+        float getProgress() const;
+    };
+
+    /**
+     * @brief update() 1回の転送の統計情報
+     */
+    struct FrameStats {
+        std::size_t uploadedMeshes = 0;  ///< 転送したメッシュ数
+        std::size_t uploadedBytes = 0;   ///< 転送したバイト数
+        double milliseconds = 0.0;       ///< 転送の呼び出しに掛かった時間
+        std::size_t pendingAssets = 0;   ///< 準備中・転送待ちのアセット数（update() の後）
+        bool overBudget = false;         ///< 予算を超えたか（予算より大きいメッシュを転送した）
+    };
+
+    /**
+     * @brief 1フレームの転送の予算
+     */
+    struct Budget {
+        std::size_t maxBytes = 4 * 1024 * 1024;  ///< 転送するバイト数の上限
+        double maxMilliseconds = 2.0;            ///< 転送の呼び出しに掛ける時間の上限
+    };
+
+private:
+    struct Request;
+
+public:
+    /**
+     * @brief 読み込みの結果を受け取るハンドル（std::shared_future と同じく値として共有できる）
+     */
+    class ModelHandle {
+    public:
+        /**
+         * @brief 何も読み込まない無効なハンドルを作成する
+         */
+        ModelHandle() = default;
+
+        /**
+         * @brief loadModel() が返したハンドルか判定する
+         * @return 有効な場合はtrue
+         */
+        bool isValid() const;
+
+        /**
+         * @brief 読み込みの状態を取得する
+         * @return 状態（無効なハンドルは Failed）
+         */
+        State getState() const;
+
+        /**
+         * @brief 全メッシュを転送したか判定する
+         * @return 取得できる場合はtrue
+         */
+        bool isReady() const;
+
+        /**
+         * @brief 読み込みが終わったか（完了か失敗）判定する
+         * @return 終わった場合はtrue
+         */
+        bool isDone() const;
+
+        /**
+         * @brief 読み込んだモデルを取得する（待たない）
+         * @return モデル（完了していない場合はnullptr）
+         */
+        std::shared_ptr<Model> get() const;
+
+        /**
+         * @brief 失敗した理由を取得する
+         * @return 例外のメッセージ（失敗していない場合は空）
+         */
+        std::string getError() const;
+
+        /**
+         * @brief ファイルのパスを取得する
+         * @return loadModel() に渡したパス
+         */
+        const std::string& getPath() const;
+
+        /**
+         * @brief 進み具合と所要時間を取得する
+         * @return 現時点の統計情報
+         */
+        AssetStats getStats() const;
+
+    private:
+        friend class AssetLoader;
+
+        std::shared_ptr<Request> request;  ///< 読み込みの共有の状態
+
+        explicit ModelHandle(std::shared_ptr<Request> request);
+    };
+
+    /**
+     * @brief コンストラクタ
+     * @param threadCount 準備を行うワーカースレッド数（0の場合はハードウェアスレッド数）
+     */
+    explicit AssetLoader(unsigned int threadCount = 0);
+
+    /**
+     * @brief デストラクタ
+     *
+     * 投入済みの準備が全て終わるまで待ち、転送を終えていないアセットは失敗にします。
+     * 転送済みのメッシュを解放するため、GLのコンテキストがある間に破棄すること。
+     */
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    /**
+     * @brief モデルの読み込みを開始する
+     * @param filepath OBJファイルのパス
+     * @param options 読み込みの設定
+     * @return 結果を受け取るハンドル
+     */
+    ModelHandle loadModel(const std::string& filepath,
+                          const ModelLoadOptions& options = ModelLoadOptions());
+
+    /**
+     * @brief 準備が終わったモデルのメッシュを予算の範囲でGPUへ転送する
+     *
+     * GLのコンテキストを持つスレッドで毎フレーム呼ぶ。
+     *
+     * @return このフレームで完了（または失敗）したアセット数
+     */
+    std::size_t update();
+
+    /**
+     * @brief 1フレームの転送の予算を設定する
+     * @param budget 予算
+     */
+    void setBudget(const Budget& budget);
+
+    /**
+     * @brief 1フレームの転送の予算を取得する
+     * @return 予算
+     */
+    const Budget& getBudget() const;
+
+    /**
+     * @brief 準備中・転送待ちのアセットがないか判定する
+     * @return ない場合はtrue
+     */
+    bool isIdle() const;
+
+    /**
+     * @brief 直近の update() の統計情報を取得する
+     * @return 統計情報
+     */
+    const FrameStats& getFrameStats() const;
+
+private:
+    std::unique_ptr<ThreadPool> pool;                ///< 準備を行うワーカースレッド
+    mutable std::mutex mutex;                        ///< prepared と inFlight の排他制御
+    std::vector<std::shared_ptr<Request>> prepared;  ///< 準備が終わり update() を待つ要求
+    std::size_t inFlight = 0;                        ///< 準備が終わっていない要求の数
+    std::deque<std::shared_ptr<Request>> uploading;  ///< 転送中の要求（要求順）
+    Budget budget;                                   ///< 1フレームの転送の予算
+    FrameStats frameStats;                           ///< 直近の update() の統計情報
+    std::size_t frameIndex = 0;                      ///< update() の回数
+};
+
+} // namespace claude_gl
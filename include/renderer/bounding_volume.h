@@ -0,0 +1,112 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace claude_gl {
+
+/**
+ * @brief 軸平行バウンディングボックス
+ */
+struct Aabb {
+    glm::vec3 boundsMin = glm::vec3(0.0f);  ///< 最小点
+    glm::vec3 boundsMax = glm::vec3(0.0f);  ///< 最大点
+
+    /**
+     * @brief 2つのボックスを包むボックスを求める
+     */
+    static Aabb merge(const Aabb& a, const Aabb& b) {
+        return {glm::min(a.boundsMin, b.boundsMin), glm::max(a.boundsMax, b.boundsMax)};
+    }
+
+    /**
+     * @brief ローカル空間のボックスを変換し、それを包むワールド軸平行のボックスを求める
+     * @param local ローカル空間のボックス
+     * @param world ワールド変換行列
+     * @return ワールド空間のボックス
+     */
+    static Aabb transform(const Aabb& local, const glm::mat4& world) {
+        glm::vec3 center = glm::vec3(world * glm::vec4(local.getCenter(), 1.0f));
+        glm::vec3 extents = local.getExtents();
+        glm::vec3 worldExtents = glm::abs(glm::vec3(world[0])) * extents.x +
+                                 glm::abs(glm::vec3(world[1])) * extents.y +
+                                 glm::abs(glm::vec3(world[2])) * extents.z;
+        return {center - worldExtents, center + worldExtents};
+    }
+
+    /**
+     * @brief 中心を取得する
+     */
+    glm::vec3 getCenter() const {
+        return (boundsMin + boundsMax) * 0.5f;
+    }
+
+    /**
+     * @brief 各軸の半分の大きさを取得する
+     */
+    glm::vec3 getExtents() const {
+        return (boundsMax - boundsMin) * 0.5f;
+    }
+
+    /**
+     * @brief 表面積の半分を取得する（SAHのコスト計算用）
+     */
+    float getHalfArea() const {
+        glm::vec3 size = boundsMax - boundsMin;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    /**
+     * @brief 他のボックスと重なるか判定する（接している場合も含む）
+     */
+    bool overlaps(const Aabb& other) const {
+        return boundsMin.x <= other.boundsMax.x && boundsMax.x >= other.boundsMin.x &&
+               boundsMin.y <= other.boundsMax.y && boundsMax.y >= other.boundsMin.y &&
+               boundsMin.z <= other.boundsMax.z && boundsMax.z >= other.boundsMin.z;
+    }
+
+    /**
+     * @brief 他のボックスを完全に含むか判定する
+     */
+    bool contains(const Aabb& other) const {
+        return boundsMin.x <= other.boundsMin.x && boundsMax.x >= other.boundsMax.x &&
+               boundsMin.y <= other.boundsMin.y && boundsMax.y >= other.boundsMax.y &&
+               boundsMin.z <= other.boundsMin.z && boundsMax.z >= other.boundsMax.z;
+    }
+};
+
+/**
+ * @brief メッシュのバウンディングボックスとバウンディング球
+ *
+ * 球の中心はボックスの中心と共通で、半径は中心から最も遠い頂点までの距離です。
+ * 中心を共有するため、カリングでは1つの中心に対して球とボックスの両方を判定できます。
+ */
+struct BoundingVolume {
+    glm::vec3 boundsMin = glm::vec3(0.0f);  ///< バウンディングボックスの最小点
+    glm::vec3 boundsMax = glm::vec3(0.0f);  ///< バウンディングボックスの最大点
+    float radius = 0.0f;                    ///< バウンディング球の半径
+
+    /**
+     * @brief ボックスと球の中心を取得する
+     * @return 中心
+     */
+    glm::vec3 getCenter() const {
+        return (boundsMin + boundsMax) * 0.5f;
+    }
+
+    /**
+     * @brief ボックスの半分の大きさを取得する
+     * @return 各軸の半分の大きさ
+     */
+    glm::vec3 getExtents() const {
+        return (boundsMax - boundsMin) * 0.5f;
+    }
+
+    /**
+     * @brief バウンディングボックスを取得する
+     */
+    Aabb getBox() const {
+        return {boundsMin, boundsMax};
+    }
+};
+
+} // namespace claude_gl
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "mesh.h"
+
+namespace claude_gl {
+
+/**
+ * @brief メッシュのクラスタ（Mesh::Meshlet）ごとに視錐台と面の向きでカリングするクラス
+ *
+ * インスタンスごとに視錐台の平面とカメラ位置をメッシュ空間へ変換し、クラスタの境界球と
+ * 法線の錐をそのまま判定します（アフィン変換では平面の内外と面の表裏が変わらないため、
+ * 拡大率が軸ごとに異なっても正しく判定できる）。
+ *
+ * - 視錐台: 境界球が6平面のいずれかの完全に外側にあるクラスタを除きます。
+ * - 面の向き: 境界球のどの点から見ても全三角形が裏を向くクラスタを除きます。裏面が見える
+ *   描画（半透明や、面カリングなしで開いたメッシュ）では setConeCulling(false) にするか、
+ *   クラスタに分けずに描画します。
+ *
+ * GPUでカリングする場合は同じ判定を cull.comp が描画ごとに行います。
+ * GLを使わないため、コンテキストなしで動作を確認できます。
+ */
+class ClusterCuller {
+public:
+    /**
+     * @brief 直近の beginFrame() からの判定の数
+     */
+    struct Stats {
+        std::size_t meshes = 0;           ///< クラスタごとに判定したメッシュ数
+        std::size_t tested = 0;           ///< 判定したクラスタ数
+        std::size_t frustumCulled = 0;    ///< 視錐台の外で除いたクラスタ数
+        std::size_t backfaceCulled = 0;   ///< 裏を向いていて除いたクラスタ数
+        std::size_t triangles = 0;        ///< 判定したクラスタの三角形数
+        std::size_t culledTriangles = 0;  ///< 除いたクラスタの三角形数
+    };
+
+    /**
+     * @brief フレームの判定を開始する（統計情報を0にする）
+     * @param viewProjection プロジェクション行列 × ビュー行列
+     * @param cameraPosition ワールド空間のカメラ位置
+     */
+    void beginFrame(const glm::mat4& viewProjection, const glm::vec3& cameraPosition);
+
+    /**
+     * @brief 以降の cull() で判定するインスタンスのワールド変換行列を設定する
+     * @param world ワールド変換行列（逆行列を持つこと）
+     */
+    void beginInstance(const glm::mat4& world);
+
+    /**
+     * @brief クラスタを判定し、描画するものの番号を求める
+     * @param meshlets メッシュのクラスタの配列
+     * @param count クラスタ数
+     * @param visible 描画するクラスタの番号の出力先（昇順、以前の内容は消す）
+     * @return 描画するクラスタ数
+     */
+    std::size_t cull(const Mesh::Meshlet* meshlets, std::size_t count,
+                     std::vector<std::uint32_t>& visible);
+
+    /**
+     * @brief 面の向きによるカリングを行うか設定する（視錐台のカリングは常に行う）
+     * @param enabled 行う場合はtrue
+     */
+    void setConeCulling(bool enabled);
+
+    /**
+     * @brief 直近の beginFrame() からの判定の数を取得する
+     * @return 統計情報
+     */
+    const Stats& getStats() const;
+
+    /**
+     * @brief クラスタの境界球が視錐台の外にあるか判定する
+     * @param meshlet クラスタ
+     * @param planes メッシュ空間の視錐台の6平面（法線は内向きで正規化済み）
+     * @return いずれかの平面の完全に外側にあればtrue
+     */
+    static bool isOutsideFrustum(const Mesh::Meshlet& meshlet, const glm::vec4 planes[6]);
+
+    /**
+     * @brief クラスタの全三角形がカメラから裏を向いているか判定する
+     * @param meshlet クラスタ
+     * @param cameraPosition メッシュ空間のカメラ位置
+     * @return 境界球のどの点から見ても裏を向く場合はtrue
+     */
+    static bool isBackfacing(const Mesh::Meshlet& meshlet, const glm::vec3& cameraPosition);
+
+private:
+    glm::mat4 viewProjection = glm::mat4(1.0f);  ///< 今フレームのビュー・プロジェクション
+    glm::vec3 cameraPosition = glm::vec3(0.0f);  ///< ワールド空間のカメラ位置
+    glm::vec4 localPlanes[6];                    ///< メッシュ空間の視錐台の平面
+    glm::vec3 localCamera = glm::vec3(0.0f);     ///< メッシュ空間のカメラ位置
+    bool coneCulling = true;                     ///< 面の向きによるカリングを行うか
+    Stats stats;                                 ///< 判定の数
+};
+
+} // namespace claude_gl
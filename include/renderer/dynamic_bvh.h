@@ -0,0 +1,399 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "bounding_volume.h"
+
+namespace claude_gl {
+
+/**
+ * @brief 動的な境界ボリューム階層（BVH）
+ *
+ * 葉ごとにAABBと利用者データ（インスタンス番号など）を保持する二分木です。
+ * rebuild() はビン分割SAHによるトップダウン構築で木全体を作り直し、
+ * insert() / update() / remove() は木を部分的に更新します。
+ * 更新時は葉から根まで境界を再計算しながら、各ノードで表面積が小さくなる
+ * 子と孫の入れ替え（木の回転）を行うため、変換が変わり続けても木の品質が保たれます。
+ *
+ * 視錐台・レイ・AABBの検索はいずれも交差しない部分木を丸ごと除外するため、
+ * コストは葉の総数ではなく木の高さ（対数）と結果の数に比例します。
+ */
+class DynamicBvh {
+public:
+    static constexpr int NULL_NODE = -1;  ///< 無効なノード番号
+
+    /**
+     * @brief 更新処理の統計情報
+     */
+    struct Stats {
+        std::size_t refits = 0;      ///< その場で境界を更新した回数
+        std::size_t reinserts = 0;   ///< 削除して挿入し直した回数
+        std::size_t rotations = 0;   ///< 木の回転を行った回数
+    };
+
+    /**
+     * @brief 葉を挿入する
+     * @param box 葉の境界
+     * @param userData 検索結果として返す値
+     * @return 葉のノード番号（update() / remove() に渡す）
+     */
+    int insert(const Aabb& box, std::uint32_t userData);
+
+    /**
+     * @brief 葉を削除する
+     * @param leaf insert() が返したノード番号
+     * @throw std::runtime_error 有効な葉でない場合
+     */
+    void remove(int leaf);
+
+    /**
+     * @brief 葉の境界を更新する
+     *
+     * 新しい境界が元の境界と重なる小さな移動では、その場で祖先の境界を更新して回転を行う。
+     * 離れた位置への移動では、木の適切な位置に挿入し直す。
+     *
+     * @param leaf insert() が返したノード番号
+     * @param box 新しい境界
+     * @throw std::runtime_error 有効な葉でない場合
+     */
+    void update(int leaf, const Aabb& box);
+
+    /**
+     * @brief 現在の葉からビン分割SAHで木全体を作り直す（葉のノード番号は変わらない）
+     */
+    void rebuild();
+
+    /**
+     * @brief すべてのノードを削除する
+     */
+    void clear();
+
+    /**
+     * @brief 葉の境界を取得する
+     * @param leaf insert() が返したノード番号
+     * @return 境界
+     */
+    const Aabb& getBox(int leaf) const;
+
+    /**
+     * @brief 葉の利用者データを取得する
+     * @param leaf insert() が返したノード番号
+     * @return 利用者データ
+     */
+    std::uint32_t getUserData(int leaf) const;
+
+    /**
+     * @brief 葉の数を取得する
+     * @return 葉の数
+     */
+    std::size_t getLeafCount() const;
+
+    /**
+     * @brief 木の高さを取得する（葉のみの場合は0、空の場合は-1）
+     * @return 高さ
+     */
+    int getHeight() const;
+
+    /**
+     * @brief 木の品質の指標を計算する
+     *
+     * 内部ノードの表面積の総和を根の表面積で割った値で、小さいほど検索が速い
+     *
+     * @return SAHコスト
+     */
+    float computeSahCost() const;
+
+    /**
+     * @brief 更新処理の統計情報を取得する
+     * @return 統計情報
+     */
+    const Stats& getStats() const;
+
+    /**
+     * @brief AABBと重なる葉を列挙する
+     * @param box 検索範囲
+     * @param callback 葉ごとに callback(userData) を呼ぶ
+     * @return 訪問したノード数
+     */
+    template <typename Callback>
+    std::size_t queryAabb(const Aabb& box, Callback&& callback) const;
+
+    /**
+     * @brief 視錐台と交差する葉を列挙する
+     *
+     * 部分木が平面の内側に完全に含まれる場合、その平面は子孫で判定しない。
+     * すべての平面の内側に含まれる部分木は判定なしで列挙する
+     *
+     * @param planes FrustumCuller::extractPlanes() で抽出した6平面
+     * @param callback 葉ごとに callback(userData) を呼ぶ
+     * @return 訪問したノード数
+     */
+    template <typename Callback>
+    std::size_t queryFrustum(const glm::vec4 planes[6], Callback&& callback) const;
+
+    /**
+     * @brief レイと交差する葉を近い順に調べ、最も近い交差距離を求める
+     *
+     * callback(userData, maxDistance) は葉の内容とレイの交差距離を返す。
+     * 交差しない場合は maxDistance 以上の値を返す。返された距離より遠い部分木は調べない
+     *
+     * @param origin レイの始点
+     * @param direction レイの方向（正規化不要、距離はこの長さを単位とする）
+     * @param maxDistance 検索する最大距離
+     * @param callback 葉ごとの交差判定
+     * @return 最も近い交差距離（交差しなければ maxDistance）
+     */
+    template <typename Callback>
+    float raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                  Callback&& callback) const;
+
+private:
+    /**
+     * @brief 木のノード
+     */
+    struct Node {
+        Aabb box;                      ///< 子孫をすべて包む境界
+        int parent = NULL_NODE;        ///< 親（解放済みノードでは空きリストの次）
+        int child1 = NULL_NODE;        ///< 子1（葉ではNULL_NODE）
+        int child2 = NULL_NODE;        ///< 子2（葉ではNULL_NODE）
+        int height = 0;                ///< 葉を0とした高さ（解放済みノードでは-1）
+        std::uint32_t userData = 0;    ///< 葉の利用者データ
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    /**
+     * @brief 検索用のスタック（浅い木では固定長の領域を使い、深い木ではヒープに確保する）
+     */
+    template <typename T>
+    class TraversalStack {
+    public:
+        explicit TraversalStack(int height);
+        void push(const T& value) { data[size++] = value; }
+        T pop() { return data[--size]; }
+        bool empty() const { return size == 0; }
+
+    private:
+        static constexpr int LOCAL_CAPACITY = 64;
+        T local[LOCAL_CAPACITY];
+        std::vector<T> heap;
+        T* data;
+        std::size_t size = 0;
+    };
+
+    std::vector<Node> nodes;      ///< 全ノード（解放済みを含む）
+    int root = NULL_NODE;         ///< 根のノード番号
+    int freeList = NULL_NODE;     ///< 解放済みノードの先頭
+    std::size_t leafCount = 0;    ///< 葉の数
+    Stats stats;                  ///< 更新処理の統計情報
+
+    int allocateNode();
+    void freeNode(int index);
+
+    /**
+     * @brief 葉を挿入するコストが最小になる兄弟を探して木に繋ぐ
+     */
+    void insertLeaf(int leaf);
+
+    /**
+     * @brief insert() が返した現在も有効な葉の番号か確認する
+     * @throw std::runtime_error 範囲外、内部ノード、解放済みのノードの場合
+     */
+    void validateLeaf(int leaf) const;
+
+    /**
+     * @brief 葉を木から外し、兄弟を親の位置に繋ぎ直す（葉のノード自体は解放しない）
+     */
+    void removeLeaf(int leaf);
+
+    /**
+     * @brief 指定したノードから根まで境界と高さを再計算し、各ノードで回転を試みる
+     */
+    void refitAncestors(int index);
+
+    /**
+     * @brief ノードの子と孫を入れ替えて表面積が小さくなる場合に回転する
+     */
+    void rotate(int index);
+
+    /**
+     * @brief SAH構築で使う葉の情報（ノード配列を参照せずに分割できるよう複製する）
+     */
+    struct BuildItem {
+        Aabb box;            ///< 葉の境界
+        glm::vec3 centroid;  ///< 境界の中心
+        int leaf;            ///< 葉のノード番号
+    };
+
+    /**
+     * @brief 葉の範囲からビン分割SAHで部分木を構築する
+     * @param items 葉の情報（範囲内が並べ替えられる）
+     * @param begin 範囲の先頭
+     * @param end 範囲の終端
+     * @return 部分木の根
+     */
+    int buildRange(std::vector<BuildItem>& items, std::size_t begin, std::size_t end);
+
+    /**
+     * @brief レイとボックスの交差区間の入口を求める（スラブ法）
+     * @return 区間 [0, maxDistance] で交差する場合は入口の距離、しなければ負の値
+     */
+    static float intersectRay(const Aabb& box, const glm::vec3& origin,
+                              const glm::vec3& inverseDirection, float maxDistance);
+};
+
+// ---- テンプレートの実装 ----
+
+template <typename T>
+DynamicBvh::TraversalStack<T>::TraversalStack(int height) : data(local) {
+    // 子を2つ積むたびに1つ取り出すため、高さ+1の容量があれば足りる
+    std::size_t capacity = static_cast<std::size_t>(height < 0 ? 0 : height) + 2;
+    if (capacity > static_cast<std::size_t>(LOCAL_CAPACITY)) {
+        heap.resize(capacity);
+        data = heap.data();
+    }
+}
+
+inline float DynamicBvh::intersectRay(const Aabb& box, const glm::vec3& origin,
+                                      const glm::vec3& inverseDirection, float maxDistance) {
+    glm::vec3 t0 = (box.boundsMin - origin) * inverseDirection;
+    glm::vec3 t1 = (box.boundsMax - origin) * inverseDirection;
+    glm::vec3 tNear = glm::min(t0, t1);
+    glm::vec3 tFar = glm::max(t0, t1);
+    float entry = std::fmax(std::fmax(tNear.x, tNear.y), std::fmax(tNear.z, 0.0f));
+    float exit = std::fmin(std::fmin(tFar.x, tFar.y), std::fmin(tFar.z, maxDistance));
+    return entry <= exit ? entry : -1.0f;
+}
+
+template <typename Callback>
+std::size_t DynamicBvh::queryAabb(const Aabb& box, Callback&& callback) const {
+    if (root == NULL_NODE) {
+        return 0;
+    }
+
+    std::size_t visited = 0;
+    TraversalStack<int> stack(nodes[root].height);
+    stack.push(root);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.pop()];
+        ++visited;
+        if (!node.box.overlaps(box)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            callback(node.userData);
+        }
+        else {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+    return visited;
+}
+
+template <typename Callback>
+std::size_t DynamicBvh::queryFrustum(const glm::vec4 planes[6], Callback&& callback) const {
+    if (root == NULL_NODE) {
+        return 0;
+    }
+
+    // ノードと、まだ判定が必要な平面のビットマスクを積む
+    struct Entry {
+        int node;
+        unsigned int planeMask;
+    };
+    constexpr unsigned int ALL_PLANES = 0x3Fu;
+
+    std::size_t visited = 0;
+    TraversalStack<Entry> stack(nodes[root].height);
+    stack.push({root, ALL_PLANES});
+    while (!stack.empty()) {
+        Entry entry = stack.pop();
+        const Node& node = nodes[entry.node];
+        ++visited;
+
+        unsigned int planeMask = entry.planeMask;
+        if (planeMask != 0) {
+            glm::vec3 center = node.box.getCenter();
+            glm::vec3 extents = node.box.getExtents();
+            bool outside = false;
+            for (int p = 0; p < 6; ++p) {
+                if ((planeMask & (1u << p)) == 0) {
+                    continue;
+                }
+                glm::vec3 normal(planes[p]);
+                float distance = glm::dot(normal, center) + planes[p].w;
+                float projectedRadius = glm::dot(glm::abs(normal), extents);
+                if (distance < -projectedRadius) {
+                    outside = true;
+                    break;
+                }
+                if (distance >= projectedRadius) {
+                    planeMask &= ~(1u << p);  // 子孫はこの平面の内側に含まれる
+                }
+            }
+            if (outside) {
+                continue;
+            }
+        }
+
+        if (node.isLeaf()) {
+            callback(node.userData);
+        }
+        else {
+            stack.push({node.child1, planeMask});
+            stack.push({node.child2, planeMask});
+        }
+    }
+    return visited;
+}
+
+template <typename Callback>
+float DynamicBvh::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                          Callback&& callback) const {
+    if (root == NULL_NODE) {
+        return maxDistance;
+    }
+
+    // 0除算は無限大になり、スラブ法ではその軸の判定が常に成立する
+    glm::vec3 inverseDirection = 1.0f / direction;
+
+    TraversalStack<int> stack(nodes[root].height);
+    stack.push(root);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.pop()];
+        if (intersectRay(node.box, origin, inverseDirection, maxDistance) < 0.0f) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            float distance = callback(node.userData, maxDistance);
+            if (distance < maxDistance) {
+                maxDistance = distance;
+            }
+            continue;
+        }
+
+        // 近い子を先に調べると遠い子を早く除外できるため、遠い子を先に積む
+        float entry1 = intersectRay(nodes[node.child1].box, origin, inverseDirection,
+                                    maxDistance);
+        float entry2 = intersectRay(nodes[node.child2].box, origin, inverseDirection,
+                                    maxDistance);
+        if (entry1 >= 0.0f && entry2 >= 0.0f) {
+            bool firstIsNear = entry1 <= entry2;
+            stack.push(firstIsNear ? node.child2 : node.child1);
+            stack.push(firstIsNear ? node.child1 : node.child2);
+        }
+        else if (entry1 >= 0.0f) {
+            stack.push(node.child1);
+        }
+        else if (entry2 >= 0.0f) {
+            stack.push(node.child2);
+        }
+    }
+    return maxDistance;
+}
+
+} // namespace claude_gl
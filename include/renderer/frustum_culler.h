@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "bounding_volume.h"
+
+namespace claude_gl {
+
+/**
+ * @brief 視錐台カリングをまとめて行うクラス
+ *
+ * 毎フレーム addObject() でワールド空間の境界を登録し、cull() で一括判定します。
+ * 境界は中心・球の半径・ボックスの半分の大きさを成分ごとの配列（SoA）で保持し、
+ * 複数のオブジェクトを同時に判定します（AVX: 8個、SSE / NEON: 4個、それ以外はスカラー）。
+ *
+ * 各平面について「中心の符号付き距離 < -min(球の半径, ボックスの投影半径)」なら
+ * 視錐台の外と判定するため、球とボックスのうち厳しい方で除外されます。
+ */
+class FrustumCuller {
+public:
+    /**
+     * @brief カリングの統計情報
+     */
+    struct Stats {
+        std::size_t tested = 0;  ///< 判定したオブジェクト数
+        std::size_t culled = 0;  ///< 視錐台の外と判定したオブジェクト数
+
+        /**
+         * @brief 描画するオブジェクト数を取得する
+         * @return 判定数 - 除外数
+         */
+        std::size_t visible() const;
+    };
+
+    /**
+     * @brief 登録済みのオブジェクトをすべて削除する（確保済みの容量は保持する）
+     */
+    void clear();
+
+    /**
+     * @brief 登録できるオブジェクト数を予約する
+     * @param count オブジェクト数
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * @brief オブジェクトの境界をワールド空間に変換して登録する
+     * @param bounds ローカル空間の境界
+     * @param world ワールド変換行列
+     * @return 登録番号（cull() 後に isVisible() で参照する）
+     */
+    std::size_t addObject(const BoundingVolume& bounds, const glm::mat4& world);
+
+    /**
+     * @brief 登録済みのオブジェクト数を取得する
+     * @return オブジェクト数
+     */
+    std::size_t getObjectCount() const;
+
+    /**
+     * @brief 登録済みのオブジェクトをSIMDで判定する
+     * @param viewProjection プロジェクション行列 × ビュー行列
+     */
+    void cull(const glm::mat4& viewProjection);
+
+    /**
+     * @brief 登録済みのオブジェクトをスカラー処理で判定する（比較・検証用）
+     * @param viewProjection プロジェクション行列 × ビュー行列
+     */
+    void cullScalar(const glm::mat4& viewProjection);
+
+    /**
+     * @brief 直近の判定でオブジェクトが視錐台と交差していたか取得する
+     * @param index 登録番号
+     * @return 交差していればtrue
+     */
+    bool isVisible(std::size_t index) const;
+
+    /**
+     * @brief 直近の判定で視錐台と交差していたオブジェクトの登録番号を取得する
+     * @return 登録番号の昇順の配列
+     */
+    const std::vector<std::uint32_t>& getVisibleIndices() const;
+
+    /**
+     * @brief 直近の判定の統計情報を取得する
+     * @return 統計情報
+     */
+    const Stats& getStats() const;
+
+    /**
+     * @brief 行列から視錐台の6平面を抽出する（法線は内向きで正規化済み）
+     * @param viewProjection プロジェクション行列 × ビュー行列
+     * @param planes 平面の出力先（xyz: 法線、w: 距離）
+     */
+    static void extractPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]);
+
+    /**
+     * @brief cull() が使用する命令セット名を取得する
+     * @return "AVX"、"SSE"、"NEON"、"Scalar" のいずれか
+     */
+    static const char* getInstructionSet();
+
+private:
+    // 境界（SoA、SIMDの幅の倍数に切り上げて確保する）
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+    std::vector<float> extentX;
+    std::vector<float> extentY;
+    std::vector<float> extentZ;
+    std::size_t objectCount = 0;
+
+    // 直近の判定結果
+    std::vector<std::uint8_t> visibility;
+    std::vector<std::uint32_t> visibleIndices;
+    Stats stats;
+
+    /**
+     * @brief 判定結果の領域を準備し、SoA配列の末尾をSIMDの幅まで埋める
+     */
+    void beginCull();
+
+    /**
+     * @brief 可視オブジェクトの番号を確定し、統計情報を更新する
+     * @param visibleCount 可視オブジェクト数
+     */
+    void endCull(std::size_t visibleCount);
+};
+
+} // namespace claude_gl
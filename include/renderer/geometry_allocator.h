@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace claude_gl {
+
+/**
+ * @brief 1つの連続した領域を可変長のブロックに分ける TLSF（Two-Level Segregated Fit）アロケータ
+ *
+ * GPUバッファの中の頂点・インデックスの範囲を割り当てるためのもので、メモリ自体は持たず
+ * 要素単位のオフセットだけを管理します。空きブロックは大きさの2段階のクラス
+ * （2の冪の区間をさらに8分割）ごとのリストに入れ、ビットマップで空でないクラスを探すため、
+ * allocate() / free() は空きブロック数によらず定数時間です。
+ * 解放したブロックは物理的に隣り合う空きブロックとすぐに結合します。
+ *
+ * ブロックは生成から解放まで変わらない番号で参照し、defragment() でオフセットが変わっても
+ * 番号はそのまま使えます（移動の内容は戻り値で受け取り、呼び出し側がデータをコピーする）。
+ */
+class GeometryAllocator {
+public:
+    using BlockId = std::uint32_t;
+
+    /**
+     * @brief 無効なブロック番号
+     */
+    static constexpr BlockId INVALID_BLOCK = 0xFFFFFFFFu;
+
+    /**
+     * @brief 使用量と断片化の統計情報（要素単位）
+     */
+    struct Stats {
+        std::size_t capacity = 0;     ///< 領域全体の大きさ
+        std::size_t used = 0;         ///< 割り当て中の合計
+        std::size_t largestFree = 0;  ///< 最大の空きブロック
+        std::size_t freeBlocks = 0;   ///< 空きブロック数
+        std::size_t allocations = 0;  ///< 割り当て中のブロック数
+
+        /**
+         * @brief 使用率を取得する
+         * @return used / capacity（0〜1）
+         */
+        double getUtilization() const {
+            return capacity > 0 ? static_cast<double>(used) / static_cast<double>(capacity) : 0.0;
+        }
+
+        /**
+         * @brief 断片化の度合いを取得する
+         * @return 1 - 最大の空きブロック / 空きの合計（0: 空きが1つにまとまっている）
+         */
+        double getFragmentation() const {
+            std::size_t freeSize = capacity - used;
+            return freeSize > 0 ? 1.0 - static_cast<double>(largestFree) /
+                                            static_cast<double>(freeSize)
+                                : 0.0;
+        }
+    };
+
+    /**
+     * @brief defragment() でのブロックの移動
+     */
+    struct Move {
+        BlockId block;       ///< 移動したブロック
+        std::uint32_t from;  ///< 移動前のオフセット
+        std::uint32_t to;    ///< 移動後のオフセット（from より小さい）
+        std::uint32_t size;  ///< 大きさ
+    };
+
+    /**
+     * @brief コンストラクタ
+     * @param capacity 領域の大きさ（要素数）
+     */
+    explicit GeometryAllocator(std::uint32_t capacity = 0);
+
+    /**
+     * @brief ブロックを割り当てる
+     * @param size 大きさ（要素数、1以上）
+     * @return ブロック番号（収まる空きブロックがない場合は INVALID_BLOCK）
+     */
+    BlockId allocate(std::uint32_t size);
+
+    /**
+     * @brief ブロックを解放し、隣り合う空きブロックと結合する
+     * @param block allocate() が返した番号
+     */
+    void free(BlockId block);
+
+    /**
+     * @brief ブロックのオフセットを取得する
+     */
+    std::uint32_t getOffset(BlockId block) const;
+
+    /**
+     * @brief ブロックの大きさを取得する
+     */
+    std::uint32_t getSize(BlockId block) const;
+
+    /**
+     * @brief 領域を末尾に広げる（割り当て中のブロックは移動しない）
+     * @param capacity 新しい大きさ（現在より小さい場合は何もしない）
+     */
+    void grow(std::uint32_t capacity);
+
+    /**
+     * @brief 割り当て中のブロックをオフセット順に先頭へ詰め、空きを末尾の1つにまとめる
+     * @return 移動したブロック（移動後のオフセット順）
+     */
+    std::vector<Move> defragment();
+
+    /**
+     * @brief 領域全体の大きさを取得する
+     */
+    std::uint32_t getCapacity() const;
+
+    /**
+     * @brief 使用量と断片化の統計情報を取得する
+     */
+    Stats getStats() const;
+
+private:
+    // 第2段階の分割数（2の冪の区間を 2^SL_BITS 個のクラスに分ける）
+    static constexpr std::uint32_t SL_BITS = 3;
+    static constexpr std::uint32_t SL_COUNT = 1u << SL_BITS;
+    static constexpr std::uint32_t FL_COUNT = 32;
+
+    /**
+     * @brief ブロック（割り当て中・空き・未使用の番号）
+     */
+    struct Block {
+        std::uint32_t offset = 0;                  ///< 領域の先頭からのオフセット
+        std::uint32_t size = 0;                    ///< 大きさ（0は未使用の番号）
+        BlockId previousPhysical = INVALID_BLOCK;  ///< 直前のブロック
+        BlockId nextPhysical = INVALID_BLOCK;      ///< 直後のブロック
+        BlockId previousFree = INVALID_BLOCK;      ///< 同じクラスの前の空きブロック
+        BlockId nextFree = INVALID_BLOCK;          ///< 同じクラスの次の空きブロック
+        bool free = false;                         ///< 空きブロックか
+    };
+
+    std::uint32_t capacity = 0;                    ///< 領域全体の大きさ
+    std::vector<Block> blocks;                     ///< 番号ごとのブロック
+    std::vector<BlockId> unusedIds;                ///< 再利用できる番号
+    BlockId lastBlock = INVALID_BLOCK;             ///< 末尾のブロック
+    std::uint32_t firstLevelMap = 0;               ///< 空きブロックがある第1段階のクラス
+    std::uint32_t secondLevelMaps[FL_COUNT] = {};  ///< 第1段階ごとの、空きがある第2段階
+    BlockId freeLists[FL_COUNT][SL_COUNT];         ///< クラスごとの空きブロックのリスト
+    std::size_t used = 0;                          ///< 割り当て中の合計
+    std::size_t allocations = 0;                   ///< 割り当て中のブロック数
+    std::size_t freeBlocks = 0;                    ///< 空きブロック数
+
+    /**
+     * @brief 大きさが属するクラスを求める
+     */
+    static void mapSize(std::uint32_t size, std::uint32_t& firstLevel,
+                        std::uint32_t& secondLevel);
+
+    /**
+     * @brief 番号を確保する（未使用の番号があれば再利用する）
+     */
+    BlockId createBlock(std::uint32_t offset, std::uint32_t size);
+
+    /**
+     * @brief 番号を未使用に戻す
+     */
+    void destroyBlock(BlockId block);
+
+    /**
+     * @brief 空きブロックをクラスのリストに追加する
+     */
+    void insertFree(BlockId block);
+
+    /**
+     * @brief 空きブロックをクラスのリストから外す
+     */
+    void removeFree(BlockId block);
+
+    /**
+     * @brief 大きさ以上の空きブロックを探す
+     * @return 見つからない場合は INVALID_BLOCK
+     */
+    BlockId findFree(std::uint32_t size) const;
+
+    /**
+     * @brief 空きブロックに直後の空きブロックを結合する
+     */
+    void mergeNext(BlockId block);
+};
+
+} // namespace claude_gl
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/gl.h>
+#include "geometry_allocator.h"
+#include "indirect_draw_buffer.h"
+#include "instance_buffer.h"
+#include "mesh.h"
+
+namespace claude_gl {
+
+/**
+ * @brief 複数のメッシュの頂点とインデックスを格納する共有のVBO・EBO
+ *
+ * メッシュは1つの大きなVBO（Mesh::Vertex のインターリーブ）とEBO（16ビット）の範囲を
+ * GeometryAllocator で割り当てて使います。インデックスはメッシュの先頭の頂点からの
+ * 相対値で格納し、描画時に glDrawElementsBaseVertex の baseVertex で位置を合わせるため、
+ * 65536頂点以下のメッシュはバッファ全体の頂点数によらず16ビットインデックスのままです。
+ *
+ * 全メッシュが1つのVAOを共有するので、メッシュを切り替えてもVAOの切り替えは起きず、
+ * 同じ変換行列とマテリアルのメッシュは drawMulti() の glMultiDrawElementsBaseVertex
+ * 1回で描画できます。
+ *
+ * 割り当てに失敗した場合、空きの合計が足りていれば断片化を解消し（ブロックを先頭へ詰めて
+ * glCopyBufferSubData で移動）、足りなければバッファを倍に広げてから割り当て直します。
+ */
+class GeometryArena {
+public:
+    using Handle = std::uint32_t;
+
+    /**
+     * @brief 無効なハンドル
+     */
+    static constexpr Handle INVALID_HANDLE = 0xFFFFFFFFu;
+
+    /**
+     * @brief 1メッシュあたりの最大頂点数（16ビットの相対インデックスで表せる数）
+     */
+    static constexpr std::size_t MAX_VERTICES_PER_MESH = 65536;
+
+    /**
+     * @brief 使用量と断片化の統計情報
+     */
+    struct Stats {
+        GeometryAllocator::Stats vertices;  ///< 頂点（要素数は頂点数）
+        GeometryAllocator::Stats indices;   ///< インデックス（要素数はインデックス数）
+        std::size_t meshes = 0;             ///< 格納中のメッシュ数
+        std::size_t grows = 0;              ///< バッファを広げた回数（累計）
+        std::size_t defragmentations = 0;   ///< 断片化を解消した回数（累計）
+        std::size_t movedBytes = 0;         ///< 断片化の解消で移動したバイト数（累計）
+    };
+
+    /**
+     * @brief コンストラクタ（VAO・VBO・EBOを生成する）
+     * @param vertexCapacity 最初に確保する頂点数
+     * @param indexCapacity 最初に確保するインデックス数
+     */
+    explicit GeometryArena(std::uint32_t vertexCapacity = 1u << 18,
+                           std::uint32_t indexCapacity = 1u << 20);
+
+    /**
+     * @brief デストラクタ
+     */
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    /**
+     * @brief メッシュの頂点とインデックスを格納する
+     * @param vertices 頂点配列の先頭
+     * @param vertexCount 頂点数（1〜MAX_VERTICES_PER_MESH）
+     * @param indices インデックス配列の先頭（メッシュ内の頂点番号）
+     * @param indexCount インデックス数
+     * @return メッシュのハンドル
+     */
+    Handle add(const Mesh::Vertex* vertices, std::size_t vertexCount,
+               const unsigned int* indices, std::size_t indexCount);
+
+    /**
+     * @brief 格納済みのメッシュのインデックスの一部を描画するハンドルを作る
+     *
+     * 頂点とインデックスは元のメッシュと共有します（詳細度の段階ごとの範囲など）。
+     * 元のメッシュより先に remove() で解放します。
+     *
+     * @param handle add() が返したハンドル
+     * @param firstIndex メッシュのインデックス内の先頭
+     * @param indexCount インデックス数
+     * @return 範囲のハンドル
+     */
+    Handle addView(Handle handle, std::uint32_t firstIndex, std::uint32_t indexCount);
+
+    /**
+     * @brief メッシュの範囲を解放する
+     * @param handle add() か addView() が返したハンドル
+     */
+    void remove(Handle handle);
+
+    /**
+     * @brief 共有のVAOをバインドする
+     */
+    void bind() const;
+
+    /**
+     * @brief 1つのメッシュを描画する（bind() の後に呼ぶ）
+     * @param handle メッシュのハンドル
+     */
+    void draw(Handle handle) const;
+
+    /**
+     * @brief 複数のメッシュを1回の描画呼び出しで描画する（bind() の後に呼ぶ）
+     * @param handles メッシュのハンドルの配列
+     * @param count メッシュ数
+     */
+    void drawMulti(const Handle* handles, std::size_t count) const;
+
+    /**
+     * @brief 1つのメッシュのインデックスの複数の範囲を1回の描画呼び出しで描画する
+     *        （bind() の後に呼ぶ）
+     * @param handle メッシュのハンドル
+     * @param firstIndices ハンドルの範囲内の先頭のインデックスの配列
+     * @param indexCounts 範囲ごとのインデックス数の配列
+     * @param count 範囲の数
+     */
+    void drawRanges(Handle handle, const std::uint32_t* firstIndices, const GLsizei* indexCounts,
+                    std::size_t count) const;
+
+    /**
+     * @brief インスタンスバッファの全インスタンスでメッシュを描画する
+     *
+     * インスタンスストリームは共有のVAOに接続し、バッファか位置が変わった時だけ接続し直します。
+     *
+     * @param handle メッシュのハンドル
+     * @param instances update() 済みのインスタンスバッファ
+     */
+    void drawInstanced(Handle handle, const InstanceBuffer& instances) const;
+
+    /**
+     * @brief メッシュの間接描画のコマンドを取得する（IndirectDrawBuffer 用）
+     * @param handle メッシュのハンドル
+     * @return インスタンス数1のコマンド（インデックスは GL_UNSIGNED_SHORT）
+     */
+    IndirectDrawBuffer::Command getDrawCommand(Handle handle) const;
+
+    /**
+     * @brief 頂点とインデックスの割り当てを先頭へ詰め、空きを末尾の1つにまとめる
+     */
+    void defragment();
+
+    /**
+     * @brief 格納できるメッシュか判定する
+     * @param vertexCount 頂点数
+     * @return 16ビットの相対インデックスで表せる頂点数ならtrue
+     */
+    static bool canStore(std::size_t vertexCount);
+
+    /**
+     * @brief 使用量と断片化の統計情報を取得する
+     */
+    Stats getStats() const;
+
+private:
+    /**
+     * @brief 格納中のメッシュの範囲
+     */
+    struct Entry {
+        GeometryAllocator::BlockId vertexBlock;  ///< 頂点の範囲
+        GeometryAllocator::BlockId indexBlock;   ///< インデックスの範囲
+        GLsizei indexCount;                      ///< インデックス数（0はハンドルが未使用）
+        std::uint32_t firstIndex;                ///< 描画するインデックスのブロック内の先頭
+        bool view;                               ///< 他のメッシュの範囲を参照するだけか
+    };
+
+    GLuint vao = 0;                                ///< 全メッシュで共有するVAO
+    GLuint vbo = 0;                                ///< 全メッシュの頂点
+    GLuint ebo = 0;                                ///< 全メッシュのインデックス（16ビット）
+    GeometryAllocator vertexAllocator;             ///< VBO内の頂点の範囲
+    GeometryAllocator indexAllocator;              ///< EBO内のインデックスの範囲
+    std::vector<Entry> entries;                    ///< ハンドルごとの範囲
+    std::vector<Handle> unusedHandles;             ///< 再利用できるハンドル
+    std::size_t meshCount = 0;                     ///< 格納中のメッシュ数
+    std::size_t grows = 0;                         ///< バッファを広げた回数
+    std::size_t defragmentations = 0;              ///< 断片化を解消した回数
+    std::size_t movedBytes = 0;                    ///< 断片化の解消で移動したバイト数
+    mutable GLuint instanceVbo = 0;                ///< VAOに接続済みのインスタンスストリーム
+    mutable GLintptr instanceOffset = 0;           ///< 接続済みのインスタンスストリームの位置
+    mutable std::vector<GLsizei> drawCounts;       ///< drawMulti() のインデックス数
+    mutable std::vector<const void*> drawOffsets;  ///< drawMulti() のEBO内の位置
+    mutable std::vector<GLint> baseVertices;       ///< drawMulti() の先頭の頂点
+
+    /**
+     * @brief 範囲を割り当てる（足りなければ断片化の解消かバッファの拡張を行う）
+     * @param allocator 頂点かインデックスのアロケータ
+     * @param buffer allocator に対応するバッファ（拡張時に作り直す）
+     * @param elementSize 1要素のバイト数
+     * @param size 要素数
+     * @return ブロック番号
+     */
+    GeometryAllocator::BlockId allocateBlock(GeometryAllocator& allocator, GLuint& buffer,
+                                             std::size_t elementSize, std::uint32_t size);
+
+    /**
+     * @brief ブロックを先頭へ詰め、バッファの内容を移動する
+     * @return 移動したブロックがあればtrue
+     */
+    bool compact(GeometryAllocator& allocator, GLuint buffer, std::size_t elementSize);
+
+    /**
+     * @brief バッファを広げ、以前の内容をコピーする
+     */
+    void grow(GeometryAllocator& allocator, GLuint& buffer, std::size_t elementSize,
+              std::uint32_t capacity);
+
+    /**
+     * @brief VAOに頂点属性とEBOを設定する（バッファを作り直した後に呼ぶ）
+     */
+    void attachBuffers();
+
+    /**
+     * @brief ハンドルの番号を割り当てる
+     */
+    Handle allocateHandle();
+
+    /**
+     * @brief インデックスのEBO内の位置を取得する
+     */
+    const void* getIndexPointer(const Entry& entry) const;
+};
+
+} // namespace claude_gl
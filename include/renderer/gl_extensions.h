@@ -0,0 +1,146 @@
+#pragma once
+
+#include <glad/gl.h>
+
+#ifndef GLAD_API_PTR
+#define GLAD_API_PTR
+#endif
+
+// GL 4.x の定数（glad は 3.3 core で生成しているため、使うものだけ定義する）
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT
+#define GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT 0x90DF
+#endif
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_PARAMETER_BUFFER
+#define GL_PARAMETER_BUFFER 0x80EE
+#endif
+#ifndef GL_TEXTURE_FETCH_BARRIER_BIT
+#define GL_TEXTURE_FETCH_BARRIER_BIT 0x00000008
+#endif
+#ifndef GL_SHADER_IMAGE_ACCESS_BARRIER_BIT
+#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT 0x00000020
+#endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#endif
+#ifndef GL_BUFFER_UPDATE_BARRIER_BIT
+#define GL_BUFFER_UPDATE_BARRIER_BIT 0x00000200
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+
+namespace claude_gl {
+
+/**
+ * @brief glad（GL 3.3 core）に含まれないGL 4.xの機能の対応状況と関数ポインタ
+ *
+ * ウィンドウの作成時に gladLoadGL() の後で load() を呼びます。
+ * 対応していない機能の関数ポインタは nullptr のままで、呼び出し側は
+ * has*() で確認してGL 3.3の方法に切り替えます。
+ */
+class GlExtensions {
+public:
+    using BufferStorageFunction = void(GLAD_API_PTR*)(GLenum target, GLsizeiptr size,
+                                                      const void* data, GLbitfield flags);
+    using MultiDrawIndirectFunction = void(GLAD_API_PTR*)(GLenum mode, GLenum type,
+                                                          const void* indirect,
+                                                          GLsizei drawCount, GLsizei stride);
+    using MultiDrawIndirectCountFunction = void(GLAD_API_PTR*)(GLenum mode, GLenum type,
+                                                               const void* indirect,
+                                                               GLintptr drawCount,
+                                                               GLsizei maxDrawCount,
+                                                               GLsizei stride);
+    using DispatchComputeFunction = void(GLAD_API_PTR*)(GLuint x, GLuint y, GLuint z);
+    using MemoryBarrierFunction = void(GLAD_API_PTR*)(GLbitfield barriers);
+    using BindImageTextureFunction = void(GLAD_API_PTR*)(GLuint unit, GLuint texture,
+                                                         GLint level, GLboolean layered,
+                                                         GLint layer, GLenum access,
+                                                         GLenum format);
+    using ClearBufferSubDataFunction = void(GLAD_API_PTR*)(GLenum target, GLenum internalFormat,
+                                                           GLintptr offset, GLsizeiptr size,
+                                                           GLenum format, GLenum type,
+                                                           const void* data);
+
+    /**
+     * @brief 現在のコンテキストの対応状況を調べ、関数を読み込む
+     * @param loader 関数のアドレスを返す関数（glfwGetProcAddress）
+     */
+    static void load(GLADloadfunc loader);
+
+    /**
+     * @brief 読み込み済みの対応状況を取得する
+     * @return load() 前は全機能が未対応
+     */
+    static const GlExtensions& get();
+
+    /**
+     * @brief コンテキストのバージョンを取得する
+     * @return メジャー番号 * 10 + マイナー番号（4.6 なら 46）
+     */
+    int getVersion() const;
+
+    /**
+     * @brief 永続マップ可能なバッファ（GL 4.4 / ARB_buffer_storage）に対応しているか
+     */
+    bool hasBufferStorage() const;
+
+    /**
+     * @brief 間接描画の一括実行とSSBO（GL 4.3 / ARB_multi_draw_indirect）に対応しているか
+     */
+    bool hasMultiDrawIndirect() const;
+
+    /**
+     * @brief 頂点シェーダーで gl_DrawIDARB を読めるか（ARB_shader_draw_parameters）
+     */
+    bool hasShaderDrawParameters() const;
+
+    /**
+     * @brief コンピュートシェーダーとイメージの読み書き（GL 4.3）に対応しているか
+     */
+    bool hasComputeShader() const;
+
+    /**
+     * @brief 描画数をバッファから読む間接描画（GL 4.6 / ARB_indirect_parameters）に対応しているか
+     */
+    bool hasIndirectCount() const;
+
+    BufferStorageFunction bufferStorage = nullptr;                  ///< glBufferStorage
+    MultiDrawIndirectFunction multiDrawElementsIndirect = nullptr;  ///< glMultiDrawElementsIndirect
+    DispatchComputeFunction dispatchCompute = nullptr;              ///< glDispatchCompute
+    MemoryBarrierFunction memoryBarrier = nullptr;                  ///< glMemoryBarrier
+    BindImageTextureFunction bindImageTexture = nullptr;            ///< glBindImageTexture
+    ClearBufferSubDataFunction clearBufferSubData = nullptr;        ///< glClearBufferSubData
+    /// glMultiDrawElementsIndirectCount（ARB_indirect_parameters の場合は ARB 版）
+    MultiDrawIndirectCountFunction multiDrawElementsIndirectCount = nullptr;
+
+private:
+    int version = 0;                    ///< メジャー番号 * 10 + マイナー番号
+    bool shaderDrawParameters = false;  ///< ARB_shader_draw_parameters に対応しているか
+
+    /**
+     * @brief 書き込み可能なインスタンスを取得する
+     */
+    static GlExtensions& getInstance();
+
+    /**
+     * @brief 拡張機能の文字列が報告されているか判定する
+     */
+    static bool hasExtension(const char* name);
+};
+
+} // namespace claude_gl
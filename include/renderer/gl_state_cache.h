@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/gl.h>
+
+namespace claude_gl {
+
+/**
+ * @brief 深度・ブレンド・カリングの固定機能の状態のまとまり
+ *
+ * GlStateCache::createPipeline() で登録すると変更できないハンドルになり、
+ * 描画はハンドルで状態を指定します。
+ */
+struct PipelineState {
+    bool depthTest = true;                             ///< 深度テスト
+    bool depthWrite = true;                            ///< 深度の書き込み
+    GLenum depthFunc = GL_LESS;                        ///< 深度の比較関数
+    bool blend = false;                                ///< ブレンド
+    GLenum blendSource = GL_SRC_ALPHA;                 ///< ブレンドの入力側の係数
+    GLenum blendDestination = GL_ONE_MINUS_SRC_ALPHA;  ///< ブレンドの出力側の係数
+    bool cullFace = false;                             ///< 面カリング
+    GLenum cullMode = GL_BACK;                         ///< カリングする面
+    GLenum frontFace = GL_CCW;                         ///< 表面の頂点の順
+
+    bool operator==(const PipelineState& other) const;
+};
+
+/**
+ * @brief OpenGLの状態をCPU側で覚えておき、変化のない呼び出しを省くキャッシュ
+ *
+ * プログラム・VAO・バッファ・テクスチャのバインドと、PipelineState の固定機能の状態を
+ * 現在の値と比較し、異なる場合だけGLを呼び出します。フレームごとに発行した呼び出しと
+ * 省いた呼び出しを種類別に数えます。
+ *
+ * コンテキストは1つ（メインスレッドのみ）を想定したシングルトンです。キャッシュを通さずに
+ * 状態を変更した場合は invalidate() を、オブジェクトを削除する場合は forget*() を呼びます。
+ */
+class GlStateCache {
+public:
+    using PipelineHandle = std::uint32_t;
+    static constexpr PipelineHandle INVALID_PIPELINE = 0xFFFFFFFFu;  ///< 無効なハンドル
+
+    /**
+     * @brief 発行した呼び出しと省いた呼び出しの数
+     */
+    struct Counter {
+        std::size_t issued = 0;   ///< 発行したGL呼び出し数
+        std::size_t skipped = 0;  ///< 現在の状態と同じため省いた呼び出し数
+    };
+
+    /**
+     * @brief 種類別の呼び出し数
+     */
+    struct Stats {
+        Counter programs;      ///< glUseProgram
+        Counter vertexArrays;  ///< glBindVertexArray
+        Counter buffers;       ///< glBindBuffer
+        Counter textures;      ///< glActiveTexture / glBindTexture
+        Counter pipeline;      ///< glEnable / glDisable / glDepthFunc / glBlendFunc などの固定機能
+
+        /**
+         * @brief 全種類の合計を取得する
+         * @return 発行数と省略数の合計
+         */
+        Counter getTotal() const;
+    };
+
+    /**
+     * @brief キャッシュを取得する
+     * @return 唯一のインスタンス
+     */
+    static GlStateCache& getInstance();
+
+    GlStateCache(const GlStateCache&) = delete;
+    GlStateCache& operator=(const GlStateCache&) = delete;
+
+    /**
+     * @brief 固定機能の状態のまとまりを登録する（同じ内容なら同じハンドルを返す）
+     * @param state 状態
+     * @return 変更できないハンドル
+     */
+    PipelineHandle createPipeline(const PipelineState& state);
+
+    /**
+     * @brief 登録した状態を取得する
+     * @param pipeline ハンドル
+     * @return 状態
+     */
+    const PipelineState& getPipeline(PipelineHandle pipeline) const;
+
+    /**
+     * @brief 固定機能の状態を設定する（現在と異なる項目のみGLを呼ぶ）
+     * @param pipeline createPipeline() が返したハンドル
+     */
+    void bindPipeline(PipelineHandle pipeline);
+
+    /**
+     * @brief プログラムを使用する
+     * @param program プログラム（0で解除）
+     */
+    void useProgram(GLuint program);
+
+    /**
+     * @brief VAOをバインドする
+     * @param vertexArray VAO（0で解除）
+     */
+    void bindVertexArray(GLuint vertexArray);
+
+    /**
+     * @brief バッファをバインドする
+     *
+     * GL_ELEMENT_ARRAY_BUFFER はVAOの状態のため、VAOを切り替えると不明として扱います。
+     *
+     * @param target バインド先
+     * @param buffer バッファ（0で解除）
+     */
+    void bindBuffer(GLenum target, GLuint buffer);
+
+    /**
+     * @brief バッファの範囲をインデックス付きのバインディングポイントに設定する
+     *
+     * glBindBufferRange は通常のバインド先も変更するため、その状態も更新します。
+     * GL_UNIFORM_BUFFER のバインディングポイントのみキャッシュします。
+     *
+     * @param target バインド先（GL_UNIFORM_BUFFER など）
+     * @param index バインディングポイント
+     * @param buffer バッファ
+     * @param offset 範囲の先頭（バイト）
+     * @param size 範囲の大きさ（バイト）
+     */
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset,
+                         GLsizeiptr size);
+
+    /**
+     * @brief テクスチャをユニットにバインドする
+     * @param unit テクスチャユニット（0から）
+     * @param target バインド先（GL_TEXTURE_2D など）
+     * @param texture テクスチャ（0で解除）
+     */
+    void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+    /**
+     * @brief 削除するプログラムを忘れる（削除の前に呼ぶ）
+     */
+    void forgetProgram(GLuint program);
+
+    /**
+     * @brief 削除するVAOを忘れる（削除の前に呼ぶ）
+     */
+    void forgetVertexArray(GLuint vertexArray);
+
+    /**
+     * @brief 削除するバッファを忘れる（削除の前に呼ぶ）
+     */
+    void forgetBuffer(GLuint buffer);
+
+    /**
+     * @brief 削除するテクスチャを忘れる（削除の前に呼ぶ）
+     */
+    void forgetTexture(GLuint texture);
+
+    /**
+     * @brief すべての状態を不明にする（次の呼び出しは必ず発行される）
+     */
+    void invalidate();
+
+    /**
+     * @brief フレームの開始時に呼び、前フレームの呼び出し数を確定させる
+     */
+    void beginFrame();
+
+    /**
+     * @brief 直前のフレームの呼び出し数を取得する
+     * @return 種類別の呼び出し数
+     */
+    const Stats& getFrameStats() const;
+
+private:
+    // バッファのバインド先（キャッシュする種類）
+    static constexpr std::size_t BUFFER_TARGET_COUNT = 9;
+    // キャッシュするテクスチャユニット数（GL 3.3で保証される数）
+    static constexpr std::size_t TEXTURE_UNIT_COUNT = 16;
+    // キャッシュする uniform バッファのバインディングポイント数
+    static constexpr std::size_t UNIFORM_BINDING_COUNT = 16;
+    // 状態が不明であることを表す値
+    static constexpr GLuint UNKNOWN = 0xFFFFFFFFu;
+
+    /**
+     * @brief テクスチャユニットのバインド
+     */
+    struct TextureBinding {
+        GLenum target = 0;         ///< バインド先
+        GLuint texture = UNKNOWN;  ///< テクスチャ
+    };
+
+    /**
+     * @brief インデックス付きのバインディングポイントの範囲
+     */
+    struct RangeBinding {
+        GLuint buffer = UNKNOWN;  ///< バッファ
+        GLintptr offset = 0;      ///< 範囲の先頭
+        GLsizeiptr size = 0;      ///< 範囲の大きさ
+    };
+
+    std::vector<PipelineState> pipelines;                 ///< 登録された状態
+    PipelineState currentPipeline;                        ///< 現在の固定機能の状態
+    bool pipelineKnown = false;                           ///< currentPipeline が実際と一致するか
+    GLuint currentProgram = UNKNOWN;                      ///< 使用中のプログラム
+    GLuint currentVertexArray = UNKNOWN;                  ///< バインド中のVAO
+    GLuint currentBuffers[BUFFER_TARGET_COUNT];           ///< バインド先ごとのバッファ
+    GLuint activeTextureUnit = UNKNOWN;                   ///< アクティブなテクスチャユニット
+    TextureBinding textures[TEXTURE_UNIT_COUNT];          ///< ユニットごとのテクスチャ
+    RangeBinding uniformBindings[UNIFORM_BINDING_COUNT];  ///< uniform バッファの範囲
+    Stats frameStats;                                     ///< 集計中のフレームの呼び出し数
+    Stats lastFrameStats;                                 ///< 直前のフレームの呼び出し数
+
+    GlStateCache();
+
+    /**
+     * @brief キャッシュするバッファのバインド先の番号を取得する
+     * @return 番号（キャッシュしない種類は BUFFER_TARGET_COUNT）
+     */
+    static std::size_t getBufferSlot(GLenum target);
+
+    /**
+     * @brief glEnable / glDisable を現在と異なる場合のみ呼ぶ
+     */
+    void setCapability(GLenum capability, bool enabled, bool current);
+};
+
+} // namespace claude_gl
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+#include "indirect_draw_buffer.h"
+#include "renderer/shader.h"
+
+namespace claude_gl {
+
+/**
+ * @brief コンピュートシェーダーで視錐台と遮蔽のカリングを行い、間接描画のコマンドを詰める（GL 4.3）
+ *
+ * IndirectDrawBuffer に書いた描画ごとの境界球（モデル空間）を cull.comp が読み、
+ * 描画ごとのワールド変換行列で変換してから、今フレームの視錐台と前フレームの深度の
+ * ピラミッド（Hi-Z）で判定します。残った描画はアトミックな加算で番号を取り、
+ * 描画コマンドと描画ごとのデータを出力のバッファへ詰めて書きます。CPUは可視判定を行いません。
+ * 法線の錐を持つ描画（メッシュのクラスタ）は、カメラをモデル空間へ変換して全三角形が
+ * 裏を向くかも判定します（ClusterCuller と同じ判定）。
+ *
+ * 描画数はGPUにしかないため、glMultiDrawElementsIndirectCount が使える場合はカウンタから
+ * 読みます。使えない場合は出力のコマンドを0で埋めておき、判定した数のコマンドを実行します
+ * （除かれた分はインデックス数0の空の描画になる）。
+ *
+ * 深度のピラミッドは endFrame() で描画済みの深度バッファをコピーし、depth_reduce.comp で
+ * 2x2 の最も遠い深度を段ごとに求めて作ります。前フレームのビュー・プロジェクション行列で
+ * 境界球を投影して比べるため、物体やカメラが速く動くと1フレーム遅れて見えることがあります。
+ *
+ * 判定の数（残った数・視錐台・遮蔽）は数フレーム後にフェンスで完了を確認してから読み、
+ * 結果を待ってCPUが停止することはありません。
+ */
+class GpuCuller {
+public:
+    /**
+     * @brief 読み戻した1フレーム分の判定の数
+     */
+    struct Stats {
+        std::size_t tested = 0;           ///< 判定した描画数
+        std::size_t visible = 0;          ///< 残って描画した数
+        std::size_t frustumCulled = 0;    ///< 視錐台の外で除いた数
+        std::size_t occlusionCulled = 0;  ///< 前フレームの深度で遮蔽されて除いた数
+        std::size_t backfaceCulled = 0;   ///< クラスタの全三角形が裏を向いていて除いた数
+        std::size_t latencyFrames = 0;    ///< 発行から読み戻すまでのフレーム数
+    };
+
+    /**
+     * @brief 1フレームでカリングできる IndirectDrawBuffer::draw() の回数
+     */
+    static constexpr std::size_t MAX_BATCHES = 64;
+
+    /**
+     * @brief コンストラクタ（出力のバッファとカウンタを生成する）
+     * @param cullShader cull.comp を読み込んだシェーダー（破棄するまで有効であること）
+     * @param depthReduceShader depth_reduce.comp を読み込んだシェーダー（同上）
+     * @param maxDraws 1フレームでカリングできる最大の描画数
+     */
+    GpuCuller(const Shader& cullShader, const Shader& depthReduceShader,
+              std::size_t maxDraws = 16384);
+
+    /**
+     * @brief デストラクタ
+     */
+    ~GpuCuller();
+
+    GpuCuller(const GpuCuller&) = delete;
+    GpuCuller& operator=(const GpuCuller&) = delete;
+
+    /**
+     * @brief 現在のコンテキストで使えるか判定する
+     * @return コンピュートシェーダーと IndirectDrawBuffer が使える場合はtrue
+     */
+    static bool isSupported();
+
+    /**
+     * @brief フレームのカリングを開始する（完了済みの読み戻しもここで回収する）
+     * @param viewProjection 今フレームのプロジェクション行列 × ビュー行列
+     * @param cameraPosition ワールド空間のカメラ位置（クラスタの面の向きの判定に使う）
+     */
+    void beginFrame(const glm::mat4& viewProjection, const glm::vec3& cameraPosition);
+
+    /**
+     * @brief 描画をカリングし、残りを出力のバッファへ詰める（プログラムを切り替える）
+     *
+     * 詰めた順序は元の順序と一致しないため、順序に依存しない不透明の描画だけを渡すこと。
+     *
+     * @param source batch を書いたバッファ
+     * @param batch IndirectDrawBuffer::allocate() が返し、境界まで書き込んだもの
+     * @return draw() に渡す番号（今フレームの容量を超えた場合は -1）
+     */
+    int cull(GLuint source, const IndirectDrawBuffer::Batch& batch);
+
+    /**
+     * @brief cull() で詰めた描画を実行する（VAOとプログラムは呼び出し側が設定する）
+     * @param culledBatch cull() が返した番号
+     */
+    void draw(int culledBatch);
+
+    /**
+     * @brief 描画済みの深度から次フレーム用の深度のピラミッドを作り、判定の数の読み戻しを発行する
+     *
+     * 不透明な描画の後に呼びます（ビューポートの範囲の深度バッファを使う）。
+     */
+    void endFrame();
+
+    /**
+     * @brief 遮蔽のカリングを行うか設定する（視錐台のカリングは常に行う）
+     * @param enabled 行う場合はtrue
+     */
+    void setOcclusionCulling(bool enabled);
+
+    /**
+     * @brief 直近に読み戻した判定の数を取得する
+     * @return 判定の数（まだ読み戻していない場合は0）
+     */
+    const Stats& getStats() const;
+
+private:
+    static constexpr int READBACK_COUNT = 4;           ///< 同時に結果待ちにできる読み戻しの数
+    static constexpr std::size_t COUNTERS_PER_BATCH = 4;  ///< 残った数・視錐台・遮蔽・面の向き
+
+    /**
+     * @brief 1回の cull() の出力の範囲
+     */
+    struct CulledBatch {
+        std::size_t first;  ///< 出力のバッファ内の最初の描画の番号
+        std::size_t count;  ///< 判定した描画数（出力のコマンドの最大数）
+    };
+
+    const Shader* cullShader;                ///< カリングのコンピュートシェーダー
+    const Shader* depthReduceShader;         ///< 深度のピラミッドのコンピュートシェーダー
+    std::size_t maxDraws;                    ///< 1フレームの最大の描画数
+    std::size_t drawStep = 1;                ///< 出力の先頭をSSBOのアラインメントに揃える単位
+    GLuint outputBuffer = 0;                 ///< 詰めた描画コマンドと描画ごとのデータ
+    GLintptr outputDrawOffset = 0;           ///< 出力のバッファ内の描画ごとのデータの位置
+    GLuint counterBuffer = 0;                ///< cull() ごとの判定の数
+    std::vector<CulledBatch> culledBatches;  ///< 今フレームの cull() の出力の範囲
+    std::size_t outputCount = 0;             ///< 今フレームで使った出力の描画数
+
+    GLuint readbackBuffers[READBACK_COUNT] = {};       ///< 判定の数のコピー先
+    GLsync readbackFences[READBACK_COUNT] = {};        ///< コピーの完了を確認するフェンス
+    std::size_t readbackBatches[READBACK_COUNT] = {};  ///< コピーした cull() の回数
+    std::size_t readbackFrames[READBACK_COUNT] = {};   ///< コピーを発行したフレーム
+    int nextReadback = 0;                              ///< 次に使う読み戻しの番号
+
+    GLuint depthTexture = 0;                            ///< 深度バッファのコピー
+    GLuint pyramidTexture = 0;                          ///< 最も遠い深度のピラミッド（R32F）
+    int depthWidth = 0;                                 ///< 深度バッファのコピーの幅
+    int depthHeight = 0;                                ///< 深度バッファのコピーの高さ
+    int pyramidLevels = 0;                              ///< ピラミッドの段数
+    glm::mat4 viewProjection = glm::mat4(1.0f);         ///< 今フレームのビュー・プロジェクション
+    glm::mat4 pyramidViewProjection = glm::mat4(1.0f);  ///< ピラミッドを作ったフレームのもの
+    glm::vec3 cameraPosition = glm::vec3(0.0f);         ///< 今フレームのワールド空間のカメラ位置
+    std::size_t frame = 0;                              ///< beginFrame() の回数
+    std::size_t pyramidFrame = 0;                       ///< ピラミッドを作ったフレーム（0は未作成）
+    bool occlusionCulling = true;                       ///< 遮蔽のカリングを行うか
+    Stats stats;                                        ///< 直近に読み戻した判定の数
+
+    /**
+     * @brief 完了した読み戻しを発行順に待たずに回収する
+     */
+    void collectReadbacks();
+
+    /**
+     * @brief ビューポートの大きさに合わせて深度のコピーとピラミッドのテクスチャを作り直す
+     */
+    void resizeDepthPyramid(int width, int height);
+
+    /**
+     * @brief 深度バッファをコピーし、ピラミッドの各段を作る
+     */
+    void buildDepthPyramid(const GLint viewport[4]);
+};
+
+} // namespace claude_gl
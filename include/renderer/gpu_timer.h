@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <glad/gl.h>
+
+namespace claude_gl {
+
+/**
+ * @brief GL_TIME_ELAPSED クエリでGPUの処理時間を計測するクラス
+ *
+ * 複数のクエリを順番に使い回し、結果は数フレーム後に取得できたものから集計します
+ * （結果を待ってCPUが停止することはない）。未完了のクエリで埋まっている間の begin() は
+ * 計測を行いません。
+ */
+class GpuTimer {
+public:
+    /**
+     * @brief コンストラクタ（クエリを生成する）
+     */
+    GpuTimer();
+
+    /**
+     * @brief デストラクタ
+     */
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    /**
+     * @brief 計測を開始する（完了済みのクエリの結果もここで回収する）
+     */
+    void begin();
+
+    /**
+     * @brief 計測を終了する
+     */
+    void end();
+
+    /**
+     * @brief 回収済みの計測結果の平均を取得する
+     * @return 1回あたりのGPU時間（ミリ秒、結果がなければ0）
+     */
+    double getAverageMilliseconds() const;
+
+    /**
+     * @brief 回収済みの計測回数を取得する
+     * @return 計測回数
+     */
+    std::size_t getSampleCount() const;
+
+    /**
+     * @brief 集計をリセットする（計測中のクエリの結果は破棄する）
+     */
+    void reset();
+
+private:
+    static constexpr int QUERY_COUNT = 4;  ///< 同時に結果待ちにできるクエリ数
+
+    GLuint queries[QUERY_COUNT] = {};      ///< クエリオブジェクト
+    bool pending[QUERY_COUNT] = {};        ///< 結果待ちのクエリ
+    bool discard[QUERY_COUNT] = {};        ///< reset() 前に発行した結果を捨てるクエリ
+    int current = 0;                       ///< 次に使うクエリ
+    bool active = false;                   ///< begin() で計測を開始したか
+    double totalMilliseconds = 0.0;        ///< 回収した結果の合計
+    std::size_t sampleCount = 0;           ///< 回収した結果の数
+
+    /**
+     * @brief 結果が出ているクエリを待たずに回収する
+     */
+    void collect();
+};
+
+} // namespace claude_gl
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+#include "stream_buffer.h"
+#include "uniform_blocks.h"
+
+namespace claude_gl {
+
+class GpuCuller;
+
+/**
+ * @brief 間接描画のコマンドと描画ごとのデータを毎フレーム書き込むバッファ（GL 4.3 以上）
+ *
+ * 描画コマンド（DrawElementsIndirectCommand）を GL_DRAW_INDIRECT_BUFFER に並べ、
+ * glMultiDrawElementsIndirect 1回で実行します。変換行列とマテリアルは描画ごとのデータとして
+ * SSBO（DRAW_DATA_BINDING）に同じ順で並べ、頂点シェーダーが gl_DrawIDARB で読みます
+ * （indirect.vs）。コマンドとデータは1つの StreamBuffer に置き、GPUが読み終えた領域だけを
+ * 再利用します。
+ *
+ * setCuller() で GpuCuller を設定すると、描画の前にコンピュートシェーダーで視錐台と
+ * 遮蔽のカリングを行い、残った描画だけを詰めたコマンドで実行します（CPUは可視判定をしない）。
+ *
+ * 使えるかどうかは isSupported() で確認し、使えない場合（GL 3.3 のコンテキストなど）は
+ * 呼び出し側が従来の描画に切り替えます。
+ */
+class IndirectDrawBuffer {
+public:
+    /**
+     * @brief 描画コマンド（glMultiDrawElementsIndirect が読むレイアウト）
+     */
+    struct Command {
+        GLuint count = 0;          ///< インデックス数
+        GLuint instanceCount = 1;  ///< インスタンス数
+        GLuint firstIndex = 0;     ///< EBO内の最初のインデックスの位置（要素数）
+        GLint baseVertex = 0;      ///< インデックスに加える頂点番号
+        GLuint baseInstance = 0;   ///< 最初のインスタンス番号
+    };
+    static_assert(sizeof(Command) == 20, "Command must match DrawElementsIndirectCommand");
+
+    /**
+     * @brief 描画ごとのデータ（indirect.vs の DrawData、std430）
+     *
+     * std430 でも mat3 の列は16バイトに揃えられるため、法線行列は vec4 の3列で保持します。
+     */
+    struct DrawData {
+        glm::mat4 model;            ///< ワールド変換行列
+        glm::vec4 normalMatrix[3];  ///< 法線行列の列（xyz）
+        MaterialUniforms material;  ///< マテリアルの定数
+    };
+    static_assert(sizeof(DrawData) == 144, "DrawData must match the std430 layout");
+
+    /**
+     * @brief GPUのカリングで判定する描画ごとの境界（cull.comp の Bounds、std430）
+     */
+    struct CullBounds {
+        glm::vec4 sphere = glm::vec4(0.0f);                  ///< モデル空間の境界球（w: 半径）
+        glm::vec4 cone = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);  ///< 法線の錐（w が1なら判定しない）
+    };
+
+    static_assert(sizeof(CullBounds) == 32, "CullBounds must match the std430 layout");
+
+    /**
+     * @brief allocate() で確保した1回の glMultiDrawElementsIndirect 分の書き込み先
+     */
+    struct Batch {
+        Command* commands = nullptr;   ///< 描画コマンドの書き込み先
+        DrawData* draws = nullptr;     ///< 描画ごとのデータの書き込み先
+        CullBounds* bounds = nullptr;  ///< カリングで判定する境界の書き込み先
+        std::size_t count = 0;         ///< 描画数（0は確保できなかった）
+        GLintptr commandOffset = 0;    ///< バッファ内の描画コマンドの位置
+        GLintptr drawOffset = 0;       ///< バッファ内の描画ごとのデータの位置
+        GLintptr boundsOffset = 0;     ///< バッファ内の境界の位置
+        int culledBatch = -1;          ///< GpuCuller::cull() の番号（-1はカリングしていない）
+    };
+
+    /**
+     * @brief 1フレーム分の量
+     */
+    struct Stats {
+        std::size_t batches = 0;  ///< glMultiDrawElementsIndirect の呼び出し数
+        std::size_t draws = 0;    ///< 書き込んだ描画コマンド数（GPUのカリングの前）
+    };
+
+    /**
+     * @brief 描画ごとのデータのSSBOのバインディングポイント
+     */
+    static constexpr GLuint DRAW_DATA_BINDING = 0;
+
+    /**
+     * @brief コンストラクタ（バッファを生成する。isSupported() の場合のみ生成できる）
+     * @param maxDraws 1フレームで描画できる最大のコマンド数
+     * @param frameCount 領域の数（GPUが遅れて読むフレーム数より多くする）
+     */
+    explicit IndirectDrawBuffer(std::size_t maxDraws = 16384, std::size_t frameCount = 3);
+
+    /**
+     * @brief 現在のコンテキストで使えるか判定する
+     * @return glMultiDrawElementsIndirect・SSBO・gl_DrawIDARB が使える場合はtrue
+     */
+    static bool isSupported();
+
+    /**
+     * @brief 次の領域に切り替え、前フレームの量を確定させる
+     */
+    void beginFrame();
+
+    /**
+     * @brief 今フレームで使った領域にフェンスを置く（フレームの全描画の後に呼ぶ）
+     */
+    void endFrame();
+
+    /**
+     * @brief 描画コマンドと描画ごとのデータの書き込み先を確保する
+     * @param count 描画数
+     * @return 書き込み先（今フレームの残りに収まらない場合は count が0）
+     */
+    Batch allocate(std::size_t count);
+
+    /**
+     * @brief 書き込んだ内容をGPUへ見えるようにし、カリングを設定していれば実行する
+     *
+     * カリングはプログラムを切り替えるため、描画のプログラムを設定する前に呼びます。
+     * カリングは残った描画を atomicAdd の順に詰めるため、書き込んだ順で描く必要がある
+     * 半透明の描画（奥から手前）では cull を false にします。
+     *
+     * @param batch allocate() が返し、count 個すべて（境界を含む）を書き込んだもの
+     * @param cull 設定したカリングを使うか（false の場合は書き込んだ描画をすべて実行する）
+     */
+    void prepare(Batch& batch, bool cull = true);
+
+    /**
+     * @brief 書き込んだ描画をまとめて実行する（VAOとプログラムは呼び出し側が設定する）
+     * @param batch prepare() 済みのもの
+     */
+    void draw(const Batch& batch);
+
+    /**
+     * @brief 描画の前にGPUでカリングを行うか設定する
+     * @param culler beginFrame() 済みのカリング（nullptr の場合は書き込んだ描画をすべて実行する）
+     */
+    void setCuller(GpuCuller* culler);
+
+    /**
+     * @brief 直前のフレームの量を取得する
+     * @return 呼び出し数と描画数
+     */
+    const Stats& getFrameStats() const;
+
+    /**
+     * @brief バッファの領域の統計情報（ストールや一巡の回数）を取得する
+     * @return 生成からの累計
+     */
+    const StreamBuffer::Stats& getStreamStats() const;
+
+private:
+    StreamBuffer stream;          ///< 全フレームの描画コマンドとデータ
+    std::size_t alignment = 256;  ///< 描画ごとのデータのオフセットのアラインメント
+    std::size_t frameBytes = 0;   ///< 今フレームで確保したバイト数（アラインメントの隙間を含む）
+    GpuCuller* culler = nullptr;  ///< 描画の前に使うGPUのカリング
+    Stats frameStats;             ///< 集計中のフレームの量
+    Stats lastFrameStats;         ///< 直前のフレームの量
+
+    /**
+     * @brief SSBOの範囲のオフセットのアラインメントを取得する
+     */
+    static std::size_t queryAlignment();
+};
+
+} // namespace claude_gl
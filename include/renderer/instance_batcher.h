@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "instance_buffer.h"
+#include "model.h"
+#include "renderer/shader.h"
+
+namespace claude_gl {
+
+/**
+ * @brief フレームごとに投入されたインスタンスをモデル単位にまとめて描画するクラス
+ *
+ * 同じモデルへの投入は1つのバッチに連結され、描画時にバッチごとのインスタンスバッファへ
+ * 転送してメッシュごとに1回の glDrawElementsInstanced で描画します。
+ * バッチとバッファはフレームをまたいで再利用し、描画後は投入内容のみを空にします。
+ */
+class InstanceBatcher {
+public:
+    /**
+     * @brief 直近の描画の統計情報
+     */
+    struct Stats {
+        std::size_t batches = 0;    ///< 描画したバッチ数（モデル数）
+        std::size_t instances = 0;  ///< 描画したインスタンス数
+        std::size_t drawCalls = 0;  ///< 描画呼び出し数
+    };
+
+    /**
+     * @brief インスタンスを投入する（次の draw() で描画される）
+     * @param model 描画するモデル
+     * @param transforms インスタンスごとのモデル行列
+     * @param count インスタンス数
+     */
+    void submit(const std::shared_ptr<const Model>& model, const glm::mat4* transforms,
+                std::size_t count);
+
+    /**
+     * @brief 投入済みのインスタンスを描画し、投入内容を空にする
+     * @param shader インスタンスストリームを読むシェーダー（use() 済み）
+     */
+    void draw(const Shader& shader);
+
+    /**
+     * @brief 投入済みのインスタンスがあるか判定する
+     * @return 描画待ちのインスタンスがあればtrue
+     */
+    bool hasPending() const;
+
+    /**
+     * @brief すべてのバッチとバッファを解放する
+     */
+    void clear();
+
+    /**
+     * @brief 直近の draw() の統計情報を取得する
+     * @return バッチ数・インスタンス数・描画呼び出し数
+     */
+    const Stats& getStats() const;
+
+private:
+    /**
+     * @brief モデル1つ分のバッチ
+     */
+    struct Batch {
+        std::shared_ptr<const Model> model;       ///< 描画するモデル
+        std::vector<glm::mat4> transforms;        ///< このフレームに投入されたモデル行列
+        std::unique_ptr<InstanceBuffer> buffer;   ///< 転送先（フレームをまたいで再利用）
+    };
+
+    std::vector<Batch> batches;  ///< モデルごとのバッチ
+    Stats stats;                 ///< 直近の描画の統計情報
+};
+
+} // namespace claude_gl
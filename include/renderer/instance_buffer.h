@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+#include "stream_buffer.h"
+#include "vertex_layout.h"
+
+namespace claude_gl {
+
+/**
+ * @brief インスタンス描画用の変換行列を保持するVBO
+ *
+ * インスタンスごとのモデル行列と、TransformSystem で計算した法線行列（3x3部分の逆転置）を
+ * 1つのVBOに詰めて転送します。メッシュのVAOにインスタンスストリーム（ロケーション3〜9、
+ * 除数1）として接続し、glDrawElementsInstanced の1回の呼び出しで全インスタンスを描画します。
+ *
+ * 毎フレーム update() で内容を置き換えることを想定し、データは StreamBuffer の
+ * フレームごとの領域に書き込みます。永続マップが使える場合はマップ先へ直接書き、
+ * 作業領域を経由するコピーと glBufferSubData を省きます。
+ * 領域はフレームごとに変わるため、描画側は getOffset() の位置にストリームを接続します。
+ */
+class InstanceBuffer {
+public:
+    /**
+     * @brief 1インスタンス分のデータ（100バイト）
+     */
+    struct InstanceData {
+        glm::mat4 model;         ///< モデル行列
+        glm::mat3 normalMatrix;  ///< 法線行列（モデル行列の3x3部分の逆転置）
+    };
+
+    /**
+     * @brief インスタンスストリームの記述子（mat4 はロケーション3〜6、mat3 は7〜9）
+     */
+    using Stream = VertexStream<
+        InstanceData, InstanceAttribute<3, 4, offsetof(InstanceData, model)>,
+        InstanceAttribute<4, 4, offsetof(InstanceData, model) + sizeof(glm::vec4)>,
+        InstanceAttribute<5, 4, offsetof(InstanceData, model) + sizeof(glm::vec4) * 2>,
+        InstanceAttribute<6, 4, offsetof(InstanceData, model) + sizeof(glm::vec4) * 3>,
+        InstanceAttribute<7, 3, offsetof(InstanceData, normalMatrix)>,
+        InstanceAttribute<8, 3, offsetof(InstanceData, normalMatrix) + sizeof(glm::vec3)>,
+        InstanceAttribute<9, 3, offsetof(InstanceData, normalMatrix) + sizeof(glm::vec3) * 2>>;
+
+    /**
+     * @brief インスタンスストリームのみのレイアウト（メッシュのVAOに追加で設定する）
+     */
+    using Layout = VertexLayout<Stream>;
+
+    /**
+     * @brief コンストラクタ（VBOは最初の update() で確保する）
+     */
+    InstanceBuffer();
+
+    /**
+     * @brief デストラクタ
+     */
+    ~InstanceBuffer();
+
+    InstanceBuffer(const InstanceBuffer&) = delete;
+    InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+    /**
+     * @brief インスタンスの変換行列を設定してGPUへ転送する
+     *
+     * 1フレームに1回呼ぶ想定で、呼び出しごとに前回の領域にフェンスを置いて次の領域へ進みます。
+     *
+     * @param transforms インスタンスごとのモデル行列
+     * @param count インスタンス数
+     */
+    void update(const glm::mat4* transforms, std::size_t count);
+
+    /**
+     * @brief インスタンスの変換行列を設定してGPUへ転送する
+     * @param transforms インスタンスごとのモデル行列
+     */
+    void update(const std::vector<glm::mat4>& transforms);
+
+    /**
+     * @brief VBOのIDを取得する
+     * @return VBOのID
+     */
+    GLuint getBuffer() const;
+
+    /**
+     * @brief 直近の update() で書き込んだ位置を取得する
+     * @return VBOの先頭からのオフセット（バイト）
+     */
+    GLintptr getOffset() const;
+
+    /**
+     * @brief 直近の update() で設定したインスタンス数を取得する
+     * @return インスタンス数
+     */
+    std::size_t getCount() const;
+
+    /**
+     * @brief ストリーミング用のバッファの統計情報を取得する
+     * @return 未確保の場合は nullptr
+     */
+    const StreamBuffer::Stats* getStreamStats() const;
+
+private:
+    std::unique_ptr<StreamBuffer> stream;  ///< インスタンスストリームのVBO
+    GLintptr offset = 0;                   ///< 現在のデータの位置
+    std::size_t count = 0;                 ///< 現在のインスタンス数
+    std::size_t capacity = 0;              ///< 1領域に入るインスタンス数
+};
+
+} // namespace claude_gl
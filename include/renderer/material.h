@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "uniform_blocks.h"
+
+namespace claude_gl {
+
+/**
+ * @brief basic.fs のマテリアルのパラメータ
+ *
+ * 不透明度が1未満のマテリアルは半透明として、RenderQueue の半透明パスで奥から手前へ描画されます。
+ */
+struct Material {
+    glm::vec3 color = glm::vec3(0.3f, 0.3f, 0.35f);  ///< 物体の色（objectColor）
+    float ambientStrength = 0.3f;                    ///< 環境光の強さ
+    float specularStrength = 0.5f;                   ///< 鏡面反射の強さ
+    int shininess = 32;                              ///< 鏡面反射の鋭さ
+    float opacity = 1.0f;                            ///< 不透明度（1未満で半透明）
+
+    /**
+     * @brief 半透明か判定する
+     * @return 不透明度が1未満ならtrue
+     */
+    bool isTransparent() const {
+        return opacity < 1.0f;
+    }
+
+    /**
+     * @brief MaterialData ブロックの内容を作成する
+     * @return std140 のブロック
+     */
+    MaterialUniforms getUniforms() const;
+
+    bool operator==(const Material& other) const {
+        return color == other.color && ambientStrength == other.ambientStrength &&
+               specularStrength == other.specularStrength && shininess == other.shininess &&
+               opacity == other.opacity;
+    }
+
+    bool operator!=(const Material& other) const {
+        return !(*this == other);
+    }
+};
+
+} // namespace claude_gl
@@ -1,17 +1,30 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 #include <glad/gl.h>
 #include <glm/glm.hpp>
+#include "renderer/bounding_volume.h"
+#include "renderer/instance_buffer.h"
 #include "renderer/shader.h"
+#include "renderer/triangle_bvh.h"
+#include "renderer/vertex_layout.h"
 
 namespace claude_gl {
 
+class GeometryArena;
+struct QuantizedVertices;
+
 /**
  * @brief 3Dメッシュを管理するクラス
  * 
- * 頂点データとインデックスデータを保持し、OpenGLによる描画を処理します
+ * 頂点データとインデックスデータを保持し、OpenGLによる描画を処理します。
+ * 頂点数が65536以下のメッシュは16ビットインデックスで転送・描画します。
+ * GeometryArena に格納したメッシュは自身のVAO・VBO・EBOを持たず、共有のバッファの範囲を
+ * glDrawElementsBaseVertex で描画します。
  */
 class Mesh {
 public:
@@ -23,6 +36,74 @@ public:
         glm::vec3 normal;    ///< 法線ベクトル
         glm::vec2 texCoords; ///< テクスチャ座標
     };
+    
+    /**
+     * @brief 位置ストリームを分離した場合の、位置以外の属性
+     */
+    struct SurfaceAttributes {
+        glm::vec3 normal;    ///< 法線ベクトル
+        glm::vec2 texCoords; ///< テクスチャ座標
+    };
+    
+    /**
+     * @brief 詳細度（LOD）の段階
+     * 
+     * 全段階のインデックスは1つのEBOに連結し、頂点は全段階で共有します。
+     */
+    struct LodLevel {
+        std::uint32_t firstIndex = 0;  ///< 連結したインデックス配列内の先頭
+        std::uint32_t indexCount = 0;  ///< インデックス数
+        float error = 0.0f;            ///< 元の形状からの誤差（メッシュ空間の距離）
+    };
+    
+    /**
+     * @brief 三角形のクラスタ（メッシュレット）
+     * 
+     * 最も詳細な段階のインデックスを、近くの三角形が連続する範囲に並べ替えて分割したものです。
+     * 頂点とインデックスはメッシュと共有し、クラスタごとに描画するかを判定できます。
+     */
+    struct Meshlet {
+        std::uint32_t firstIndex = 0;          ///< 格納したインデックス内の先頭
+        std::uint32_t indexCount = 0;          ///< インデックス数
+        glm::vec3 center = glm::vec3(0.0f);    ///< 境界球の中心（メッシュ空間）
+        float radius = 0.0f;                   ///< 境界球の半径
+        glm::vec3 coneAxis = glm::vec3(0.0f);  ///< 三角形の法線を包む錐の軸
+        float coneCutoff = 1.0f;               ///< 錐の軸に対する視線の閾値（1: 向きで除かない）
+    };
+    
+    /**
+     * @brief 頂点バッファの構成
+     */
+    enum class StreamLayout {
+        Interleaved,    ///< 全属性を1つのVBOにインターリーブ（32バイト/頂点）
+        SplitPosition,  ///< 位置（12バイト/頂点）とその他の属性を別々のVBOに格納
+    };
+    
+    /**
+     * @brief Vertex をそのまま1つのVBOに格納するレイアウト
+     */
+    using InterleavedLayout = VertexLayout<
+        VertexStream<Vertex, FloatAttribute<0, 3, offsetof(Vertex, position)>,
+                     FloatAttribute<1, 3, offsetof(Vertex, normal)>,
+                     FloatAttribute<2, 2, offsetof(Vertex, texCoords)>>>;
+    
+    /**
+     * @brief 詰めて格納した位置のみのストリーム
+     */
+    using PositionStream = VertexStream<glm::vec3, FloatAttribute<0, 3, 0>>;
+    
+    /**
+     * @brief 位置ストリームと、法線・テクスチャ座標のストリームに分けたレイアウト
+     */
+    using SplitLayout = VertexLayout<
+        PositionStream,
+        VertexStream<SurfaceAttributes, FloatAttribute<1, 3, offsetof(SurfaceAttributes, normal)>,
+                     FloatAttribute<2, 2, offsetof(SurfaceAttributes, texCoords)>>>;
+    
+    /**
+     * @brief 深度のみのパスで使う位置だけのレイアウト
+     */
+    using PositionOnlyLayout = VertexLayout<PositionStream>;
 
     /**
      * @brief コンストラクタ
@@ -31,6 +112,47 @@ public:
      */
     Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
     
+    /**
+     * @brief メモリ上の配列から直接GPUへ転送するコンストラクタ
+     * 
+     * メッシュキャッシュのメモリマップ領域などをコピーせずにそのまま glBufferData に渡します。
+     * CPU側のコピーは保持しません。
+     * 
+     * @param vertices 頂点配列の先頭
+     * @param vertexCount 頂点数
+     * @param indices インデックス配列の先頭
+     * @param indexCount インデックス数
+     * @param streamLayout 頂点バッファの構成
+     */
+    Mesh(const Vertex* vertices, std::size_t vertexCount,
+         const unsigned int* indices, std::size_t indexCount,
+         StreamLayout streamLayout = StreamLayout::Interleaved);
+    
+    /**
+     * @brief 量子化した頂点データからメッシュを生成するコンストラクタ
+     * 
+     * CPU側のコピーは保持しません。描画時に復元用のuniformを設定します。
+     * 
+     * @param vertices 量子化した頂点データ
+     * @param indices インデックス配列の先頭
+     * @param indexCount インデックス数
+     */
+    Mesh(const QuantizedVertices& vertices, const unsigned int* indices, std::size_t indexCount);
+    
+    /**
+     * @brief 共有のバッファに格納するコンストラクタ
+     * 
+     * CPU側のコピーは保持しません。頂点数は GeometryArena::MAX_VERTICES_PER_MESH 以下とします。
+     * 
+     * @param arena 格納先（メッシュが破棄されるまで保持する）
+     * @param vertices 頂点配列の先頭
+     * @param vertexCount 頂点数
+     * @param indices インデックス配列の先頭
+     * @param indexCount インデックス数
+     */
+    Mesh(std::shared_ptr<GeometryArena> arena, const Vertex* vertices, std::size_t vertexCount,
+         const unsigned int* indices, std::size_t indexCount);
+    
     /**
      * @brief デストラクタ
      */
@@ -39,23 +161,237 @@ public:
     /**
      * @brief メッシュを描画
      * @param shader 使用するシェーダー
+     * @param level 詳細度の段階（0が最も詳細）
+     */
+    void draw(const Shader& shader, std::size_t level = 0) const;
+    
+    /**
+     * @brief 描画の準備として復元用のuniformを設定し、VAOをバインドする
+     * 
+     * 同じメッシュを続けて描画する場合は1回だけ呼び、drawElements() を繰り返します。
+     * 
+     * @param shader 使用中のシェーダー
+     */
+    void bind(const Shader& shader) const;
+    
+    /**
+     * @brief バインド済みのVAOで描画呼び出しのみを行う（bind() の後に呼ぶ）
+     * @param level 詳細度の段階（0が最も詳細）
+     */
+    void drawElements(std::size_t level = 0) const;
+    
+    /**
+     * @brief バインド済みのVAOで一部のクラスタのみを描画する（bind() の後に呼ぶ）
+     * 
+     * 連続する番号のクラスタは1つの範囲にまとめ、1回の glMultiDrawElements（共有のバッファでは
+     * glMultiDrawElementsBaseVertex）で描画します。
+     * 
+     * @param clusters 昇順に並べたクラスタの番号
+     * @param count クラスタ数
+     */
+    void drawClusters(const std::uint32_t* clusters, std::size_t count) const;
+    
+    /**
+     * @brief 位置のみを使って描画する（深度のみのパス・シャドウパス用）
+     * 
+     * 位置ストリームを分離したメッシュは位置のVBOだけを読むVAOで描画し、
+     * 頂点フェッチを12バイト/頂点に抑えます。
+     * 
+     * @param shader 使用するシェーダー（positionBias / positionScale を設定する）
+     */
+    void drawDepthOnly(const Shader& shader) const;
+    
+    /**
+     * @brief インスタンスバッファの全インスタンスを1回の描画呼び出しで描画する
+     * 
+     * 初回（またはバッファが変わった時）にインスタンスストリームをVAOへ接続します。
+     * シェーダーは instanced.vs のようにモデル行列と法線行列を頂点属性から読むものを使います。
+     * 
+     * @param shader 使用するシェーダー
+     * @param instances update() 済みのインスタンスバッファ
+     */
+    void drawInstanced(const Shader& shader, const InstanceBuffer& instances) const;
+    
+    /**
+     * @brief 格納先の共有のバッファを取得する
+     * @return 自身のバッファを持つメッシュは nullptr
      */
-    void draw(const Shader& shader) const;
+    GeometryArena* getArena() const;
+    
+    /**
+     * @brief 共有のバッファ内のハンドルを取得する（GeometryArena::drawMulti() 用）
+     * @param level 詳細度の段階（段階ごとにインデックスの範囲が異なるハンドルになる）
+     * @return ハンドル（getArena() が nullptr の場合は無効）
+     */
+    std::uint32_t getArenaHandle(std::size_t level = 0) const;
+    
+    /**
+     * @brief 詳細度の段階を設定する
+     * 
+     * コンストラクタに渡したインデックスは全段階を連結したものとし、その中の範囲を指定します。
+     * 設定しない場合は全インデックスを1つの段階として描画します。
+     * 
+     * @param levels 詳細なものから順に並べた段階（1つ以上、範囲はインデックス数以内）
+     */
+    void setLodLevels(const std::vector<LodLevel>& levels);
+    
+    /**
+     * @brief 詳細度の段階数を取得する
+     * @return 段階数（1以上）
+     */
+    std::size_t getLodCount() const;
+    
+    /**
+     * @brief 詳細度の段階を取得する
+     * @param level 段階（0が最も詳細）
+     * @return インデックスの範囲と誤差
+     */
+    const LodLevel& getLodLevel(std::size_t level) const;
+    
+    /**
+     * @brief 詳細度の段階の配列を取得する
+     * @return 詳細なものから順に並べた段階
+     */
+    const std::vector<LodLevel>& getLodLevels() const;
+    
+    /**
+     * @brief クラスタを設定する
+     * 
+     * クラスタは最も詳細な段階のインデックスを重ならずに分割した範囲とします。
+     * 
+     * @param meshlets 最も詳細な段階の範囲内のクラスタ（空で解除）
+     */
+    void setMeshlets(std::vector<Meshlet> meshlets);
+    
+    /**
+     * @brief クラスタ数を取得する
+     * @return クラスタ数（分割していない場合は0）
+     */
+    std::size_t getMeshletCount() const;
+    
+    /**
+     * @brief クラスタの配列を取得する
+     * @return インデックスの順に並べたクラスタ
+     */
+    const std::vector<Meshlet>& getMeshlets() const;
+    
+    /**
+     * @brief ローカル空間の境界を設定する
+     * @param bounds バウンディングボックスとバウンディング球
+     */
+    void setBounds(const BoundingVolume& bounds);
+    
+    /**
+     * @brief ローカル空間の境界を取得する
+     * @return バウンディングボックスとバウンディング球
+     */
+    const BoundingVolume& getBounds() const;
+    
+    /**
+     * @brief レイキャスト用の三角形BVHを設定する
+     * @param bvh メッシュのインデックス順で構築したBVH（nullptrで解除）
+     */
+    void setTriangleBvh(std::shared_ptr<const TriangleBvh> bvh);
+    
+    /**
+     * @brief レイキャスト用の三角形BVHを取得する
+     * @return BVH（構築していない場合はnullptr）
+     */
+    const TriangleBvh* getTriangleBvh() const;
+    
+    /**
+     * @brief 頂点配列の境界を計算する
+     * 
+     * 球の中心はボックスの中心とし、半径は中心から最も遠い頂点までの距離とします。
+     * 
+     * @param vertices 頂点配列の先頭
+     * @param vertexCount 頂点数
+     * @return バウンディングボックスとバウンディング球
+     */
+    static BoundingVolume computeBounds(const Vertex* vertices, std::size_t vertexCount);
+    
+    /**
+     * @brief 頂点数に応じたインデックス1つのバイト数を取得する
+     * @param vertexCount 頂点数
+     * @return 65536頂点以下なら2、それ以外は4
+     */
+    static std::size_t indexSizeFor(std::size_t vertexCount);
     
 private:
     // メッシュデータ
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
     
+    // ローカル空間の境界（カリング用）
+    BoundingVolume bounds;
+    
+    // ローカル空間の三角形BVH（レイキャスト用、任意）
+    std::shared_ptr<const TriangleBvh> triangleBvh;
+    
+    // 格納したインデックス数と型（GL_UNSIGNED_SHORT または GL_UNSIGNED_INT）
+    std::size_t indexCount;
+    GLenum indexType;
+    
+    // 詳細度の段階（格納したインデックス内の範囲）と、共有のバッファでの段階ごとのハンドル
+    std::vector<LodLevel> lodLevels;
+    std::vector<std::uint32_t> lodHandles;
+    
+    // 最も詳細な段階を分割したクラスタと、drawClusters() でまとめた範囲の作業領域
+    std::vector<Meshlet> meshlets;
+    mutable std::vector<std::uint32_t> rangeFirsts;
+    mutable std::vector<GLsizei> rangeCounts;
+    mutable std::vector<const void*> rangeOffsets;
+    
+    // 頂点の復元パラメータ（basic.vs の positionBias / positionScale / normalEncoding）
+    glm::vec3 positionBias;
+    glm::vec3 positionScale;
+    int normalEncoding;
+    
     // OpenGLオブジェクト
     unsigned int vao;
     unsigned int vbo;
     unsigned int ebo;
+    unsigned int positionVbo;  // 位置ストリームを分離した場合の位置のVBO
+    unsigned int depthVao;     // 位置ストリームのみを参照するVAO（分離しない場合は0）
+    
+    // VAOに接続済みのインスタンスストリームのVBOと、VBO内の先頭のオフセット（未接続なら0）
+    mutable unsigned int instanceVbo;
+    mutable GLintptr instanceOffset;
+    
+    // 格納先の共有のバッファとその中のハンドル（自身のバッファを持つ場合は nullptr）
+    std::shared_ptr<GeometryArena> arena;
+    std::uint32_t arenaHandle;
     
     /**
      * @brief OpenGLバッファの設定
+     * @param vertexData 頂点配列の先頭
+     * @param vertexCount 頂点数
+     * @param indexData インデックス配列の先頭
+     * @param streamLayout 頂点バッファの構成
+     */
+    void setupMesh(const Vertex* vertexData, std::size_t vertexCount,
+                   const unsigned int* indexData, StreamLayout streamLayout);
+    
+    /**
+     * @brief 量子化した頂点データでOpenGLバッファを設定
+     * @param vertexData 量子化した頂点データ
+     * @param indexData インデックス配列の先頭
+     */
+    void setupQuantizedMesh(const QuantizedVertices& vertexData, const unsigned int* indexData);
+    
+    /**
+     * @brief EBOを生成し、頂点数に応じた型でインデックスを転送する（VAOをバインドした状態で呼ぶ）
+     * @param indexData インデックス配列の先頭
+     * @param vertexCount 頂点数
+     */
+    void setupIndexBuffer(const unsigned int* indexData, std::size_t vertexCount);
+    
+    /**
+     * @brief 段階のインデックスのEBO内の位置を取得する
+     * @param level 詳細度の段階
+     * @return glDrawElements に渡すオフセット
      */
-    void setupMesh();
+    const void* getIndexPointer(std::size_t level) const;
 };
 
 } // namespace claude_gl
\ No newline at end of file
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "mesh.h"
+
+namespace claude_gl {
+
+class MappedFile;
+
+/**
+ * @brief インポート済みメッシュのバイナリキャッシュ
+ *
+ * 最終的な頂点・インデックス配列、バウンディングボックス、サブメッシュ表を
+ * glBufferData にそのまま渡せるレイアウトで保存します。
+ * インデックス配列はクラスタの順に並べ替え、詳細度の段階を連結したもので、段階表と
+ * クラスタ表もあわせて保存するため、読み込み時に簡略化や分割をやり直す必要はありません。
+ * 読み込みはファイルをメモリマップするだけで、解析やコピーは行いません。
+ *
+ * ファイルレイアウト（ネイティブエンディアン、各領域は16バイト境界）:
+ * ヘッダー | サブメッシュ表 | 頂点配列（Mesh::Vertex） | インデックス配列（uint32） |
+ * 詳細度の段階表（Mesh::LodLevel） | クラスタ表（Mesh::Meshlet）
+ *
+ * ソースの内容ハッシュ、インポーターのバージョン、読み込み設定のいずれかが
+ * 記録と異なるキャッシュは無効として扱います。
+ */
+class MeshCache {
+public:
+    /**
+     * @brief キャッシュファイル形式のバージョン（レイアウト変更時に更新する）
+     */
+    static constexpr std::uint32_t FORMAT_VERSION = 4;
+
+    /**
+     * @brief インポーターのバージョン（解析・溶接・最適化の結果が変わる変更時に更新する）
+     */
+    static constexpr std::uint32_t IMPORTER_VERSION = 1;
+
+    /**
+     * @brief サブメッシュ（1つの Mesh に対応する範囲）
+     */
+    struct Submesh {
+        std::uint32_t vertexOffset;   ///< 頂点配列内の開始位置
+        std::uint32_t vertexCount;    ///< 頂点数
+        std::uint32_t indexOffset;    ///< インデックス配列内の開始位置
+        std::uint32_t indexCount;     ///< インデックス数（サブメッシュ内の頂点番号、全段階の合計）
+        glm::vec3 boundsMin;          ///< バウンディングボックスの最小点
+        glm::vec3 boundsMax;          ///< バウンディングボックスの最大点
+        float boundsRadius;           ///< ボックス中心を中心とするバウンディング球の半径
+        std::uint32_t lodOffset;      ///< 段階表内の開始位置
+        std::uint32_t lodCount;       ///< 段階数（0: 簡略化していない）
+        std::uint32_t meshletOffset;  ///< クラスタ表内の開始位置
+        std::uint32_t meshletCount;   ///< クラスタ数（0: 分割していない）
+        std::uint32_t reserved;       ///< 予約（0）
+    };
+
+    /**
+     * @brief ソースファイルに対応するキャッシュファイルのパスを取得する
+     * @param sourcePath ソースファイル（OBJ）のパス
+     * @return ソースと同じディレクトリのキャッシュファイルパス
+     */
+    static std::string cachePathFor(const std::string& sourcePath);
+
+    /**
+     * @brief ソースファイルの内容ハッシュを計算する
+     * @param sourcePath ソースファイルのパス
+     * @return 64ビットのハッシュ値
+     * @throw std::runtime_error ファイルを開けない場合
+     */
+    static std::uint64_t hashFile(const std::string& sourcePath);
+
+    /**
+     * @brief メモリ上のデータのハッシュを計算する
+     * @param data データの先頭
+     * @param size バイト数
+     * @return 64ビットのハッシュ値
+     */
+    static std::uint64_t hashData(const void* data, std::size_t size);
+
+    /**
+     * @brief キャッシュファイルを書き出す
+     *
+     * 一時ファイルに書き出してから置き換えるため、書き込み途中のファイルは読まれません。
+     *
+     * @param cachePath キャッシュファイルのパス
+     * @param sourceHash ソースファイルの内容ハッシュ
+     * @param settingsKey 結果に影響する読み込み設定の識別値
+     * @param vertices 全サブメッシュの頂点配列
+     * @param indices 全サブメッシュのインデックス配列（段階を連結したもの）
+     * @param submeshes サブメッシュ表
+     * @param lodLevels 全サブメッシュの段階表（先頭はサブメッシュのインデックス範囲内の位置）
+     * @param meshlets 全サブメッシュのクラスタ表（先頭はサブメッシュのインデックス範囲内の位置）
+     * @return 成功した場合はtrue
+     */
+    static bool write(const std::string& cachePath, std::uint64_t sourceHash,
+                      std::uint32_t settingsKey, const std::vector<Mesh::Vertex>& vertices,
+                      const std::vector<unsigned int>& indices,
+                      const std::vector<Submesh>& submeshes,
+                      const std::vector<Mesh::LodLevel>& lodLevels,
+                      const std::vector<Mesh::Meshlet>& meshlets);
+
+    /**
+     * @brief キャッシュファイルをメモリマップして開く
+     * @param cachePath キャッシュファイルのパス
+     * @param sourceHash 現在のソースファイルの内容ハッシュ
+     * @param settingsKey 現在の読み込み設定の識別値
+     * @return 有効なキャッシュ、存在しないか無効な場合はnullptr
+     */
+    static std::unique_ptr<MeshCache> open(const std::string& cachePath, std::uint64_t sourceHash,
+                                           std::uint32_t settingsKey);
+
+    /**
+     * @brief デストラクタ（マップを解除する）
+     */
+    ~MeshCache();
+
+    MeshCache(const MeshCache&) = delete;
+    MeshCache& operator=(const MeshCache&) = delete;
+
+    /**
+     * @brief 頂点配列の先頭を取得する
+     * @return マップ領域内の頂点配列
+     */
+    const Mesh::Vertex* getVertices() const;
+
+    /**
+     * @brief インデックス配列の先頭を取得する
+     * @return マップ領域内のインデックス配列
+     */
+    const unsigned int* getIndices() const;
+
+    /**
+     * @brief サブメッシュ表を取得する
+     * @return マップ領域内のサブメッシュ表の先頭
+     */
+    const Submesh* getSubmeshes() const;
+
+    /**
+     * @brief 詳細度の段階表を取得する
+     * @return マップ領域内の段階表の先頭（Submesh::lodOffset から Submesh::lodCount 個）
+     */
+    const Mesh::LodLevel* getLodLevels() const;
+
+    /**
+     * @brief クラスタ表を取得する
+     * @return マップ領域内のクラスタ表の先頭（Submesh::meshletOffset から meshletCount 個）
+     */
+    const Mesh::Meshlet* getMeshlets() const;
+
+    /**
+     * @brief サブメッシュ数を取得する
+     * @return サブメッシュ数
+     */
+    std::size_t getSubmeshCount() const;
+
+    /**
+     * @brief 全体のバウンディングボックスの最小点を取得する
+     */
+    glm::vec3 getBoundsMin() const;
+
+    /**
+     * @brief 全体のバウンディングボックスの最大点を取得する
+     */
+    glm::vec3 getBoundsMax() const;
+
+    /**
+     * @brief キャッシュファイルのバイト数を取得する
+     */
+    std::size_t getFileSize() const;
+
+private:
+    struct Header;
+
+    std::unique_ptr<MappedFile> file;  ///< マップしたキャッシュファイル
+    const Header* header;              ///< マップ領域内のヘッダー
+
+    /**
+     * @brief コンストラクタ（open() からのみ生成する）
+     */
+    MeshCache(std::unique_ptr<MappedFile> file, const Header* header);
+};
+
+} // namespace claude_gl
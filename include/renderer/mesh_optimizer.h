@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "mesh.h"
+
+namespace claude_gl {
+
+/**
+ * @brief インデックス付きメッシュの描画効率を改善する最適化パス
+ *
+ * 読み込み後、Mesh::setupMesh に渡す前の頂点・インデックス配列に対して
+ * 以下の順で適用します。
+ * 1. 頂点キャッシュ最適化（Tipsify）: 変換後頂点キャッシュのヒット率を上げる三角形順序
+ * 2. オーバードロー最適化: キャッシュ効率を閾値内に保ったまま、外向きのクラスタを先に描く
+ * 3. 頂点フェッチ最適化: インデックスの参照順に頂点を並べ替え、メモリアクセスを局所化する
+ *
+ * 効果の確認用に、FIFOキャッシュのシミュレーションによるACMR/ATVRと、
+ * CPUラスタライズによるオーバードロー率の計測も提供します。
+ */
+class MeshOptimizer {
+public:
+    /**
+     * @brief 頂点キャッシュの評価結果
+     */
+    struct VertexCacheStats {
+        std::size_t vertexTransforms = 0;  ///< 頂点シェーダーの実行回数（キャッシュミス数）
+        float acmr = 0.0f;                 ///< 三角形あたりのキャッシュミス数（0.5〜3.0）
+        float atvr = 0.0f;                 ///< 頂点あたりの変換回数（1.0が最良）
+    };
+
+    /**
+     * @brief オーバードローの評価結果
+     */
+    struct OverdrawStats {
+        std::size_t pixelsCovered = 0;  ///< 覆われたピクセル数
+        std::size_t pixelsShaded = 0;   ///< 深度テストを通過したフラグメント数
+        float overdraw = 0.0f;          ///< シェーディング数 / 被覆ピクセル数（1.0が最良）
+    };
+
+    /**
+     * @brief 最適化全体の統計情報
+     */
+    struct Stats {
+        VertexCacheStats cacheBefore;    ///< 最適化前の頂点キャッシュ効率
+        VertexCacheStats cacheAfter;     ///< 最適化後の頂点キャッシュ効率
+        OverdrawStats overdrawBefore;    ///< 最適化前のオーバードロー
+        OverdrawStats overdrawAfter;     ///< 最適化後のオーバードロー
+        std::size_t clusterCount = 0;    ///< オーバードロー最適化で並べ替えたクラスタ数
+    };
+
+    /**
+     * @brief 既定の頂点キャッシュサイズ（最適化とシミュレーションの両方で使用）
+     */
+    static constexpr unsigned int DEFAULT_CACHE_SIZE = 16;
+
+    /**
+     * @brief 既定のオーバードロー最適化の閾値（許容するACMRの悪化率）
+     */
+    static constexpr float DEFAULT_OVERDRAW_THRESHOLD = 1.05f;
+
+    /**
+     * @brief すべての最適化を順に適用する
+     * @param vertices 頂点配列（並べ替えられる）
+     * @param indices 三角形リストのインデックス配列（並べ替えられる）
+     * @param cacheSize 想定する頂点キャッシュサイズ
+     * @param overdrawThreshold オーバードロー最適化で許容するACMRの悪化率
+     * @param analyzeOverdraw オーバードローを計測するかどうか（ラスタライズのため高コスト）
+     * @return 最適化前後の統計情報
+     */
+    static Stats optimize(std::vector<Mesh::Vertex>& vertices, std::vector<unsigned int>& indices,
+                          unsigned int cacheSize = DEFAULT_CACHE_SIZE,
+                          float overdrawThreshold = DEFAULT_OVERDRAW_THRESHOLD,
+                          bool analyzeOverdraw = true);
+
+    /**
+     * @brief 頂点キャッシュのヒット率が上がるよう三角形を並べ替える（Tipsify）
+     * @param indices 三角形リストのインデックス配列
+     * @param vertexCount 頂点数
+     * @param cacheSize 想定する頂点キャッシュサイズ
+     */
+    static void optimizeVertexCache(std::vector<unsigned int>& indices, std::size_t vertexCount,
+                                    unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+
+    /**
+     * @brief オーバードローが減るようクラスタ単位で三角形を並べ替える
+     *
+     * 頂点キャッシュ最適化済みの順序を、キャッシュ効率が閾値内に収まる範囲でクラスタに分割し、
+     * メッシュ中心から外向きのクラスタほど先に描画されるよう並べ替えます。
+     *
+     * @param indices 頂点キャッシュ最適化済みのインデックス配列
+     * @param vertices 頂点配列（位置のみ使用）
+     * @param cacheSize 想定する頂点キャッシュサイズ
+     * @param threshold 許容するACMRの悪化率（1.05なら5%まで）
+     * @return クラスタ数
+     */
+    static std::size_t optimizeOverdraw(std::vector<unsigned int>& indices,
+                                        const std::vector<Mesh::Vertex>& vertices,
+                                        unsigned int cacheSize = DEFAULT_CACHE_SIZE,
+                                        float threshold = DEFAULT_OVERDRAW_THRESHOLD);
+
+    /**
+     * @brief インデックスの参照順に頂点を並べ替え、インデックスを付け替える
+     *
+     * 参照されない頂点は削除されます。
+     *
+     * @param vertices 頂点配列
+     * @param indices インデックス配列
+     */
+    static void optimizeVertexFetch(std::vector<Mesh::Vertex>& vertices,
+                                    std::vector<unsigned int>& indices);
+
+    /**
+     * @brief FIFO頂点キャッシュをシミュレーションして効率を評価する
+     * @param indices 三角形リストのインデックス配列
+     * @param vertexCount 頂点数
+     * @param cacheSize キャッシュサイズ
+     * @return 評価結果
+     */
+    static VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices,
+                                               std::size_t vertexCount,
+                                               unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+
+    /**
+     * @brief CPUラスタライズでオーバードローを評価する
+     *
+     * バウンディングボックスに合わせた正射影で、各軸の正負6方向から
+     * 低解像度の深度バッファへインデックス順に描画して計測します。
+     *
+     * @param indices 三角形リストのインデックス配列
+     * @param vertices 頂点配列（位置のみ使用）
+     * @return 評価結果
+     */
+    static OverdrawStats analyzeOverdraw(const std::vector<unsigned int>& indices,
+                                         const std::vector<Mesh::Vertex>& vertices);
+};
+
+} // namespace claude_gl
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "bounding_volume.h"
+#include "mesh.h"
+
+namespace claude_gl {
+
+/**
+ * @brief 詳細度の段階を選ぶためのカメラの情報
+ */
+struct LodView {
+    glm::vec3 cameraPosition = glm::vec3(0.0f);  ///< ワールド空間のカメラ位置
+    float projectionScale = 0.0f;  ///< 距離1でワールドの長さ1が占めるピクセル数（0: 常に最も詳細）
+    float thresholdPixels = 1.0f;  ///< 許容する画面上の誤差（ピクセル）
+    float hysteresis = 0.25f;      ///< 粗い段階へ移る時に閾値から差し引く余裕（閾値に対する比）
+
+    /**
+     * @brief 透視投影の行列とビューポートの高さから作る
+     * @param cameraPosition ワールド空間のカメラ位置
+     * @param projection プロジェクション行列
+     * @param viewportHeight ビューポートの高さ（ピクセル）
+     * @param thresholdPixels 許容する画面上の誤差（ピクセル）
+     * @return カメラの情報
+     */
+    static LodView make(const glm::vec3& cameraPosition, const glm::mat4& projection,
+                        float viewportHeight, float thresholdPixels = 1.0f) {
+        LodView view;
+        view.cameraPosition = cameraPosition;
+        view.projectionScale = projection[1][1] * viewportHeight * 0.5f;
+        view.thresholdPixels = thresholdPixels;
+        return view;
+    }
+};
+
+/**
+ * @brief 二次誤差（Quadric Error Metrics）による辺の縮約でメッシュを簡略化するクラス
+ *
+ * 三角形の平面からの距離の2乗を頂点ごとの二次形式に蓄積し、誤差の小さい辺から順に
+ * 一方の頂点をもう一方の頂点へ寄せて三角形を減らします。頂点は新しく作らず元の頂点を
+ * 参照するため、全段階のインデックスが同じ頂点バッファを共有できます。
+ *
+ * - 属性: 寄せた頂点と寄せ先の法線・テクスチャ座標の差を重み付きで誤差に加えます。
+ *   位置が同じで属性が異なる頂点（テクスチャの継ぎ目など）は動かしません。
+ * - 境界: 開いた縁の頂点は縁に沿ってのみ縮約し、縁に垂直な平面の二次形式で形を保ちます。
+ * - 面の反転: 縮約で向きが大きく変わる三角形ができる場合は縮約しません。
+ *
+ * 1回の走査では互いに近傍を共有しない辺だけを縮約し、目標の三角形数か誤差の上限に
+ * 達するまで走査を繰り返します。GLを使わないため、コンテキストなしで動作を確認できます。
+ */
+class MeshSimplifier {
+public:
+    /**
+     * @brief 簡略化の設定
+     */
+    struct Options {
+        float normalWeight = 0.0f;    ///< 法線の差1あたりの誤差（メッシュ空間の距離）
+        float texCoordWeight = 0.0f;  ///< テクスチャ座標の差1あたりの誤差（メッシュ空間の距離）
+        bool lockBorder = false;      ///< 開いた縁の頂点を動かさないか
+    };
+
+    /**
+     * @brief 詳細度の段階の生成の設定
+     */
+    struct LodOptions {
+        unsigned int levelCount = 4;    ///< 元のメッシュを含む段階数の上限
+        float reduction = 0.5f;         ///< 前の段階に対する三角形数の比
+        float maxError = 0.0f;          ///< 1回の簡略化で許容する誤差（メッシュ空間の距離）
+        std::size_t minTriangles = 32;  ///< これより少ない三角形数の段階は作らない
+        Options simplify;               ///< 各段階の簡略化の設定
+    };
+
+    /**
+     * @brief メッシュを簡略化する
+     * @param vertices 頂点配列の先頭
+     * @param vertexCount 頂点数
+     * @param indices 三角形リストのインデックス配列の先頭
+     * @param indexCount インデックス数
+     * @param targetIndexCount 目標のインデックス数（達しなくても誤差の上限で止まる）
+     * @param maxError 許容する誤差（メッシュ空間の距離）
+     * @param output 簡略化したインデックスの出力先（元の頂点番号を参照する）
+     * @param options 簡略化の設定
+     * @return 縮約した辺の最大の誤差（メッシュ空間の距離）
+     */
+    static float simplify(const Mesh::Vertex* vertices, std::size_t vertexCount,
+                          const unsigned int* indices, std::size_t indexCount,
+                          std::size_t targetIndexCount, float maxError,
+                          std::vector<unsigned int>& output, const Options& options);
+
+    /**
+     * @brief 詳細度の段階を生成し、インデックス配列の末尾へ連結する
+     *
+     * 各段階は1つ前の段階から簡略化し、誤差は前の段階の誤差に加算して元の形状からの上限とします。
+     * 三角形数が十分に減らなくなった段階で打ち切ります。
+     *
+     * @param vertices 頂点配列の先頭
+     * @param vertexCount 頂点数
+     * @param indices 元のメッシュのインデックス（生成した段階を末尾に追加する）
+     * @param options 生成の設定
+     * @return 元のメッシュを含む段階（Mesh::setLodLevels() に渡す）
+     */
+    static std::vector<Mesh::LodLevel> buildLodChain(const Mesh::Vertex* vertices,
+                                                     std::size_t vertexCount,
+                                                     std::vector<unsigned int>& indices,
+                                                     const LodOptions& options);
+
+    /**
+     * @brief 画面上の誤差が閾値以下になる最も粗い段階を選ぶ
+     *
+     * 粗い段階へは閾値から hysteresis の比率だけ余裕がある場合にのみ移り、細かい段階へは
+     * すぐに戻すため、閾値の付近で段階が交互に切り替わりません。
+     *
+     * @param levels 詳細なものから順に並べた段階
+     * @param levelCount 段階数
+     * @param pixelsPerUnit メッシュ空間の長さ1が画面上で占めるピクセル数
+     * @param current 前回選んだ段階
+     * @param thresholdPixels 許容する画面上の誤差（ピクセル）
+     * @param hysteresis 粗い段階へ移る時に閾値から差し引く余裕（閾値に対する比）
+     * @return 選んだ段階
+     */
+    static std::size_t selectLod(const Mesh::LodLevel* levels, std::size_t levelCount,
+                                 float pixelsPerUnit, std::size_t current, float thresholdPixels,
+                                 float hysteresis);
+
+    /**
+     * @brief メッシュ空間の長さ1が画面上で占めるピクセル数を求める
+     *
+     * 境界球のカメラに最も近い点での値とし、カメラが球の中にある場合は非常に大きな値になります。
+     *
+     * @param view カメラの情報
+     * @param world ワールド変換行列
+     * @param bounds メッシュ空間の境界
+     * @return ピクセル数（view.projectionScale が0なら最も詳細な段階が選ばれる最大の値）
+     */
+    static float getPixelsPerUnit(const LodView& view, const glm::mat4& world,
+                                  const BoundingVolume& bounds);
+};
+
+} // namespace claude_gl
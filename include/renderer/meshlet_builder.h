@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "mesh.h"
+
+namespace claude_gl {
+
+/**
+ * @brief メッシュを頂点数と三角形数の上限があるクラスタ（メッシュレット）に分割するクラス
+ *
+ * 三角形を隣接する順にたどって貪欲にクラスタへ加え、クラスタごとに連続する範囲になるよう
+ * インデックスを並べ替えます。頂点は並べ替えず、クラスタはメッシュのインデックスの範囲として
+ * 同じ頂点・インデックスのバッファを共有します。
+ *
+ * - 次に加える三角形: クラスタに新しく加わる頂点が最も少ないものを選び、同じ数なら
+ *   クラスタの中心に近く、法線がクラスタの平均の向きに近いものを選びます。
+ * - 境界: クラスタの頂点を包む球と、三角形の法線を包む錐を求めます。錐は面の向きで
+ *   クラスタ全体が裏を向いているかの判定（ClusterCuller）に使います。
+ *
+ * GLを使わないため、コンテキストなしで動作を確認できます。
+ */
+class MeshletBuilder {
+public:
+    /**
+     * @brief 分割の設定
+     */
+    struct Options {
+        std::size_t maxVertices = 64;    ///< 1クラスタの最大頂点数
+        std::size_t maxTriangles = 124;  ///< 1クラスタの最大三角形数
+        float coneWeight = 0.5f;         ///< 法線の向きを揃える重み（0: 距離のみで選ぶ）
+    };
+
+    /**
+     * @brief 三角形をクラスタに分割し、インデックスをクラスタの順に並べ替える
+     * @param vertices 頂点配列の先頭
+     * @param vertexCount 頂点数
+     * @param indices 三角形リストのインデックス配列の先頭（クラスタの順に書き換える）
+     * @param indexCount インデックス数（3の倍数）
+     * @param options 分割の設定
+     * @return インデックスの順に並べたクラスタ（範囲は indices の先頭からの位置）
+     */
+    static std::vector<Mesh::Meshlet> build(const Mesh::Vertex* vertices, std::size_t vertexCount,
+                                            unsigned int* indices, std::size_t indexCount,
+                                            const Options& options);
+
+    /**
+     * @brief クラスタの境界球と法線の錐を求める
+     *
+     * 錐の閾値は「軸と法線の最小の内積」の正弦で、法線が軸から90度以上離れる場合は
+     * 向きで除かないことを表す1にします。
+     *
+     * @param vertices 頂点配列の先頭
+     * @param indices インデックス配列の先頭（meshlet の範囲を読む）
+     * @param meshlet firstIndex と indexCount を設定したクラスタ（境界を書き込む）
+     */
+    static void computeBounds(const Mesh::Vertex* vertices, const unsigned int* indices,
+                              Mesh::Meshlet& meshlet);
+};
+
+} // namespace claude_gl
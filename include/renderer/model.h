@@ -1,30 +1,125 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
 #include <glm/glm.hpp>
+#include "cluster_culler.h"
+#include "frustum_culler.h"
+#include "material.h"
 #include "mesh.h"
+#include "mesh_simplifier.h"
+#include "meshlet_builder.h"
+#include "render_queue.h"
+#include "vertex_quantizer.h"
 
 namespace claude_gl {
 
+class MeshCache;
+
+/**
+ * @brief モデル読み込みの設定
+ */
+struct ModelLoadOptions {
+    unsigned int importThreads = 0;  ///< OBJ解析スレッド数（0: ハードウェアスレッド数、1: 逐次）
+    bool weldVertices = true;        ///< 同一の頂点を溶接してインデックスで共有するか
+    bool optimizeMesh = false;       ///< 頂点キャッシュ・オーバードロー・頂点フェッチ最適化を行うか
+    bool useMeshCache = true;        ///< ソースと同じ場所のバイナリキャッシュを使用・作成するか
+    bool splitPositions = false;     ///< 位置を別VBOに分離するか（深度パス向け、非量子化時）
+    bool quantizeVertices = false;   ///< GPUへ転送する頂点を量子化レイアウトにするか
+    VertexFormat vertexFormat;       ///< 量子化する場合のレイアウト
+    bool buildTriangleBvh = false;   ///< レイキャスト用の三角形BVHを構築するか
+    unsigned int lodLevels = 1;      ///< 詳細度の段階数の上限（1: 簡略化しない）
+    float lodReduction = 0.5f;       ///< 前の段階に対する三角形数の比
+    float lodMaxError = 0.05f;       ///< 1段階の簡略化で許容する誤差（メッシュの半径に対する比）
+    bool buildMeshlets = false;      ///< 最も詳細な段階をクラスタに分割するか（ClusterCuller 用）
+    MeshletBuilder::Options meshletOptions;  ///< クラスタの頂点数と三角形数の上限
+    
+    // 格納先の共有のバッファ（nullptr の場合はメッシュごとにVAO・VBO・EBOを持つ。
+    // 量子化・位置の分離・65536頂点を超えるメッシュは常にメッシュごと）
+    std::shared_ptr<GeometryArena> geometryArena;
+};
+
 /**
  * @brief 3Dモデルを管理するクラス
  * 
- * OBJファイルを読み込み、メッシュデータとして管理します
+ * OBJファイルを読み込み、メッシュデータとして管理します。
+ * 
+ * 読み込みはファイルの解析・最適化・段階の生成などGLを使わない準備（prepare()）と、
+ * メッシュごとのGPUへの転送（uploadNext()）に分けて行えます。準備はワーカースレッドで行い、
+ * 転送はGLのコンテキストを持つスレッドで少しずつ行います（AssetLoader）。
  */
 class Model {
 public:
     /**
-     * @brief コンストラクタ
+     * @brief レイと三角形の交差結果
+     */
+    struct RayHit {
+        float distance = 0.0f;       ///< 始点からの距離
+        std::size_t mesh = 0;        ///< 交差したメッシュの番号
+        std::uint32_t triangle = 0;  ///< メッシュ内の三角形番号（インデックス / 3）
+    };
+    
+    /**
+     * @brief コンストラクタ（準備と全メッシュの転送を行う）
      * @param filepath OBJファイルのパス
+     * @param options 読み込みの設定
      */
-    explicit Model(const std::string& filepath);
+    explicit Model(const std::string& filepath,
+                   const ModelLoadOptions& options = ModelLoadOptions());
     
     /**
      * @brief デストラクタ
      */
-    ~Model() = default;
+    ~Model();
+    
+    /**
+     * @brief メッシュをGPUへ転送せずにモデルを準備する
+     * 
+     * GLを使わないため、ワーカースレッドから呼べます。転送を待つメッシュは uploadNext() で
+     * 転送し、全て転送するまではメッシュを持たないモデルとして扱います。
+     * 
+     * @param filepath OBJファイルのパス
+     * @param options 読み込みの設定（geometryArena は転送時にのみ使う）
+     * @return 準備したモデル
+     * @throws std::runtime_error ファイルの読み込みや解析に失敗した場合
+     */
+    static std::shared_ptr<Model> prepare(const std::string& filepath,
+                                          const ModelLoadOptions& options);
+    
+    /**
+     * @brief GPUへの転送を待つメッシュがあるか判定する
+     * @return 転送していないメッシュがあればtrue
+     */
+    bool hasPendingUploads() const;
+    
+    /**
+     * @brief GPUへの転送を待つメッシュ数を取得する
+     * @return メッシュ数
+     */
+    std::size_t getPendingUploadCount() const;
+    
+    /**
+     * @brief 次に転送するメッシュのバイト数を取得する
+     * @return 頂点とインデックスのバイト数（転送を待つメッシュがない場合は0）
+     */
+    std::size_t getNextUploadBytes() const;
+    
+    /**
+     * @brief 転送を待つ全メッシュのバイト数を取得する
+     * @return 頂点とインデックスのバイト数
+     */
+    std::size_t getPendingUploadBytes() const;
+    
+    /**
+     * @brief 転送を待つメッシュを1つGPUへ転送する（GLのコンテキストを持つスレッドで呼ぶ）
+     * 
+     * 最後のメッシュを転送すると、準備に使った頂点・インデックスとキャッシュを解放します。
+     * 
+     * @return 転送したバイト数（転送を待つメッシュがない場合は0）
+     */
+    std::size_t uploadNext();
     
     /**
      * @brief モデルを描画
@@ -32,6 +127,124 @@ public:
      */
     void draw(const Shader& shader) const;
     
+    /**
+     * @brief 画面上の誤差で詳細度の段階を選んでモデルを描画
+     * 
+     * 段階は前回の draw() で選んだ段階からヒステリシス付きで変えます。
+     * 
+     * @param shader 使用するシェーダー
+     * @param view カメラの情報
+     */
+    void draw(const Shader& shader, const LodView& view) const;
+    
+    /**
+     * @brief 位置のみを使ってモデルを描画（深度のみのパス・シャドウパス用）
+     * @param shader 使用するシェーダー
+     */
+    void drawDepthOnly(const Shader& shader) const;
+    
+    /**
+     * @brief インスタンスバッファの全インスタンスを描画（メッシュごとに1回の描画呼び出し）
+     * 
+     * インスタンスのモデル行列がそのままワールド変換になり、setModelMatrix() の行列は使いません。
+     * 
+     * @param shader インスタンスストリームを読むシェーダー（instanced.vs）
+     * @param instances update() 済みのインスタンスバッファ
+     * @return 描画呼び出し数
+     */
+    std::size_t drawInstanced(const Shader& shader, const InstanceBuffer& instances) const;
+    
+    /**
+     * @brief 全メッシュの境界をカリングに登録する
+     * @param culler 登録先
+     * @param world ワールド変換行列（インスタンスごとの行列）
+     * @return 最初のメッシュの登録番号（drawVisible() に渡す）
+     */
+    std::size_t addToCuller(FrustumCuller& culler, const glm::mat4& world) const;
+    
+    /**
+     * @brief カリングで視錐台と交差したメッシュのみ描画
+     * @param shader 使用するシェーダー
+     * @param culler cull() 済みのカリング
+     * @param firstIndex addToCuller() が返した登録番号
+     * @param world ワールド変換行列（addToCuller() に渡したもの）
+     * @param normalMatrix world の法線行列（TransformSystem で計算したもの）
+     */
+    void drawVisible(const Shader& shader, const FrustumCuller& culler, std::size_t firstIndex,
+                     const glm::mat4& world, const glm::mat3& normalMatrix) const;
+    
+    /**
+     * @brief カリングで視錐台と交差したメッシュを描画キューに投入する
+     * @param queue 投入先の描画キュー
+     * @param shader 使用するシェーダー
+     * @param material マテリアル（execute() まで有効であること）
+     * @param culler cull() 済みのカリング
+     * @param firstIndex addToCuller() が返した登録番号
+     * @param transform RenderQueue::addTransform() が返した変換行列の番号
+     * @param levels メッシュごとの詳細度の段階（nullptr の場合は最も詳細な段階）
+     * @param clusters 最も詳細な段階のクラスタを判定するカリング（beginInstance() 済み、
+     *                 nullptr の場合はクラスタごとに判定しない）
+     * @return 投入したコマンド数
+     */
+    std::size_t submitVisible(RenderQueue& queue, const Shader& shader, const Material& material,
+                              const FrustumCuller& culler, std::size_t firstIndex,
+                              std::uint32_t transform, const std::uint8_t* levels = nullptr,
+                              ClusterCuller* clusters = nullptr) const;
+    
+    /**
+     * @brief カリングせずに全メッシュを描画キューに投入する
+     * @param queue 投入先の描画キュー
+     * @param shader 使用するシェーダー
+     * @param material マテリアル（execute() まで有効であること）
+     * @param transform RenderQueue::addTransform() が返した変換行列の番号
+     * @param levels メッシュごとの詳細度の段階（nullptr の場合は最も詳細な段階）
+     * @param splitClusters 最も詳細な段階を全クラスタに分けて投入するか（GPUのカリング用）
+     * @return 投入したコマンド数
+     */
+    std::size_t submit(RenderQueue& queue, const Shader& shader, const Material& material,
+                       std::uint32_t transform, const std::uint8_t* levels = nullptr,
+                       bool splitClusters = false) const;
+    
+    /**
+     * @brief メッシュごとに画面上の誤差で詳細度の段階を選ぶ
+     * @param view カメラの情報
+     * @param world ワールド変換行列
+     * @param levels メッシュごとの段階（getMeshCount() 個、前回の段階を読んで更新する）
+     * @return 選んだ段階の三角形数の合計
+     */
+    std::size_t selectLods(const LodView& view, const glm::mat4& world,
+                           std::uint8_t* levels) const;
+    
+    /**
+     * @brief メッシュ数を取得する
+     * @return メッシュ数
+     */
+    std::size_t getMeshCount() const;
+    
+    /**
+     * @brief レイと最も近くで交差する三角形を求める（三角形BVHを持つメッシュのみ対象）
+     * @param origin ワールド空間のレイの始点
+     * @param direction ワールド空間のレイの方向（距離はこの長さを単位とする）
+     * @param maxDistance 検索する最大距離
+     * @param world モデルのワールド変換行列
+     * @param hit 交差結果の出力先（交差した場合のみ書き込む）
+     * @return 交差した場合はtrue
+     */
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                 const glm::mat4& world, RayHit& hit) const;
+    
+    /**
+     * @brief 三角形BVHを持つメッシュがあるか判定する
+     * @return ModelLoadOptions::buildTriangleBvh で読み込んだ場合はtrue
+     */
+    bool hasTriangleBvh() const;
+    
+    /**
+     * @brief 全メッシュを包むモデル空間の境界を取得する
+     * @return 境界（メッシュがない場合は原点の点）
+     */
+    BoundingVolume getBounds() const;
+    
     /**
      * @brief モデル行列の設定
      * @param model モデル変換行列
@@ -63,20 +276,179 @@ public:
     void rotateZ(float angle);
     
 private:
-    std::vector<std::shared_ptr<Mesh>> meshes;  ///< モデルを構成するメッシュ
-    glm::mat4 modelMatrix;                      ///< モデル変換行列
+    /**
+     * @brief GPUへの転送を待つメッシュ（GLを使わない準備の結果）
+     */
+    struct PreparedMesh {
+        const Mesh::Vertex* vertices = nullptr;          ///< 頂点（準備元の配列かマップ領域）
+        std::size_t vertexCount = 0;                     ///< 頂点数
+        const unsigned int* sourceIndices = nullptr;     ///< 準備元のインデックス
+        std::vector<unsigned int> indices;               ///< 並べ替え・連結したインデックス
+        std::size_t indexCount = 0;                      ///< 転送するインデックス数
+        QuantizedVertices quantized;                     ///< 量子化した頂点（しない場合は空）
+        BoundingVolume bounds;                           ///< メッシュの境界
+        std::vector<Mesh::LodLevel> lodLevels;           ///< 詳細度の段階
+        std::vector<Mesh::Meshlet> meshlets;             ///< クラスタ
+        std::shared_ptr<const TriangleBvh> triangleBvh;  ///< 三角形BVH
+        
+        /**
+         * @brief 転送するインデックスの先頭を取得する
+         * @return インデックス配列の先頭
+         */
+        const unsigned int* getIndices() const;
+        
+        /**
+         * @brief 転送する頂点とインデックスのバイト数を取得する
+         * @return バイト数
+         */
+        std::size_t getUploadBytes() const;
+    };
+    
+    std::vector<std::shared_ptr<Mesh>> meshes;        ///< モデルを構成するメッシュ
+    glm::mat4 modelMatrix;                            ///< モデル変換行列
+    ModelLoadOptions loadOptions;                     ///< 読み込みの設定
+    mutable std::vector<std::uint32_t> arenaHandles;  ///< 1回で描画する共有のバッファのメッシュ
+    mutable std::vector<std::uint8_t> drawLevels;     ///< draw() で選んだメッシュごとの段階
+    mutable std::vector<std::uint32_t> clusterIds;    ///< 投入するクラスタの番号
+    std::vector<PreparedMesh> pendingMeshes;          ///< GPUへの転送を待つメッシュ
+    std::size_t nextUpload = 0;                       ///< 次に転送する pendingMeshes の番号
+    std::vector<Mesh::Vertex> sourceVertices;         ///< OBJから生成した頂点
+    std::vector<unsigned int> sourceIndices;          ///< OBJから生成したインデックス
+    std::unique_ptr<MeshCache> sourceCache;           ///< 読み込んだキャッシュ（転送まで保持）
+    
+    /**
+     * @brief メッシュを持たないモデルを作成する（prepare() 用）
+     * @param options 読み込みの設定
+     */
+    explicit Model(const ModelLoadOptions& options);
+    
+    /**
+     * @brief メッシュを描画する（共有のバッファのメッシュは1回の描画呼び出しにまとめる）
+     * @param shader 変換行列を設定済みのシェーダー
+     * @param culler cull() 済みのカリング（nullptr の場合は全メッシュを描画）
+     * @param firstIndex addToCuller() が返した登録番号
+     * @param levels メッシュごとの詳細度の段階（nullptr の場合は最も詳細な段階）
+     */
+    void drawMeshes(const Shader& shader, const FrustumCuller* culler, std::size_t firstIndex,
+                    const std::uint8_t* levels = nullptr) const;
     
     /**
-     * @brief OBJファイルを読み込む
+     * @brief メッシュを描画キューに投入する
+     * @param queue 投入先の描画キュー
+     * @param mesh メッシュの番号
+     * @param shader 使用するシェーダー
+     * @param material マテリアル
+     * @param transform 変換行列の番号
+     * @param level 詳細度の段階
+     * @param clusters クラスタを判定するカリング（nullptr の場合は判定しない）
+     * @param splitClusters 判定せずに全クラスタに分けて投入するか
+     * @return 投入したコマンド数（全クラスタを除いた場合は0）
+     */
+    std::size_t submitMesh(RenderQueue& queue, std::size_t mesh, const Shader& shader,
+                           const Material& material, std::uint32_t transform, std::size_t level,
+                           ClusterCuller* clusters, bool splitClusters) const;
+    
+    /**
+     * @brief OBJファイルを読み込み、全メッシュをGPUへ転送する（失敗はログ出力する）
      * @param filepath OBJファイルのパス
      */
     void loadModel(const std::string& filepath);
     
     /**
-     * @brief OBJファイルからメッシュを処理
+     * @brief OBJファイルを読み込み、転送を待つメッシュを準備する
+     * 
+     * 有効なメッシュキャッシュがあればそれを使い、なければOBJを解析してキャッシュを書き出す
+     * 
      * @param filepath OBJファイルのパス
      */
-    void processObjFile(const std::string& filepath);
+    void prepareModel(const std::string& filepath);
+    
+    /**
+     * @brief メッシュキャッシュから転送を待つメッシュを準備する
+     * @param cachePath キャッシュファイルのパス
+     * @param sourceHash OBJファイルの内容ハッシュ
+     * @return 有効なキャッシュから読み込めた場合はtrue
+     */
+    bool prepareFromCache(const std::string& cachePath, std::uint64_t sourceHash);
+    
+    /**
+     * @brief 頂点・インデックス配列からGPUへ転送するメッシュを準備する（GLを使わない）
+     * 
+     * 量子化が有効な場合は量子化レイアウトに変換し、削減量と誤差をログ出力する。
+     * 三角形BVHが有効な場合は元の精度の頂点から構築する。
+     * クラスタの分割が有効な場合は元のインデックスをクラスタの順に並べ替え、
+     * 詳細度の段階が有効な場合は簡略化した段階のインデックスを連結する
+     * 
+     * @param vertices 頂点配列の先頭（転送まで有効であること）
+     * @param vertexCount 頂点数
+     * @param indices インデックス配列の先頭（転送まで有効であること）
+     * @param indexCount インデックス数
+     * @param bounds メッシュの境界
+     * @return 準備したメッシュ
+     */
+    PreparedMesh prepareMesh(const Mesh::Vertex* vertices, std::size_t vertexCount,
+                             const unsigned int* indices, std::size_t indexCount,
+                             const BoundingVolume& bounds) const;
+    
+    /**
+     * @brief 準備したメッシュの頂点を量子化し、三角形BVHを構築する（有効な場合）
+     * @param prepared 頂点・インデックス・段階を設定済みのメッシュ
+     * @param baseIndexCount 最も詳細な段階のインデックス数
+     */
+    void prepareVertices(PreparedMesh& prepared, std::size_t baseIndexCount) const;
+    
+    /**
+     * @brief 準備したメッシュからGPUメッシュを生成する
+     * @param prepared prepareMesh() の結果
+     * @return 生成したメッシュ
+     */
+    std::shared_ptr<Mesh> createMesh(const PreparedMesh& prepared) const;
+    
+    /**
+     * @brief 詳細度の段階を生成し、結果をログ出力する
+     * @param vertices 頂点配列の先頭
+     * @param vertexCount 頂点数
+     * @param indices 元のメッシュのインデックス（生成した段階を末尾に追加する）
+     * @param bounds メッシュの境界（誤差の上限と属性の重みの基準）
+     * @return 元のメッシュを含む段階
+     */
+    std::vector<Mesh::LodLevel> buildLods(const Mesh::Vertex* vertices, std::size_t vertexCount,
+                                          std::vector<unsigned int>& indices,
+                                          const BoundingVolume& bounds) const;
+    
+    /**
+     * @brief 三角形をクラスタに分割し、結果をログ出力する
+     * @param vertices 頂点配列の先頭
+     * @param vertexCount 頂点数
+     * @param indices 元のメッシュのインデックス（クラスタの順に並べ替える）
+     * @param indexCount インデックス数
+     * @return インデックスの順に並べたクラスタ
+     */
+    std::vector<Mesh::Meshlet> buildMeshlets(const Mesh::Vertex* vertices,
+                                             std::size_t vertexCount, unsigned int* indices,
+                                             std::size_t indexCount) const;
+    
+    /**
+     * @brief キャッシュの内容に影響する読み込み設定の識別値を取得する
+     * @return 識別値
+     */
+    std::uint32_t getCacheSettingsKey() const;
+    
+    /**
+     * @brief OBJファイルを解析して描画用の頂点データを生成する
+     * @param filepath OBJファイルのパス
+     * @param vertices 頂点の出力先
+     * @param indices インデックスの出力先
+     */
+    void processObjFile(const std::string& filepath, std::vector<Mesh::Vertex>& vertices,
+                        std::vector<unsigned int>& indices);
+    
+    /**
+     * @brief 頂点・インデックス配列に描画効率の最適化を適用し、結果をログ出力する
+     * @param vertices 頂点配列
+     * @param indices インデックス配列
+     */
+    void optimizeMesh(std::vector<Mesh::Vertex>& vertices, std::vector<unsigned int>& indices);
 };
 
 } // namespace claude_gl
\ No newline at end of file
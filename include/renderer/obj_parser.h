@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "mesh.h"
+
+namespace claude_gl {
+
+/**
+ * @brief 面の1頂点が参照する属性インデックス
+ *
+ * 0始まりに解決済みのインデックスです。旧実装と同じく、指定されていない属性は0（先頭の要素）、
+ * 0や範囲外を指す負のインデックスは-1になります
+ */
+struct ObjCorner {
+    int position;  ///< 位置インデックス
+    int texCoord;  ///< テクスチャ座標インデックス
+    int normal;    ///< 法線インデックス
+};
+
+/**
+ * @brief OBJファイルの解析結果
+ */
+struct ObjData {
+    std::vector<glm::vec3> positions;  ///< 頂点位置（v）
+    std::vector<glm::vec3> normals;    ///< 頂点法線（vn）
+    std::vector<glm::vec2> texCoords;  ///< テクスチャ座標（vt）
+    std::vector<ObjCorner> corners;    ///< 面の先頭3頂点（3つで1三角形）
+};
+
+/**
+ * @brief 高速なOBJパーサー
+ *
+ * ファイルをメモリマップし、行ごとの文字列やストリームを生成せずにその場で字句解析します。
+ * 数値は std::from_chars 相当の処理で直接変換するため、行ごとのヒープ確保は発生しません。
+ * 複数スレッドを指定すると、ファイルを行境界で区間に分割して並列に解析し、
+ * 要素数のプレフィックス和で全体のインデックスを確定します（結果は逐次解析と同一）。
+ */
+class ObjParser {
+public:
+    /**
+     * @brief 解析の統計情報
+     */
+    struct Stats {
+        std::size_t fileBytes = 0;      ///< 入力ファイルのバイト数
+        double parseSeconds = 0.0;      ///< 解析に要した時間（秒）
+        unsigned int threadCount = 1;   ///< 解析に使用したスレッド数
+        std::size_t chunkCount = 1;     ///< 分割した区間数
+
+        /**
+         * @brief 解析スループットを取得する
+         * @return MB/s（1MB = 2^20バイト）
+         */
+        double megabytesPerSecond() const;
+    };
+
+    /**
+     * @brief 頂点生成（溶接）の統計情報
+     */
+    struct BuildStats {
+        std::size_t cornerCount = 0;  ///< 面頂点数（溶接前の頂点数）
+        std::size_t vertexCount = 0;  ///< 生成した頂点数
+
+        /**
+         * @brief 溶接前のVBOバイト数を取得する
+         * @return バイト数
+         */
+        std::size_t unweldedBytes() const;
+
+        /**
+         * @brief 生成したVBOのバイト数を取得する
+         * @return バイト数
+         */
+        std::size_t vertexBytes() const;
+
+        /**
+         * @brief 頂点数の削減率を取得する
+         * @return 面頂点数 / 頂点数（頂点がない場合は1）
+         */
+        double reductionRatio() const;
+    };
+
+    /**
+     * @brief コンストラクタ
+     * @param threadCount 解析スレッド数（0はハードウェアスレッド数、1は逐次解析）
+     */
+    explicit ObjParser(unsigned int threadCount = 1);
+
+    /**
+     * @brief 解析スレッド数を設定する
+     * @param count 解析スレッド数（0はハードウェアスレッド数、1は逐次解析）
+     */
+    void setThreadCount(unsigned int count);
+
+    /**
+     * @brief OBJファイルを解析する
+     * @param filepath OBJファイルのパス
+     * @return 解析結果
+     * @throw std::runtime_error ファイルを開けない場合
+     */
+    ObjData parseFile(const std::string& filepath);
+
+    /**
+     * @brief メモリ上のOBJテキストを逐次解析する
+     * @param begin テキストの先頭
+     * @param end テキストの終端
+     * @param data 解析結果の追加先
+     */
+    static void parseText(const char* begin, const char* end, ObjData& data);
+
+    /**
+     * @brief 解析結果から描画用の頂点とインデックスを生成する
+     *
+     * 溶接を有効にすると、位置・テクスチャ座標・法線がすべて一致する面頂点を
+     * ハッシュで検出して1つの頂点にまとめ、インデックスで共有します。
+     * 無効の場合は面の頂点ごとに Mesh::Vertex を1つ生成します。
+     * インデックスが範囲外の場合、テクスチャ座標は(0, 0)、法線は(0, 0, 1)を使用します。
+     *
+     * @param data 解析結果
+     * @param vertices 頂点の出力先
+     * @param indices インデックスの出力先
+     * @param weld 同一の頂点を溶接するかどうか
+     * @return 頂点生成の統計情報
+     */
+    static BuildStats buildVertices(const ObjData& data, std::vector<Mesh::Vertex>& vertices,
+                                    std::vector<unsigned int>& indices, bool weld = true);
+
+    /**
+     * @brief 直近の解析の統計情報を取得する
+     * @return 統計情報
+     */
+    const Stats& getStats() const;
+
+private:
+    unsigned int threadCount;  ///< 解析スレッド数
+    Stats stats;               ///< 直近の解析の統計情報
+};
+
+} // namespace claude_gl
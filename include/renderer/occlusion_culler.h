@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "bounding_volume.h"
+
+namespace claude_gl {
+
+class ThreadPool;
+
+/**
+ * @brief 遮蔽物として深度バッファに描く簡略化したメッシュ（ローカル空間）
+ *
+ * 描画用のメッシュより少ない三角形で、見た目の内側に収まる形（壁・床・柱など）にします。
+ * 三角形は反時計回りを表面とし、裏面は描きません。
+ */
+struct OccluderMesh {
+    std::vector<glm::vec3> positions;    ///< 頂点の位置
+    std::vector<std::uint32_t> indices;  ///< 三角形のインデックス（3つで1つ）
+
+    /**
+     * @brief ボックスの遮蔽物を作る（外向きの12三角形）
+     * @param box ローカル空間のボックス
+     * @return 遮蔽物のメッシュ
+     */
+    static OccluderMesh makeBox(const Aabb& box);
+};
+
+/**
+ * @brief CPUで遮蔽物を低解像度の深度バッファに描き、境界ボックスの遮蔽を判定するクラス
+ *
+ * Masked Software Occlusion Culling と同じく、深度バッファは 32x8 ピクセルのタイルごとに
+ * 「タイル全体の最も遠い深度」と「ビットマスクで示すピクセルの最も遠い深度」の2層だけを持ちます。
+ * 三角形はピクセルごとの深度を書かず、行ごとの範囲から作った32ビットのマスクと三角形の
+ * タイル内の最も遠い深度でタイルを更新するため、1回の演算で32ピクセルを処理します。
+ * マスクが埋まると2層目を1層目にまとめます。深度はどちらも保守的（実際以上に遠い）なので、
+ * 遮蔽されていると判定したものは確実に見えません。
+ *
+ * 三角形の変換とクリップは三角形の範囲ごとに、ラスタライズはタイルの行の帯ごとに
+ * ワーカースレッドで分担します（帯は重ならないため排他制御はなく、結果はスレッド数に依らない）。
+ * GLを使わないため、コンテキストなしで動作を確認できます。
+ *
+ * 使い方: beginFrame() → addOccluder()（手前のものから追加するほど効果が高い） → render()
+ * → isVisible() / testBoxes()
+ */
+class OcclusionCuller {
+public:
+    /**
+     * @brief 直近のフレームの統計情報
+     */
+    struct Stats {
+        std::size_t occluderTriangles = 0;    ///< 追加した遮蔽物の三角形数
+        std::size_t rasterizedTriangles = 0;  ///< クリップと裏面の除去の後に描いた三角形数
+        std::size_t tested = 0;               ///< 判定したボックス数
+        std::size_t occluded = 0;             ///< 遮蔽されていると判定したボックス数
+        double renderMilliseconds = 0.0;      ///< render() にかかった時間
+        double testMilliseconds = 0.0;        ///< testBoxes() にかかった時間の合計
+    };
+
+    static constexpr int TILE_WIDTH = 32;  ///< タイルの幅（マスクのビット数）
+    static constexpr int TILE_HEIGHT = 8;  ///< タイルの高さ（マスクの行数）
+
+    /**
+     * @brief コンストラクタ
+     * @param width 深度バッファの幅（TILE_WIDTH の倍数に切り上げる）
+     * @param height 深度バッファの高さ（TILE_HEIGHT の倍数に切り上げる）
+     * @param threadCount ワーカースレッド数（0: ハードウェアスレッド数、1: 呼び出し元のみ）
+     */
+    explicit OcclusionCuller(int width = 320, int height = 192, unsigned int threadCount = 0);
+
+    /**
+     * @brief デストラクタ
+     */
+    ~OcclusionCuller();
+
+    OcclusionCuller(const OcclusionCuller&) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+    /**
+     * @brief フレームを開始する（遮蔽物と統計情報を破棄する）
+     * @param viewProjection プロジェクション行列 × ビュー行列
+     */
+    void beginFrame(const glm::mat4& viewProjection);
+
+    /**
+     * @brief 遮蔽物を追加する
+     * @param mesh 遮蔽物のメッシュ（render() まで有効であること）
+     * @param world ワールド変換行列
+     */
+    void addOccluder(const OccluderMesh& mesh, const glm::mat4& world);
+
+    /**
+     * @brief 追加した遮蔽物を深度バッファに描く
+     */
+    void render();
+
+    /**
+     * @brief ワールド空間のボックスが見える可能性があるか判定する
+     * @param box ワールド空間のボックス
+     * @return 遮蔽されていると確定できない場合はtrue（近クリップ面に掛かる場合を含む）
+     */
+    bool isVisible(const Aabb& box) const;
+
+    /**
+     * @brief 複数のボックスをワーカースレッドで分担して判定する
+     * @param boxes ワールド空間のボックスの配列
+     * @param count ボックス数
+     * @param visibility 判定結果の出力先（見える可能性があれば1、count 個）
+     * @return 見える可能性があるボックス数
+     */
+    std::size_t testBoxes(const Aabb* boxes, std::size_t count, std::uint8_t* visibility);
+
+    /**
+     * @brief ピクセルの深度の上限を取得する（検証・可視化用）
+     * @param x ピクセルの列（左から）
+     * @param y ピクセルの行（下から）
+     * @return 保存している最も遠い深度（[0, 1]、遮蔽物がなければ1）
+     */
+    float getDepth(int x, int y) const;
+
+    /**
+     * @brief 深度バッファの幅を取得する
+     * @return 幅（ピクセル）
+     */
+    int getWidth() const;
+
+    /**
+     * @brief 深度バッファの高さを取得する
+     * @return 高さ（ピクセル）
+     */
+    int getHeight() const;
+
+    /**
+     * @brief 使用するスレッド数を取得する
+     * @return 呼び出し元を含むスレッド数
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * @brief 直近のフレームの統計情報を取得する
+     * @return 統計情報
+     */
+    const Stats& getStats() const;
+
+private:
+    /**
+     * @brief 32x8 ピクセルのタイル
+     */
+    struct Tile {
+        std::uint32_t mask[TILE_HEIGHT];  ///< 2層目に含まれるピクセル（行ごと、ビット i が列 i）
+        float farDepth;                   ///< タイル全体の最も遠い深度（1層目）
+        float maskDepth;                  ///< マスクのピクセルの最も遠い深度（2層目）
+    };
+
+    /**
+     * @brief 画面に投影した三角形
+     */
+    struct ScreenTriangle {
+        glm::vec2 vertices[3];  ///< 画面の座標（反時計回り）
+        glm::vec3 depthPlane;   ///< 深度の平面（depth = x * px + y * py + z）
+        float maxDepth;         ///< 頂点の最も遠い深度
+        int minX, maxX;         ///< 覆いうるピクセルの列の範囲
+        int minY, maxY;         ///< 覆いうるピクセルの行の範囲
+    };
+
+    /**
+     * @brief 追加された遮蔽物
+     */
+    struct Occluder {
+        const OccluderMesh* mesh;     ///< メッシュ
+        glm::mat4 world;              ///< ワールド変換行列
+        std::size_t firstTriangle;    ///< フレーム内の最初の三角形の番号
+    };
+
+    int width;                                          ///< 深度バッファの幅
+    int height;                                         ///< 深度バッファの高さ
+    int tilesX;                                         ///< 横のタイル数
+    int tilesY;                                         ///< 縦のタイル数
+    std::vector<Tile> tiles;                            ///< タイル（行優先）
+    std::unique_ptr<ThreadPool> pool;                   ///< ワーカースレッド（1スレッドならなし）
+    unsigned int threadCount;                           ///< 呼び出し元を含むスレッド数
+    glm::mat4 viewProjection = glm::mat4(1.0f);         ///< 今フレームの行列
+    std::vector<Occluder> occluders;                    ///< 今フレームの遮蔽物
+    std::size_t triangleCount = 0;                      ///< 今フレームの遮蔽物の三角形数
+    std::vector<std::vector<ScreenTriangle>> binnedTriangles;  ///< 変換の範囲ごとの三角形
+    Stats stats;                                        ///< 統計情報
+
+    /**
+     * @brief 関数を taskCount 回（番号 0..taskCount-1）ワーカースレッドで分担して呼ぶ
+     */
+    template <typename F>
+    void runTasks(std::size_t taskCount, F&& task);
+
+    /**
+     * @brief 三角形の範囲を変換・クリップして画面の三角形にする
+     */
+    void setupTriangles(std::size_t first, std::size_t last,
+                        std::vector<ScreenTriangle>& output) const;
+
+    /**
+     * @brief 画面の三角形をタイルの行の範囲に描く
+     */
+    void rasterize(const ScreenTriangle& triangle, int firstTileY, int lastTileY);
+
+    /**
+     * @brief 三角形の覆うピクセルと深度でタイルを更新する
+     */
+    static void updateTile(Tile& tile, const std::uint32_t coverage[TILE_HEIGHT], float depth);
+};
+
+} // namespace claude_gl
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "gl_state_cache.h"
+#include "indirect_draw_buffer.h"
+#include "material.h"
+#include "mesh.h"
+#include "render_sort.h"
+#include "renderer/shader.h"
+#include "uniform_ring_buffer.h"
+
+namespace claude_gl {
+
+/**
+ * @brief 描画コマンドをソートキーで並べ替えてから実行する描画キュー
+ *
+ * 描画はメッシュ・シェーダー・マテリアル・変換行列の番号だけを持つ小さなコマンドとして投入し、
+ * execute() で64ビットのソートキー（RenderSort）を基数ソートしてから順に実行します。
+ * 実行時は直前と異なる状態だけを設定するため、プログラム・VAO・uniform の切り替えは
+ * ソート後に隣り合うコマンドの間の変化分だけになります。
+ *
+ * 不透明なコマンドは状態ごとにまとめて手前から奥へ、半透明なコマンドはブレンドを有効にして
+ * 奥から手前へ描画します。固定機能の状態はパスごとの PipelineState のハンドルで参照し、
+ * GL呼び出しは GlStateCache を通します。シェーダー・マテリアル・メッシュの番号は
+ * フレームごとに振り直します。
+ *
+ * マテリアルの定数は execute() で UniformRingBuffer にまとめて積み、切り替えは
+ * MATERIAL_BLOCK_BINDING の範囲の変更だけで行います。
+ *
+ * GeometryArena に格納したメッシュはVAOを共有するため、ソートキーではメッシュの代わりに
+ * 共有のバッファで区別し、不透明パスでは奥行きを変換行列の原点で求めます（同じモデルの
+ * メッシュが隣り合う）。状態がすべて同じで隣り合うコマンドは glMultiDrawElementsBaseVertex の
+ * 1回の呼び出しにまとめます。
+ *
+ * execute() に IndirectDrawBuffer を渡し、シェーダーに setIndirectShader() で間接描画用の
+ * バリアントを登録している場合、同じ共有のバッファ・パス・シェーダーで隣り合うコマンドは
+ * 変換行列とマテリアルが異なっても glMultiDrawElementsIndirect 1回で描画します
+ * （変換行列とマテリアルは描画ごとのデータとしてSSBOに書く）。
+ */
+class RenderQueue {
+public:
+    /**
+     * @brief 直近の execute() の統計情報
+     */
+    struct Stats {
+        std::size_t commands = 0;              ///< 実行した描画コマンド数
+        std::size_t transparentCommands = 0;   ///< そのうち半透明のコマンド数
+        std::size_t sortPasses = 0;            ///< 基数ソートで並べ替えた桁の数
+        double sortMilliseconds = 0.0;         ///< キーの生成とソートにかかった時間
+        std::size_t pipelineChanges = 0;       ///< 固定機能の状態の切り替え数
+        std::size_t shaderChanges = 0;         ///< プログラムの切り替え数
+        std::size_t materialChanges = 0;       ///< マテリアルのUBOの範囲の切り替え数
+        std::size_t meshChanges = 0;           ///< メッシュ（VAOと復元用の uniform）の設定数
+        std::size_t transformChanges = 0;      ///< 変換行列の uniform の設定数
+        std::size_t unsortedStateChanges = 0;  ///< 投入順に実行した場合の状態の切り替え数
+        std::size_t drawCalls = 0;             ///< 描画呼び出し数
+        std::size_t multiDrawCommands = 0;     ///< まとめて描画したコマンド数（glMultiDraw*）
+        std::size_t indirectCommands = 0;      ///< そのうち間接描画で実行したコマンド数
+        std::size_t triangles = 0;             ///< 選んだ詳細度の段階の三角形数（GPUのカリング前）
+        std::size_t fullDetailTriangles = 0;   ///< 全コマンドが最も詳細な段階の場合の三角形数
+        std::size_t clusterCommands = 0;       ///< クラスタを指定して投入したコマンド数
+        std::size_t clusters = 0;              ///< そのコマンドで描画したクラスタ数
+
+        /**
+         * @brief 状態の切り替えの合計を取得する
+         * @return 固定機能・プログラム・マテリアル・メッシュ・変換行列の切り替え数の合計
+         */
+        std::size_t getStateChanges() const {
+            return pipelineChanges + shaderChanges + materialChanges + meshChanges +
+                   transformChanges;
+        }
+    };
+
+    /**
+     * @brief コンストラクタ（不透明・半透明パスの固定機能の状態を登録する）
+     */
+    RenderQueue();
+
+    /**
+     * @brief フレームの投入を開始する（前フレームのコマンドは破棄する）
+     * @param view ビュー行列（深度の計算に使う）
+     * @param nearPlane 近クリップ面までの距離
+     * @param farPlane 遠クリップ面までの距離
+     */
+    void begin(const glm::mat4& view, float nearPlane, float farPlane);
+
+    /**
+     * @brief 変換行列を登録する（同じモデルのメッシュで共有する）
+     * @param world ワールド変換行列
+     * @param normalMatrix world の法線行列
+     * @return submit() に渡す変換行列の番号
+     */
+    std::uint32_t addTransform(const glm::mat4& world, const glm::mat3& normalMatrix);
+
+    /**
+     * @brief 描画コマンドを投入する
+     *
+     * シェーダー・マテリアル・メッシュはアドレスで区別し、execute() まで有効である必要があります。
+     *
+     * クラスタを指定した場合は最も詳細な段階のそのクラスタだけを描画し、間接描画では
+     * クラスタごとに1つの描画コマンド（境界球と法線の錐を持つ）にします。
+     *
+     * @param mesh 描画するメッシュ
+     * @param shader 使用するシェーダー
+     * @param material マテリアル（不透明度でパスが決まる）
+     * @param transform addTransform() が返した番号
+     * @param level メッシュの詳細度の段階（0が最も詳細）
+     * @param clusters 描画するクラスタの昇順の番号（nullptr の場合は段階の全体、コピーする）
+     * @param clusterCount クラスタ数（clusters を指定する場合は1以上、level は0）
+     */
+    void submit(const Mesh& mesh, const Shader& shader, const Material& material,
+                std::uint32_t transform, std::size_t level = 0,
+                const std::uint32_t* clusters = nullptr, std::size_t clusterCount = 0);
+
+    /**
+     * @brief シェーダーの間接描画用のバリアントを登録する
+     *
+     * shader で投入された共有のバッファのメッシュは、間接描画する場合に indirectShader で
+     * 描画します。indirectShader は描画ごとのデータを gl_DrawIDARB で読むもの（indirect.vs）で、
+     * どちらも execute() まで有効である必要があります。
+     *
+     * @param shader submit() に渡すシェーダー
+     * @param indirectShader 間接描画に使うシェーダー
+     */
+    void setIndirectShader(const Shader& shader, const Shader& indirectShader);
+
+    /**
+     * @brief コマンドをソートして実行し、キューを空にする
+     *
+     * マテリアルの定数を uniforms に積んで flush() してから描画します。
+     * FrameData の範囲は呼び出し側が設定しておきます。
+     *
+     * @param uniforms フレームの uniform ブロックのリングバッファ
+     * @param indirect 間接描画のバッファ（nullptr の場合は間接描画を使わない）
+     */
+    void execute(UniformRingBuffer& uniforms, IndirectDrawBuffer* indirect = nullptr);
+
+    /**
+     * @brief 投入済みのコマンドを破棄する
+     */
+    void clear();
+
+    /**
+     * @brief パスの固定機能の状態を取得する
+     * @param pass 描画パス
+     * @return GlStateCache のハンドル
+     */
+    GlStateCache::PipelineHandle getPipeline(RenderPass pass) const;
+
+    /**
+     * @brief 投入済みのコマンド数を取得する
+     * @return コマンド数
+     */
+    std::size_t getCommandCount() const;
+
+    /**
+     * @brief 直近の execute() の統計情報を取得する
+     * @return 統計情報
+     */
+    const Stats& getStats() const;
+
+private:
+    /**
+     * @brief 描画コマンド
+     */
+    struct Command {
+        const Mesh* mesh;                       ///< 描画するメッシュ
+        const Shader* shader;                   ///< 使用するシェーダー
+        const Material* material;               ///< マテリアル
+        std::uint32_t transform;                ///< 変換行列の番号
+        float depth;                            ///< メッシュの中心のビュー空間の奥行き
+        GlStateCache::PipelineHandle pipeline;  ///< 固定機能の状態
+        std::uint32_t level;                    ///< 詳細度の段階
+        std::uint32_t firstCluster;             ///< clusterIds 内の描画するクラスタの先頭
+        std::uint32_t clusterCount;             ///< 描画するクラスタ数（0は段階の全体）
+    };
+
+    using IdMap = std::unordered_map<const void*, std::uint32_t>;
+    using ShaderMap = std::unordered_map<const Shader*, const Shader*>;
+
+    glm::vec4 depthRow = glm::vec4(0.0f, 0.0f, -1.0f, 0.0f);  ///< ビュー空間の奥行きを求める行
+    float nearPlane = 0.1f;                                    ///< 近クリップ面までの距離
+    float farPlane = 100.0f;                                   ///< 遠クリップ面までの距離
+    GlStateCache::PipelineHandle opaquePipeline;               ///< 不透明パスの状態
+    GlStateCache::PipelineHandle transparentPipeline;          ///< 半透明パスの状態
+
+    std::vector<Command> commands;                         ///< 投入されたコマンド
+    std::vector<RenderSort::Item> keys;                    ///< ソートキーとコマンドの番号
+    std::vector<RenderSort::Item> scratch;                 ///< 基数ソートの作業領域
+    std::vector<glm::mat4> worlds;                         ///< 登録された変換行列
+    std::vector<glm::mat3> normalMatrices;                 ///< 登録された法線行列
+    IdMap shaderIds;                                       ///< シェーダーのフレーム内の番号
+    IdMap materialIds;                                     ///< マテリアルのフレーム内の番号
+    IdMap meshIds;                                         ///< メッシュのフレーム内の番号
+    std::vector<std::uint32_t> commandMaterials;           ///< コマンドごとのマテリアルの番号
+    std::vector<UniformRingBuffer::Range> materialRanges;  ///< マテリアル番号ごとのUBOの範囲
+    std::vector<std::uint32_t> arenaHandles;               ///< まとめて描画するメッシュのハンドル
+    std::vector<std::uint32_t> clusterIds;                 ///< コマンドが描画するクラスタの番号
+    ShaderMap indirectShaders;                             ///< シェーダー -> 間接描画用のバリアント
+    Stats stats;                                           ///< 直近の execute() の統計情報
+
+    /**
+     * @brief アドレスにフレーム内の番号を振る（初めてのアドレスには次の番号）
+     */
+    static std::uint32_t getId(IdMap& ids, const void* object);
+
+    /**
+     * @brief メッシュの頂点の設定（VAOと復元用の uniform）を区別する値を取得する
+     * @return 共有のバッファに格納したメッシュはバッファのアドレス、それ以外はメッシュのアドレス
+     */
+    static const void* getGeometryKey(const Mesh* mesh);
+
+    /**
+     * @brief 2つのコマンドを1回の描画呼び出しにまとめられるか判定する
+     */
+    static bool canMerge(const Command& first, const Command& second);
+
+    /**
+     * @brief コマンドを間接描画する場合のシェーダーを取得する
+     * @return 共有のバッファのメッシュでバリアントが登録されていればそのシェーダー、
+     *         それ以外は nullptr
+     */
+    const Shader* getIndirectShader(const Command& command) const;
+
+    /**
+     * @brief 2つのコマンドを1回の間接描画にまとめられるか判定する
+     *        （変換行列とマテリアルは問わない）
+     */
+    bool canMergeIndirect(const Command& first, const Command& second) const;
+
+    /**
+     * @brief 投入順に実行した場合の状態の切り替え数を数える
+     */
+    std::size_t countUnsortedStateChanges() const;
+};
+
+} // namespace claude_gl
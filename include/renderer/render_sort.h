@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace claude_gl {
+
+/**
+ * @brief 描画パス（ソートキーの最上位に入り、この順に実行される）
+ */
+enum class RenderPass : std::uint8_t {
+    Opaque = 0,       ///< 不透明（手前から奥へ）
+    Transparent = 1,  ///< 半透明（奥から手前へ、ブレンドあり）
+};
+
+/**
+ * @brief 描画コマンドの64ビットのソートキーの生成と基数ソート
+ *
+ * キーの上位ビットから順に比較されるため、変更のコストが大きい状態ほど上位に置きます。
+ *
+ * - 不透明: パス(4) | シェーダー(12) | マテリアル(12) | メッシュ(16) | 深度(20)
+ * - 半透明: パス(4) | 反転した深度(20) | シェーダー(12) | マテリアル(12) | メッシュ(16)
+ *
+ * 不透明は状態の切り替えが最小になる順に並び、同じ状態の中では手前から奥へ描画します。
+ * 半透明は正しく合成するため奥から手前の順を優先します。
+ * 番号がビット数を超えた場合は下位ビットのみを使います（まとまりが悪くなるだけで順序は壊れない）。
+ */
+class RenderSort {
+public:
+    static constexpr unsigned PASS_BITS = 4;       ///< パスのビット数
+    static constexpr unsigned SHADER_BITS = 12;    ///< シェーダー番号のビット数
+    static constexpr unsigned MATERIAL_BITS = 12;  ///< マテリアル番号のビット数
+    static constexpr unsigned MESH_BITS = 16;      ///< メッシュ番号のビット数
+    static constexpr unsigned DEPTH_BITS = 20;     ///< 量子化した深度のビット数
+
+    /**
+     * @brief ソートする要素（キーと描画コマンドの番号）
+     */
+    struct Item {
+        std::uint64_t key = 0;      ///< ソートキー
+        std::uint32_t command = 0;  ///< 描画コマンドの番号
+    };
+
+    /**
+     * @brief ソートキーを生成する
+     * @param pass 描画パス
+     * @param shader シェーダー番号
+     * @param material マテリアル番号
+     * @param mesh メッシュ番号
+     * @param depth quantizeDepth() で量子化した深度（小さいほど手前）
+     * @return ソートキー
+     */
+    static std::uint64_t makeKey(RenderPass pass, std::uint32_t shader, std::uint32_t material,
+                                 std::uint32_t mesh, std::uint32_t depth);
+
+    /**
+     * @brief ソートキーからパスを取り出す
+     * @param key ソートキー
+     * @return 描画パス
+     */
+    static RenderPass getPass(std::uint64_t key);
+
+    /**
+     * @brief カメラからの距離を DEPTH_BITS ビットに量子化する
+     * @param depth ビュー空間での奥行き（カメラの前方が正）
+     * @param nearPlane 近クリップ面までの距離
+     * @param farPlane 遠クリップ面までの距離
+     * @return 量子化した深度（範囲外は端に丸める）
+     */
+    static std::uint32_t quantizeDepth(float depth, float nearPlane, float farPlane);
+
+    /**
+     * @brief キーの昇順に基数ソートする（同じキーは元の順を保つ）
+     *
+     * 11ビットずつ下位から並べ替え（最大6桁）、全要素で同じ値の桁は飛ばします。
+     * 要素が少ない場合は std::stable_sort で並べます。
+     *
+     * @param items ソートする要素（結果もここに格納される）
+     * @param scratch 作業領域（フレームをまたいで再利用すると確保が不要になる）
+     * @return 基数ソートで実際に並べ替えた桁の数（比較ソートの場合は0）
+     */
+    static unsigned sort(std::vector<Item>& items, std::vector<Item>& scratch);
+};
+
+} // namespace claude_gl
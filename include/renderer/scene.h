@@ -0,0 +1,281 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include "bounding_volume.h"
+#include "cluster_culler.h"
+#include "dynamic_bvh.h"
+#include "frustum_culler.h"
+#include "material.h"
+#include "model.h"
+#include "occlusion_culler.h"
+#include "render_queue.h"
+#include "transform_hierarchy.h"
+
+namespace claude_gl {
+
+/**
+ * @brief モデルのインスタンスを多数配置するシーン
+ *
+ * インスタンスはモデル（メッシュデータ）を共有し、それぞれワールド変換行列を持ちます。
+ * ワールド空間の境界は動的BVHで管理し、変換の変更は木の部分的な更新で反映するため、
+ * 視錐台カリングやピッキングのコストはインスタンス数が増えてもほぼ一定に保たれます。
+ */
+class Scene {
+public:
+    using InstanceId = std::uint32_t;
+    static constexpr InstanceId INVALID_INSTANCE = 0xFFFFFFFFu;  ///< 無効なインスタンス
+
+    /**
+     * @brief レイとの交差結果
+     */
+    struct RayHit {
+        InstanceId instance = INVALID_INSTANCE;  ///< 交差したインスタンス
+        float distance = 0.0f;                   ///< 始点からの距離
+        bool triangleHit = false;                ///< 三角形との交差か（falseなら境界との交差）
+        std::size_t mesh = 0;                    ///< 交差したメッシュ（三角形との交差のみ）
+        std::uint32_t triangle = 0;              ///< 交差した三角形（三角形との交差のみ）
+    };
+
+    /**
+     * @brief 直近の描画の統計情報
+     */
+    struct Stats {
+        std::size_t instanceCount = 0;     ///< シーン内のインスタンス数
+        std::size_t visibleInstances = 0;  ///< 視錐台と交差したインスタンス数
+        std::size_t nodesVisited = 0;      ///< 視錐台の検索で訪問したBVHノード数
+        std::size_t occludedInstances = 0; ///< 視錐台と交差したが遮蔽で除いたインスタンス数
+    };
+
+    /**
+     * @brief インスタンスを追加する
+     * @param model 描画するモデル（複数のインスタンスで共有できる）
+     * @param transform ワールド変換行列
+     * @return インスタンス番号
+     */
+    InstanceId addInstance(std::shared_ptr<const Model> model, const glm::mat4& transform);
+
+    /**
+     * @brief インスタンスを削除する（番号は以降の addInstance() で再利用される）
+     * @param instance インスタンス番号
+     */
+    void removeInstance(InstanceId instance);
+
+    /**
+     * @brief インスタンスのワールド変換行列を変更し、BVHを更新する
+     * @param instance インスタンス番号
+     * @param transform ワールド変換行列
+     */
+    void setTransform(InstanceId instance, const glm::mat4& transform);
+
+    /**
+     * @brief インスタンスのワールド変換行列を取得する
+     * @param instance インスタンス番号
+     * @return ワールド変換行列
+     */
+    const glm::mat4& getTransform(InstanceId instance) const;
+
+    /**
+     * @brief インスタンスのマテリアルを設定する
+     * @param instance インスタンス番号
+     * @param material マテリアル（不透明度が1未満なら半透明パスで描画される）
+     */
+    void setMaterial(InstanceId instance, const Material& material);
+
+    /**
+     * @brief インスタンスのマテリアルを取得する
+     * @param instance インスタンス番号
+     * @return マテリアル
+     */
+    const Material& getMaterial(InstanceId instance) const;
+
+    /**
+     * @brief インスタンスのワールド変換行列を階層のノードに追従させる
+     * @param instance インスタンス番号
+     * @param node 追従するノード（TransformHierarchy::INVALID_NODE で解除）
+     */
+    void attachNode(InstanceId instance, TransformHierarchy::NodeId node);
+
+    /**
+     * @brief インスタンスを遮蔽物にする
+     *
+     * 遮蔽のカリングを行う submit() で、視錐台と交差する遮蔽物のインスタンスを
+     * OcclusionCuller に描いてから他のインスタンスを判定する（遮蔽物自身は判定しない）
+     *
+     * @param instance インスタンス番号
+     * @param occluder 見た目の内側に収まる簡略化したメッシュ（nullptr で解除）
+     */
+    void setOccluder(InstanceId instance, std::shared_ptr<const OccluderMesh> occluder);
+
+    /**
+     * @brief 直近の update() でワールド行列が変わったノードの変換をインスタンスに反映する
+     * @param hierarchy attachNode() で指定したノードを持つ階層
+     * @return 変換を更新したインスタンス数
+     */
+    std::size_t syncTransforms(const TransformHierarchy& hierarchy);
+
+    /**
+     * @brief インスタンスのワールド空間の境界を取得する
+     * @param instance インスタンス番号
+     * @return ワールド空間の境界
+     */
+    const Aabb& getWorldBounds(InstanceId instance) const;
+
+    /**
+     * @brief インスタンス数を取得する
+     * @return インスタンス数
+     */
+    std::size_t getInstanceCount() const;
+
+    /**
+     * @brief BVH全体をSAHで作り直す
+     *
+     * 多数のインスタンスをまとめて追加した後や、部分的な更新が長く続いた後に呼ぶ
+     */
+    void rebuild();
+
+    /**
+     * @brief 視錐台と交差するインスタンスを求める
+     * @param viewProjection プロジェクション行列 × ビュー行列
+     * @param result インスタンス番号の出力先（追記する）
+     */
+    void queryFrustum(const glm::mat4& viewProjection, std::vector<InstanceId>& result) const;
+
+    /**
+     * @brief AABBと重なるインスタンスを求める
+     * @param box 検索範囲
+     * @param result インスタンス番号の出力先（追記する）
+     */
+    void queryAabb(const Aabb& box, std::vector<InstanceId>& result) const;
+
+    /**
+     * @brief レイと最も近くで交差するインスタンスを求める
+     *
+     * 三角形BVHを持つモデルは三角形と、持たないモデルはワールド空間の境界と判定する
+     *
+     * @param origin レイの始点
+     * @param direction レイの方向（距離はこの長さを単位とする）
+     * @param maxDistance 検索する最大距離
+     * @param hit 交差結果の出力先
+     * @return 交差した場合はtrue
+     */
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                 RayHit& hit) const;
+
+    /**
+     * @brief 視錐台と交差するインスタンスを描画する
+     *
+     * BVHでインスタンスを絞り込んだ後、インスタンス内のメッシュを culler で判定する
+     *
+     * @param shader 使用するシェーダー
+     * @param viewProjection プロジェクション行列 × ビュー行列
+     * @param culler メッシュ単位のカリングに使うカリング
+     */
+    void draw(const Shader& shader, const glm::mat4& viewProjection, FrustumCuller& culler);
+
+    /**
+     * @brief 視錐台と交差するインスタンスのメッシュを描画キューに投入する
+     *
+     * カリングは draw() と同じで、描画順と状態の設定は queue の execute() に任せる。
+     * インスタンスのマテリアルを参照するため、execute() まではインスタンスを変更しないこと
+     *
+     * @param queue 投入先の描画キュー（begin() 済み）
+     * @param shader 使用するシェーダー
+     * @param viewProjection プロジェクション行列 × ビュー行列
+     * @param culler メッシュ単位のカリングに使うカリング
+     * @param occlusion 遮蔽のカリング（nullptr の場合は行わない）
+     * @param lod 詳細度の段階を選ぶカメラの情報（nullptr の場合は最も詳細な段階）
+     * @param clusters 不透明なメッシュのクラスタを判定するカリング（beginFrame() 済み、
+     *                 nullptr の場合はメッシュ単位で描画する）
+     * @return 投入したコマンド数
+     */
+    std::size_t submit(RenderQueue& queue, const Shader& shader, const glm::mat4& viewProjection,
+                       FrustumCuller& culler, OcclusionCuller* occlusion = nullptr,
+                       const LodView* lod = nullptr, ClusterCuller* clusters = nullptr);
+
+    /**
+     * @brief カリングせずに全インスタンスのメッシュを描画キューに投入する
+     *
+     * 可視判定をGPU（GpuCuller）で行う場合に使う。統計情報の visibleInstances は
+     * インスタンス数と同じになる
+     *
+     * @param queue 投入先の描画キュー（begin() 済み）
+     * @param shader 使用するシェーダー
+     * @param lod 詳細度の段階を選ぶカメラの情報（nullptr の場合は最も詳細な段階）
+     * @param splitClusters 不透明なメッシュをクラスタごとの描画に分けるか（GPUで判定する場合）
+     * @return 投入したコマンド数
+     */
+    std::size_t submitAll(RenderQueue& queue, const Shader& shader, const LodView* lod = nullptr,
+                          bool splitClusters = false);
+
+    /**
+     * @brief BVHを取得する
+     * @return BVH
+     */
+    const DynamicBvh& getBvh() const;
+
+    /**
+     * @brief 直近の描画の統計情報を取得する
+     * @return 統計情報
+     */
+    const Stats& getStats() const;
+
+private:
+    /**
+     * @brief インスタンスの情報
+     */
+    struct Instance {
+        std::shared_ptr<const Model> model;     ///< 描画するモデル（削除済みならnullptr）
+        glm::mat4 transform = glm::mat4(1.0f);  ///< ワールド変換行列
+        Aabb localBounds;                       ///< モデル空間の境界
+        int leaf = DynamicBvh::NULL_NODE;       ///< BVHの葉
+        TransformHierarchy::NodeId node = TransformHierarchy::INVALID_NODE;  ///< 追従するノード
+        Material material;                      ///< マテリアル
+        std::shared_ptr<const OccluderMesh> occluder;  ///< 遮蔽物のメッシュ（なければnullptr）
+        std::vector<std::uint8_t> lodLevels;    ///< メッシュごとの直近の詳細度の段階
+    };
+
+    std::vector<Instance> instances;          ///< 全インスタンス（削除済みを含む）
+    std::vector<InstanceId> freeInstances;    ///< 再利用できるインスタンス番号
+    DynamicBvh bvh;                           ///< ワールド空間の境界の階層
+    std::vector<InstanceId> nodeInstances;    ///< ノードIDごとの追従するインスタンス
+
+    // 描画時の作業領域
+    std::vector<InstanceId> visibleInstances;
+    std::vector<std::size_t> firstCullerIndices;
+    std::vector<glm::mat4> visibleTransforms;
+    std::vector<glm::mat3> visibleNormalMatrices;
+    std::vector<std::pair<float, InstanceId>> occluderOrder;
+    std::vector<Aabb> occludeeBoxes;
+    std::vector<std::uint8_t> occludeeVisibility;
+    Stats stats;
+
+    /**
+     * @brief インスタンス番号を検証し、インスタンスを取得する
+     */
+    const Instance& getInstance(InstanceId instance) const;
+
+    /**
+     * @brief 視錐台と交差するインスタンスを求め、メッシュを判定して法線行列を計算する
+     */
+    void gatherVisible(const glm::mat4& viewProjection, FrustumCuller& culler,
+                       OcclusionCuller* occlusion = nullptr);
+
+    /**
+     * @brief インスタンスのメッシュごとに詳細度の段階を選ぶ
+     * @return メッシュごとの段階（lod が nullptr なら nullptr）
+     */
+    const std::uint8_t* selectLods(Instance& instance, const glm::mat4& world,
+                                   const LodView* lod);
+
+    /**
+     * @brief 視錐台と交差したインスタンスから遮蔽されているものを除く
+     */
+    void removeOccluded(const glm::mat4& viewProjection, OcclusionCuller& occlusion);
+};
+
+} // namespace claude_gl
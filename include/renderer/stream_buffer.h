@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <glad/gl.h>
+
+namespace claude_gl {
+
+/**
+ * @brief 毎フレーム書き換えるデータ用のGPUリングバッファ
+ *
+ * バッファを同じ大きさの領域（既定で3つ）に分け、フレームごとに次の領域から割り当てます。
+ * 領域を使い終えたフレームの最後に glFenceSync を置き、次にその領域を使う前に
+ * GPUが読み終えたことを確認します（終わっていなければ待ち、ストールとして数える）。
+ *
+ * GL 4.4 / ARB_buffer_storage が使える場合はバッファを永続的にコヒーレントでマップし、
+ * allocate() が返すポインタに書いたデータをそのままGPUが読みます（flush() は何もしない）。
+ * 使えない場合は作業領域に書き、flush() でフレームの最初にバッファを orphan してから
+ * glBufferSubData で転送します（1回のコピーが増えるが、暗黙の同期待ちは起きない）。
+ *
+ * 1フレームの割り当てが領域に収まらない場合は次の領域へはみ出し、
+ * 全領域を使い切る割り当ては例外になります。
+ */
+class StreamBuffer {
+public:
+    /**
+     * @brief 割り当てた範囲
+     */
+    struct Allocation {
+        void* data = nullptr;  ///< 書き込み先（今フレームの間有効）
+        GLintptr offset = 0;   ///< バッファの先頭からのオフセット
+        GLsizeiptr size = 0;   ///< 大きさ（バイト）
+    };
+
+    /**
+     * @brief 生成からの累計の統計情報
+     */
+    struct Stats {
+        std::size_t frames = 0;        ///< endFrame() の回数
+        std::size_t allocations = 0;   ///< 割り当て数
+        std::size_t bytes = 0;         ///< 割り当てたバイト数（アラインメントの隙間を除く）
+        std::size_t stalls = 0;        ///< フェンスを待った回数
+        double stallMilliseconds = 0;  ///< フェンスを待った時間の合計
+        std::size_t wraps = 0;         ///< 最後の領域から先頭の領域へ戻った回数
+        std::size_t overflows = 0;     ///< 1フレームの割り当てが次の領域へはみ出した回数
+    };
+
+    /**
+     * @brief コンストラクタ（バッファを確保する）
+     * @param regionSize 1領域の大きさ（バイト）
+     * @param regionCount 領域の数（GPUが遅れて読むフレーム数より多くする）
+     * @param allowPersistentMapping falseの場合は永続マップを使わない（比較用）
+     */
+    explicit StreamBuffer(std::size_t regionSize, std::size_t regionCount = 3,
+                          bool allowPersistentMapping = true);
+
+    /**
+     * @brief デストラクタ（GPUの読み込みを待たずに解放する）
+     */
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    /**
+     * @brief 次の領域に切り替える（GPUがまだ読んでいる場合は待つ）
+     */
+    void beginFrame();
+
+    /**
+     * @brief 今フレームの範囲を割り当てる
+     * @param size 大きさ（バイト）
+     * @param alignment オフセットのアラインメント（UBOは GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT）
+     * @return 割り当てた範囲
+     */
+    Allocation allocate(std::size_t size, std::size_t alignment = 16);
+
+    /**
+     * @brief 書き込んだデータをGPUから見えるようにする（描画の前に呼ぶ）
+     */
+    void flush();
+
+    /**
+     * @brief 今フレームで使った領域にフェンスを置く（フレームの全描画の後に呼ぶ）
+     */
+    void endFrame();
+
+    /**
+     * @brief バッファのIDを取得する
+     */
+    GLuint getBuffer() const;
+
+    /**
+     * @brief 1領域の大きさを取得する
+     */
+    std::size_t getRegionSize() const;
+
+    /**
+     * @brief 永続マップを使っているか判定する
+     * @return falseの場合は orphan と glBufferSubData で転送している
+     */
+    bool isPersistent() const;
+
+    /**
+     * @brief 生成からの累計の統計情報を取得する
+     */
+    const Stats& getStats() const;
+
+private:
+    GLuint buffer = 0;                   ///< バッファ
+    std::size_t regionSize;              ///< 1領域の大きさ
+    std::size_t regionCount;             ///< 領域の数
+    unsigned char* mapped = nullptr;     ///< 永続マップの先頭（使わない場合は nullptr）
+    std::vector<unsigned char> staging;  ///< 永続マップを使わない場合の書き込み先
+    std::vector<GLsync> fences;          ///< 領域ごとの、最後に使ったフレームのフェンス
+    std::size_t region = 0;              ///< 割り当て中の領域
+    std::size_t head = 0;                ///< 割り当て中の領域内の次の位置
+    std::size_t firstRegion = 0;         ///< 今フレームの最初の領域
+    std::size_t usedRegions = 1;         ///< 今フレームで使った領域の数
+    std::size_t flushedEnd = 0;          ///< 転送済みの終わり（永続マップを使わない場合）
+    bool orphaned = false;               ///< 今フレームで orphan したか（永続マップを使わない場合）
+    Stats stats;                         ///< 累計の統計情報
+
+    /**
+     * @brief 次の領域に進み、GPUが読み終えるまで待つ
+     */
+    void advanceRegion();
+};
+
+} // namespace claude_gl
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace claude_gl {
+
+/**
+ * @brief 親子関係を持つ変換（シーングラフ）を管理するクラス
+ *
+ * ノードのローカルの平行移動・回転・拡大縮小は要素ごとの配列（SoA）に格納し、
+ * ノードの並びは親が必ず子より前になる深さ優先の行きがけ順に保ちます。
+ * このため各ノードの子孫は連続した範囲になり、update() はローカルの変換が変更された
+ * ノードの部分木だけを先頭から順に更新します（変更のない部分木には触れない）。
+ * ローカル行列の合成とワールド行列の積は TransformSystem のSIMD実装を使います。
+ *
+ * ノードIDは並べ替えの影響を受けません。親子関係の変更や削除があった場合は
+ * 次の update() で並びを作り直します。
+ */
+class TransformHierarchy {
+public:
+    using NodeId = std::uint32_t;
+    static constexpr NodeId INVALID_NODE = 0xFFFFFFFFu;  ///< 無効なノード（親なしを表す）
+
+    /**
+     * @brief 直近の update() の統計情報
+     */
+    struct Stats {
+        std::size_t nodeCount = 0;       ///< ノード数
+        std::size_t dirtySubtrees = 0;   ///< 更新した部分木の数
+        std::size_t updatedNodes = 0;    ///< ワールド行列を更新したノード数
+        std::size_t composedLocals = 0;  ///< ローカル行列を合成したノード数
+        bool reordered = false;          ///< ノードの並びを作り直したか
+    };
+
+    /**
+     * @brief ノードを作成する（ローカルの変換は単位行列）
+     * @param parent 親のノード（INVALID_NODE でルート）
+     * @return 作成したノード
+     */
+    NodeId createNode(NodeId parent = INVALID_NODE);
+
+    /**
+     * @brief ノードとその子孫をすべて削除する
+     * @param node 削除するノード
+     */
+    void destroyNode(NodeId node);
+
+    /**
+     * @brief 親を変更する（ローカルの変換は保持し、ワールド行列は新しい親の下で計算し直す）
+     * @param node 対象のノード
+     * @param parent 新しい親（INVALID_NODE でルート）。自身の子孫は指定できない
+     */
+    void setParent(NodeId node, NodeId parent);
+
+    /**
+     * @brief 親を取得する
+     * @param node 対象のノード
+     * @return 親のノード（ルートなら INVALID_NODE）
+     */
+    NodeId getParent(NodeId node) const;
+
+    /**
+     * @brief ローカルの平行移動を設定する
+     */
+    void setTranslation(NodeId node, const glm::vec3& translation);
+
+    /**
+     * @brief ローカルの回転を設定する（正規化して格納する）
+     */
+    void setRotation(NodeId node, const glm::quat& rotation);
+
+    /**
+     * @brief ローカルの拡大縮小を設定する
+     */
+    void setScale(NodeId node, const glm::vec3& scale);
+
+    /**
+     * @brief ローカルの平行移動・回転・拡大縮小をまとめて設定する
+     */
+    void setLocalTransform(NodeId node, const glm::vec3& translation, const glm::quat& rotation,
+                           const glm::vec3& scale);
+
+    /**
+     * @brief ローカルの平行移動を取得する
+     */
+    const glm::vec3& getTranslation(NodeId node) const;
+
+    /**
+     * @brief ローカルの回転を取得する
+     */
+    const glm::quat& getRotation(NodeId node) const;
+
+    /**
+     * @brief ローカルの拡大縮小を取得する
+     */
+    const glm::vec3& getScale(NodeId node) const;
+
+    /**
+     * @brief ワールド行列を取得する（直近の update() の結果）
+     * @param node 対象のノード
+     * @return ワールド行列
+     */
+    const glm::mat4& getWorldMatrix(NodeId node) const;
+
+    /**
+     * @brief 変更されたノードの部分木のワールド行列を更新する
+     */
+    void update();
+
+    /**
+     * @brief 直近の update() でワールド行列が更新されたノードを取得する
+     * @return ノードの一覧（親が子より前）
+     */
+    const std::vector<NodeId>& getChangedNodes() const;
+
+    /**
+     * @brief ノード数を取得する
+     * @return 削除されていないノード数
+     */
+    std::size_t getNodeCount() const;
+
+    /**
+     * @brief 直近の update() の統計情報を取得する
+     * @return 統計情報
+     */
+    const Stats& getStats() const;
+
+private:
+    // 並び（親が子より前の行きがけ順）ごとの配列
+    std::vector<glm::vec3> translations;      ///< ローカルの平行移動
+    std::vector<glm::quat> rotations;         ///< ローカルの回転
+    std::vector<glm::vec3> scales;            ///< ローカルの拡大縮小
+    std::vector<glm::mat4> localMatrices;     ///< ローカル行列
+    std::vector<glm::mat4> worldMatrices;     ///< ワールド行列
+    std::vector<std::uint32_t> parentSlots;   ///< 親の位置（TransformSystem::NO_PARENT でルート）
+    std::vector<std::uint32_t> subtreeSizes;  ///< 自身を含む子孫の数
+    std::vector<std::uint8_t> localDirty;     ///< ローカルの変換が変更されたか
+    std::vector<NodeId> slotNodes;            ///< 位置のノードID
+
+    // ノードIDの管理
+    std::vector<std::uint32_t> nodeSlots;     ///< ノードIDの位置（削除済みは NO_PARENT）
+    std::vector<NodeId> nodeParents;          ///< ノードIDの親（並びの作り直しに使う）
+    std::vector<NodeId> freeNodes;            ///< 再利用できるノードID
+
+    std::vector<std::uint32_t> dirtySlots;    ///< ローカルの変換が変更された位置
+    std::vector<NodeId> changedNodes;         ///< 直近の update() で更新されたノード
+    bool orderDirty = false;                  ///< 並びを作り直す必要があるか
+    Stats stats;                              ///< 直近の update() の統計情報
+
+    /**
+     * @brief ノードIDを検証して位置を取得する（無効なら例外）
+     */
+    std::uint32_t getSlot(NodeId node) const;
+
+    /**
+     * @brief ローカルの変換が変更された位置を記録する
+     */
+    void markDirty(std::uint32_t slot);
+
+    /**
+     * @brief ノードIDの親子関係から行きがけ順の並びを作り直す（削除済みのノードは詰める）
+     */
+    void rebuildOrder();
+};
+
+} // namespace claude_gl
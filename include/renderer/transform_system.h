@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace claude_gl {
+
+/**
+ * @brief オブジェクトのローカル行列・ワールド行列・法線行列をまとめて計算するクラス
+ *
+ * 法線行列（ワールド行列の3x3部分の逆転置）は頂点シェーダーで頂点ごとに求めず、
+ * 描画前にオブジェクトごとに1回だけCPUで計算して uniform またはインスタンスストリームで渡します。
+ * 法線行列は4オブジェクトずつ成分ごとに並べ替えてSIMDで同時に計算し
+ * （SSE / NEON、それ以外はスカラー）、ワールド行列の積は列ごとにSIMDで計算します。
+ * 平行移動・回転・拡大縮小からの行列の合成も4要素ずつ同時に行います（TransformHierarchy 用）。
+ *
+ * 入出力はバイト単位のストライドを指定でき、InstanceBuffer::InstanceData のような
+ * 構造体の配列へ直接書き込めます。
+ */
+class TransformSystem {
+public:
+    static constexpr std::uint32_t NO_PARENT = 0xFFFFFFFFu;  ///< 親を持たないことを表す番号
+
+    /**
+     * @brief 親の行列とローカル行列の積をまとめて計算する（worlds[i] = parent * locals[i]）
+     * @param parent 親の行列
+     * @param locals ローカル行列の配列
+     * @param worlds ワールド行列の出力先（locals と同じ配列でもよい）
+     * @param count 行列数
+     */
+    static void computeWorldMatrices(const glm::mat4& parent, const glm::mat4* locals,
+                                     glm::mat4* worlds, std::size_t count);
+
+    /**
+     * @brief 親子関係のあるワールド行列を順に計算する
+     *
+     * [begin, end) の各 i について worlds[i] = worlds[parents[i]] * locals[i]
+     * （親がなければ locals[i]）を計算します。親は子より前に並んでいる必要があります。
+     *
+     * @param parents 親の番号（NO_PARENT は親なし）
+     * @param locals ローカル行列
+     * @param worlds ワールド行列（範囲外の親は計算済みであること）
+     * @param begin 計算する範囲の先頭
+     * @param end 計算する範囲の終端
+     */
+    static void computeHierarchyWorldMatrices(const std::uint32_t* parents,
+                                              const glm::mat4* locals, glm::mat4* worlds,
+                                              std::size_t begin, std::size_t end);
+
+    /**
+     * @brief 平行移動・回転・拡大縮小から行列をまとめて合成する（4個ずつSIMDで計算）
+     *
+     * 各 i について matrices[indices[i]] = T * R * S を計算します。
+     *
+     * @param translations 平行移動の配列
+     * @param rotations 回転（正規化済みのクォータニオン）の配列
+     * @param scales 拡大縮小の配列
+     * @param indices 合成する要素の番号
+     * @param count 番号の数
+     * @param matrices 出力先の行列の配列
+     */
+    static void composeMatrices(const glm::vec3* translations, const glm::quat* rotations,
+                                const glm::vec3* scales, const std::uint32_t* indices,
+                                std::size_t count, glm::mat4* matrices);
+
+    /**
+     * @brief 平行移動・回転・拡大縮小から1つの行列を合成する
+     * @param translation 平行移動
+     * @param rotation 回転（正規化済みのクォータニオン）
+     * @param scale 拡大縮小
+     * @return T * R * S
+     */
+    static glm::mat4 composeMatrix(const glm::vec3& translation, const glm::quat& rotation,
+                                   const glm::vec3& scale);
+
+    /**
+     * @brief ワールド行列の配列から法線行列をまとめて計算する
+     * @param worlds 先頭のワールド行列
+     * @param worldStride ワールド行列の間のバイト数
+     * @param normals 先頭の法線行列の出力先
+     * @param normalStride 法線行列の間のバイト数
+     * @param count 行列数
+     */
+    static void computeNormalMatrices(const glm::mat4* worlds, std::size_t worldStride,
+                                      glm::mat3* normals, std::size_t normalStride,
+                                      std::size_t count);
+
+    /**
+     * @brief 連続したワールド行列の配列から法線行列をまとめて計算する
+     * @param worlds ワールド行列の配列
+     * @param normals 法線行列の出力先
+     * @param count 行列数
+     */
+    static void computeNormalMatrices(const glm::mat4* worlds, glm::mat3* normals,
+                                      std::size_t count);
+
+    /**
+     * @brief 1つのワールド行列から法線行列を計算する
+     *
+     * 3x3部分の逆転置を余因子（列の外積）と行列式から求めます。
+     * 行列式が0の場合は余因子行列をそのまま返します（法線はシェーダーで正規化する）。
+     *
+     * @param world ワールド行列
+     * @return 法線行列
+     */
+    static glm::mat3 computeNormalMatrix(const glm::mat4& world);
+
+    /**
+     * @brief 計算に使用する命令セット名を取得する
+     * @return "SSE"、"NEON"、"Scalar" のいずれか
+     */
+    static const char* getInstructionSet();
+};
+
+} // namespace claude_gl
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace claude_gl {
+
+/**
+ * @brief メッシュの三角形に対するBVH（CPUでのレイキャスト・ピッキング用）
+ *
+ * ビン分割SAHで構築した二分木を32バイトのノード配列として保持し、
+ * 葉の三角形は最大4個を成分ごとの配列（SoA）にまとめたパケットとして格納します。
+ * 走査ではノードのボックス判定と4三角形の同時判定をSIMDで行います
+ * （SSE / NEON、それ以外はスカラー）。
+ *
+ * 三角形は両面として扱い、交差距離はレイの方向ベクトルの長さを単位とします。
+ */
+class TriangleBvh {
+public:
+    static constexpr std::size_t MAX_LEAF_TRIANGLES = 4;  ///< 葉1つ（パケット1つ）の最大三角形数
+
+    /**
+     * @brief 木のノード（32バイト）
+     *
+     * 内部ノードの子は leftFirst と leftFirst + 1 に隣接して配置する。
+     * 葉では leftFirst がパケット番号、triangleCount が三角形数（1〜4）
+     */
+    struct Node {
+        glm::vec3 boundsMin;          ///< 境界の最小点
+        std::uint32_t leftFirst;      ///< 左の子（内部ノード）またはパケット番号（葉）
+        glm::vec3 boundsMax;          ///< 境界の最大点
+        std::uint32_t triangleCount;  ///< 三角形数（内部ノードでは0）
+
+        bool isLeaf() const { return triangleCount > 0; }
+    };
+
+    /**
+     * @brief 4三角形分の交差判定用データ（頂点0と2辺をSoAで保持する）
+     *
+     * 空きレーンは辺が0の退化三角形で埋め、常に交差しないようにする
+     */
+    struct alignas(16) TrianglePacket {
+        float v0x[4], v0y[4], v0z[4];           ///< 頂点0
+        float edge1x[4], edge1y[4], edge1z[4];  ///< 頂点1 - 頂点0
+        float edge2x[4], edge2y[4], edge2z[4];  ///< 頂点2 - 頂点0
+        std::uint32_t triangle[4];              ///< 元の三角形番号（インデックス / 3）
+    };
+
+    /**
+     * @brief レイとの最も近い交差
+     */
+    struct Hit {
+        float distance = 0.0f;         ///< 始点からの距離
+        std::uint32_t triangle = 0;    ///< 三角形番号（インデックス / 3）
+        float u = 0.0f;                ///< 重心座標（頂点1の重み）
+        float v = 0.0f;                ///< 重心座標（頂点2の重み）
+    };
+
+    /**
+     * @brief 三角形からBVHを構築する
+     * @param positions 先頭頂点の位置
+     * @param positionStride 頂点間のバイト数（Mesh::Vertex の配列なら sizeof(Mesh::Vertex)）
+     * @param vertexCount 頂点数
+     * @param indices 三角形リストのインデックス
+     * @param indexCount インデックス数（3の倍数）
+     */
+    void build(const glm::vec3* positions, std::size_t positionStride, std::size_t vertexCount,
+               const unsigned int* indices, std::size_t indexCount);
+
+    /**
+     * @brief レイと最も近くで交差する三角形を求める
+     * @param origin レイの始点
+     * @param direction レイの方向（正規化不要）
+     * @param maxDistance 検索する最大距離
+     * @param hit 交差結果の出力先（交差した場合のみ書き込む）
+     * @return 交差した場合はtrue
+     */
+    bool intersect(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                   Hit& hit) const;
+
+    /**
+     * @brief レイが maxDistance までにいずれかの三角形と交差するか判定する（最初の交差で終了）
+     * @param origin レイの始点
+     * @param direction レイの方向（正規化不要）
+     * @param maxDistance 検索する最大距離
+     * @return 交差した場合はtrue
+     */
+    bool occluded(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const;
+
+    /**
+     * @brief 構築済みか判定する
+     * @return 三角形が1つ以上あればtrue
+     */
+    bool empty() const;
+
+    /**
+     * @brief 三角形数を取得する
+     * @return 三角形数
+     */
+    std::size_t getTriangleCount() const;
+
+    /**
+     * @brief ノード数を取得する
+     * @return ノード数
+     */
+    std::size_t getNodeCount() const;
+
+    /**
+     * @brief ノードとパケットが使用するメモリのバイト数を取得する
+     * @return バイト数
+     */
+    std::size_t getMemoryBytes() const;
+
+    /**
+     * @brief 走査が使用する命令セット名を取得する
+     * @return "SSE"、"NEON"、"Scalar" のいずれか
+     */
+    static const char* getInstructionSet();
+
+private:
+    /**
+     * @brief 構築中の三角形の情報
+     */
+    struct BuildTriangle {
+        glm::vec3 boundsMin;   ///< 境界の最小点
+        glm::vec3 boundsMax;   ///< 境界の最大点
+        glm::vec3 centroid;    ///< 境界の中心
+        std::uint32_t index;   ///< 三角形番号
+    };
+
+    std::vector<Node> nodes;               ///< ノード（0番が根）
+    std::vector<TrianglePacket> packets;   ///< 葉の三角形
+    std::size_t triangleCount = 0;         ///< 三角形数
+
+    /**
+     * @brief ノードの範囲を分割して子を作る（葉になるまで再帰する）
+     * @param nodeIndex 分割するノード（境界は設定済み）
+     * @param triangles 構築中の三角形（範囲内が並べ替えられる）
+     * @param begin 範囲の先頭
+     * @param end 範囲の終端
+     * @param depth ノードの深さ
+     * @param positions 頂点の位置（パケット作成用）
+     * @param positionStride 頂点間のバイト数
+     * @param indices インデックス
+     */
+    void subdivide(std::uint32_t nodeIndex, std::vector<BuildTriangle>& triangles,
+                   std::size_t begin, std::size_t end, int depth, const unsigned char* positions,
+                   std::size_t positionStride, const unsigned int* indices);
+};
+
+} // namespace claude_gl
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+namespace claude_gl {
+
+/**
+ * @brief フレームで共通の定数（シェーダーの FrameData ブロック、std140）
+ *
+ * std140 では vec3 が16バイトに揃えられるため、位置と色は vec4 で保持します。
+ */
+struct FrameUniforms {
+    glm::mat4 view;        ///< ビュー行列
+    glm::mat4 projection;  ///< 投影行列
+    glm::vec4 viewPos;     ///< カメラ位置（xyz）
+    glm::vec4 lightPos;    ///< ライト位置（xyz）
+    glm::vec4 lightColor;  ///< ライトの色（rgb）
+};
+static_assert(sizeof(FrameUniforms) == 176, "FrameUniforms must match the std140 layout");
+
+/**
+ * @brief マテリアルの定数（basic.fs の MaterialData ブロック、std140）
+ */
+struct MaterialUniforms {
+    glm::vec3 objectColor;   ///< 物体の色
+    float opacity;           ///< 不透明度（vec3 の後ろの4バイトに入る）
+    float ambientStrength;   ///< 環境光の強さ
+    float specularStrength;  ///< 鏡面反射の強さ
+    float shininess;         ///< 鏡面反射の鋭さ
+    float padding;           ///< ブロックの大きさを16バイトの倍数にする
+};
+static_assert(sizeof(MaterialUniforms) == 32, "MaterialUniforms must match the std140 layout");
+
+// uniform ブロックのバインディングポイント（全プログラムで共通）
+constexpr GLuint FRAME_BLOCK_BINDING = 0;     ///< FrameData
+constexpr GLuint MATERIAL_BLOCK_BINDING = 1;  ///< MaterialData
+
+/**
+ * @brief シェーダーのリンク時に自動で割り当てる uniform ブロック
+ */
+struct UniformBlockInfo {
+    const char* name;  ///< GLSL のブロック名
+    GLuint binding;    ///< バインディングポイント
+    std::size_t size;  ///< C++ 側の構造体の大きさ（GLSL 側はこれ以下であること）
+};
+
+/**
+ * @brief 既知の uniform ブロックの一覧（Shader が参照する）
+ */
+constexpr UniformBlockInfo UNIFORM_BLOCKS[] = {
+    {"FrameData", FRAME_BLOCK_BINDING, sizeof(FrameUniforms)},
+    {"MaterialData", MATERIAL_BLOCK_BINDING, sizeof(MaterialUniforms)},
+};
+
+} // namespace claude_gl
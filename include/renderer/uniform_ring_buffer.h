@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <glad/gl.h>
+#include "stream_buffer.h"
+
+namespace claude_gl {
+
+/**
+ * @brief フレームごとの uniform ブロックのデータを1つのUBOに詰めて転送するリングバッファ
+ *
+ * UBOの領域は StreamBuffer で管理し、フレームごとに次の領域へ書き込みます。
+ * push() はブロックを GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT で揃えて並べ、永続マップが
+ * 使える場合はマップ先へ直接、使えない場合は作業領域に書いて flush() でまとめて転送します。
+ * 描画では bind() で glBindBufferRange し、ブロックの切り替えは範囲の変更だけで済みます。
+ *
+ * 領域はGPUが読み終えたことをフェンスで確認してから再利用します。
+ * 1フレームの量が領域を超えた場合は次の領域へはみ出し、全領域を超える量は例外になります。
+ */
+class UniformRingBuffer {
+public:
+    /**
+     * @brief push() したブロックのUBO内での範囲
+     */
+    struct Range {
+        GLintptr offset = 0;  ///< UBOの先頭からのオフセット
+        GLsizeiptr size = 0;  ///< 大きさ（バイト）
+    };
+
+    /**
+     * @brief 1フレーム分の転送量
+     */
+    struct Stats {
+        std::size_t blocks = 0;   ///< push() したブロック数
+        std::size_t bytes = 0;    ///< 書き込んだバイト数（アラインメントの隙間を除く）
+    };
+
+    /**
+     * @brief コンストラクタ（UBOを生成する）
+     * @param frameCapacity 1フレームの領域の大きさ（バイト）
+     * @param frameCount 領域の数（GPUが遅れて読むフレーム数より多くする）
+     */
+    explicit UniformRingBuffer(std::size_t frameCapacity = 256 * 1024,
+                               std::size_t frameCount = 3);
+
+    /**
+     * @brief 次の領域に切り替え、前フレームの量を確定させる
+     */
+    void beginFrame();
+
+    /**
+     * @brief 今フレームで使った領域にフェンスを置く（フレームの全描画の後に呼ぶ）
+     */
+    void endFrame();
+
+    /**
+     * @brief ブロックを追加する（永続マップを使わない場合の転送は flush() で行う）
+     * @param data ブロックのデータ
+     * @param size 大きさ（バイト）
+     * @return UBO内の範囲
+     */
+    Range push(const void* data, std::size_t size);
+
+    /**
+     * @brief std140 の構造体を作業領域に追加する
+     * @param block ブロックのデータ
+     * @return UBO内の範囲
+     */
+    template <typename T>
+    Range push(const T& block) {
+        return push(&block, sizeof(T));
+    }
+
+    /**
+     * @brief 未転送のブロックをまとめて転送する（描画の前に呼ぶ）
+     */
+    void flush();
+
+    /**
+     * @brief 範囲をバインディングポイントに設定する
+     * @param binding バインディングポイント（FRAME_BLOCK_BINDING など）
+     * @param range push() が返した今フレームの範囲
+     */
+    void bind(GLuint binding, const Range& range);
+
+    /**
+     * @brief 1フレームの領域の大きさを取得する
+     * @return 大きさ（バイト）
+     */
+    std::size_t getFrameCapacity() const;
+
+    /**
+     * @brief 直前のフレームの量を取得する
+     * @return ブロック数とバイト数
+     */
+    const Stats& getFrameStats() const;
+
+    /**
+     * @brief UBOの領域の統計情報（ストールや一巡の回数）を取得する
+     * @return 生成からの累計
+     */
+    const StreamBuffer::Stats& getStreamStats() const;
+
+    /**
+     * @brief 永続マップで直接書き込んでいるか判定する
+     */
+    bool isPersistent() const;
+
+private:
+    StreamBuffer stream;          ///< 全フレームの領域を持つUBO
+    std::size_t alignment = 256;  ///< 範囲のオフセットのアラインメント
+    Stats frameStats;             ///< 集計中のフレームの量
+    Stats lastFrameStats;         ///< 直前のフレームの量
+
+    /**
+     * @brief 範囲のオフセットのアラインメントを取得する
+     */
+    static std::size_t queryAlignment();
+};
+
+} // namespace claude_gl
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace claude_gl {
+
+/**
+ * @brief ハッシュ値を持つ uniform の名前
+ *
+ * constexpr の変数として定義するとハッシュ値はコンパイル時に計算され、
+ * 描画中の設定で文字列の構築やハッシュ計算が起きません。
+ *
+ * @code
+ * constexpr UniformName MODEL("model");
+ * shader.setMat4(MODEL, world);
+ * @endcode
+ */
+class UniformName {
+public:
+    /**
+     * @brief 文字列リテラルから作成する
+     * @param name uniform の名前（このオブジェクトより長く有効であること）
+     */
+    constexpr UniformName(const char* name) : name(name), hash(hashName(name)) {}
+
+    /**
+     * @brief 文字列から作成する（ハッシュ値は実行時に計算される）
+     * @param name uniform の名前（このオブジェクトより長く有効であること）
+     */
+    UniformName(const std::string& name) : UniformName(name.c_str()) {}
+
+    /**
+     * @brief 名前を取得する（警告の表示用）
+     */
+    constexpr const char* getName() const {
+        return name;
+    }
+
+    /**
+     * @brief ハッシュ値を取得する
+     */
+    constexpr std::uint32_t getHash() const {
+        return hash;
+    }
+
+    /**
+     * @brief 名前のハッシュ値を計算する（32ビット FNV-1a）
+     * @param name uniform の名前
+     * @return ハッシュ値
+     */
+    static constexpr std::uint32_t hashName(const char* name) {
+        std::uint32_t value = 2166136261u;
+        for (; *name != '\0'; ++name) {
+            value = (value ^ static_cast<unsigned char>(*name)) * 16777619u;
+        }
+        return value;
+    }
+
+private:
+    const char* name;    ///< 名前
+    std::uint32_t hash;  ///< 名前のハッシュ値
+};
+
+/**
+ * @brief リンク時に取得したプログラムの uniform の一覧
+ *
+ * 名前のハッシュ値の昇順に並べ、ハッシュ値の二分探索で位置を引きます。
+ * OpenGLに依存しないため、型は GLenum の値を整数として保持します。
+ */
+class UniformTable {
+public:
+    /**
+     * @brief uniform の情報
+     */
+    struct Entry {
+        std::string name;            ///< 名前（配列は添字を除く）
+        std::int32_t location = -1;  ///< 位置
+        std::uint32_t type = 0;      ///< 型（GL_FLOAT_VEC3 など）
+        std::int32_t count = 1;      ///< 配列の要素数
+    };
+
+    /**
+     * @brief uniform を追加する
+     * @param name 名前
+     * @param location 位置
+     * @param type 型（GL_FLOAT_VEC3 など）
+     * @param count 配列の要素数
+     * @return ハッシュ値が別の名前と衝突した場合はfalse（追加されない）
+     */
+    bool add(const std::string& name, std::int32_t location, std::uint32_t type,
+             std::int32_t count);
+
+    /**
+     * @brief すべての uniform を削除する
+     */
+    void clear();
+
+    /**
+     * @brief ハッシュ値で uniform を探す
+     * @param hash UniformName::getHash() の値
+     * @return 見つからない場合は nullptr
+     */
+    const Entry* find(std::uint32_t hash) const;
+
+    /**
+     * @brief uniform の数を取得する
+     */
+    std::size_t getCount() const;
+
+    /**
+     * @brief ハッシュ値の順の uniform を取得する
+     * @param index 番号（getCount() 未満）
+     */
+    const Entry& getEntry(std::size_t index) const;
+
+private:
+    std::vector<std::uint32_t> hashes;  ///< 昇順のハッシュ値（探索用に分けて保持）
+    std::vector<Entry> entries;         ///< hashes と同じ順の情報
+};
+
+} // namespace claude_gl
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <glad/gl.h>
+#include "renderer/gl_state_cache.h"
+
+namespace claude_gl {
+
+/**
+ * @brief 頂点属性の型のバイト数を取得する
+ * @param type 属性の型（GL_FLOAT など）
+ * @return 1成分のバイト数（GL_INT_2_10_10_10_REV などのパック型は4成分で4バイトとして1を返す）
+ */
+constexpr std::size_t vertexAttributeTypeSize(GLenum type) {
+    switch (type) {
+        case GL_BYTE:
+        case GL_UNSIGNED_BYTE:
+        case GL_INT_2_10_10_10_REV:
+        case GL_UNSIGNED_INT_2_10_10_10_REV:
+            return 1;
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT:
+        case GL_HALF_FLOAT:
+            return 2;
+        default:
+            return 4;
+    }
+}
+
+/**
+ * @brief 頂点属性の記述子
+ *
+ * すべてのパラメータがテンプレート引数で決まるため、setup() は
+ * 定数を引数に持つ glVertexAttribPointer の呼び出しに展開されます。
+ *
+ * @tparam Location シェーダーの layout(location)
+ * @tparam Components 成分数（1〜4）
+ * @tparam Type 成分の型
+ * @tparam Normalized 整数型を0〜1（-1〜1）に正規化するか
+ * @tparam Offset ストリーム要素内のバイトオフセット
+ * @tparam Divisor 何インスタンスごとに次の要素へ進むか（0: 頂点ごと）
+ */
+template <GLuint Location, GLint Components, GLenum Type, GLboolean Normalized,
+          std::size_t Offset, GLuint Divisor = 0>
+struct VertexAttribute {
+    static constexpr GLuint LOCATION = Location;
+    static constexpr std::size_t OFFSET = Offset;
+    static constexpr std::size_t SIZE = Components * vertexAttributeTypeSize(Type);
+
+    static_assert(Components >= 1 && Components <= 4, "attribute must have 1-4 components");
+
+    /**
+     * @brief 現在バインドされている GL_ARRAY_BUFFER に属性を設定する
+     * @param stride ストリームの要素サイズ
+     * @param base ストリームの先頭のバッファ内のオフセット
+     */
+    static void setup(GLsizei stride, GLintptr base = 0) {
+        std::uintptr_t offset = static_cast<std::uintptr_t>(base) + Offset;
+        glEnableVertexAttribArray(Location);
+        glVertexAttribPointer(Location, Components, Type, Normalized, stride,
+                              reinterpret_cast<const void*>(offset));
+        glVertexAttribDivisor(Location, Divisor);
+    }
+};
+
+/**
+ * @brief float属性の記述子
+ */
+template <GLuint Location, GLint Components, std::size_t Offset>
+using FloatAttribute = VertexAttribute<Location, Components, GL_FLOAT, GL_FALSE, Offset>;
+
+/**
+ * @brief インスタンスごとに進むfloat属性の記述子（インスタンスストリーム用）
+ */
+template <GLuint Location, GLint Components, std::size_t Offset>
+using InstanceAttribute = VertexAttribute<Location, Components, GL_FLOAT, GL_FALSE, Offset, 1>;
+
+/**
+ * @brief 1つのVBOに格納される頂点ストリームの記述子
+ * @tparam Element ストリームの要素型（ストライドは sizeof(Element)）
+ * @tparam Attributes ストリームに含まれる属性
+ */
+template <typename Element, typename... Attributes>
+struct VertexStream {
+    using ElementType = Element;
+    static constexpr GLsizei STRIDE = static_cast<GLsizei>(sizeof(Element));
+
+    static_assert(sizeof...(Attributes) > 0, "stream must have at least one attribute");
+    static_assert(((Attributes::OFFSET + Attributes::SIZE <= sizeof(Element)) && ...),
+                  "attribute exceeds the stream element");
+
+    /**
+     * @brief ストリームの属性をすべて設定する（VBOをバインドした状態で呼ぶ）
+     * @param base ストリームの先頭のバッファ内のオフセット
+     */
+    static void setup(GLintptr base = 0) {
+        (Attributes::setup(STRIDE, base), ...);
+    }
+
+    /**
+     * @brief 属性のロケーションを含むか判定する
+     */
+    static constexpr bool hasLocation(GLuint location) {
+        return ((Attributes::LOCATION == location) || ...);
+    }
+
+    /**
+     * @brief ストリーム内のロケーションに重複がないか判定する
+     */
+    static constexpr bool hasUniqueLocations() {
+        GLuint locations[] = {Attributes::LOCATION...};
+        for (std::size_t i = 0; i < sizeof...(Attributes); ++i) {
+            for (std::size_t j = i + 1; j < sizeof...(Attributes); ++j) {
+                if (locations[i] == locations[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief 頂点レイアウトの記述子（1つ以上のストリームで構成）
+ *
+ * 使用例:
+ * @code
+ * using Layout = VertexLayout<VertexStream<glm::vec3, FloatAttribute<0, 3, 0>>,
+ *                             VertexStream<Surface, FloatAttribute<1, 3, 0>,
+ *                                          FloatAttribute<2, 2, 12>>>;
+ * Layout::setup(buffers);  // buffers[i] が i 番目のストリームのVBO
+ * @endcode
+ *
+ * @tparam Streams 頂点ストリーム（VBOごとに1つ）
+ */
+template <typename... Streams>
+class VertexLayout {
+public:
+    /**
+     * @brief ストリーム数
+     */
+    static constexpr std::size_t STREAM_COUNT = sizeof...(Streams);
+
+    /**
+     * @brief 1頂点あたりの全ストリームの合計バイト数
+     */
+    static constexpr std::size_t VERTEX_SIZE =
+        (std::size_t(0) + ... + static_cast<std::size_t>(Streams::STRIDE));
+
+    /**
+     * @brief I 番目のストリームの記述子
+     */
+    template <std::size_t I>
+    using Stream = std::tuple_element_t<I, std::tuple<Streams...>>;
+
+    /**
+     * @brief すべてのストリームの属性を設定する（VAOをバインドした状態で呼ぶ）
+     * @param buffers ストリームごとのVBO（STREAM_COUNT 個）
+     * @param offsets ストリームごとのVBO内の先頭のオフセット（nullptr の場合はすべて0）
+     */
+    static void setup(const GLuint* buffers, const GLintptr* offsets = nullptr) {
+        static_assert(STREAM_COUNT > 0, "layout must have at least one stream");
+        static_assert(hasUniqueLocations(), "duplicate attribute location");
+        setupStreams(buffers, offsets, std::index_sequence_for<Streams...>());
+    }
+
+private:
+    // GL 3.3で保証される頂点属性数
+    static constexpr GLuint MAX_LOCATIONS = 16;
+
+    /**
+     * @brief レイアウト全体でロケーションに重複がないか判定する
+     */
+    static constexpr bool hasUniqueLocations() {
+        for (GLuint location = 0; location < MAX_LOCATIONS; ++location) {
+            if ((static_cast<int>(Streams::hasLocation(location)) + ...) > 1) {
+                return false;
+            }
+        }
+        return (Streams::hasUniqueLocations() && ...);
+    }
+
+    template <std::size_t... I>
+    static void setupStreams(const GLuint* buffers, const GLintptr* offsets,
+                             std::index_sequence<I...>) {
+        ((GlStateCache::getInstance().bindBuffer(GL_ARRAY_BUFFER, buffers[I]),
+          Streams::setup(offsets ? offsets[I] : 0)),
+         ...);
+    }
+};
+
+} // namespace claude_gl
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "mesh.h"
+
+namespace claude_gl {
+
+/**
+ * @brief 法線の格納形式
+ */
+enum class NormalEncoding {
+    Float,          ///< float×3（12バイト）
+    Octahedral,     ///< 八面体マッピングした16ビット符号付き正規化整数×2（4バイト）
+    Packed1010102,  ///< GL_INT_2_10_10_10_REV（4バイト）
+};
+
+/**
+ * @brief 量子化頂点のレイアウト設定
+ */
+struct VertexFormat {
+    bool quantizePositions = true;  ///< 位置をAABB基準の16ビット正規化整数にする
+    bool halfTexCoords = true;      ///< テクスチャ座標を半精度浮動小数点数にする
+    NormalEncoding normalEncoding = NormalEncoding::Octahedral;  ///< 法線の格納形式
+};
+
+/**
+ * @brief 量子化した頂点データと、シェーダーで復元するためのパラメータ
+ *
+ * 属性のバイトオフセットは VertexQuantizer::quantize が設定に応じて決めます。
+ * 位置は「positionBias + 正規化値 × positionScale」で復元します。
+ */
+struct QuantizedVertices {
+    VertexFormat format;                  ///< 使用したレイアウト設定
+    std::vector<std::uint8_t> data;       ///< インターリーブした頂点データ
+    std::size_t vertexCount = 0;          ///< 頂点数
+    std::uint32_t stride = 0;             ///< 頂点1つのバイト数
+    std::uint32_t positionOffset = 0;     ///< 位置属性のバイトオフセット
+    std::uint32_t normalOffset = 0;       ///< 法線属性のバイトオフセット
+    std::uint32_t texCoordOffset = 0;     ///< テクスチャ座標属性のバイトオフセット
+    glm::vec3 positionBias = glm::vec3(0.0f);   ///< 位置復元のオフセット（AABBの最小点）
+    glm::vec3 positionScale = glm::vec3(1.0f);  ///< 位置復元のスケール（AABBの大きさ）
+};
+
+/**
+ * @brief Mesh::Vertex 配列を帯域を節約する量子化レイアウトに変換するクラス
+ *
+ * 既定のレイアウト（16バイト/頂点）:
+ * 位置 uint16×4（正規化、AABB基準） | 法線 八面体 int16×2 | テクスチャ座標 half×2
+ *
+ * インデックスの16ビット化は Mesh が頂点数に応じて自動で行います。
+ */
+class VertexQuantizer {
+public:
+    /**
+     * @brief 量子化による削減量と誤差
+     */
+    struct Stats {
+        std::size_t vertexCount = 0;         ///< 頂点数
+        std::size_t sourceVertexBytes = 0;   ///< 量子化前の頂点バイト数
+        std::size_t vertexBytes = 0;         ///< 量子化後の頂点バイト数
+        std::size_t sourceIndexBytes = 0;    ///< 32ビットインデックスのバイト数
+        std::size_t indexBytes = 0;          ///< 実際に転送するインデックスのバイト数
+        float maxPositionError = 0.0f;       ///< 位置の最大誤差（モデル空間の距離）
+        float maxNormalErrorDegrees = 0.0f;  ///< 法線の最大角度誤差（度）
+        float maxTexCoordError = 0.0f;       ///< テクスチャ座標の最大誤差（成分ごと）
+
+        /**
+         * @brief 削減したバイト数の割合を取得する
+         * @return 0〜1（頂点とインデックスの合計に対する割合）
+         */
+        double savedRatio() const;
+    };
+
+    /**
+     * @brief 頂点配列を量子化する
+     * @param vertices 頂点配列の先頭
+     * @param vertexCount 頂点数
+     * @param format レイアウト設定
+     * @return 量子化した頂点データ
+     */
+    static QuantizedVertices quantize(const Mesh::Vertex* vertices, std::size_t vertexCount,
+                                      const VertexFormat& format = VertexFormat());
+
+    /**
+     * @brief 量子化結果を復元して元の頂点と比較し、削減量と誤差を計測する
+     * @param vertices 量子化前の頂点配列の先頭
+     * @param quantized 量子化した頂点データ（頂点数は vertices と同じ）
+     * @param indexCount インデックス数
+     * @return 削減量と誤差
+     */
+    static Stats measure(const Mesh::Vertex* vertices, const QuantizedVertices& quantized,
+                         std::size_t indexCount);
+};
+
+} // namespace claude_gl
@@ -6,6 +6,23 @@
 
 namespace claude_gl {
 
+namespace {
+
+/**
+ * @brief キーで切り替える設定
+ */
+struct KeyToggle {
+    int key;              ///< GLFWのキー
+    bool& value;          ///< 切り替える設定
+    bool& keyDown;        ///< キーが押されたままか
+    const char* name;     ///< ログに出力する名前
+    const char* onText;   ///< 有効にしたときにログに出力する状態
+    const char* offText;  ///< 無効にしたときにログに出力する状態
+    bool available;       ///< 切り替えられるか（機能が使えない場合はfalse）
+};
+
+} // namespace
+
 // 静的メンバ変数の定義
 Application* Application::instance = nullptr;
 
@@ -18,7 +35,11 @@ Application& Application::getInstance() {
 
 Application::Application()
     : window(nullptr), running(false), currentTime(0.0f), lastTime(0.0f), deltaTime(0.0f),
-      shader(nullptr), model(nullptr), rotationSpeed(1.0f) {
+      shader(nullptr), perVertexNormalMatrix(false), normalMatrixKeyDown(false),
+      indirectDraw(false), indirectKeyDown(false), gpuCulling(false), cullingKeyDown(false),
+      occlusionCulling(false), occlusionKeyDown(false), lodEnabled(true), lodKeyDown(false),
+      clusterCulling(true), clusterKeyDown(false), model(nullptr), rotationSpeed(1.0f),
+      modelInstance(Scene::INVALID_INSTANCE), modelNode(TransformHierarchy::INVALID_NODE) {
 }
 
 Application::~Application() {
@@ -41,7 +62,8 @@ bool Application::initialize(int width, int height, const std::string& title) {
         
         // OpenGL設定の初期化
         glClearColor(0.7f, 0.8f, 0.9f, 1.0f); // 薄い青みがかったグレーに変更
-        glEnable(GL_DEPTH_TEST);
+        // 深度テストなどの固定機能の状態は GlStateCache を通して設定する
+        GlStateCache::getInstance().bindPipeline(renderQueue.getPipeline(RenderPass::Opaque));
         
         // シェーダーの初期化
         shader = std::make_unique<Shader>();
@@ -49,10 +71,74 @@ bool Application::initialize(int width, int height, const std::string& title) {
             std::cerr << "Failed to load shaders" << std::endl;
             return false;
         }
+        instancedShader = std::make_unique<Shader>();
+        if (!instancedShader->loadFromFile("assets/shaders/instanced.vs",
+                                           "assets/shaders/basic.fs")) {
+            std::cerr << "Failed to load instanced shaders" << std::endl;
+            return false;
+        }
+        // 法線行列の計算場所によるGPU時間の比較用（Nキーで切り替え）
+        referenceShader = std::make_unique<Shader>();
+        if (!referenceShader->loadFromFile("assets/shaders/basic.vs", "assets/shaders/basic.fs",
+                                           {"COMPUTE_NORMAL_MATRIX"})) {
+            std::cerr << "Failed to load reference shaders" << std::endl;
+            return false;
+        }
+        sceneTimer = std::make_unique<GpuTimer>();
+        frameUniforms = std::make_unique<UniformRingBuffer>();
         
-        // モデルのロード
+        // 間接描画（GL 4.3 以上）。使えない場合は従来の描画のまま（Iキーで切り替え）
+        if (IndirectDrawBuffer::isSupported()) {
+            indirectShader = std::make_unique<Shader>();
+            if (indirectShader->loadFromFile("assets/shaders/indirect.vs",
+                                             "assets/shaders/basic.fs", {"INDIRECT_DRAW"})) {
+                indirectDraws = std::make_unique<IndirectDrawBuffer>();
+                renderQueue.setIndirectShader(*shader, *indirectShader);
+                indirectDraw = true;
+            }
+            else {
+                std::cerr << "Failed to load indirect shaders" << std::endl;
+                indirectShader.reset();
+            }
+        }
+        std::cout << "Indirect draw: " << (indirectDraw ? "enabled" : "unavailable") << std::endl;
+        
+        // 間接描画の可視判定をコンピュートシェーダーで行う（Gキーで切り替え）
+        if (indirectDraws && GpuCuller::isSupported()) {
+            cullShader = std::make_unique<Shader>();
+            depthReduceShader = std::make_unique<Shader>();
+            if (cullShader->loadComputeFromFile("assets/shaders/cull.comp") &&
+                depthReduceShader->loadComputeFromFile("assets/shaders/depth_reduce.comp")) {
+                gpuCuller = std::make_unique<GpuCuller>(*cullShader, *depthReduceShader);
+                gpuCulling = true;
+            }
+            else {
+                std::cerr << "Failed to load culling shaders" << std::endl;
+                cullShader.reset();
+                depthReduceShader.reset();
+            }
+        }
+        std::cout << "GPU culling: " << (gpuCulling ? "enabled" : "unavailable") << std::endl;
+        
+        // モデルのロード（準備はワーカースレッドで行い、転送と追加は updateAssets() で行う）
         try {
-            model = std::make_unique<Model>("assets/models/teapot.obj");
+            // メッシュは共有のバッファに格納し、VAOの切り替えなしで描画する
+            geometryArena = std::make_shared<GeometryArena>();
+            assetLoader = std::make_unique<AssetLoader>();
+            ModelLoadOptions loadOptions;
+            loadOptions.geometryArena = geometryArena;
+            loadOptions.lodLevels = 4;
+            loadOptions.buildMeshlets = true;
+            modelHandle = assetLoader->loadModel("assets/models/teapot.obj", loadOptions);
+            
+            // 親ノードでX軸周りに傾けて縮小し（ティーポットの上部が見えるように）、
+            // 子ノードでY軸周りに回転させる
+            TransformHierarchy::NodeId root = transforms.createNode();
+            transforms.setLocalTransform(root, glm::vec3(0.0f),
+                                         glm::angleAxis(glm::radians(-10.0f),
+                                                        glm::vec3(1.0f, 0.0f, 0.0f)),
+                                         glm::vec3(0.8f, 0.8f, 0.8f));
+            modelNode = transforms.createNode(root);
         } catch (const std::exception& e) {
             std::cerr << "Failed to load model: " << e.what() << std::endl;
             return false;
@@ -85,8 +171,9 @@ void Application::run() {
         deltaTime = currentTime - lastTime;
         lastTime = currentTime;
         
-        // 入力処理、更新、描画
+        // 入力処理、アセットの転送、更新、描画
         processInput();
+        updateAssets();
         update();
         render();
         
@@ -100,8 +187,25 @@ void Application::shutdown() {
     running = false;
     
     // OpenGLリソースの解放
-    model.reset(); // モデルを先に解放（依存関係のため）
+    renderQueue.clear();
+    scene = Scene(); // シーンとモデルを先に解放（依存関係のため）
+    transforms = TransformHierarchy();
+    modelNode = TransformHierarchy::INVALID_NODE;
+    instanceBatcher.clear();
+    modelHandle = AssetLoader::ModelHandle();
+    assetLoader.reset();
+    model.reset();
+    geometryArena.reset();
     shader.reset();
+    instancedShader.reset();
+    referenceShader.reset();
+    indirectShader.reset();
+    gpuCuller.reset();
+    cullShader.reset();
+    depthReduceShader.reset();
+    sceneTimer.reset();
+    frameUniforms.reset();
+    indirectDraws.reset();
     
     if (window) {
         window->shutdown();
@@ -135,11 +239,94 @@ Window* Application::getWindow() {
     return window.get();
 }
 
+const FrustumCuller::Stats& Application::getCullingStats() const {
+    return frustumCuller.getStats();
+}
+
+Scene& Application::getScene() {
+    return scene;
+}
+
+void Application::submitInstances(const std::shared_ptr<const Model>& model,
+                                  const std::vector<glm::mat4>& transforms) {
+    instanceBatcher.submit(model, transforms.data(), transforms.size());
+}
+
+const RenderQueue::Stats& Application::getRenderQueueStats() const {
+    return renderQueue.getStats();
+}
+
+const InstanceBatcher::Stats& Application::getInstancingStats() const {
+    return instanceBatcher.getStats();
+}
+
 void Application::processInput() {
     // ESCキーでアプリケーション終了
     if (window && glfwGetKey(window->getHandle(), GLFW_KEY_ESCAPE) == GLFW_PRESS) {
         window->setShouldClose(true);
     }
+    
+    // 押した瞬間に設定を切り替え、比較のためGPU時間の集計をやり直す
+    // （N: 法線行列を頂点ごとに求めるバリアント、I: 共有のバッファのメッシュの間接描画、
+    //   G: 間接描画の可視判定をGPUで行う、O: 遮蔽物によるCPUの遮蔽カリング、
+    //   L: 画面上の誤差による詳細度の選択、C: メッシュのクラスタごとのカリング）
+    const KeyToggle toggles[] = {
+        {GLFW_KEY_N, perVertexNormalMatrix, normalMatrixKeyDown, "Normal matrix",
+         "per-vertex", "CPU", true},
+        {GLFW_KEY_I, indirectDraw, indirectKeyDown, "Indirect draw", "on", "off",
+         indirectDraws != nullptr},
+        {GLFW_KEY_G, gpuCulling, cullingKeyDown, "GPU culling", "on", "off",
+         gpuCuller != nullptr},
+        {GLFW_KEY_O, occlusionCulling, occlusionKeyDown, "Occlusion culling", "on", "off", true},
+        {GLFW_KEY_L, lodEnabled, lodKeyDown, "LOD selection", "on", "off", true},
+        {GLFW_KEY_C, clusterCulling, clusterKeyDown, "Cluster culling", "on", "off", true},
+    };
+    for (const KeyToggle& toggle : toggles) {
+        bool keyDown = window && glfwGetKey(window->getHandle(), toggle.key) == GLFW_PRESS;
+        if (keyDown && !toggle.keyDown && toggle.available) {
+            toggle.value = !toggle.value;
+            if (sceneTimer) {
+                sceneTimer->reset();
+            }
+            std::cout << toggle.name << ": " << (toggle.value ? toggle.onText : toggle.offText)
+                      << std::endl;
+        }
+        toggle.keyDown = keyDown;
+    }
+}
+
+void Application::updateAssets() {
+    if (!assetLoader) {
+        return;
+    }
+    assetLoader->update();
+    const AssetLoader::FrameStats& uploadStats = assetLoader->getFrameStats();
+    if (uploadStats.overBudget) {
+        std::cout << "Asset upload over budget: " << uploadStats.uploadedBytes << " bytes in "
+                  << uploadStats.milliseconds << " ms" << std::endl;
+    }
+    if (!modelHandle.isValid() || !modelHandle.isDone()) {
+        return;
+    }
+    
+    // 全メッシュを転送したモデルだけをシーンへ追加し、ノードに追従させる
+    model = modelHandle.get();
+    if (model) {
+        AssetLoader::AssetStats stats = modelHandle.getStats();
+        modelInstance = scene.addInstance(model, transforms.getWorldMatrix(modelNode));
+        scene.attachNode(modelInstance, modelNode);
+        std::cout << "Loaded " << modelHandle.getPath() << " asynchronously in "
+                  << stats.latencyMilliseconds << " ms (queue " << stats.queueMilliseconds
+                  << " ms, prepare " << stats.prepareMilliseconds << " ms, upload wait "
+                  << stats.uploadWaitMilliseconds << " ms, upload " << stats.uploadMilliseconds
+                  << " ms over " << stats.uploadFrames << " frames, " << stats.meshCount
+                  << " meshes, " << stats.uploadBytes << " bytes)" << std::endl;
+    }
+    else {
+        std::cerr << "Failed to load model " << modelHandle.getPath() << ": "
+                  << modelHandle.getError() << std::endl;
+    }
+    modelHandle = AssetLoader::ModelHandle();
 }
 
 void Application::update() {
@@ -147,35 +334,25 @@ void Application::update() {
     
     // モデルの回転（Y軸周り）
     if (model) {
-        model->rotateY(rotationSpeed * deltaTime);
+        glm::quat spin = glm::angleAxis(rotationSpeed * deltaTime, glm::vec3(0.0f, 1.0f, 0.0f));
+        transforms.setRotation(modelNode, transforms.getRotation(modelNode) * spin);
     }
+    
+    // 変更されたノードの部分木だけワールド行列を計算し、インスタンスに反映する（BVHも更新される）
+    transforms.update();
+    scene.syncTransforms(transforms);
 }
 
 void Application::render() {
+    // GL呼び出しの集計をフレームごとに区切る
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    stateCache.beginFrame();
+    
     // 画面クリア
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
-    if (shader && window && model) {
-        // シェーダーを使用
-        shader->use();
-        
-        // カメラとライトの設定
+    if (shader && window && frameUniforms) {
         glm::vec3 viewPos(5.0f, 8.0f, 12.0f); // モデルの斜め上から見下ろす位置に調整
-        // ライト位置もカメラ位置に合わせて調整
-        glm::vec3 lightPos(5.0f, 10.0f, 5.0f);
-        glm::vec3 lightColor(1.0f, 1.0f, 1.0f);
-        // オブジェクトの色を濃めにして背景とのコントラストを上げる
-        glm::vec3 objectColor(0.3f, 0.3f, 0.35f);
-        
-        // ライト関連の設定（Phongシェーディング用）
-        shader->setVec3("viewPos", viewPos);
-        shader->setVec3("lightPos", lightPos);
-        shader->setVec3("lightColor", lightColor);
-        shader->setVec3("objectColor", objectColor);
-        // 環境光を明るくしてモデルが見やすくなるように調整
-        shader->setFloat("ambientStrength", 0.3f);
-        shader->setFloat("specularStrength", 0.5f);
-        shader->setInt("shininess", 32);
         
         // 変換行列設定 - カメラがモデルのマイナスY方向を見るように調整
         glm::mat4 view = glm::lookAt(
@@ -186,29 +363,176 @@ void Application::render() {
         
         // 投影行列（透視投影）
         float aspectRatio = window->getAspectRatio();
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f);
+        constexpr float NEAR_PLANE = 0.1f;
+        constexpr float FAR_PLANE = 100.0f;
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspectRatio, NEAR_PLANE,
+                                                FAR_PLANE);
         
-        // Uniform設定
-        shader->setMat4("view", view);
-        shader->setMat4("projection", projection);
+        // シェーダーを選択（比較時は法線行列を頂点ごとに求めるバリアント）
+        const Shader& sceneShader =
+            perVertexNormalMatrix && referenceShader ? *referenceShader : *shader;
         
-        // モデルの描画
+        // フレームの定数と既定のマテリアルを積む（転送はシーンのマテリアルと合わせて1回）
+        frameUniforms->beginFrame();
+        if (indirectDraws) {
+            indirectDraws->beginFrame();
+        }
+        UniformRingBuffer::Range frameRange =
+            frameUniforms->push(makeFrameUniforms(viewPos, view, projection));
+        UniformRingBuffer::Range defaultMaterial = frameUniforms->push(Material().getUniforms());
+        frameUniforms->bind(FRAME_BLOCK_BINDING, frameRange);
+        
+        // GPUのカリングは間接描画のバリアントがあるシェーダーで描画する場合のみ使う
+        bool culling = gpuCuller && gpuCulling && indirectDraw && &sceneShader == shader.get();
+        if (indirectDraws) {
+            indirectDraws->setCuller(culling ? gpuCuller.get() : nullptr);
+        }
+        if (culling) {
+            gpuCuller->beginFrame(projection * view, viewPos);
+        }
+        
+        // 詳細度の段階は画面上の誤差が1ピクセル以下になる最も粗いものを選ぶ
+        int windowWidth = 0;
+        int windowHeight = 0;
+        window->getSize(windowWidth, windowHeight);
+        LodView lodView = LodView::make(viewPos, projection, static_cast<float>(windowHeight));
+        const LodView* lod = lodEnabled ? &lodView : nullptr;
+        
+        // シーンの投入（BVHとメッシュ単位の視錐台カリングを行い、画面内のもののみ投入）
+        // 遮蔽物があれば遮蔽されたインスタンスも除き、クラスタのカリングが有効なら
+        // 最も詳細な段階のメッシュは残ったクラスタのみ投入する。GPUでカリングする場合は
+        // CPUで判定せず全インスタンスを（クラスタごとの描画に分けて）投入する
+        renderQueue.begin(view, NEAR_PLANE, FAR_PLANE);
+        if (culling) {
+            scene.submitAll(renderQueue, sceneShader, lod, clusterCulling);
+        }
+        else {
+            if (clusterCulling) {
+                clusterCuller.beginFrame(projection * view, viewPos);
+            }
+            scene.submit(renderQueue, sceneShader, projection * view, frustumCuller,
+                         occlusionCulling ? &occlusionCuller : nullptr, lod,
+                         clusterCulling ? &clusterCuller : nullptr);
+        }
         
-        // teapotの設定調整 - 新しいカメラアングルに合わせて初期回転を調整
-        glm::mat4 initialTransform = glm::mat4(1.0f);
-        // X軸周りに回転させ、ティーポットの上部が見えるように調整
-        initialTransform = glm::rotate(initialTransform, glm::radians(-10.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+        // ソートキーの順に描画（フレームの定数は全プログラムで同じUBOの範囲を参照する）
+        if (sceneTimer) {
+            sceneTimer->begin();
+        }
+        renderQueue.execute(*frameUniforms, indirectDraw ? indirectDraws.get() : nullptr);
+        if (sceneTimer) {
+            sceneTimer->end();
+            
+            // 一定数の結果が集まったら平均と各段階の統計を出力する
+            constexpr std::size_t REPORT_SAMPLES = 300;
+            if (sceneTimer->getSampleCount() >= REPORT_SAMPLES) {
+                printFrameReport(culling);
+                sceneTimer->reset();
+            }
+        }
         
-        // モデルスケールも適切な大きさに合わせる
-        initialTransform = glm::scale(initialTransform, glm::vec3(0.8f, 0.8f, 0.8f));
+        // 投入されたインスタンスをモデルごとにまとめて描画
+        if (instancedShader && instanceBatcher.hasPending()) {
+            frameUniforms->flush();
+            stateCache.bindPipeline(renderQueue.getPipeline(RenderPass::Opaque));
+            instancedShader->use();
+            frameUniforms->bind(MATERIAL_BLOCK_BINDING, defaultMaterial);
+            instanceBatcher.draw(*instancedShader);
+        }
         
-        // 現在のモデル行列と組み合わせる
-        glm::mat4 modelMatrix = initialTransform * model->getModelMatrix();
-        shader->setMat4("model", modelMatrix);
+        // 描画済みの深度から次フレームの遮蔽の判定に使うピラミッドを作る
+        if (culling) {
+            gpuCuller->endFrame();
+        }
         
-        // モデル描画
-        model->draw(*shader);
+        // このフレームのUBOと間接描画の領域を読む描画をすべて発行したのでフェンスを置く
+        frameUniforms->endFrame();
+        if (indirectDraws) {
+            indirectDraws->endFrame();
+        }
     }
 }
 
+void Application::printFrameReport(bool culling) const {
+    std::cout << "Scene GPU time (normal matrix: "
+              << (perVertexNormalMatrix ? "per-vertex" : "CPU")
+              << ", indirect draw: " << (indirectDraw ? "on" : "off")
+              << ", GPU culling: " << (culling ? "on" : "off") << "): "
+              << sceneTimer->getAverageMilliseconds() << " ms" << std::endl;
+    const RenderQueue::Stats& queueStats = renderQueue.getStats();
+    std::cout << "Render queue: " << queueStats.commands << " commands, "
+              << queueStats.getStateChanges() << " state changes (submission order: "
+              << queueStats.unsortedStateChanges << "), " << queueStats.drawCalls
+              << " draw calls (" << queueStats.multiDrawCommands
+              << " commands multi-drawn, " << queueStats.indirectCommands
+              << " indirect)" << std::endl;
+    std::cout << "LOD: " << queueStats.triangles << " triangles ("
+              << queueStats.fullDetailTriangles << " at full detail)" << std::endl;
+    if (clusterCulling && !culling) {
+        const ClusterCuller::Stats& clusterStats = clusterCuller.getStats();
+        std::cout << "Cluster culling: " << clusterStats.tested << " clusters in "
+                  << clusterStats.meshes << " meshes, " << clusterStats.frustumCulled
+                  << " frustum culled, " << clusterStats.backfaceCulled
+                  << " backface culled (" << clusterStats.culledTriangles << " of "
+                  << clusterStats.triangles << " triangles), "
+                  << queueStats.clusterCommands << " cluster draws" << std::endl;
+    }
+    if (occlusionCulling) {
+        const OcclusionCuller::Stats& occlusionStats = occlusionCuller.getStats();
+        std::cout << "Occlusion culling: " << scene.getStats().occludedInstances
+                  << " of " << occlusionStats.tested << " instances occluded by "
+                  << occlusionStats.rasterizedTriangles << " triangles ("
+                  << occlusionCuller.getThreadCount() << " threads, render "
+                  << occlusionStats.renderMilliseconds << " ms, test "
+                  << occlusionStats.testMilliseconds << " ms)" << std::endl;
+    }
+    if (culling) {
+        const GpuCuller::Stats& cullStats = gpuCuller->getStats();
+        std::cout << "GPU culling: " << cullStats.tested << " tested, "
+                  << cullStats.visible << " visible, " << cullStats.frustumCulled
+                  << " frustum culled, " << cullStats.backfaceCulled
+                  << " backface culled, " << cullStats.occlusionCulled
+                  << " occlusion culled (read back after " << cullStats.latencyFrames
+                  << " frames)" << std::endl;
+    }
+    if (geometryArena) {
+        GeometryArena::Stats arenaStats = geometryArena->getStats();
+        std::cout << "Geometry arena: " << arenaStats.meshes << " meshes, vertices "
+                  << arenaStats.vertices.getUtilization() * 100.0 << "% used ("
+                  << arenaStats.vertices.getFragmentation() * 100.0
+                  << "% fragmented), indices "
+                  << arenaStats.indices.getUtilization() * 100.0 << "% used ("
+                  << arenaStats.indices.getFragmentation() * 100.0 << "% fragmented), "
+                  << arenaStats.grows << " grows, " << arenaStats.defragmentations
+                  << " defragmentations" << std::endl;
+    }
+    GlStateCache::Counter glCalls = GlStateCache::getInstance().getFrameStats().getTotal();
+    std::cout << "GL state: " << glCalls.issued << " calls issued, "
+              << glCalls.skipped << " skipped" << std::endl;
+    const UniformRingBuffer::Stats& uniformStats = frameUniforms->getFrameStats();
+    const StreamBuffer::Stats& streamStats = frameUniforms->getStreamStats();
+    std::cout << "Uniform buffer: " << uniformStats.blocks << " blocks, "
+              << uniformStats.bytes << " bytes ("
+              << (frameUniforms->isPersistent() ? "persistent" : "orphaned")
+              << "), " << streamStats.stalls << " stalls ("
+              << streamStats.stallMilliseconds << " ms), " << streamStats.wraps
+              << " wraps" << std::endl;
+}
+
+FrameUniforms Application::makeFrameUniforms(const glm::vec3& viewPos, const glm::mat4& view,
+                                             const glm::mat4& projection) const {
+    // ライト位置もカメラ位置に合わせて調整
+    glm::vec3 lightPos(5.0f, 10.0f, 5.0f);
+    glm::vec3 lightColor(1.0f, 1.0f, 1.0f);
+    
+    // ライト関連の設定（Phongシェーディング用、マテリアルは MaterialData で設定する）
+    FrameUniforms frame;
+    frame.view = view;
+    frame.projection = projection;
+    frame.viewPos = glm::vec4(viewPos, 1.0f);
+    frame.lightPos = glm::vec4(lightPos, 1.0f);
+    frame.lightColor = glm::vec4(lightColor, 1.0f);
+    return frame;
+}
+
 } // namespace claude_gl
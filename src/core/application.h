@@ -2,11 +2,27 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "window.h"
+#include "renderer/asset_loader.h"
+#include "renderer/cluster_culler.h"
+#include "renderer/frustum_culler.h"
+#include "renderer/geometry_arena.h"
+#include "renderer/gl_state_cache.h"
+#include "renderer/gpu_culler.h"
+#include "renderer/gpu_timer.h"
+#include "renderer/indirect_draw_buffer.h"
+#include "renderer/instance_batcher.h"
 #include "renderer/shader.h"
 #include "renderer/model.h"
+#include "renderer/occlusion_culler.h"
+#include "renderer/render_queue.h"
+#include "renderer/scene.h"
+#include "renderer/transform_hierarchy.h"
+#include "renderer/uniform_blocks.h"
+#include "renderer/uniform_ring_buffer.h"
 
 namespace claude_gl {
 
@@ -77,6 +93,42 @@ public:
      */
     Window* getWindow();
     
+    /**
+     * @brief 直近のフレームの視錐台カリングの統計情報を取得する
+     * @return 判定数と除外数
+     */
+    const FrustumCuller::Stats& getCullingStats() const;
+    
+    /**
+     * @brief 描画するシーンを取得する（インスタンスの追加・移動に使う）
+     * @return シーン
+     */
+    Scene& getScene();
+    
+    /**
+     * @brief モデルのインスタンスを投入する（次のフレームでインスタンス描画される）
+     * 
+     * 同じモデルへの投入は1つのバッチにまとめられ、メッシュごとに1回の描画呼び出しで
+     * 描画されます。投入内容は描画後に破棄されるため、毎フレーム update() などから呼びます。
+     * 
+     * @param model 描画するモデル
+     * @param transforms インスタンスごとのモデル行列
+     */
+    void submitInstances(const std::shared_ptr<const Model>& model,
+                         const std::vector<glm::mat4>& transforms);
+    
+    /**
+     * @brief 直近のフレームのインスタンス描画の統計情報を取得する
+     * @return バッチ数・インスタンス数・描画呼び出し数
+     */
+    const InstanceBatcher::Stats& getInstancingStats() const;
+    
+    /**
+     * @brief 直近のフレームの描画キューの統計情報を取得する
+     * @return コマンド数と状態の切り替え数
+     */
+    const RenderQueue::Stats& getRenderQueueStats() const;
+    
 private:
     /**
      * @brief プライベートコンストラクタ（シングルトンパターン）
@@ -98,6 +150,11 @@ private:
      */
     void processInput();
     
+    /**
+     * @brief 準備が終わったアセットをGPUへ転送し、読み込みが終わったモデルをシーンへ追加する
+     */
+    void updateAssets();
+    
     /**
      * @brief アプリケーションの状態を更新する
      */
@@ -108,6 +165,22 @@ private:
      */
     void render();
     
+    /**
+     * @brief シーン描画の平均GPU時間と、描画・カリング・バッファの統計を出力する
+     * @param culling このフレームでGPUのカリングを行ったか
+     */
+    void printFrameReport(bool culling) const;
+    
+    /**
+     * @brief カメラとライトの FrameData ブロックを作成する
+     * @param viewPos カメラ位置
+     * @param view ビュー行列
+     * @param projection 投影行列
+     * @return std140 のブロック
+     */
+    FrameUniforms makeFrameUniforms(const glm::vec3& viewPos, const glm::mat4& view,
+                                    const glm::mat4& projection) const;
+    
     static Application* instance;     ///< シングルトンインスタンス
     
     std::unique_ptr<Window> window;   ///< ウィンドウオブジェクト
@@ -117,10 +190,46 @@ private:
     float lastTime;                   ///< 前回のフレームの時間
     float deltaTime;                  ///< 前回のフレームからの経過時間
     
-    std::unique_ptr<Shader> shader;    ///< シェーダープログラム
-    
-    std::unique_ptr<Model> model;      ///< 3Dモデル
-    float rotationSpeed;               ///< モデル回転速度
+    std::unique_ptr<Shader> shader;             ///< シェーダープログラム
+    std::unique_ptr<Shader> instancedShader;    ///< インスタンス描画用のシェーダープログラム
+    std::unique_ptr<Shader> referenceShader;    ///< 法線行列を頂点ごとに求める比較用のバリアント
+    bool perVertexNormalMatrix;                 ///< シーンを比較用のバリアントで描画するか（Nキー）
+    bool normalMatrixKeyDown;                   ///< Nキーが押されたままか
+    std::unique_ptr<Shader> indirectShader;     ///< 間接描画用のバリアント（GL 4.3 以上のみ）
+    bool indirectDraw;                          ///< 共有のバッファのメッシュを間接描画する（Iキー）
+    bool indirectKeyDown;                       ///< Iキーが押されたままか
+    std::unique_ptr<Shader> cullShader;         ///< GPUのカリング（cull.comp）
+    std::unique_ptr<Shader> depthReduceShader;  ///< 深度のピラミッドの作成（depth_reduce.comp）
+    bool gpuCulling;                            ///< 間接描画の可視判定をGPUで行うか（Gキー）
+    bool cullingKeyDown;                        ///< Gキーが押されたままか
+    bool occlusionCulling;                      ///< 遮蔽物でCPUの遮蔽カリングを行うか（Oキー）
+    bool occlusionKeyDown;                      ///< Oキーが押されたままか
+    bool lodEnabled;                            ///< 画面上の誤差で詳細度の段階を選ぶか（Lキー）
+    bool lodKeyDown;                            ///< Lキーが押されたままか
+    bool clusterCulling;                        ///< メッシュのクラスタごとにカリングするか（Cキー）
+    bool clusterKeyDown;                        ///< Cキーが押されたままか
+    
+    std::unique_ptr<GpuTimer> sceneTimer;               ///< シーン描画のGPU時間
+    std::unique_ptr<UniformRingBuffer> frameUniforms;   ///< フレームとマテリアルの定数のUBO
+    std::unique_ptr<IndirectDrawBuffer> indirectDraws;  ///< 間接描画のコマンドと描画ごとのデータ
+    std::unique_ptr<GpuCuller> gpuCuller;               ///< 間接描画の視錐台と遮蔽のカリング
+    
+    std::shared_ptr<GeometryArena> geometryArena;  ///< モデルのメッシュを格納する共有のバッファ
+    std::unique_ptr<AssetLoader> assetLoader;      ///< モデルの非同期の読み込み
+    AssetLoader::ModelHandle modelHandle;          ///< 読み込み中のモデル（追加後は無効）
+    
+    std::shared_ptr<Model> model;          ///< 3Dモデル（読み込みが終わるまではnullptr）
+    float rotationSpeed;                   ///< モデル回転速度
+    
+    Scene scene;                           ///< 描画するインスタンスの集合
+    Scene::InstanceId modelInstance;       ///< 回転させるモデルのインスタンス
+    TransformHierarchy transforms;         ///< インスタンスが追従する変換の階層
+    TransformHierarchy::NodeId modelNode;  ///< モデルを回転させるノード
+    FrustumCuller frustumCuller;           ///< 描画前の視錐台カリング
+    OcclusionCuller occlusionCuller;       ///< 遮蔽物によるCPUの遮蔽カリング
+    ClusterCuller clusterCuller;           ///< クラスタ単位の視錐台と面の向きのカリング
+    RenderQueue renderQueue;               ///< シーンの描画コマンドのキュー
+    InstanceBatcher instanceBatcher;       ///< 投入されたインスタンスのバッチ
 };
 
 } // namespace claude_gl
@@ -1,6 +1,7 @@
 #include "window.h"
 #include <iostream>
 #include <stdexcept>
+#include "renderer/gl_extensions.h"
 
 namespace claude_gl {
 
@@ -64,6 +65,13 @@ bool Window::initialize() {
         return false;
     }
     
+    // glad に含まれないGL 4.xの機能（使えない場合はGL 3.3の方法で代用する）
+    GlExtensions::load(glfwGetProcAddress);
+    const GlExtensions& extensions = GlExtensions::get();
+    std::cout << "OpenGL " << extensions.getVersion() / 10 << "." << extensions.getVersion() % 10
+              << " (buffer storage: " << (extensions.hasBufferStorage() ? "yes" : "no") << ")"
+              << std::endl;
+    
     // ウィンドウユーザーポインタの設定（コールバック内でthisポインタにアクセスするため）
     glfwSetWindowUserPointer(window, this);
     
@@ -0,0 +1,287 @@
+#include "renderer/asset_loader.h"
+#include <chrono>
+#include <exception>
+#include <utility>
+#include "utils/thread_pool.h"
+
+namespace claude_gl {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief 2つの時刻の間のミリ秒を求める
+ */
+double getMilliseconds(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+} // namespace
+
+/**
+ * @brief 1つの読み込みの要求（ハンドルとワーカーと update() で共有する）
+ *
+ * model はワーカーが準備の後に設定し、それ以降は update() を呼ぶスレッドだけが転送する。
+ * ハンドルへは state が Ready になってから返す。
+ */
+struct AssetLoader::Request {
+    std::string path;                 ///< OBJファイルのパス
+    ModelLoadOptions options;         ///< 読み込みの設定
+    Clock::time_point requested;      ///< 要求した時刻
+    Clock::time_point preparedTime;   ///< 準備が終わった時刻
+    std::size_t lastUploadFrame = 0;  ///< 最後に転送した update() の番号（0: 未転送）
+    mutable std::mutex mutex;         ///< 以下の排他制御
+    State state = State::Queued;      ///< 読み込みの状態
+    std::shared_ptr<Model> model;     ///< 準備したモデル
+    std::string error;                ///< 失敗した理由
+    AssetStats stats;                 ///< 進み具合と所要時間
+};
+
+float AssetLoader::AssetStats::getProgress() const {
+    if (finished) {
+        return 1.0f;
+    }
+    if (!prepared) {
+        return 0.0f;
+    }
+    float uploaded = uploadBytes > 0 ? static_cast<float>(uploadedBytes) / uploadBytes : 1.0f;
+    return 0.5f + 0.5f * uploaded;
+}
+
+AssetLoader::ModelHandle::ModelHandle(std::shared_ptr<Request> request)
+    : request(std::move(request)) {
+}
+
+bool AssetLoader::ModelHandle::isValid() const {
+    return request != nullptr;
+}
+
+AssetLoader::State AssetLoader::ModelHandle::getState() const {
+    if (!request) {
+        return State::Failed;
+    }
+    std::lock_guard<std::mutex> lock(request->mutex);
+    return request->state;
+}
+
+bool AssetLoader::ModelHandle::isReady() const {
+    return getState() == State::Ready;
+}
+
+bool AssetLoader::ModelHandle::isDone() const {
+    State state = getState();
+    return state == State::Ready || state == State::Failed;
+}
+
+std::shared_ptr<Model> AssetLoader::ModelHandle::get() const {
+    if (!request) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(request->mutex);
+    return request->state == State::Ready ? request->model : nullptr;
+}
+
+std::string AssetLoader::ModelHandle::getError() const {
+    if (!request) {
+        return std::string();
+    }
+    std::lock_guard<std::mutex> lock(request->mutex);
+    return request->error;
+}
+
+const std::string& AssetLoader::ModelHandle::getPath() const {
+    static const std::string EMPTY;
+    return request ? request->path : EMPTY;
+}
+
+AssetLoader::AssetStats AssetLoader::ModelHandle::getStats() const {
+    if (!request) {
+        return AssetStats();
+    }
+    std::lock_guard<std::mutex> lock(request->mutex);
+    return request->stats;
+}
+
+AssetLoader::AssetLoader(unsigned int threadCount)
+    : pool(std::make_unique<ThreadPool>(threadCount)) {
+}
+
+AssetLoader::~AssetLoader() {
+    // ワーカーの準備を待ってから、転送していない要求を失敗にする
+    pool.reset();
+    std::vector<std::shared_ptr<Request>> remaining(uploading.begin(), uploading.end());
+    remaining.insert(remaining.end(), prepared.begin(), prepared.end());
+    Clock::time_point now = Clock::now();
+    for (const std::shared_ptr<Request>& request : remaining) {
+        std::lock_guard<std::mutex> lock(request->mutex);
+        if (request->state == State::Failed) {
+            continue;
+        }
+        request->state = State::Failed;
+        request->error = "AssetLoader: destroyed before upload";
+        request->model.reset();
+        request->stats.latencyMilliseconds = getMilliseconds(request->requested, now);
+        request->stats.finished = true;
+    }
+}
+
+AssetLoader::ModelHandle AssetLoader::loadModel(const std::string& filepath,
+                                                const ModelLoadOptions& options) {
+    auto request = std::make_shared<Request>();
+    request->path = filepath;
+    request->options = options;
+    request->requested = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++inFlight;
+    }
+
+    // 準備はGLを使わないため、結果のモデルをそのまま update() へ渡す
+    pool->submit([this, request]() {
+        Clock::time_point start = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(request->mutex);
+            request->state = State::Preparing;
+            request->stats.queueMilliseconds = getMilliseconds(request->requested, start);
+        }
+        std::shared_ptr<Model> model;
+        std::string error;
+        try {
+            model = Model::prepare(request->path, request->options);
+        }
+        catch (const std::exception& e) {
+            error = e.what();
+        }
+        Clock::time_point end = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(request->mutex);
+            request->preparedTime = end;
+            request->stats.prepareMilliseconds = getMilliseconds(start, end);
+            if (model) {
+                request->state = State::Uploading;
+                request->model = std::move(model);
+                request->stats.meshCount = request->model->getPendingUploadCount();
+                request->stats.uploadBytes = request->model->getPendingUploadBytes();
+                request->stats.prepared = true;
+            }
+            else {
+                request->state = State::Failed;
+                request->error = error;
+                request->stats.latencyMilliseconds = getMilliseconds(request->requested, end);
+                request->stats.finished = true;
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        prepared.push_back(request);
+        --inFlight;
+    });
+    return ModelHandle(std::move(request));
+}
+
+std::size_t AssetLoader::update() {
+    frameStats = FrameStats();
+    ++frameIndex;
+    std::size_t finished = 0;
+
+    // 準備が終わった順に転送の列へ移す（失敗したものはここで終わる）
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const std::shared_ptr<Request>& request : prepared) {
+            std::lock_guard<std::mutex> requestLock(request->mutex);
+            if (request->state == State::Failed) {
+                ++finished;
+            }
+            else {
+                uploading.push_back(request);
+            }
+        }
+        prepared.clear();
+    }
+
+    // 少なくとも1つのメッシュを転送し、以降は予算を超える前に止める
+    Clock::time_point start = Clock::now();
+    while (!uploading.empty()) {
+        // ハンドルが手放されていても、列から外す間は要求を保持する
+        std::shared_ptr<Request> current = uploading.front();
+        Request& request = *current;
+        Model& model = *request.model;
+        if (model.hasPendingUploads()) {
+            double elapsed = getMilliseconds(start, Clock::now());
+            std::size_t nextBytes = model.getNextUploadBytes();
+            if (frameStats.uploadedMeshes > 0 &&
+                (frameStats.uploadedBytes + nextBytes > budget.maxBytes ||
+                 elapsed >= budget.maxMilliseconds)) {
+                break;
+            }
+            Clock::time_point uploadStart = Clock::now();
+            std::size_t bytes = 0;
+            try {
+                bytes = model.uploadNext();
+            }
+            catch (const std::exception& e) {
+                // 転送済みのメッシュごとモデルを捨てる
+                std::lock_guard<std::mutex> lock(request.mutex);
+                request.state = State::Failed;
+                request.error = e.what();
+                request.model.reset();
+                request.stats.latencyMilliseconds =
+                    getMilliseconds(request.requested, Clock::now());
+                request.stats.finished = true;
+                ++finished;
+                uploading.pop_front();
+                continue;
+            }
+            Clock::time_point uploadEnd = Clock::now();
+            ++frameStats.uploadedMeshes;
+            frameStats.uploadedBytes += bytes;
+
+            std::lock_guard<std::mutex> lock(request.mutex);
+            AssetStats& stats = request.stats;
+            if (stats.uploadedMeshes == 0) {
+                stats.uploadWaitMilliseconds = getMilliseconds(request.preparedTime, uploadStart);
+            }
+            ++stats.uploadedMeshes;
+            stats.uploadedBytes += bytes;
+            stats.uploadMilliseconds += getMilliseconds(uploadStart, uploadEnd);
+            if (request.lastUploadFrame != frameIndex) {
+                request.lastUploadFrame = frameIndex;
+                ++stats.uploadFrames;
+            }
+        }
+        if (!model.hasPendingUploads()) {
+            std::lock_guard<std::mutex> lock(request.mutex);
+            request.state = State::Ready;
+            request.stats.latencyMilliseconds = getMilliseconds(request.requested, Clock::now());
+            request.stats.finished = true;
+            ++finished;
+            uploading.pop_front();
+        }
+    }
+
+    frameStats.milliseconds = getMilliseconds(start, Clock::now());
+    frameStats.overBudget = frameStats.uploadedBytes > budget.maxBytes ||
+                            frameStats.milliseconds > budget.maxMilliseconds;
+    std::lock_guard<std::mutex> lock(mutex);
+    frameStats.pendingAssets = inFlight + prepared.size() + uploading.size();
+    return finished;
+}
+
+void AssetLoader::setBudget(const Budget& budget) {
+    this->budget = budget;
+}
+
+const AssetLoader::Budget& AssetLoader::getBudget() const {
+    return budget;
+}
+
+bool AssetLoader::isIdle() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return inFlight == 0 && prepared.empty() && uploading.empty();
+}
+
+const AssetLoader::FrameStats& AssetLoader::getFrameStats() const {
+    return frameStats;
+}
+
+} // namespace claude_gl
@@ -0,0 +1,74 @@
+#include "renderer/cluster_culler.h"
+#include "renderer/frustum_culler.h"
+
+namespace claude_gl {
+
+void ClusterCuller::beginFrame(const glm::mat4& viewProjection,
+                               const glm::vec3& cameraPosition) {
+    this->viewProjection = viewProjection;
+    this->cameraPosition = cameraPosition;
+    stats = Stats();
+    beginInstance(glm::mat4(1.0f));
+}
+
+void ClusterCuller::beginInstance(const glm::mat4& world) {
+    // ビュー・プロジェクション × ワールドから取り出した平面はメッシュ空間の平面になる
+    FrustumCuller::extractPlanes(viewProjection * world, localPlanes);
+    localCamera = glm::vec3(glm::inverse(world) * glm::vec4(cameraPosition, 1.0f));
+}
+
+std::size_t ClusterCuller::cull(const Mesh::Meshlet* meshlets, std::size_t count,
+                                std::vector<std::uint32_t>& visible) {
+    visible.clear();
+    ++stats.meshes;
+    stats.tested += count;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Mesh::Meshlet& meshlet = meshlets[i];
+        std::size_t triangles = meshlet.indexCount / 3;
+        stats.triangles += triangles;
+        if (isOutsideFrustum(meshlet, localPlanes)) {
+            ++stats.frustumCulled;
+            stats.culledTriangles += triangles;
+        }
+        else if (coneCulling && isBackfacing(meshlet, localCamera)) {
+            ++stats.backfaceCulled;
+            stats.culledTriangles += triangles;
+        }
+        else {
+            visible.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    return visible.size();
+}
+
+void ClusterCuller::setConeCulling(bool enabled) {
+    coneCulling = enabled;
+}
+
+const ClusterCuller::Stats& ClusterCuller::getStats() const {
+    return stats;
+}
+
+bool ClusterCuller::isOutsideFrustum(const Mesh::Meshlet& meshlet, const glm::vec4 planes[6]) {
+    for (int p = 0; p < 6; ++p) {
+        const glm::vec4& plane = planes[p];
+        if (glm::dot(glm::vec3(plane), meshlet.center) + plane.w < -meshlet.radius) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ClusterCuller::isBackfacing(const Mesh::Meshlet& meshlet, const glm::vec3& cameraPosition) {
+    if (meshlet.coneCutoff >= 1.0f) {
+        return false;
+    }
+    // 視線と軸のなす角が「90度 - 錐の半角」以内なら全三角形が裏を向く。境界球の中の
+    // どの点へ向かう視線でもそうなるよう、中心への視線に半径の分の余裕を持たせて判定する
+    glm::vec3 toCenter = meshlet.center - cameraPosition;
+    float margin = meshlet.radius * (1.0f + meshlet.coneCutoff);
+    return glm::dot(toCenter, meshlet.coneAxis) >=
+           meshlet.coneCutoff * glm::length(toCenter) + margin;
+}
+
+} // namespace claude_gl
@@ -0,0 +1,433 @@
+#include "renderer/dynamic_bvh.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace claude_gl {
+
+namespace {
+
+constexpr int SAH_BIN_COUNT = 16;  ///< SAH構築で1軸あたりに使うビン数
+
+} // namespace
+
+int DynamicBvh::insert(const Aabb& box, std::uint32_t userData) {
+    int leaf = allocateNode();
+    nodes[leaf].box = box;
+    nodes[leaf].userData = userData;
+    nodes[leaf].height = 0;
+    insertLeaf(leaf);
+    ++leafCount;
+    return leaf;
+}
+
+void DynamicBvh::remove(int leaf) {
+    validateLeaf(leaf);
+    removeLeaf(leaf);
+    freeNode(leaf);
+    --leafCount;
+}
+
+void DynamicBvh::update(int leaf, const Aabb& box) {
+    validateLeaf(leaf);
+    Node& node = nodes[leaf];
+    bool nearby = node.box.overlaps(box);
+    node.box = box;
+
+    if (nearby) {
+        // 小さな移動: 祖先の境界を広げ直し、回転で局所的に木を整える
+        refitAncestors(node.parent);
+        ++stats.refits;
+    }
+    else {
+        // 離れた位置への移動: 挿入し直して適切な兄弟の隣に移す
+        removeLeaf(leaf);
+        insertLeaf(leaf);
+        ++stats.reinserts;
+    }
+}
+
+void DynamicBvh::rebuild() {
+    if (root == NULL_NODE) {
+        return;
+    }
+
+    // 葉を集め、内部ノードをすべて解放する
+    std::vector<BuildItem> items;
+    items.reserve(leafCount);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const Node& node = nodes[i];
+        if (node.height < 0) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            items.push_back({node.box, node.box.getCenter(), static_cast<int>(i)});
+        }
+        else {
+            freeNode(static_cast<int>(i));
+        }
+    }
+
+    root = buildRange(items, 0, items.size());
+    nodes[root].parent = NULL_NODE;
+}
+
+void DynamicBvh::clear() {
+    nodes.clear();
+    root = NULL_NODE;
+    freeList = NULL_NODE;
+    leafCount = 0;
+    stats = Stats();
+}
+
+const Aabb& DynamicBvh::getBox(int leaf) const {
+    return nodes[leaf].box;
+}
+
+std::uint32_t DynamicBvh::getUserData(int leaf) const {
+    return nodes[leaf].userData;
+}
+
+std::size_t DynamicBvh::getLeafCount() const {
+    return leafCount;
+}
+
+int DynamicBvh::getHeight() const {
+    return root == NULL_NODE ? -1 : nodes[root].height;
+}
+
+float DynamicBvh::computeSahCost() const {
+    if (root == NULL_NODE) {
+        return 0.0f;
+    }
+    float rootArea = nodes[root].box.getHalfArea();
+    if (rootArea <= 0.0f) {
+        return 0.0f;
+    }
+
+    float totalArea = 0.0f;
+    for (const Node& node : nodes) {
+        if (node.height > 0) {
+            totalArea += node.box.getHalfArea();
+        }
+    }
+    return totalArea / rootArea;
+}
+
+const DynamicBvh::Stats& DynamicBvh::getStats() const {
+    return stats;
+}
+
+void DynamicBvh::validateLeaf(int leaf) const {
+    if (leaf < 0 || static_cast<std::size_t>(leaf) >= nodes.size() || !nodes[leaf].isLeaf() ||
+        nodes[leaf].height != 0) {
+        throw std::runtime_error("DynamicBvh: invalid leaf " + std::to_string(leaf));
+    }
+}
+
+int DynamicBvh::allocateNode() {
+    if (freeList == NULL_NODE) {
+        nodes.emplace_back();
+        return static_cast<int>(nodes.size() - 1);
+    }
+    int index = freeList;
+    freeList = nodes[index].parent;
+    nodes[index] = Node();
+    return index;
+}
+
+void DynamicBvh::freeNode(int index) {
+    nodes[index].parent = freeList;
+    nodes[index].child1 = NULL_NODE;
+    nodes[index].child2 = NULL_NODE;
+    nodes[index].height = -1;
+    freeList = index;
+}
+
+void DynamicBvh::insertLeaf(int leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // 葉を兄弟にしたときに増える表面積が最小になるノードまで降りる
+    const Aabb leafBox = nodes[leaf].box;
+    int index = root;
+    while (!nodes[index].isLeaf()) {
+        const Node& node = nodes[index];
+        float area = node.box.getHalfArea();
+        float combinedArea = Aabb::merge(node.box, leafBox).getHalfArea();
+
+        // このノードの兄弟にする場合と、子孫に降りる場合に祖先へ引き継がれる増加分
+        float siblingCost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int child) {
+            const Node& childNode = nodes[child];
+            float merged = Aabb::merge(leafBox, childNode.box).getHalfArea();
+            float cost = childNode.isLeaf() ? merged : merged - childNode.box.getHalfArea();
+            return cost + inheritanceCost;
+        };
+        float cost1 = descendCost(node.child1);
+        float cost2 = descendCost(node.child2);
+
+        if (siblingCost < cost1 && siblingCost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    // 兄弟と葉をまとめる新しい親を作る
+    int sibling = index;
+    int oldParent = nodes[sibling].parent;
+    int newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = Aabb::merge(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        root = newParent;
+    }
+    else if (nodes[oldParent].child1 == sibling) {
+        nodes[oldParent].child1 = newParent;
+    }
+    else {
+        nodes[oldParent].child2 = newParent;
+    }
+
+    refitAncestors(oldParent);
+}
+
+void DynamicBvh::removeLeaf(int leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    int parent = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent == NULL_NODE) {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+        return;
+    }
+
+    // 親を取り除き、兄弟を祖父母に直接繋ぐ
+    if (nodes[grandParent].child1 == parent) {
+        nodes[grandParent].child1 = sibling;
+    }
+    else {
+        nodes[grandParent].child2 = sibling;
+    }
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    refitAncestors(grandParent);
+}
+
+void DynamicBvh::refitAncestors(int index) {
+    while (index != NULL_NODE) {
+        Node& node = nodes[index];
+        const Node& child1 = nodes[node.child1];
+        const Node& child2 = nodes[node.child2];
+        node.box = Aabb::merge(child1.box, child2.box);
+        node.height = 1 + std::max(child1.height, child2.height);
+
+        rotate(index);
+        index = nodes[index].parent;
+    }
+}
+
+void DynamicBvh::rotate(int index) {
+    // Aの子をB・C、Bの子をD・E、Cの子をF・Gとする。
+    // Bと孫F/G、またはCと孫D/Eを入れ替え、入れ替えで変わる子の表面積が最も減るものを選ぶ
+    Node& a = nodes[index];
+    if (a.height < 2) {
+        return;
+    }
+
+    int b = a.child1;
+    int c = a.child2;
+    enum class Rotation { None, BF, BG, CD, CE };
+    Rotation best = Rotation::None;
+    float bestDelta = 0.0f;
+
+    if (!nodes[c].isLeaf()) {
+        int f = nodes[c].child1;
+        int g = nodes[c].child2;
+        float areaC = nodes[c].box.getHalfArea();
+
+        float deltaBF = Aabb::merge(nodes[b].box, nodes[g].box).getHalfArea() - areaC;
+        float deltaBG = Aabb::merge(nodes[b].box, nodes[f].box).getHalfArea() - areaC;
+        if (deltaBF < bestDelta) {
+            best = Rotation::BF;
+            bestDelta = deltaBF;
+        }
+        if (deltaBG < bestDelta) {
+            best = Rotation::BG;
+            bestDelta = deltaBG;
+        }
+    }
+    if (!nodes[b].isLeaf()) {
+        int d = nodes[b].child1;
+        int e = nodes[b].child2;
+        float areaB = nodes[b].box.getHalfArea();
+
+        float deltaCD = Aabb::merge(nodes[c].box, nodes[e].box).getHalfArea() - areaB;
+        float deltaCE = Aabb::merge(nodes[c].box, nodes[d].box).getHalfArea() - areaB;
+        if (deltaCD < bestDelta) {
+            best = Rotation::CD;
+            bestDelta = deltaCD;
+        }
+        if (deltaCE < bestDelta) {
+            best = Rotation::CE;
+            bestDelta = deltaCE;
+        }
+    }
+    if (best == Rotation::None) {
+        return;
+    }
+
+    // Aの子childと、Aのもう一方の子parentの子grandChildを入れ替える
+    auto swapWithGrandChild = [&](int child, int parent, int grandChild) {
+        Node& parentNode = nodes[parent];
+        int remaining = parentNode.child1 == grandChild ? parentNode.child2 : parentNode.child1;
+        if (parentNode.child1 == grandChild) {
+            parentNode.child1 = child;
+        }
+        else {
+            parentNode.child2 = child;
+        }
+        nodes[child].parent = parent;
+        parentNode.box = Aabb::merge(nodes[child].box, nodes[remaining].box);
+        parentNode.height = 1 + std::max(nodes[child].height, nodes[remaining].height);
+
+        Node& nodeA = nodes[index];
+        if (nodeA.child1 == child) {
+            nodeA.child1 = grandChild;
+        }
+        else {
+            nodeA.child2 = grandChild;
+        }
+        nodes[grandChild].parent = index;
+        nodeA.height = 1 + std::max(nodes[nodeA.child1].height, nodes[nodeA.child2].height);
+    };
+
+    switch (best) {
+        case Rotation::BF: swapWithGrandChild(b, c, nodes[c].child1); break;
+        case Rotation::BG: swapWithGrandChild(b, c, nodes[c].child2); break;
+        case Rotation::CD: swapWithGrandChild(c, b, nodes[b].child1); break;
+        case Rotation::CE: swapWithGrandChild(c, b, nodes[b].child2); break;
+        case Rotation::None: break;
+    }
+    ++stats.rotations;
+}
+
+int DynamicBvh::buildRange(std::vector<BuildItem>& items, std::size_t begin, std::size_t end) {
+    std::size_t count = end - begin;
+    if (count == 1) {
+        return items[begin].leaf;
+    }
+
+    // 重心の範囲を求める
+    glm::vec3 centroidMin(INFINITY);
+    glm::vec3 centroidMax(-INFINITY);
+    for (std::size_t i = begin; i < end; ++i) {
+        centroidMin = glm::min(centroidMin, items[i].centroid);
+        centroidMax = glm::max(centroidMax, items[i].centroid);
+    }
+
+    // 重心の広がりが最大の軸でビンに分け、SAHコストが最小になる分割を探す
+    // （葉が少ない範囲ではビンも減らし、末端付近の固定費を抑える）
+    glm::vec3 centroidExtent = centroidMax - centroidMin;
+    int axis = centroidExtent.x >= centroidExtent.y ? 0 : 1;
+    axis = centroidExtent[axis] >= centroidExtent.z ? axis : 2;
+    const float axisMin = centroidMin[axis];
+    const int binCount = static_cast<int>(std::min<std::size_t>(SAH_BIN_COUNT, count));
+    const float binScale = centroidExtent[axis] > 0.0f ? binCount / centroidExtent[axis] : 0.0f;
+    auto binOf = [&](const BuildItem& item) {
+        return std::min(binCount - 1, static_cast<int>((item.centroid[axis] - axisMin) * binScale));
+    };
+
+    int bestSplit = 0;
+    if (binScale > 0.0f) {
+        Aabb binBoxes[SAH_BIN_COUNT];
+        std::size_t binCounts[SAH_BIN_COUNT] = {};
+        for (std::size_t i = begin; i < end; ++i) {
+            int bin = binOf(items[i]);
+            binBoxes[bin] = binCounts[bin] == 0 ? items[i].box
+                                                : Aabb::merge(binBoxes[bin], items[i].box);
+            ++binCounts[bin];
+        }
+
+        // 右側からの累積表面積を先に求め、左側を累積しながら各分割位置のコストを評価する
+        float rightAreas[SAH_BIN_COUNT];
+        std::size_t rightCounts[SAH_BIN_COUNT];
+        Aabb rightBox;
+        std::size_t rightCount = 0;
+        for (int bin = binCount - 1; bin > 0; --bin) {
+            if (binCounts[bin] > 0) {
+                rightBox = rightCount == 0 ? binBoxes[bin] : Aabb::merge(rightBox, binBoxes[bin]);
+                rightCount += binCounts[bin];
+            }
+            rightAreas[bin] = rightCount > 0 ? rightBox.getHalfArea() : 0.0f;
+            rightCounts[bin] = rightCount;
+        }
+
+        float bestCost = INFINITY;
+        Aabb leftBox;
+        std::size_t leftCount = 0;
+        for (int split = 1; split < binCount; ++split) {
+            if (binCounts[split - 1] > 0) {
+                leftBox = leftCount == 0 ? binBoxes[split - 1]
+                                         : Aabb::merge(leftBox, binBoxes[split - 1]);
+                leftCount += binCounts[split - 1];
+            }
+            if (leftCount == 0 || rightCounts[split] == 0) {
+                continue;
+            }
+            float cost = leftCount * leftBox.getHalfArea() + rightCounts[split] * rightAreas[split];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestSplit = split;
+            }
+        }
+    }
+
+    std::size_t middle;
+    if (bestSplit == 0) {
+        // 重心がすべて一致する場合は半分に分ける
+        middle = begin + count / 2;
+    }
+    else {
+        auto first = items.begin() + static_cast<std::ptrdiff_t>(begin);
+        auto last = items.begin() + static_cast<std::ptrdiff_t>(end);
+        auto split = std::partition(first, last, [&](const BuildItem& item) {
+            return binOf(item) < bestSplit;
+        });
+        middle = static_cast<std::size_t>(split - items.begin());
+    }
+
+    int child1 = buildRange(items, begin, middle);
+    int child2 = buildRange(items, middle, end);
+
+    int index = allocateNode();
+    Node& node = nodes[index];
+    node.child1 = child1;
+    node.child2 = child2;
+    node.box = Aabb::merge(nodes[child1].box, nodes[child2].box);
+    node.height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+    nodes[child1].parent = index;
+    nodes[child2].parent = index;
+    return index;
+}
+
+} // namespace claude_gl
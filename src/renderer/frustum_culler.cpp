@@ -0,0 +1,371 @@
+#include "renderer/frustum_culler.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CLAUDE_GL_CULL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CLAUDE_GL_CULL_SSE
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define CLAUDE_GL_CULL_NEON
+#endif
+
+namespace claude_gl {
+
+namespace {
+
+// SoA配列を切り上げる単位（最も広いSIMDの幅）
+constexpr std::size_t BLOCK_SIZE = 8;
+
+/**
+ * @brief 判定に使う境界配列（要素数は BLOCK_SIZE の倍数）
+ */
+struct SoaBounds {
+    const float* centerX;
+    const float* centerY;
+    const float* centerZ;
+    const float* radius;
+    const float* extentX;
+    const float* extentY;
+    const float* extentZ;
+};
+
+/**
+ * @brief ブロックの判定結果を書き出し、可視オブジェクトの番号を詰めて追加する
+ * @param mask レーンごとの可視ビット
+ * @param first ブロックの先頭番号
+ * @param laneCount ブロック内の有効なレーン数
+ * @param visibility 可視フラグの出力先
+ * @param visibleIndices 可視オブジェクト番号の出力先
+ * @param visibleCount 出力済みの可視オブジェクト数
+ */
+inline void writeBlock(int mask, std::size_t first, std::size_t laneCount,
+                       std::uint8_t* visibility, std::uint32_t* visibleIndices,
+                       std::size_t& visibleCount) {
+    for (std::size_t lane = 0; lane < laneCount; ++lane) {
+        std::uint32_t bit = static_cast<std::uint32_t>(mask >> lane) & 1u;
+        visibility[first + lane] = static_cast<std::uint8_t>(bit);
+        // 分岐せずに常に書き込み、可視の場合のみ位置を進める
+        visibleIndices[visibleCount] = static_cast<std::uint32_t>(first + lane);
+        visibleCount += bit;
+    }
+}
+
+/**
+ * @brief 1オブジェクトを6平面で判定する
+ */
+bool isInsideScalar(const SoaBounds& bounds, std::size_t i, const glm::vec4 planes[6]) {
+    for (int p = 0; p < 6; ++p) {
+        const glm::vec4& plane = planes[p];
+        float distance = plane.x * bounds.centerX[i] + plane.y * bounds.centerY[i] +
+                         plane.z * bounds.centerZ[i] + plane.w;
+        float boxRadius = std::abs(plane.x) * bounds.extentX[i] +
+                          std::abs(plane.y) * bounds.extentY[i] +
+                          std::abs(plane.z) * bounds.extentZ[i];
+        float effectiveRadius = std::min(bounds.radius[i], boxRadius);
+        if (!(distance >= -effectiveRadius)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if defined(CLAUDE_GL_CULL_AVX)
+
+/**
+ * @brief 8オブジェクトずつ判定する（AVX）
+ */
+std::size_t cullBlocks(const SoaBounds& bounds, const glm::vec4 planes[6], std::size_t objectCount,
+                       std::uint8_t* visibility, std::uint32_t* visibleIndices) {
+    std::size_t visibleCount = 0;
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    for (std::size_t i = 0; i < objectCount; i += 8) {
+        __m256 cx = _mm256_loadu_ps(bounds.centerX + i);
+        __m256 cy = _mm256_loadu_ps(bounds.centerY + i);
+        __m256 cz = _mm256_loadu_ps(bounds.centerZ + i);
+        __m256 r = _mm256_loadu_ps(bounds.radius + i);
+        __m256 ex = _mm256_loadu_ps(bounds.extentX + i);
+        __m256 ey = _mm256_loadu_ps(bounds.extentY + i);
+        __m256 ez = _mm256_loadu_ps(bounds.extentZ + i);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p) {
+            __m256 nx = _mm256_set1_ps(planes[p].x);
+            __m256 ny = _mm256_set1_ps(planes[p].y);
+            __m256 nz = _mm256_set1_ps(planes[p].z);
+            __m256 distance = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(nx, cx), _mm256_mul_ps(ny, cy)),
+                _mm256_add_ps(_mm256_mul_ps(nz, cz), _mm256_set1_ps(planes[p].w)));
+            __m256 boxRadius = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(_mm256_andnot_ps(signMask, nx), ex),
+                              _mm256_mul_ps(_mm256_andnot_ps(signMask, ny), ey)),
+                _mm256_mul_ps(_mm256_andnot_ps(signMask, nz), ez));
+            __m256 negRadius = _mm256_xor_ps(_mm256_min_ps(r, boxRadius), signMask);
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+        }
+
+        writeBlock(_mm256_movemask_ps(inside), i, std::min<std::size_t>(8, objectCount - i),
+                   visibility, visibleIndices, visibleCount);
+    }
+    return visibleCount;
+}
+
+#elif defined(CLAUDE_GL_CULL_SSE)
+
+/**
+ * @brief 4オブジェクトずつ判定する（SSE）
+ */
+std::size_t cullBlocks(const SoaBounds& bounds, const glm::vec4 planes[6], std::size_t objectCount,
+                       std::uint8_t* visibility, std::uint32_t* visibleIndices) {
+    std::size_t visibleCount = 0;
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    for (std::size_t i = 0; i < objectCount; i += 4) {
+        __m128 cx = _mm_loadu_ps(bounds.centerX + i);
+        __m128 cy = _mm_loadu_ps(bounds.centerY + i);
+        __m128 cz = _mm_loadu_ps(bounds.centerZ + i);
+        __m128 r = _mm_loadu_ps(bounds.radius + i);
+        __m128 ex = _mm_loadu_ps(bounds.extentX + i);
+        __m128 ey = _mm_loadu_ps(bounds.extentY + i);
+        __m128 ez = _mm_loadu_ps(bounds.extentZ + i);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p) {
+            __m128 nx = _mm_set1_ps(planes[p].x);
+            __m128 ny = _mm_set1_ps(planes[p].y);
+            __m128 nz = _mm_set1_ps(planes[p].z);
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+                _mm_add_ps(_mm_mul_ps(nz, cz), _mm_set1_ps(planes[p].w)));
+            __m128 boxRadius = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, nx), ex),
+                           _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey)),
+                _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+            __m128 negRadius = _mm_xor_ps(_mm_min_ps(r, boxRadius), signMask);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+        }
+
+        writeBlock(_mm_movemask_ps(inside), i, std::min<std::size_t>(4, objectCount - i),
+                   visibility, visibleIndices, visibleCount);
+    }
+    return visibleCount;
+}
+
+#elif defined(CLAUDE_GL_CULL_NEON)
+
+/**
+ * @brief 4オブジェクトずつ判定する（NEON）
+ */
+std::size_t cullBlocks(const SoaBounds& bounds, const glm::vec4 planes[6], std::size_t objectCount,
+                       std::uint8_t* visibility, std::uint32_t* visibleIndices) {
+    std::size_t visibleCount = 0;
+    for (std::size_t i = 0; i < objectCount; i += 4) {
+        float32x4_t cx = vld1q_f32(bounds.centerX + i);
+        float32x4_t cy = vld1q_f32(bounds.centerY + i);
+        float32x4_t cz = vld1q_f32(bounds.centerZ + i);
+        float32x4_t r = vld1q_f32(bounds.radius + i);
+        float32x4_t ex = vld1q_f32(bounds.extentX + i);
+        float32x4_t ey = vld1q_f32(bounds.extentY + i);
+        float32x4_t ez = vld1q_f32(bounds.extentZ + i);
+
+        uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFu);
+        for (int p = 0; p < 6; ++p) {
+            float32x4_t distance = vdupq_n_f32(planes[p].w);
+            distance = vaddq_f32(distance, vmulq_n_f32(cx, planes[p].x));
+            distance = vaddq_f32(distance, vmulq_n_f32(cy, planes[p].y));
+            distance = vaddq_f32(distance, vmulq_n_f32(cz, planes[p].z));
+            float32x4_t boxRadius = vmulq_n_f32(ex, std::abs(planes[p].x));
+            boxRadius = vaddq_f32(boxRadius, vmulq_n_f32(ey, std::abs(planes[p].y)));
+            boxRadius = vaddq_f32(boxRadius, vmulq_n_f32(ez, std::abs(planes[p].z)));
+            float32x4_t negRadius = vnegq_f32(vminq_f32(r, boxRadius));
+            inside = vandq_u32(inside, vcgeq_f32(distance, negRadius));
+        }
+
+        // 各レーンの比較結果（全ビット1または0）からビットマスクを作る
+        static const std::uint32_t LANE_BITS[4] = {1, 2, 4, 8};
+        int mask = static_cast<int>(vaddvq_u32(vandq_u32(inside, vld1q_u32(LANE_BITS))));
+        writeBlock(mask, i, std::min<std::size_t>(4, objectCount - i), visibility,
+                   visibleIndices, visibleCount);
+    }
+    return visibleCount;
+}
+
+#else
+
+/**
+ * @brief 1オブジェクトずつ判定する（SIMDが使えない環境）
+ */
+std::size_t cullBlocks(const SoaBounds& bounds, const glm::vec4 planes[6], std::size_t objectCount,
+                       std::uint8_t* visibility, std::uint32_t* visibleIndices) {
+    std::size_t visibleCount = 0;
+    for (std::size_t i = 0; i < objectCount; ++i) {
+        int mask = isInsideScalar(bounds, i, planes) ? 1 : 0;
+        writeBlock(mask, i, 1, visibility, visibleIndices, visibleCount);
+    }
+    return visibleCount;
+}
+
+#endif
+
+} // namespace
+
+std::size_t FrustumCuller::Stats::visible() const {
+    return tested - culled;
+}
+
+void FrustumCuller::clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
+    extentX.clear();
+    extentY.clear();
+    extentZ.clear();
+    objectCount = 0;
+}
+
+void FrustumCuller::reserve(std::size_t count) {
+    std::size_t padded = (count + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+    for (std::vector<float>* array :
+         {&centerX, &centerY, &centerZ, &radius, &extentX, &extentY, &extentZ}) {
+        array->reserve(padded);
+    }
+    visibility.reserve(padded);
+    visibleIndices.reserve(count);
+}
+
+std::size_t FrustumCuller::addObject(const BoundingVolume& bounds, const glm::mat4& world) {
+    // 前回の判定で埋めた末尾を取り除く
+    if (centerX.size() != objectCount) {
+        for (std::vector<float>* array :
+             {&centerX, &centerY, &centerZ, &radius, &extentX, &extentY, &extentZ}) {
+            array->resize(objectCount);
+        }
+    }
+
+    glm::vec3 center = glm::vec3(world * glm::vec4(bounds.getCenter(), 1.0f));
+
+    // 回転・スケールしたボックスを包む、ワールド軸に平行なボックスの半分の大きさ
+    glm::vec3 axisX(world[0]);
+    glm::vec3 axisY(world[1]);
+    glm::vec3 axisZ(world[2]);
+    glm::vec3 localExtents = bounds.getExtents();
+    glm::vec3 extents = glm::abs(axisX) * localExtents.x + glm::abs(axisY) * localExtents.y +
+                        glm::abs(axisZ) * localExtents.z;
+
+    // 球の半径は最大の軸スケールで拡大する
+    float scale = std::max(glm::length(axisX), std::max(glm::length(axisY), glm::length(axisZ)));
+
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    radius.push_back(bounds.radius * scale);
+    extentX.push_back(extents.x);
+    extentY.push_back(extents.y);
+    extentZ.push_back(extents.z);
+    return objectCount++;
+}
+
+std::size_t FrustumCuller::getObjectCount() const {
+    return objectCount;
+}
+
+void FrustumCuller::cull(const glm::mat4& viewProjection) {
+    glm::vec4 planes[6];
+    extractPlanes(viewProjection, planes);
+
+    beginCull();
+    SoaBounds bounds = {centerX.data(), centerY.data(), centerZ.data(), radius.data(),
+                        extentX.data(), extentY.data(), extentZ.data()};
+    std::size_t visibleCount = cullBlocks(bounds, planes, objectCount, visibility.data(),
+                                          visibleIndices.data());
+    endCull(visibleCount);
+}
+
+void FrustumCuller::cullScalar(const glm::mat4& viewProjection) {
+    glm::vec4 planes[6];
+    extractPlanes(viewProjection, planes);
+
+    beginCull();
+    SoaBounds bounds = {centerX.data(), centerY.data(), centerZ.data(), radius.data(),
+                        extentX.data(), extentY.data(), extentZ.data()};
+    std::size_t visibleCount = 0;
+    for (std::size_t i = 0; i < objectCount; ++i) {
+        if (isInsideScalar(bounds, i, planes)) {
+            visibility[i] = 1;
+            visibleIndices[visibleCount++] = static_cast<std::uint32_t>(i);
+        }
+        else {
+            visibility[i] = 0;
+        }
+    }
+    endCull(visibleCount);
+}
+
+bool FrustumCuller::isVisible(std::size_t index) const {
+    return index < objectCount && visibility[index] != 0;
+}
+
+const std::vector<std::uint32_t>& FrustumCuller::getVisibleIndices() const {
+    return visibleIndices;
+}
+
+const FrustumCuller::Stats& FrustumCuller::getStats() const {
+    return stats;
+}
+
+void FrustumCuller::extractPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]) {
+    // Gribb-Hartmann法: クリップ座標の -w <= x,y,z <= w を行ベクトルの和と差で表す
+    glm::vec4 rows[4];
+    for (int row = 0; row < 4; ++row) {
+        rows[row] = glm::vec4(viewProjection[0][row], viewProjection[1][row],
+                              viewProjection[2][row], viewProjection[3][row]);
+    }
+    planes[0] = rows[3] + rows[0];  // 左
+    planes[1] = rows[3] - rows[0];  // 右
+    planes[2] = rows[3] + rows[1];  // 下
+    planes[3] = rows[3] - rows[1];  // 上
+    planes[4] = rows[3] + rows[2];  // 近
+    planes[5] = rows[3] - rows[2];  // 遠
+
+    // 球の半径と比較できるよう法線を正規化する
+    for (int p = 0; p < 6; ++p) {
+        float length = glm::length(glm::vec3(planes[p]));
+        if (length > 0.0f) {
+            planes[p] = planes[p] / length;
+        }
+    }
+}
+
+const char* FrustumCuller::getInstructionSet() {
+#if defined(CLAUDE_GL_CULL_AVX)
+    return "AVX";
+#elif defined(CLAUDE_GL_CULL_SSE)
+    return "SSE";
+#elif defined(CLAUDE_GL_CULL_NEON)
+    return "NEON";
+#else
+    return "Scalar";
+#endif
+}
+
+void FrustumCuller::beginCull() {
+    // SIMDの幅の倍数まで0で埋める（末尾の判定結果は使わない）
+    std::size_t padded = (objectCount + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+    for (std::vector<float>* array :
+         {&centerX, &centerY, &centerZ, &radius, &extentX, &extentY, &extentZ}) {
+        array->resize(padded, 0.0f);
+    }
+    visibility.resize(padded);
+    visibleIndices.resize(padded);
+}
+
+void FrustumCuller::endCull(std::size_t visibleCount) {
+    visibleIndices.resize(visibleCount);
+    stats.tested = objectCount;
+    stats.culled = objectCount - visibleCount;
+}
+
+} // namespace claude_gl
@@ -0,0 +1,356 @@
+#include "renderer/geometry_allocator.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace claude_gl {
+
+namespace {
+
+/**
+ * @brief 最下位の立っているビットの位置を求める（0以外の値に使う）
+ */
+std::uint32_t findLowestBit(std::uint32_t value) {
+#if defined(__GNUC__)
+    return static_cast<std::uint32_t>(__builtin_ctz(value));
+#else
+    std::uint32_t bit = 0;
+    while ((value & 1u) == 0) {
+        value >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * @brief 最上位の立っているビットの位置を求める（0以外の値に使う）
+ */
+std::uint32_t findHighestBit(std::uint32_t value) {
+#if defined(__GNUC__)
+    return 31u - static_cast<std::uint32_t>(__builtin_clz(value));
+#else
+    std::uint32_t bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+} // namespace
+
+GeometryAllocator::GeometryAllocator(std::uint32_t capacity) {
+    for (auto& lists : freeLists) {
+        std::fill(std::begin(lists), std::end(lists), INVALID_BLOCK);
+    }
+    grow(capacity);
+}
+
+GeometryAllocator::BlockId GeometryAllocator::allocate(std::uint32_t size) {
+    if (size == 0) {
+        throw std::runtime_error("GeometryAllocator: invalid size 0");
+    }
+    BlockId block = findFree(size);
+    if (block == INVALID_BLOCK) {
+        return INVALID_BLOCK;
+    }
+    removeFree(block);
+
+    // 余りは新しい空きブロックとして直後に残す
+    if (blocks[block].size > size) {
+        BlockId rest = createBlock(blocks[block].offset + size, blocks[block].size - size);
+        Block& current = blocks[block];
+        BlockId next = current.nextPhysical;
+        blocks[rest].previousPhysical = block;
+        blocks[rest].nextPhysical = next;
+        if (next != INVALID_BLOCK) {
+            blocks[next].previousPhysical = rest;
+        }
+        else {
+            lastBlock = rest;
+        }
+        current.nextPhysical = rest;
+        current.size = size;
+        insertFree(rest);
+    }
+    blocks[block].free = false;
+    used += size;
+    ++allocations;
+    return block;
+}
+
+void GeometryAllocator::free(BlockId block) {
+    if (block >= blocks.size() || blocks[block].size == 0 || blocks[block].free) {
+        throw std::runtime_error("GeometryAllocator: invalid block " + std::to_string(block));
+    }
+    used -= blocks[block].size;
+    --allocations;
+
+    // 前後の空きブロックと結合する（結合後のブロックは前側の番号を使う）
+    BlockId next = blocks[block].nextPhysical;
+    if (next != INVALID_BLOCK && blocks[next].free) {
+        removeFree(next);
+        mergeNext(block);
+    }
+    BlockId previous = blocks[block].previousPhysical;
+    if (previous != INVALID_BLOCK && blocks[previous].free) {
+        removeFree(previous);
+        mergeNext(previous);
+        block = previous;
+    }
+    insertFree(block);
+}
+
+std::uint32_t GeometryAllocator::getOffset(BlockId block) const {
+    return blocks[block].offset;
+}
+
+std::uint32_t GeometryAllocator::getSize(BlockId block) const {
+    return blocks[block].size;
+}
+
+void GeometryAllocator::grow(std::uint32_t capacity) {
+    if (capacity <= this->capacity) {
+        return;
+    }
+    std::uint32_t extra = capacity - this->capacity;
+    if (lastBlock != INVALID_BLOCK && blocks[lastBlock].free) {
+        // 末尾が空きならそのまま広げる
+        removeFree(lastBlock);
+        blocks[lastBlock].size += extra;
+        insertFree(lastBlock);
+    }
+    else {
+        BlockId tail = createBlock(this->capacity, extra);
+        blocks[tail].previousPhysical = lastBlock;
+        if (lastBlock != INVALID_BLOCK) {
+            blocks[lastBlock].nextPhysical = tail;
+        }
+        lastBlock = tail;
+        insertFree(tail);
+    }
+    this->capacity = capacity;
+}
+
+std::vector<GeometryAllocator::Move> GeometryAllocator::defragment() {
+    std::vector<Move> moves;
+    if (lastBlock == INVALID_BLOCK) {
+        return moves;
+    }
+
+    // 物理的な順に割り当て中のブロックを集め、空きブロックは捨てる
+    BlockId first = lastBlock;
+    while (blocks[first].previousPhysical != INVALID_BLOCK) {
+        first = blocks[first].previousPhysical;
+    }
+    std::vector<BlockId> live;
+    live.reserve(allocations);
+    for (BlockId block = first; block != INVALID_BLOCK;) {
+        BlockId next = blocks[block].nextPhysical;
+        if (blocks[block].free) {
+            destroyBlock(block);
+        }
+        else {
+            live.push_back(block);
+        }
+        block = next;
+    }
+    firstLevelMap = 0;
+    std::fill(std::begin(secondLevelMaps), std::end(secondLevelMaps), 0u);
+    for (auto& lists : freeLists) {
+        std::fill(std::begin(lists), std::end(lists), INVALID_BLOCK);
+    }
+    freeBlocks = 0;
+
+    // 先頭から隙間なく並べ直す
+    std::uint32_t offset = 0;
+    BlockId previous = INVALID_BLOCK;
+    for (BlockId block : live) {
+        Block& current = blocks[block];
+        if (current.offset != offset) {
+            moves.push_back({block, current.offset, offset, current.size});
+            current.offset = offset;
+        }
+        current.previousPhysical = previous;
+        current.nextPhysical = INVALID_BLOCK;
+        if (previous != INVALID_BLOCK) {
+            blocks[previous].nextPhysical = block;
+        }
+        previous = block;
+        offset += current.size;
+    }
+    lastBlock = previous;
+
+    // 残りを末尾の1つの空きブロックにする
+    if (offset < capacity) {
+        BlockId tail = createBlock(offset, capacity - offset);
+        blocks[tail].previousPhysical = previous;
+        if (previous != INVALID_BLOCK) {
+            blocks[previous].nextPhysical = tail;
+        }
+        lastBlock = tail;
+        insertFree(tail);
+    }
+    return moves;
+}
+
+std::uint32_t GeometryAllocator::getCapacity() const {
+    return capacity;
+}
+
+GeometryAllocator::Stats GeometryAllocator::getStats() const {
+    Stats stats;
+    stats.capacity = capacity;
+    stats.used = used;
+    stats.freeBlocks = freeBlocks;
+    stats.allocations = allocations;
+
+    // 最大の空きブロックは空きがある最上位のクラスにある
+    if (firstLevelMap != 0) {
+        std::uint32_t firstLevel = findHighestBit(firstLevelMap);
+        std::uint32_t secondLevel = findHighestBit(secondLevelMaps[firstLevel]);
+        for (BlockId block = freeLists[firstLevel][secondLevel]; block != INVALID_BLOCK;
+             block = blocks[block].nextFree) {
+            stats.largestFree = std::max<std::size_t>(stats.largestFree, blocks[block].size);
+        }
+    }
+    return stats;
+}
+
+void GeometryAllocator::mapSize(std::uint32_t size, std::uint32_t& firstLevel,
+                                std::uint32_t& secondLevel) {
+    if (size < SL_COUNT) {
+        // 小さい大きさは第1段階の0番で1要素ずつのクラスにする
+        firstLevel = 0;
+        secondLevel = size;
+        return;
+    }
+    std::uint32_t bit = findHighestBit(size);
+    firstLevel = bit - SL_BITS + 1;
+    secondLevel = (size >> (bit - SL_BITS)) - SL_COUNT;
+}
+
+GeometryAllocator::BlockId GeometryAllocator::createBlock(std::uint32_t offset,
+                                                          std::uint32_t size) {
+    BlockId block;
+    if (!unusedIds.empty()) {
+        block = unusedIds.back();
+        unusedIds.pop_back();
+    }
+    else {
+        block = static_cast<BlockId>(blocks.size());
+        blocks.emplace_back();
+    }
+    Block& created = blocks[block];
+    created = Block();
+    created.offset = offset;
+    created.size = size;
+    return block;
+}
+
+void GeometryAllocator::destroyBlock(BlockId block) {
+    blocks[block] = Block();
+    unusedIds.push_back(block);
+}
+
+void GeometryAllocator::insertFree(BlockId block) {
+    std::uint32_t firstLevel;
+    std::uint32_t secondLevel;
+    mapSize(blocks[block].size, firstLevel, secondLevel);
+
+    BlockId head = freeLists[firstLevel][secondLevel];
+    Block& inserted = blocks[block];
+    inserted.free = true;
+    inserted.previousFree = INVALID_BLOCK;
+    inserted.nextFree = head;
+    if (head != INVALID_BLOCK) {
+        blocks[head].previousFree = block;
+    }
+    freeLists[firstLevel][secondLevel] = block;
+    firstLevelMap |= 1u << firstLevel;
+    secondLevelMaps[firstLevel] |= 1u << secondLevel;
+    ++freeBlocks;
+}
+
+void GeometryAllocator::removeFree(BlockId block) {
+    std::uint32_t firstLevel;
+    std::uint32_t secondLevel;
+    mapSize(blocks[block].size, firstLevel, secondLevel);
+
+    Block& removed = blocks[block];
+    if (removed.previousFree != INVALID_BLOCK) {
+        blocks[removed.previousFree].nextFree = removed.nextFree;
+    }
+    else {
+        freeLists[firstLevel][secondLevel] = removed.nextFree;
+    }
+    if (removed.nextFree != INVALID_BLOCK) {
+        blocks[removed.nextFree].previousFree = removed.previousFree;
+    }
+    removed.previousFree = INVALID_BLOCK;
+    removed.nextFree = INVALID_BLOCK;
+    removed.free = false;
+
+    if (freeLists[firstLevel][secondLevel] == INVALID_BLOCK) {
+        secondLevelMaps[firstLevel] &= ~(1u << secondLevel);
+        if (secondLevelMaps[firstLevel] == 0) {
+            firstLevelMap &= ~(1u << firstLevel);
+        }
+    }
+    --freeBlocks;
+}
+
+GeometryAllocator::BlockId GeometryAllocator::findFree(std::uint32_t size) const {
+    // 大きさを次のクラスの境界に切り上げ、見つかったクラスのどのブロックでも収まるようにする
+    std::uint64_t rounded = size;
+    if (size >= SL_COUNT) {
+        rounded += (std::uint64_t(1) << (findHighestBit(size) - SL_BITS)) - 1;
+    }
+    if (rounded <= 0xFFFFFFFFu) {
+        std::uint32_t firstLevel;
+        std::uint32_t secondLevel;
+        mapSize(static_cast<std::uint32_t>(rounded), firstLevel, secondLevel);
+
+        std::uint32_t secondLevelMap = secondLevelMaps[firstLevel] & (~0u << secondLevel);
+        if (secondLevelMap == 0) {
+            std::uint32_t firstLevelMask = firstLevel + 1 < FL_COUNT ? ~0u << (firstLevel + 1) : 0;
+            std::uint32_t firstLevelMapAbove = firstLevelMap & firstLevelMask;
+            if (firstLevelMapAbove != 0) {
+                firstLevel = findLowestBit(firstLevelMapAbove);
+                secondLevelMap = secondLevelMaps[firstLevel];
+            }
+        }
+        if (secondLevelMap != 0) {
+            return freeLists[firstLevel][findLowestBit(secondLevelMap)];
+        }
+    }
+
+    // 上のクラスが空の場合は、大きさが属するクラスの中から収まるものを探す
+    std::uint32_t firstLevel;
+    std::uint32_t secondLevel;
+    mapSize(size, firstLevel, secondLevel);
+    for (BlockId block = freeLists[firstLevel][secondLevel]; block != INVALID_BLOCK;
+         block = blocks[block].nextFree) {
+        if (blocks[block].size >= size) {
+            return block;
+        }
+    }
+    return INVALID_BLOCK;
+}
+
+void GeometryAllocator::mergeNext(BlockId block) {
+    BlockId next = blocks[block].nextPhysical;
+    BlockId afterNext = blocks[next].nextPhysical;
+    blocks[block].size += blocks[next].size;
+    blocks[block].nextPhysical = afterNext;
+    if (afterNext != INVALID_BLOCK) {
+        blocks[afterNext].previousPhysical = block;
+    }
+    else {
+        lastBlock = block;
+    }
+    destroyBlock(next);
+}
+
+} // namespace claude_gl
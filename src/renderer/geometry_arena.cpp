@@ -0,0 +1,315 @@
+#include "renderer/geometry_arena.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "renderer/gl_state_cache.h"
+
+namespace claude_gl {
+
+GeometryArena::GeometryArena(std::uint32_t vertexCapacity, std::uint32_t indexCapacity) {
+    if (vertexCapacity == 0 || indexCapacity == 0) {
+        throw std::runtime_error("GeometryArena: invalid capacity " +
+                                 std::to_string(vertexCapacity) + " / " +
+                                 std::to_string(indexCapacity));
+    }
+    glGenVertexArrays(1, &vao);
+    grow(vertexAllocator, vbo, sizeof(Mesh::Vertex), vertexCapacity);
+    grow(indexAllocator, ebo, sizeof(std::uint16_t), indexCapacity);
+    grows = 0;
+}
+
+GeometryArena::~GeometryArena() {
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    if (vao != 0) {
+        stateCache.forgetVertexArray(vao);
+        glDeleteVertexArrays(1, &vao);
+    }
+    for (GLuint buffer : {vbo, ebo}) {
+        if (buffer != 0) {
+            stateCache.forgetBuffer(buffer);
+            glDeleteBuffers(1, &buffer);
+        }
+    }
+}
+
+GeometryArena::Handle GeometryArena::add(const Mesh::Vertex* vertices, std::size_t vertexCount,
+                                         const unsigned int* indices, std::size_t indexCount) {
+    if (vertexCount == 0 || !canStore(vertexCount) || indexCount == 0 ||
+        indexCount > 0xFFFFFFFFu) {
+        throw std::runtime_error("GeometryArena: invalid mesh " + std::to_string(vertexCount) +
+                                 " vertices, " + std::to_string(indexCount) + " indices");
+    }
+    GeometryAllocator::BlockId vertexBlock = allocateBlock(
+        vertexAllocator, vbo, sizeof(Mesh::Vertex), static_cast<std::uint32_t>(vertexCount));
+    GeometryAllocator::BlockId indexBlock = allocateBlock(
+        indexAllocator, ebo, sizeof(std::uint16_t), static_cast<std::uint32_t>(indexCount));
+
+    // インデックスはメッシュ内の番号のまま16ビットに詰める（位置は baseVertex で合わせる）
+    std::vector<std::uint16_t> shortIndices(indices, indices + indexCount);
+
+    // EBOのバインドはVAOの状態なので、転送はコピー用のバインド先で行う
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER,
+                    static_cast<GLintptr>(vertexAllocator.getOffset(vertexBlock) *
+                                          sizeof(Mesh::Vertex)),
+                    static_cast<GLsizeiptr>(vertexCount * sizeof(Mesh::Vertex)), vertices);
+    stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER,
+                    static_cast<GLintptr>(indexAllocator.getOffset(indexBlock) *
+                                          sizeof(std::uint16_t)),
+                    static_cast<GLsizeiptr>(indexCount * sizeof(std::uint16_t)),
+                    shortIndices.data());
+
+    Handle handle = allocateHandle();
+    entries[handle] = {vertexBlock, indexBlock, static_cast<GLsizei>(indexCount), 0, false};
+    ++meshCount;
+    return handle;
+}
+
+GeometryArena::Handle GeometryArena::addView(Handle handle, std::uint32_t firstIndex,
+                                             std::uint32_t indexCount) {
+    if (handle >= entries.size() || entries[handle].indexCount == 0 || entries[handle].view ||
+        indexCount == 0 ||
+        std::uint64_t(firstIndex) + indexCount > std::uint64_t(entries[handle].indexCount)) {
+        throw std::runtime_error("GeometryArena: invalid view " + std::to_string(handle) + " [" +
+                                 std::to_string(firstIndex) + ", +" +
+                                 std::to_string(indexCount) + "]");
+    }
+    // ブロックの番号は断片化の解消で移動しても変わらないため、参照するだけでよい
+    Entry source = entries[handle];
+    Handle view = allocateHandle();
+    entries[view] = {source.vertexBlock, source.indexBlock, static_cast<GLsizei>(indexCount),
+                     firstIndex, true};
+    return view;
+}
+
+void GeometryArena::remove(Handle handle) {
+    if (handle >= entries.size() || entries[handle].indexCount == 0) {
+        throw std::runtime_error("GeometryArena: invalid handle " + std::to_string(handle));
+    }
+    Entry& entry = entries[handle];
+    if (!entry.view) {
+        vertexAllocator.free(entry.vertexBlock);
+        indexAllocator.free(entry.indexBlock);
+        --meshCount;
+    }
+    entry = Entry{GeometryAllocator::INVALID_BLOCK, GeometryAllocator::INVALID_BLOCK, 0, 0, false};
+    unusedHandles.push_back(handle);
+}
+
+void GeometryArena::bind() const {
+    GlStateCache::getInstance().bindVertexArray(vao);
+}
+
+void GeometryArena::draw(Handle handle) const {
+    const Entry& entry = entries[handle];
+    glDrawElementsBaseVertex(GL_TRIANGLES, entry.indexCount, GL_UNSIGNED_SHORT,
+                             getIndexPointer(entry),
+                             static_cast<GLint>(vertexAllocator.getOffset(entry.vertexBlock)));
+}
+
+void GeometryArena::drawMulti(const Handle* handles, std::size_t count) const {
+    if (count == 1) {
+        draw(handles[0]);
+        return;
+    }
+    drawCounts.resize(count);
+    drawOffsets.resize(count);
+    baseVertices.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const Entry& entry = entries[handles[i]];
+        drawCounts[i] = entry.indexCount;
+        drawOffsets[i] = getIndexPointer(entry);
+        baseVertices[i] = static_cast<GLint>(vertexAllocator.getOffset(entry.vertexBlock));
+    }
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, drawCounts.data(), GL_UNSIGNED_SHORT,
+                                  drawOffsets.data(), static_cast<GLsizei>(count),
+                                  baseVertices.data());
+}
+
+void GeometryArena::drawRanges(Handle handle, const std::uint32_t* firstIndices,
+                               const GLsizei* indexCounts, std::size_t count) const {
+    const Entry& entry = entries[handle];
+    std::uintptr_t first = std::uintptr_t(indexAllocator.getOffset(entry.indexBlock)) +
+                           entry.firstIndex;
+    GLint baseVertex = static_cast<GLint>(vertexAllocator.getOffset(entry.vertexBlock));
+    drawOffsets.resize(count);
+    baseVertices.assign(count, baseVertex);
+    for (std::size_t i = 0; i < count; ++i) {
+        drawOffsets[i] =
+            reinterpret_cast<const void*>((first + firstIndices[i]) * sizeof(std::uint16_t));
+    }
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, indexCounts, GL_UNSIGNED_SHORT,
+                                  drawOffsets.data(), static_cast<GLsizei>(count),
+                                  baseVertices.data());
+}
+
+void GeometryArena::drawInstanced(Handle handle, const InstanceBuffer& instances) const {
+    if (instances.getCount() == 0) {
+        return;
+    }
+    bind();
+
+    // インスタンスストリームの接続はVAOに記録されるため、バッファか位置が変わった時だけ行う
+    GLuint buffer = instances.getBuffer();
+    GLintptr offset = instances.getOffset();
+    if (instanceVbo != buffer || instanceOffset != offset) {
+        InstanceBuffer::Layout::setup(&buffer, &offset);
+        instanceVbo = buffer;
+        instanceOffset = offset;
+    }
+
+    const Entry& entry = entries[handle];
+    glDrawElementsInstancedBaseVertex(
+        GL_TRIANGLES, entry.indexCount, GL_UNSIGNED_SHORT, getIndexPointer(entry),
+        static_cast<GLsizei>(instances.getCount()),
+        static_cast<GLint>(vertexAllocator.getOffset(entry.vertexBlock)));
+}
+
+IndirectDrawBuffer::Command GeometryArena::getDrawCommand(Handle handle) const {
+    const Entry& entry = entries[handle];
+    IndirectDrawBuffer::Command command;
+    command.count = static_cast<GLuint>(entry.indexCount);
+    command.firstIndex = indexAllocator.getOffset(entry.indexBlock) + entry.firstIndex;
+    command.baseVertex = static_cast<GLint>(vertexAllocator.getOffset(entry.vertexBlock));
+    return command;
+}
+
+void GeometryArena::defragment() {
+    bool moved = compact(vertexAllocator, vbo, sizeof(Mesh::Vertex));
+    moved = compact(indexAllocator, ebo, sizeof(std::uint16_t)) || moved;
+    defragmentations += moved ? 1 : 0;
+}
+
+bool GeometryArena::canStore(std::size_t vertexCount) {
+    return vertexCount <= MAX_VERTICES_PER_MESH;
+}
+
+GeometryArena::Stats GeometryArena::getStats() const {
+    Stats stats;
+    stats.vertices = vertexAllocator.getStats();
+    stats.indices = indexAllocator.getStats();
+    stats.meshes = meshCount;
+    stats.grows = grows;
+    stats.defragmentations = defragmentations;
+    stats.movedBytes = movedBytes;
+    return stats;
+}
+
+GeometryAllocator::BlockId GeometryArena::allocateBlock(GeometryAllocator& allocator,
+                                                        GLuint& buffer, std::size_t elementSize,
+                                                        std::uint32_t size) {
+    GeometryAllocator::BlockId block = allocator.allocate(size);
+    if (block != GeometryAllocator::INVALID_BLOCK) {
+        return block;
+    }
+
+    // 空きの合計が足りていれば詰めるだけで収まる。足りなければ倍に広げる
+    GeometryAllocator::Stats stats = allocator.getStats();
+    if (stats.capacity - stats.used >= size) {
+        if (compact(allocator, buffer, elementSize)) {
+            ++defragmentations;
+        }
+    }
+    else {
+        std::uint64_t capacity = std::max<std::uint64_t>(std::uint64_t(stats.capacity) * 2,
+                                                         std::uint64_t(stats.used) + size);
+        if (capacity > 0xFFFFFFFFu) {
+            throw std::runtime_error("GeometryArena: capacity exceeded " +
+                                     std::to_string(capacity));
+        }
+        grow(allocator, buffer, elementSize, static_cast<std::uint32_t>(capacity));
+    }
+    block = allocator.allocate(size);
+    if (block == GeometryAllocator::INVALID_BLOCK) {
+        throw std::runtime_error("GeometryArena: allocation failed " + std::to_string(size));
+    }
+    return block;
+}
+
+bool GeometryArena::compact(GeometryAllocator& allocator, GLuint buffer,
+                            std::size_t elementSize) {
+    std::vector<GeometryAllocator::Move> moves = allocator.defragment();
+    if (moves.empty()) {
+        return false;
+    }
+
+    // 移動元と移動先が重なることがあるため、移動する範囲を一時バッファに写してから戻す
+    GLintptr sourceBegin = static_cast<GLintptr>(moves.front().from * elementSize);
+    GLintptr sourceEnd = static_cast<GLintptr>((moves.back().from + moves.back().size) *
+                                               elementSize);
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    GLuint scratch = 0;
+    glGenBuffers(1, &scratch);
+    stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, scratch);
+    glBufferData(GL_COPY_WRITE_BUFFER, sourceEnd - sourceBegin, nullptr, GL_STREAM_COPY);
+    stateCache.bindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sourceBegin, 0,
+                        sourceEnd - sourceBegin);
+
+    stateCache.bindBuffer(GL_COPY_READ_BUFFER, scratch);
+    stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    for (const GeometryAllocator::Move& move : moves) {
+        GLsizeiptr bytes = static_cast<GLsizeiptr>(move.size * elementSize);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                            static_cast<GLintptr>(move.from * elementSize) - sourceBegin,
+                            static_cast<GLintptr>(move.to * elementSize), bytes);
+        movedBytes += static_cast<std::size_t>(bytes);
+    }
+    stateCache.forgetBuffer(scratch);
+    glDeleteBuffers(1, &scratch);
+    return true;
+}
+
+void GeometryArena::grow(GeometryAllocator& allocator, GLuint& buffer, std::size_t elementSize,
+                         std::uint32_t capacity) {
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    GLuint resized = 0;
+    glGenBuffers(1, &resized);
+    stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, resized);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(capacity * elementSize), nullptr,
+                 GL_STATIC_DRAW);
+
+    // 以前の内容はGPU内でコピーする（ブロックのオフセットは変わらない）
+    if (buffer != 0) {
+        stateCache.bindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                            static_cast<GLsizeiptr>(allocator.getCapacity() * elementSize));
+        stateCache.forgetBuffer(buffer);
+        glDeleteBuffers(1, &buffer);
+    }
+    buffer = resized;
+    allocator.grow(capacity);
+    ++grows;
+    attachBuffers();
+}
+
+void GeometryArena::attachBuffers() {
+    if (vbo == 0 || ebo == 0) {
+        return;
+    }
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    stateCache.bindVertexArray(vao);
+    stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    Mesh::InterleavedLayout::setup(&vbo);
+    stateCache.bindVertexArray(0);
+}
+
+GeometryArena::Handle GeometryArena::allocateHandle() {
+    if (!unusedHandles.empty()) {
+        Handle handle = unusedHandles.back();
+        unusedHandles.pop_back();
+        return handle;
+    }
+    entries.emplace_back();
+    return static_cast<Handle>(entries.size() - 1);
+}
+
+const void* GeometryArena::getIndexPointer(const Entry& entry) const {
+    std::uintptr_t offset = (std::uintptr_t(indexAllocator.getOffset(entry.indexBlock)) +
+                             entry.firstIndex) * sizeof(std::uint16_t);
+    return reinterpret_cast<const void*>(offset);
+}
+
+} // namespace claude_gl
@@ -0,0 +1,92 @@
+#include "renderer/gl_extensions.h"
+#include <cstring>
+
+namespace claude_gl {
+
+void GlExtensions::load(GLADloadfunc loader) {
+    GlExtensions& extensions = getInstance();
+    extensions = GlExtensions();
+
+    GLint major = 0;
+    GLint minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    extensions.version = major * 10 + minor;
+
+    // 3.3 を要求しても、ドライバーは互換性のある新しいバージョンのコンテキストを返すことが多い
+    if (extensions.version >= 44 || hasExtension("GL_ARB_buffer_storage")) {
+        extensions.bufferStorage =
+            reinterpret_cast<BufferStorageFunction>(loader("glBufferStorage"));
+    }
+    if (extensions.version >= 43 || (hasExtension("GL_ARB_multi_draw_indirect") &&
+                                     hasExtension("GL_ARB_shader_storage_buffer_object"))) {
+        extensions.multiDrawElementsIndirect = reinterpret_cast<MultiDrawIndirectFunction>(
+            loader("glMultiDrawElementsIndirect"));
+    }
+    if (extensions.version >= 43 || hasExtension("GL_ARB_compute_shader")) {
+        extensions.dispatchCompute =
+            reinterpret_cast<DispatchComputeFunction>(loader("glDispatchCompute"));
+        extensions.memoryBarrier =
+            reinterpret_cast<MemoryBarrierFunction>(loader("glMemoryBarrier"));
+        extensions.bindImageTexture =
+            reinterpret_cast<BindImageTextureFunction>(loader("glBindImageTexture"));
+        extensions.clearBufferSubData =
+            reinterpret_cast<ClearBufferSubDataFunction>(loader("glClearBufferSubData"));
+    }
+    const char* indirectCount = extensions.version >= 46 ? "glMultiDrawElementsIndirectCount"
+        : hasExtension("GL_ARB_indirect_parameters") ? "glMultiDrawElementsIndirectCountARB"
+        : nullptr;
+    if (indirectCount) {
+        extensions.multiDrawElementsIndirectCount =
+            reinterpret_cast<MultiDrawIndirectCountFunction>(loader(indirectCount));
+    }
+    // シェーダーは GLSL 4.60 の gl_DrawID ではなく、4.3 から使える拡張機能の gl_DrawIDARB を使う
+    extensions.shaderDrawParameters = hasExtension("GL_ARB_shader_draw_parameters");
+}
+
+const GlExtensions& GlExtensions::get() {
+    return getInstance();
+}
+
+int GlExtensions::getVersion() const {
+    return version;
+}
+
+bool GlExtensions::hasBufferStorage() const {
+    return bufferStorage != nullptr;
+}
+
+bool GlExtensions::hasMultiDrawIndirect() const {
+    return multiDrawElementsIndirect != nullptr;
+}
+
+bool GlExtensions::hasShaderDrawParameters() const {
+    return shaderDrawParameters;
+}
+
+bool GlExtensions::hasComputeShader() const {
+    return dispatchCompute && memoryBarrier && bindImageTexture && clearBufferSubData;
+}
+
+bool GlExtensions::hasIndirectCount() const {
+    return multiDrawElementsIndirectCount != nullptr;
+}
+
+GlExtensions& GlExtensions::getInstance() {
+    static GlExtensions instance;
+    return instance;
+}
+
+bool GlExtensions::hasExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const GLubyte* extension = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+        if (extension && std::strcmp(reinterpret_cast<const char*>(extension), name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace claude_gl
@@ -0,0 +1,276 @@
+#include "renderer/gl_state_cache.h"
+#include <stdexcept>
+#include <string>
+#include "renderer/gl_extensions.h"
+
+namespace claude_gl {
+
+namespace {
+
+/**
+ * @brief 呼び出しを発行したか省いたかを数える
+ */
+inline void count(GlStateCache::Counter& counter, bool issued) {
+    if (issued) {
+        ++counter.issued;
+    }
+    else {
+        ++counter.skipped;
+    }
+}
+
+} // namespace
+
+bool PipelineState::operator==(const PipelineState& other) const {
+    return depthTest == other.depthTest && depthWrite == other.depthWrite &&
+           depthFunc == other.depthFunc && blend == other.blend &&
+           blendSource == other.blendSource && blendDestination == other.blendDestination &&
+           cullFace == other.cullFace && cullMode == other.cullMode &&
+           frontFace == other.frontFace;
+}
+
+GlStateCache::Counter GlStateCache::Stats::getTotal() const {
+    Counter total;
+    for (const Counter* counter : {&programs, &vertexArrays, &buffers, &textures, &pipeline}) {
+        total.issued += counter->issued;
+        total.skipped += counter->skipped;
+    }
+    return total;
+}
+
+GlStateCache& GlStateCache::getInstance() {
+    static GlStateCache instance;
+    return instance;
+}
+
+GlStateCache::GlStateCache() {
+    invalidate();
+}
+
+GlStateCache::PipelineHandle GlStateCache::createPipeline(const PipelineState& state) {
+    // 状態の種類は少ないため線形探索で同じ内容を探す
+    for (std::size_t i = 0; i < pipelines.size(); ++i) {
+        if (pipelines[i] == state) {
+            return static_cast<PipelineHandle>(i);
+        }
+    }
+    pipelines.push_back(state);
+    return static_cast<PipelineHandle>(pipelines.size() - 1);
+}
+
+const PipelineState& GlStateCache::getPipeline(PipelineHandle pipeline) const {
+    if (pipeline >= pipelines.size()) {
+        throw std::runtime_error("GlStateCache: invalid pipeline " + std::to_string(pipeline));
+    }
+    return pipelines[pipeline];
+}
+
+void GlStateCache::bindPipeline(PipelineHandle pipeline) {
+    const PipelineState& state = getPipeline(pipeline);
+    const PipelineState& current = currentPipeline;
+    const bool known = pipelineKnown;
+
+    setCapability(GL_DEPTH_TEST, state.depthTest, current.depthTest);
+    bool issue = !known || state.depthWrite != current.depthWrite;
+    if (issue) {
+        glDepthMask(state.depthWrite ? GL_TRUE : GL_FALSE);
+    }
+    count(frameStats.pipeline, issue);
+    issue = !known || state.depthFunc != current.depthFunc;
+    if (issue) {
+        glDepthFunc(state.depthFunc);
+    }
+    count(frameStats.pipeline, issue);
+
+    setCapability(GL_BLEND, state.blend, current.blend);
+    issue = !known || state.blendSource != current.blendSource ||
+            state.blendDestination != current.blendDestination;
+    if (issue) {
+        glBlendFunc(state.blendSource, state.blendDestination);
+    }
+    count(frameStats.pipeline, issue);
+
+    setCapability(GL_CULL_FACE, state.cullFace, current.cullFace);
+    issue = !known || state.cullMode != current.cullMode;
+    if (issue) {
+        glCullFace(state.cullMode);
+    }
+    count(frameStats.pipeline, issue);
+    issue = !known || state.frontFace != current.frontFace;
+    if (issue) {
+        glFrontFace(state.frontFace);
+    }
+    count(frameStats.pipeline, issue);
+
+    currentPipeline = state;
+    pipelineKnown = true;
+}
+
+void GlStateCache::useProgram(GLuint program) {
+    bool issue = program != currentProgram;
+    if (issue) {
+        glUseProgram(program);
+        currentProgram = program;
+    }
+    count(frameStats.programs, issue);
+}
+
+void GlStateCache::bindVertexArray(GLuint vertexArray) {
+    bool issue = vertexArray != currentVertexArray;
+    if (issue) {
+        glBindVertexArray(vertexArray);
+        currentVertexArray = vertexArray;
+        // インデックスバッファのバインドはVAOごとの状態
+        currentBuffers[getBufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+    }
+    count(frameStats.vertexArrays, issue);
+}
+
+void GlStateCache::bindBuffer(GLenum target, GLuint buffer) {
+    std::size_t slot = getBufferSlot(target);
+    bool issue = slot == BUFFER_TARGET_COUNT || buffer != currentBuffers[slot];
+    if (issue) {
+        glBindBuffer(target, buffer);
+        if (slot != BUFFER_TARGET_COUNT) {
+            currentBuffers[slot] = buffer;
+        }
+    }
+    count(frameStats.buffers, issue);
+}
+
+void GlStateCache::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset,
+                                   GLsizeiptr size) {
+    RangeBinding* binding = target == GL_UNIFORM_BUFFER && index < UNIFORM_BINDING_COUNT
+                                ? &uniformBindings[index]
+                                : nullptr;
+    if (binding && binding->buffer == buffer && binding->offset == offset &&
+        binding->size == size) {
+        ++frameStats.buffers.skipped;
+        return;
+    }
+    glBindBufferRange(target, index, buffer, offset, size);
+    ++frameStats.buffers.issued;
+    if (binding) {
+        *binding = {buffer, offset, size};
+    }
+    std::size_t slot = getBufferSlot(target);
+    if (slot != BUFFER_TARGET_COUNT) {
+        currentBuffers[slot] = buffer;
+    }
+}
+
+void GlStateCache::bindTexture(GLuint unit, GLenum target, GLuint texture) {
+    if (unit >= TEXTURE_UNIT_COUNT) {
+        // キャッシュしないユニットはそのまま発行し、アクティブなユニットは不明にする
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, texture);
+        activeTextureUnit = UNKNOWN;
+        frameStats.textures.issued += 2;
+        return;
+    }
+
+    TextureBinding& binding = textures[unit];
+    if (binding.target == target && binding.texture == texture) {
+        ++frameStats.textures.skipped;
+        return;
+    }
+    bool activate = unit != activeTextureUnit;
+    if (activate) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        activeTextureUnit = unit;
+    }
+    count(frameStats.textures, activate);
+    glBindTexture(target, texture);
+    ++frameStats.textures.issued;
+    binding.target = target;
+    binding.texture = texture;
+}
+
+void GlStateCache::forgetProgram(GLuint program) {
+    if (currentProgram == program) {
+        currentProgram = UNKNOWN;
+    }
+}
+
+void GlStateCache::forgetVertexArray(GLuint vertexArray) {
+    if (currentVertexArray == vertexArray) {
+        currentVertexArray = UNKNOWN;
+        currentBuffers[getBufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+    }
+}
+
+void GlStateCache::forgetBuffer(GLuint buffer) {
+    for (GLuint& current : currentBuffers) {
+        if (current == buffer) {
+            current = UNKNOWN;
+        }
+    }
+    for (RangeBinding& binding : uniformBindings) {
+        if (binding.buffer == buffer) {
+            binding = RangeBinding();
+        }
+    }
+}
+
+void GlStateCache::forgetTexture(GLuint texture) {
+    for (TextureBinding& binding : textures) {
+        if (binding.texture == texture) {
+            binding.texture = UNKNOWN;
+        }
+    }
+}
+
+void GlStateCache::invalidate() {
+    pipelineKnown = false;
+    currentProgram = UNKNOWN;
+    currentVertexArray = UNKNOWN;
+    for (GLuint& buffer : currentBuffers) {
+        buffer = UNKNOWN;
+    }
+    activeTextureUnit = UNKNOWN;
+    for (TextureBinding& binding : textures) {
+        binding = TextureBinding();
+    }
+    for (RangeBinding& binding : uniformBindings) {
+        binding = RangeBinding();
+    }
+}
+
+void GlStateCache::beginFrame() {
+    lastFrameStats = frameStats;
+    frameStats = Stats();
+}
+
+const GlStateCache::Stats& GlStateCache::getFrameStats() const {
+    return lastFrameStats;
+}
+
+std::size_t GlStateCache::getBufferSlot(GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER: return 0;
+        case GL_ELEMENT_ARRAY_BUFFER: return 1;
+        case GL_UNIFORM_BUFFER: return 2;
+        case GL_COPY_READ_BUFFER: return 3;
+        case GL_COPY_WRITE_BUFFER: return 4;
+        case GL_PIXEL_PACK_BUFFER: return 5;
+        case GL_PIXEL_UNPACK_BUFFER: return 6;
+        case GL_DRAW_INDIRECT_BUFFER: return 7;
+        case GL_SHADER_STORAGE_BUFFER: return 8;
+        default: return BUFFER_TARGET_COUNT;
+    }
+}
+
+void GlStateCache::setCapability(GLenum capability, bool enabled, bool current) {
+    bool issue = !pipelineKnown || enabled != current;
+    if (issue) {
+        if (enabled) {
+            glEnable(capability);
+        }
+        else {
+            glDisable(capability);
+        }
+    }
+    count(frameStats.pipeline, issue);
+}
+
+} // namespace claude_gl
@@ -0,0 +1,370 @@
+#include "renderer/gpu_culler.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include "renderer/gl_extensions.h"
+#include "renderer/gl_state_cache.h"
+
+namespace claude_gl {
+
+namespace {
+
+// cull.comp の SSBO のバインディングポイント
+constexpr GLuint SOURCE_COMMAND_BINDING = 0;
+constexpr GLuint SOURCE_DRAW_BINDING = 1;
+constexpr GLuint BOUNDS_BINDING = 2;
+constexpr GLuint OUTPUT_COMMAND_BINDING = 3;
+constexpr GLuint OUTPUT_DRAW_BINDING = 4;
+constexpr GLuint COUNTER_BINDING = 5;
+
+// 深度を読むテクスチャユニット（cull.comp と depth_reduce.comp の binding = 0）
+constexpr GLuint DEPTH_TEXTURE_UNIT = 0;
+
+// ワークグループの大きさ（シェーダーの local_size と合わせる）
+constexpr GLuint CULL_GROUP_SIZE = 64;
+constexpr GLuint REDUCE_GROUP_SIZE = 8;
+
+constexpr UniformName DRAW_COUNT("drawCount");
+constexpr UniformName OUTPUT_FIRST("outputFirst");
+constexpr UniformName COUNTER_FIRST("counterFirst");
+constexpr UniformName VIEW_PROJECTION("viewProjection");
+constexpr UniformName PYRAMID_VIEW_PROJECTION("pyramidViewProjection");
+constexpr UniformName PYRAMID_LEVELS("pyramidLevels");
+constexpr UniformName CAMERA_POSITION("cameraPosition");
+constexpr UniformName SOURCE_LEVEL("sourceLevel");
+
+/**
+ * @brief 値をアラインメントの倍数に切り上げる
+ */
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * @brief SSBOの範囲のオフセットのアラインメントを取得する
+ */
+std::size_t queryStorageAlignment() {
+    GLint alignment = 0;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return static_cast<std::size_t>(std::max(alignment, 1));
+}
+
+/**
+ * @brief 最近傍で読み、端を繰り返さないテクスチャの設定をする（バインド済みのもの）
+ */
+void setNearestSampling(GLenum minFilter, int maxLevel) {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(minFilter));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+}
+
+} // namespace
+
+GpuCuller::GpuCuller(const Shader& cullShader, const Shader& depthReduceShader,
+                     std::size_t maxDraws)
+    : cullShader(&cullShader), depthReduceShader(&depthReduceShader), maxDraws(maxDraws) {
+    if (!isSupported() || maxDraws == 0) {
+        throw std::runtime_error("GpuCuller: unsupported context or invalid size " +
+                                 std::to_string(maxDraws));
+    }
+    // 出力の範囲の先頭の描画ごとのデータが SSBO のアラインメントに揃う描画数の単位
+    std::size_t alignment = queryStorageAlignment();
+    drawStep = alignment / std::gcd(alignment, sizeof(IndirectDrawBuffer::DrawData));
+    this->maxDraws = alignUp(maxDraws, drawStep);
+    outputDrawOffset = static_cast<GLintptr>(
+        alignUp(this->maxDraws * sizeof(IndirectDrawBuffer::Command), alignment));
+
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    glGenBuffers(1, &outputBuffer);
+    stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, outputBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER,
+                 outputDrawOffset + static_cast<GLsizeiptr>(
+                                        this->maxDraws * sizeof(IndirectDrawBuffer::DrawData)),
+                 nullptr, GL_DYNAMIC_COPY);
+
+    GLsizeiptr counterSize =
+        static_cast<GLsizeiptr>(MAX_BATCHES * COUNTERS_PER_BATCH * sizeof(GLuint));
+    glGenBuffers(1, &counterBuffer);
+    stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, counterBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, counterSize, nullptr, GL_DYNAMIC_COPY);
+
+    glGenBuffers(READBACK_COUNT, readbackBuffers);
+    for (GLuint buffer : readbackBuffers) {
+        stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, counterSize, nullptr, GL_STREAM_READ);
+    }
+    culledBatches.reserve(MAX_BATCHES);
+}
+
+GpuCuller::~GpuCuller() {
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    for (GLsync fence : readbackFences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    for (GLuint buffer : readbackBuffers) {
+        stateCache.forgetBuffer(buffer);
+    }
+    glDeleteBuffers(READBACK_COUNT, readbackBuffers);
+    for (GLuint buffer : {outputBuffer, counterBuffer}) {
+        stateCache.forgetBuffer(buffer);
+        glDeleteBuffers(1, &buffer);
+    }
+    for (GLuint texture : {depthTexture, pyramidTexture}) {
+        if (texture != 0) {
+            stateCache.forgetTexture(texture);
+            glDeleteTextures(1, &texture);
+        }
+    }
+}
+
+bool GpuCuller::isSupported() {
+    return IndirectDrawBuffer::isSupported() && GlExtensions::get().hasComputeShader();
+}
+
+void GpuCuller::beginFrame(const glm::mat4& viewProjection, const glm::vec3& cameraPosition) {
+    collectReadbacks();
+    ++frame;
+    this->viewProjection = viewProjection;
+    this->cameraPosition = cameraPosition;
+    culledBatches.clear();
+    outputCount = 0;
+
+    // cull() ごとのカウンタを0にする
+    GlStateCache::getInstance().bindBuffer(GL_COPY_WRITE_BUFFER, counterBuffer);
+    GlExtensions::get().clearBufferSubData(
+        GL_COPY_WRITE_BUFFER, GL_R32UI, 0,
+        static_cast<GLsizeiptr>(MAX_BATCHES * COUNTERS_PER_BATCH * sizeof(GLuint)),
+        GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+}
+
+int GpuCuller::cull(GLuint source, const IndirectDrawBuffer::Batch& batch) {
+    std::size_t first = alignUp(outputCount, drawStep);
+    if (batch.count == 0 || culledBatches.size() == MAX_BATCHES ||
+        first + batch.count > maxDraws) {
+        return -1;
+    }
+    outputCount = first + batch.count;
+    int culledBatch = static_cast<int>(culledBatches.size());
+    culledBatches.push_back({first, batch.count});
+
+    const GlExtensions& extensions = GlExtensions::get();
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    GLintptr commandOffset =
+        static_cast<GLintptr>(first * sizeof(IndirectDrawBuffer::Command));
+    GLsizeiptr commandSize =
+        static_cast<GLsizeiptr>(batch.count * sizeof(IndirectDrawBuffer::Command));
+
+    // 描画数をバッファから読めない場合は、残らなかった分が空の描画になるよう0で埋める
+    if (!extensions.hasIndirectCount()) {
+        stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, outputBuffer);
+        extensions.clearBufferSubData(GL_COPY_WRITE_BUFFER, GL_R32UI, commandOffset, commandSize,
+                                      GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    }
+
+    stateCache.bindBufferRange(GL_SHADER_STORAGE_BUFFER, SOURCE_COMMAND_BINDING, source,
+                               batch.commandOffset, commandSize);
+    stateCache.bindBufferRange(
+        GL_SHADER_STORAGE_BUFFER, SOURCE_DRAW_BINDING, source, batch.drawOffset,
+        static_cast<GLsizeiptr>(batch.count * sizeof(IndirectDrawBuffer::DrawData)));
+    stateCache.bindBufferRange(
+        GL_SHADER_STORAGE_BUFFER, BOUNDS_BINDING, source, batch.boundsOffset,
+        static_cast<GLsizeiptr>(batch.count * sizeof(IndirectDrawBuffer::CullBounds)));
+    stateCache.bindBufferRange(GL_SHADER_STORAGE_BUFFER, OUTPUT_COMMAND_BINDING, outputBuffer, 0,
+                               outputDrawOffset);
+    stateCache.bindBufferRange(
+        GL_SHADER_STORAGE_BUFFER, OUTPUT_DRAW_BINDING, outputBuffer, outputDrawOffset,
+        static_cast<GLsizeiptr>(maxDraws * sizeof(IndirectDrawBuffer::DrawData)));
+    stateCache.bindBufferRange(
+        GL_SHADER_STORAGE_BUFFER, COUNTER_BINDING, counterBuffer, 0,
+        static_cast<GLsizeiptr>(MAX_BATCHES * COUNTERS_PER_BATCH * sizeof(GLuint)));
+
+    // 前フレームに作ったピラミッドだけを遮蔽の判定に使う（途中で止めていた場合は古い）
+    bool occlusion = occlusionCulling && pyramidFrame != 0 && pyramidFrame + 1 == frame;
+    cullShader->use();
+    cullShader->setInt(DRAW_COUNT, static_cast<int>(batch.count));
+    cullShader->setInt(OUTPUT_FIRST, static_cast<int>(first));
+    cullShader->setInt(COUNTER_FIRST, culledBatch * static_cast<int>(COUNTERS_PER_BATCH));
+    cullShader->setMat4(VIEW_PROJECTION, viewProjection);
+    cullShader->setVec3(CAMERA_POSITION, cameraPosition);
+    cullShader->setMat4(PYRAMID_VIEW_PROJECTION, pyramidViewProjection);
+    cullShader->setInt(PYRAMID_LEVELS, occlusion ? pyramidLevels : 0);
+    if (occlusion) {
+        stateCache.bindTexture(DEPTH_TEXTURE_UNIT, GL_TEXTURE_2D, pyramidTexture);
+    }
+    extensions.dispatchCompute(
+        static_cast<GLuint>((batch.count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE), 1, 1);
+
+    // 詰めたコマンドは間接描画の引数として、描画ごとのデータは頂点シェーダーが読む
+    extensions.memoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    return culledBatch;
+}
+
+void GpuCuller::draw(int culledBatch) {
+    const CulledBatch& batch = culledBatches.at(static_cast<std::size_t>(culledBatch));
+    const GlExtensions& extensions = GlExtensions::get();
+    GlStateCache& stateCache = GlStateCache::getInstance();
+
+    // gl_DrawIDARB は呼び出しごとに0から数えるため、SSBOの範囲をこの出力の先頭に合わせる
+    stateCache.bindBufferRange(
+        GL_SHADER_STORAGE_BUFFER, IndirectDrawBuffer::DRAW_DATA_BINDING, outputBuffer,
+        outputDrawOffset +
+            static_cast<GLintptr>(batch.first * sizeof(IndirectDrawBuffer::DrawData)),
+        static_cast<GLsizeiptr>(batch.count * sizeof(IndirectDrawBuffer::DrawData)));
+    stateCache.bindBuffer(GL_DRAW_INDIRECT_BUFFER, outputBuffer);
+    const void* commands =
+        reinterpret_cast<const void*>(batch.first * sizeof(IndirectDrawBuffer::Command));
+    if (extensions.hasIndirectCount()) {
+        stateCache.bindBuffer(GL_PARAMETER_BUFFER, counterBuffer);
+        extensions.multiDrawElementsIndirectCount(
+            GL_TRIANGLES, GL_UNSIGNED_SHORT, commands,
+            static_cast<GLintptr>(culledBatch * COUNTERS_PER_BATCH * sizeof(GLuint)),
+            static_cast<GLsizei>(batch.count), 0);
+    }
+    else {
+        extensions.multiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_SHORT, commands,
+                                             static_cast<GLsizei>(batch.count), 0);
+    }
+}
+
+void GpuCuller::endFrame() {
+    GlStateCache& stateCache = GlStateCache::getInstance();
+
+    // 判定の数をコピーしてフェンスを置く（結果待ちで埋まっている場合はこのフレームを読まない）
+    GLsync& fence = readbackFences[nextReadback];
+    if (!culledBatches.empty() && !fence) {
+        stateCache.bindBuffer(GL_COPY_READ_BUFFER, counterBuffer);
+        stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, readbackBuffers[nextReadback]);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                            static_cast<GLsizeiptr>(culledBatches.size() * COUNTERS_PER_BATCH *
+                                                    sizeof(GLuint)));
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        readbackBatches[nextReadback] = culledBatches.size();
+        readbackFrames[nextReadback] = frame;
+        nextReadback = (nextReadback + 1) % READBACK_COUNT;
+    }
+
+    GLint viewport[4] = {};
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    if (viewport[2] > 0 && viewport[3] > 0) {
+        buildDepthPyramid(viewport);
+    }
+}
+
+void GpuCuller::setOcclusionCulling(bool enabled) {
+    occlusionCulling = enabled;
+}
+
+const GpuCuller::Stats& GpuCuller::getStats() const {
+    return stats;
+}
+
+void GpuCuller::collectReadbacks() {
+    // 古いものから順に、完了しているものだけを読む
+    for (int i = 0; i < READBACK_COUNT; ++i) {
+        int index = (nextReadback + i) % READBACK_COUNT;
+        GLsync& fence = readbackFences[index];
+        if (!fence) {
+            continue;
+        }
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+
+        std::vector<GLuint> counters(readbackBatches[index] * COUNTERS_PER_BATCH);
+        GlStateCache::getInstance().bindBuffer(GL_COPY_READ_BUFFER, readbackBuffers[index]);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0,
+                           static_cast<GLsizeiptr>(counters.size() * sizeof(GLuint)),
+                           counters.data());
+        stats = Stats();
+        for (std::size_t batch = 0; batch < readbackBatches[index]; ++batch) {
+            const GLuint* counter = &counters[batch * COUNTERS_PER_BATCH];
+            stats.visible += counter[0];
+            stats.frustumCulled += counter[1];
+            stats.occlusionCulled += counter[2];
+            stats.backfaceCulled += counter[3];
+        }
+        stats.tested = stats.visible + stats.frustumCulled + stats.occlusionCulled +
+                       stats.backfaceCulled;
+        stats.latencyFrames = frame - readbackFrames[index];
+    }
+}
+
+void GpuCuller::resizeDepthPyramid(int width, int height) {
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    for (GLuint* texture : {&depthTexture, &pyramidTexture}) {
+        if (*texture != 0) {
+            stateCache.forgetTexture(*texture);
+            glDeleteTextures(1, texture);
+        }
+        glGenTextures(1, texture);
+    }
+    depthWidth = width;
+    depthHeight = height;
+
+    stateCache.bindTexture(DEPTH_TEXTURE_UNIT, GL_TEXTURE_2D, depthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, width, height, 0, GL_DEPTH_COMPONENT,
+                 GL_FLOAT, nullptr);
+    setNearestSampling(GL_NEAREST, 0);
+
+    // ピラミッドの最初の段は深度バッファの半分の大きさ（奇数の端は3列を1つにまとめる）
+    int levelWidth = std::max(width / 2, 1);
+    int levelHeight = std::max(height / 2, 1);
+    stateCache.bindTexture(DEPTH_TEXTURE_UNIT, GL_TEXTURE_2D, pyramidTexture);
+    pyramidLevels = 0;
+    while (true) {
+        glTexImage2D(GL_TEXTURE_2D, pyramidLevels, GL_R32F, levelWidth, levelHeight, 0, GL_RED,
+                     GL_FLOAT, nullptr);
+        ++pyramidLevels;
+        if (levelWidth == 1 && levelHeight == 1) {
+            break;
+        }
+        levelWidth = std::max(levelWidth / 2, 1);
+        levelHeight = std::max(levelHeight / 2, 1);
+    }
+    setNearestSampling(GL_NEAREST_MIPMAP_NEAREST, pyramidLevels - 1);
+}
+
+void GpuCuller::buildDepthPyramid(const GLint viewport[4]) {
+    if (viewport[2] != depthWidth || viewport[3] != depthHeight) {
+        resizeDepthPyramid(viewport[2], viewport[3]);
+    }
+    const GlExtensions& extensions = GlExtensions::get();
+    GlStateCache& stateCache = GlStateCache::getInstance();
+
+    // 描画先（既定のフレームバッファ）の深度をコピーする
+    stateCache.bindTexture(DEPTH_TEXTURE_UNIT, GL_TEXTURE_2D, depthTexture);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, viewport[0], viewport[1], depthWidth,
+                        depthHeight);
+
+    // 段ごとに1つ前の段（最初の段は深度のコピー）の2x2の最も遠い深度を書く
+    depthReduceShader->use();
+    int levelWidth = std::max(depthWidth / 2, 1);
+    int levelHeight = std::max(depthHeight / 2, 1);
+    for (int level = 0; level < pyramidLevels; ++level) {
+        stateCache.bindTexture(DEPTH_TEXTURE_UNIT, GL_TEXTURE_2D,
+                               level == 0 ? depthTexture : pyramidTexture);
+        depthReduceShader->setInt(SOURCE_LEVEL, level == 0 ? 0 : level - 1);
+        extensions.bindImageTexture(0, pyramidTexture, level, GL_FALSE, 0, GL_WRITE_ONLY,
+                                    GL_R32F);
+        extensions.dispatchCompute(
+            static_cast<GLuint>((levelWidth + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE),
+            static_cast<GLuint>((levelHeight + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE), 1);
+        extensions.memoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT |
+                                 GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        levelWidth = std::max(levelWidth / 2, 1);
+        levelHeight = std::max(levelHeight / 2, 1);
+    }
+    pyramidViewProjection = viewProjection;
+    pyramidFrame = frame;
+}
+
+} // namespace claude_gl
@@ -0,0 +1,71 @@
+#include "renderer/gpu_timer.h"
+
+namespace claude_gl {
+
+GpuTimer::GpuTimer() {
+    glGenQueries(QUERY_COUNT, queries);
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(QUERY_COUNT, queries);
+}
+
+void GpuTimer::begin() {
+    collect();
+
+    // 次のクエリがまだ結果待ちなら、このフレームは計測しない
+    active = !pending[current];
+    if (active) {
+        glBeginQuery(GL_TIME_ELAPSED, queries[current]);
+    }
+}
+
+void GpuTimer::end() {
+    if (!active) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    pending[current] = true;
+    discard[current] = false;
+    current = (current + 1) % QUERY_COUNT;
+    active = false;
+}
+
+double GpuTimer::getAverageMilliseconds() const {
+    return sampleCount > 0 ? totalMilliseconds / static_cast<double>(sampleCount) : 0.0;
+}
+
+std::size_t GpuTimer::getSampleCount() const {
+    return sampleCount;
+}
+
+void GpuTimer::reset() {
+    for (int i = 0; i < QUERY_COUNT; ++i) {
+        discard[i] = pending[i];
+    }
+    totalMilliseconds = 0.0;
+    sampleCount = 0;
+}
+
+void GpuTimer::collect() {
+    for (int i = 0; i < QUERY_COUNT; ++i) {
+        if (!pending[i]) {
+            continue;
+        }
+        GLint available = 0;
+        glGetQueryObjectiv(queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            continue;
+        }
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &nanoseconds);
+        pending[i] = false;
+        if (!discard[i]) {
+            totalMilliseconds += static_cast<double>(nanoseconds) * 1e-6;
+            ++sampleCount;
+        }
+    }
+}
+
+} // namespace claude_gl
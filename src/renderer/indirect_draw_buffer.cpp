@@ -0,0 +1,122 @@
+#include "renderer/indirect_draw_buffer.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "renderer/gl_extensions.h"
+#include "renderer/gl_state_cache.h"
+#include "renderer/gpu_culler.h"
+
+namespace claude_gl {
+
+namespace {
+
+/**
+ * @brief 1回の allocate() で増えうるバイト数を求める（3つの配列の先頭の隙間を含む）
+ *
+ * カリングではコマンドと境界もSSBOとして読むため、3つとも alignment で揃える。
+ */
+std::size_t getBatchBytes(std::size_t count, std::size_t alignment) {
+    return count * (sizeof(IndirectDrawBuffer::Command) + sizeof(IndirectDrawBuffer::DrawData) +
+                    sizeof(IndirectDrawBuffer::CullBounds)) +
+           alignment * 3;
+}
+
+} // namespace
+
+IndirectDrawBuffer::IndirectDrawBuffer(std::size_t maxDraws, std::size_t frameCount)
+    : stream(getBatchBytes(maxDraws, queryAlignment()), frameCount),
+      alignment(queryAlignment()) {
+    if (!isSupported()) {
+        throw std::runtime_error("IndirectDrawBuffer: unsupported context (GL " +
+                                 std::to_string(GlExtensions::get().getVersion()) + ")");
+    }
+}
+
+bool IndirectDrawBuffer::isSupported() {
+    const GlExtensions& extensions = GlExtensions::get();
+    return extensions.hasMultiDrawIndirect() && extensions.hasShaderDrawParameters();
+}
+
+void IndirectDrawBuffer::beginFrame() {
+    stream.beginFrame();
+    frameBytes = 0;
+    lastFrameStats = frameStats;
+    frameStats = Stats();
+}
+
+void IndirectDrawBuffer::endFrame() {
+    stream.endFrame();
+}
+
+IndirectDrawBuffer::Batch IndirectDrawBuffer::allocate(std::size_t count) {
+    // 領域からはみ出す確保は StreamBuffer が例外にするため、先に残りを確認する
+    std::size_t bytes = getBatchBytes(count, alignment);
+    if (count == 0 || frameBytes + bytes > stream.getRegionSize()) {
+        return Batch();
+    }
+    frameBytes += bytes;
+
+    StreamBuffer::Allocation commands = stream.allocate(count * sizeof(Command), alignment);
+    StreamBuffer::Allocation draws = stream.allocate(count * sizeof(DrawData), alignment);
+    StreamBuffer::Allocation bounds = stream.allocate(count * sizeof(CullBounds), alignment);
+    Batch batch;
+    batch.commands = static_cast<Command*>(commands.data);
+    batch.draws = static_cast<DrawData*>(draws.data);
+    batch.bounds = static_cast<CullBounds*>(bounds.data);
+    batch.count = count;
+    batch.commandOffset = commands.offset;
+    batch.drawOffset = draws.offset;
+    batch.boundsOffset = bounds.offset;
+    return batch;
+}
+
+void IndirectDrawBuffer::prepare(Batch& batch, bool cull) {
+    if (batch.count == 0) {
+        return;
+    }
+    stream.flush();
+    ++frameStats.batches;
+    frameStats.draws += batch.count;
+    batch.culledBatch = culler && cull ? culler->cull(stream.getBuffer(), batch) : -1;
+}
+
+void IndirectDrawBuffer::draw(const Batch& batch) {
+    if (batch.count == 0) {
+        return;
+    }
+    // GPUでカリングした場合は残った描画だけを詰めたコマンドで実行する
+    if (batch.culledBatch >= 0) {
+        culler->draw(batch.culledBatch);
+        return;
+    }
+
+    // gl_DrawIDARB は呼び出しごとに0から数えるため、SSBOの範囲をこの呼び出しの先頭に合わせる
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    stateCache.bindBufferRange(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, stream.getBuffer(),
+                               batch.drawOffset,
+                               static_cast<GLsizeiptr>(batch.count * sizeof(DrawData)));
+    stateCache.bindBuffer(GL_DRAW_INDIRECT_BUFFER, stream.getBuffer());
+    GlExtensions::get().multiDrawElementsIndirect(
+        GL_TRIANGLES, GL_UNSIGNED_SHORT, reinterpret_cast<const void*>(batch.commandOffset),
+        static_cast<GLsizei>(batch.count), 0);
+}
+
+void IndirectDrawBuffer::setCuller(GpuCuller* culler) {
+    this->culler = culler;
+}
+
+const IndirectDrawBuffer::Stats& IndirectDrawBuffer::getFrameStats() const {
+    return lastFrameStats;
+}
+
+const StreamBuffer::Stats& IndirectDrawBuffer::getStreamStats() const {
+    return stream.getStats();
+}
+
+std::size_t IndirectDrawBuffer::queryAlignment() {
+    GLint offsetAlignment = 0;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    return static_cast<std::size_t>(std::max(offsetAlignment, 1));
+}
+
+} // namespace claude_gl
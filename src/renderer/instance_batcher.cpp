@@ -0,0 +1,61 @@
+#include "renderer/instance_batcher.h"
+
+namespace claude_gl {
+
+void InstanceBatcher::submit(const std::shared_ptr<const Model>& model,
+                             const glm::mat4* transforms, std::size_t count) {
+    if (!model || count == 0) {
+        return;
+    }
+
+    // バッチ数はモデル数程度なので線形探索で十分
+    Batch* target = nullptr;
+    for (Batch& batch : batches) {
+        if (batch.model == model) {
+            target = &batch;
+            break;
+        }
+    }
+    if (target == nullptr) {
+        batches.push_back(Batch{model, {}, std::make_unique<InstanceBuffer>()});
+        target = &batches.back();
+    }
+    target->transforms.insert(target->transforms.end(), transforms, transforms + count);
+}
+
+void InstanceBatcher::draw(const Shader& shader) {
+    stats = Stats();
+    for (Batch& batch : batches) {
+        if (batch.transforms.empty()) {
+            continue;
+        }
+
+        batch.buffer->update(batch.transforms);
+        stats.drawCalls += batch.model->drawInstanced(shader, *batch.buffer);
+        stats.instances += batch.transforms.size();
+        ++stats.batches;
+
+        // 容量は残して次のフレームの投入に再利用する
+        batch.transforms.clear();
+    }
+}
+
+bool InstanceBatcher::hasPending() const {
+    for (const Batch& batch : batches) {
+        if (!batch.transforms.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void InstanceBatcher::clear() {
+    batches.clear();
+    stats = Stats();
+}
+
+const InstanceBatcher::Stats& InstanceBatcher::getStats() const {
+    return stats;
+}
+
+} // namespace claude_gl
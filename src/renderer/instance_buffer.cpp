@@ -0,0 +1,64 @@
+#include "renderer/instance_buffer.h"
+#include <algorithm>
+#include "renderer/transform_system.h"
+
+namespace claude_gl {
+
+InstanceBuffer::InstanceBuffer() = default;
+
+InstanceBuffer::~InstanceBuffer() = default;
+
+void InstanceBuffer::update(const glm::mat4* transforms, std::size_t count) {
+    if (count > capacity) {
+        // 再確保の回数を抑えるため倍々で広げる（以前のバッファはGPUが読み終えてから解放される）
+        capacity = std::max(count, capacity * 2);
+        stream = std::make_unique<StreamBuffer>(capacity * sizeof(InstanceData));
+    }
+    else if (stream) {
+        // 前回の描画が読む領域にフェンスを置いてから次の領域へ進む
+        stream->endFrame();
+    }
+    this->count = count;
+    if (!stream) {
+        return;
+    }
+    stream->beginFrame();
+    StreamBuffer::Allocation allocation =
+        stream->allocate(count * sizeof(InstanceData), alignof(InstanceData));
+    offset = allocation.offset;
+
+    // 書き込み先はマップしたGPUメモリのことがあるため、読み出さずに書き込むだけにする
+    InstanceData* instances = static_cast<InstanceData*>(allocation.data);
+    for (std::size_t i = 0; i < count; ++i) {
+        instances[i].model = transforms[i];
+    }
+    if (count > 0) {
+        // 法線行列はインスタンスごとに1回だけCPUで計算する（頂点ごとの inverse を避ける）
+        TransformSystem::computeNormalMatrices(transforms, sizeof(glm::mat4),
+                                               &instances[0].normalMatrix, sizeof(InstanceData),
+                                               count);
+    }
+    stream->flush();
+}
+
+void InstanceBuffer::update(const std::vector<glm::mat4>& transforms) {
+    update(transforms.data(), transforms.size());
+}
+
+GLuint InstanceBuffer::getBuffer() const {
+    return stream ? stream->getBuffer() : 0;
+}
+
+GLintptr InstanceBuffer::getOffset() const {
+    return offset;
+}
+
+std::size_t InstanceBuffer::getCount() const {
+    return count;
+}
+
+const StreamBuffer::Stats* InstanceBuffer::getStreamStats() const {
+    return stream ? &stream->getStats() : nullptr;
+}
+
+} // namespace claude_gl
@@ -0,0 +1,16 @@
+#include "renderer/material.h"
+
+namespace claude_gl {
+
+MaterialUniforms Material::getUniforms() const {
+    MaterialUniforms uniforms;
+    uniforms.objectColor = color;
+    uniforms.opacity = opacity;
+    uniforms.ambientStrength = ambientStrength;
+    uniforms.specularStrength = specularStrength;
+    uniforms.shininess = static_cast<float>(shininess);
+    uniforms.padding = 0.0f;
+    return uniforms;
+}
+
+} // namespace claude_gl
@@ -1,65 +1,471 @@
 #include "renderer/mesh.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "renderer/geometry_arena.h"
+#include "renderer/gl_state_cache.h"
+#include "renderer/vertex_quantizer.h"
 
 namespace claude_gl {
 
+namespace {
+
+// 16ビットインデックスで表せる最大の頂点数
+constexpr std::size_t MAX_16BIT_INDEX_VERTICES = 65536;
+
+// 頂点の復元パラメータの uniform の名前
+constexpr UniformName POSITION_BIAS("positionBias");
+constexpr UniformName POSITION_SCALE("positionScale");
+constexpr UniformName NORMAL_ENCODING("normalEncoding");
+
+// basic.vs の normalEncoding（0: 属性をそのまま使う、1: 八面体マッピングを復元する）
+constexpr int NORMAL_ENCODING_DIRECT = 0;
+constexpr int NORMAL_ENCODING_OCTAHEDRAL = 1;
+
+} // namespace
+
 Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
-    : vertices(vertices), indices(indices), vao(0), vbo(0), ebo(0) {
-    setupMesh();
+    : vertices(vertices), indices(indices), indexCount(indices.size()),
+      indexType(GL_UNSIGNED_INT), positionBias(0.0f), positionScale(1.0f),
+      normalEncoding(NORMAL_ENCODING_DIRECT), vao(0), vbo(0), ebo(0), positionVbo(0),
+      depthVao(0), instanceVbo(0), instanceOffset(0), arenaHandle(0) {
+    setupMesh(this->vertices.data(), this->vertices.size(), this->indices.data(),
+              StreamLayout::Interleaved);
+    lodLevels.push_back({0, static_cast<std::uint32_t>(indexCount), 0.0f});
+}
+
+Mesh::Mesh(const Vertex* vertices, std::size_t vertexCount,
+           const unsigned int* indices, std::size_t indexCount, StreamLayout streamLayout)
+    : indexCount(indexCount), indexType(GL_UNSIGNED_INT), positionBias(0.0f),
+      positionScale(1.0f), normalEncoding(NORMAL_ENCODING_DIRECT), vao(0), vbo(0), ebo(0),
+      positionVbo(0), depthVao(0), instanceVbo(0), instanceOffset(0), arenaHandle(0) {
+    setupMesh(vertices, vertexCount, indices, streamLayout);
+    lodLevels.push_back({0, static_cast<std::uint32_t>(indexCount), 0.0f});
+}
+
+Mesh::Mesh(const QuantizedVertices& vertices, const unsigned int* indices, std::size_t indexCount)
+    : indexCount(indexCount), indexType(GL_UNSIGNED_INT), positionBias(vertices.positionBias),
+      positionScale(vertices.positionScale),
+      normalEncoding(vertices.format.normalEncoding == NormalEncoding::Octahedral
+                     ? NORMAL_ENCODING_OCTAHEDRAL : NORMAL_ENCODING_DIRECT),
+      vao(0), vbo(0), ebo(0), positionVbo(0), depthVao(0), instanceVbo(0), instanceOffset(0),
+      arenaHandle(0) {
+    setupQuantizedMesh(vertices, indices);
+    lodLevels.push_back({0, static_cast<std::uint32_t>(indexCount), 0.0f});
+}
+
+Mesh::Mesh(std::shared_ptr<GeometryArena> arena, const Vertex* vertices, std::size_t vertexCount,
+           const unsigned int* indices, std::size_t indexCount)
+    : indexCount(indexCount), indexType(GL_UNSIGNED_SHORT), positionBias(0.0f),
+      positionScale(1.0f), normalEncoding(NORMAL_ENCODING_DIRECT), vao(0), vbo(0), ebo(0),
+      positionVbo(0), depthVao(0), instanceVbo(0), instanceOffset(0), arena(std::move(arena)),
+      arenaHandle(0) {
+    if (!this->arena) {
+        throw std::runtime_error("Mesh: geometry arena is null");
+    }
+    arenaHandle = this->arena->add(vertices, vertexCount, indices, indexCount);
+    lodLevels.push_back({0, static_cast<std::uint32_t>(indexCount), 0.0f});
+    lodHandles.push_back(arenaHandle);
 }
 
 Mesh::~Mesh() {
-    // OpenGLリソースの解放
-    if (vao != 0) {
-        glDeleteVertexArrays(1, &vao);
+    // 共有のバッファの範囲は返却するだけで、バッファ自体は他のメッシュが使い続ける
+    // （段階ごとのハンドルは範囲を参照するだけなので先に外す）
+    if (arena) {
+        for (std::uint32_t handle : lodHandles) {
+            if (handle != arenaHandle) {
+                arena->remove(handle);
+            }
+        }
+        arena->remove(arenaHandle);
     }
-    if (vbo != 0) {
-        glDeleteBuffers(1, &vbo);
+    
+    // OpenGLリソースの解放（状態キャッシュからも外す）
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    for (GLuint vertexArray : {vao, depthVao}) {
+        if (vertexArray != 0) {
+            stateCache.forgetVertexArray(vertexArray);
+            glDeleteVertexArrays(1, &vertexArray);
+        }
     }
-    if (ebo != 0) {
-        glDeleteBuffers(1, &ebo);
+    for (GLuint buffer : {vbo, ebo, positionVbo}) {
+        if (buffer != 0) {
+            stateCache.forgetBuffer(buffer);
+            glDeleteBuffers(1, &buffer);
+        }
     }
 }
 
-void Mesh::setupMesh() {
+void Mesh::setupMesh(const Vertex* vertexData, std::size_t vertexCount,
+                     const unsigned int* indexData, StreamLayout streamLayout) {
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    
     // OpenGLバッファの生成
     glGenVertexArrays(1, &vao);
     glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
 
     // VAOのバインド
-    glBindVertexArray(vao);
+    stateCache.bindVertexArray(vao);
+    
+    if (streamLayout == StreamLayout::Interleaved) {
+        // VBOの設定
+        stateCache.bindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), vertexData, GL_STATIC_DRAW);
+        
+        // EBOの設定
+        setupIndexBuffer(indexData, vertexCount);
+        
+        // 頂点属性の設定（位置・法線・テクスチャ座標）
+        InterleavedLayout::setup(&vbo);
+    }
+    else {
+        // 位置とその他の属性を別々の配列に分ける
+        std::vector<glm::vec3> positions(vertexCount);
+        std::vector<SurfaceAttributes> surfaces(vertexCount);
+        for (std::size_t i = 0; i < vertexCount; ++i) {
+            positions[i] = vertexData[i].position;
+            surfaces[i].normal = vertexData[i].normal;
+            surfaces[i].texCoords = vertexData[i].texCoords;
+        }
+        
+        // VBOの設定（位置ストリームとその他の属性のストリーム）
+        glGenBuffers(1, &positionVbo);
+        stateCache.bindBuffer(GL_ARRAY_BUFFER, positionVbo);
+        glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(),
+                     GL_STATIC_DRAW);
+        stateCache.bindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, surfaces.size() * sizeof(SurfaceAttributes),
+                     surfaces.data(), GL_STATIC_DRAW);
+        
+        // EBOの設定
+        setupIndexBuffer(indexData, vertexCount);
+        
+        // 頂点属性の設定
+        const GLuint buffers[SplitLayout::STREAM_COUNT] = {positionVbo, vbo};
+        SplitLayout::setup(buffers);
+        
+        // 深度のみのパス用に、位置ストリームとEBOだけを参照するVAOを作る
+        glGenVertexArrays(1, &depthVao);
+        stateCache.bindVertexArray(depthVao);
+        stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        PositionOnlyLayout::setup(&positionVbo);
+    }
+    
+    // VAOのバインド解除
+    stateCache.bindVertexArray(0);
+}
+
+void Mesh::setupQuantizedMesh(const QuantizedVertices& vertexData, const unsigned int* indexData) {
+    const VertexFormat& format = vertexData.format;
+    GLsizei stride = static_cast<GLsizei>(vertexData.stride);
+    
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    
+    // OpenGLバッファの生成
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    stateCache.bindVertexArray(vao);
     
     // VBOの設定
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+    stateCache.bindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertexData.data.size(), vertexData.data.data(), GL_STATIC_DRAW);
     
     // EBOの設定
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+    setupIndexBuffer(indexData, vertexData.vertexCount);
     
-    // 頂点属性の設定
-    // 位置属性
+    // 位置属性（量子化時は0〜1に正規化され、シェーダーでAABBに戻す）
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    if (format.quantizePositions) {
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride,
+                              (void*)(std::uintptr_t)vertexData.positionOffset);
+    }
+    else {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride,
+                              (void*)(std::uintptr_t)vertexData.positionOffset);
+    }
     
     // 法線属性
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    void* normalPointer = (void*)(std::uintptr_t)vertexData.normalOffset;
+    switch (format.normalEncoding) {
+        case NormalEncoding::Float:
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, normalPointer);
+            break;
+        case NormalEncoding::Octahedral:
+            // z成分は0になり、シェーダーでxyから復元する
+            glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, normalPointer);
+            break;
+        case NormalEncoding::Packed1010102:
+            glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, normalPointer);
+            break;
+    }
     
     // テクスチャ座標属性
     glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+    glVertexAttribPointer(2, 2, format.halfTexCoords ? GL_HALF_FLOAT : GL_FLOAT, GL_FALSE, stride,
+                          (void*)(std::uintptr_t)vertexData.texCoordOffset);
     
     // VAOのバインド解除
-    glBindVertexArray(0);
+    stateCache.bindVertexArray(0);
+}
+
+void Mesh::setupIndexBuffer(const unsigned int* indexData, std::size_t vertexCount) {
+    glGenBuffers(1, &ebo);
+    GlStateCache::getInstance().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    
+    if (indexSizeFor(vertexCount) == sizeof(std::uint16_t)) {
+        // 16ビットに詰めて転送量とインデックスフェッチの帯域を半分にする
+        std::vector<std::uint16_t> shortIndices(indexData, indexData + indexCount);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(std::uint16_t),
+                     shortIndices.data(), GL_STATIC_DRAW);
+        indexType = GL_UNSIGNED_SHORT;
+    }
+    else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indexData,
+                     GL_STATIC_DRAW);
+        indexType = GL_UNSIGNED_INT;
+    }
+}
+
+void Mesh::draw(const Shader& shader, std::size_t level) const {
+    // VAOは解除せず、次の描画で同じVAOならバインドを省く
+    bind(shader);
+    drawElements(level);
+}
+
+void Mesh::bind(const Shader& shader) const {
+    // 頂点の復元パラメータ（量子化していないメッシュは恒等変換）
+    shader.setVec3(POSITION_BIAS, positionBias);
+    shader.setVec3(POSITION_SCALE, positionScale);
+    shader.setInt(NORMAL_ENCODING, normalEncoding);
+    
+    if (arena) {
+        arena->bind();
+    }
+    else {
+        GlStateCache::getInstance().bindVertexArray(vao);
+    }
+}
+
+void Mesh::drawElements(std::size_t level) const {
+    if (arena) {
+        arena->draw(lodHandles[level]);
+        return;
+    }
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(lodLevels[level].indexCount), indexType,
+                   getIndexPointer(level));
+}
+
+void Mesh::drawClusters(const std::uint32_t* clusters, std::size_t count) const {
+    // インデックスが連続するクラスタは1つの範囲にまとめる
+    rangeFirsts.clear();
+    rangeCounts.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        const Meshlet& meshlet = meshlets[clusters[i]];
+        if (!rangeFirsts.empty() &&
+            rangeFirsts.back() + static_cast<std::uint32_t>(rangeCounts.back()) ==
+                meshlet.firstIndex) {
+            rangeCounts.back() += static_cast<GLsizei>(meshlet.indexCount);
+        }
+        else {
+            rangeFirsts.push_back(meshlet.firstIndex);
+            rangeCounts.push_back(static_cast<GLsizei>(meshlet.indexCount));
+        }
+    }
+    if (rangeFirsts.empty()) {
+        return;
+    }
+    if (arena) {
+        arena->drawRanges(lodHandles[0], rangeFirsts.data(), rangeCounts.data(),
+                          rangeFirsts.size());
+        return;
+    }
+    
+    std::size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t)
+                                                           : sizeof(unsigned int);
+    rangeOffsets.resize(rangeFirsts.size());
+    for (std::size_t i = 0; i < rangeFirsts.size(); ++i) {
+        rangeOffsets[i] = reinterpret_cast<const void*>(
+            static_cast<std::uintptr_t>(rangeFirsts[i]) * indexSize);
+    }
+    glMultiDrawElements(GL_TRIANGLES, rangeCounts.data(), indexType, rangeOffsets.data(),
+                        static_cast<GLsizei>(rangeFirsts.size()));
+}
+
+void Mesh::drawDepthOnly(const Shader& shader) const {
+    // 位置の復元パラメータのみ設定する
+    shader.setVec3(POSITION_BIAS, positionBias);
+    shader.setVec3(POSITION_SCALE, positionScale);
+    
+    if (arena) {
+        arena->bind();
+        arena->draw(lodHandles[0]);
+        return;
+    }
+    
+    // 位置ストリームを分離している場合は位置のみを読むVAOで描画
+    GlStateCache::getInstance().bindVertexArray(depthVao != 0 ? depthVao : vao);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(lodLevels[0].indexCount), indexType,
+                   getIndexPointer(0));
+}
+
+void Mesh::drawInstanced(const Shader& shader, const InstanceBuffer& instances) const {
+    if (instances.getCount() == 0) {
+        return;
+    }
+    
+    // 頂点の復元パラメータ（量子化していないメッシュは恒等変換）
+    shader.setVec3(POSITION_BIAS, positionBias);
+    shader.setVec3(POSITION_SCALE, positionScale);
+    shader.setInt(NORMAL_ENCODING, normalEncoding);
+    
+    if (arena) {
+        arena->drawInstanced(lodHandles[0], instances);
+        return;
+    }
+    
+    GlStateCache::getInstance().bindVertexArray(vao);
+    
+    // インスタンスストリームの接続はVAOに記録されるため、バッファか位置が変わった時だけ行う
+    GLuint buffer = instances.getBuffer();
+    GLintptr offset = instances.getOffset();
+    if (instanceVbo != buffer || instanceOffset != offset) {
+        InstanceBuffer::Layout::setup(&buffer, &offset);
+        instanceVbo = buffer;
+        instanceOffset = offset;
+    }
+    
+    glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(lodLevels[0].indexCount),
+                            indexType, getIndexPointer(0),
+                            static_cast<GLsizei>(instances.getCount()));
+}
+
+void Mesh::setBounds(const BoundingVolume& bounds) {
+    this->bounds = bounds;
+}
+
+GeometryArena* Mesh::getArena() const {
+    return arena.get();
+}
+
+std::uint32_t Mesh::getArenaHandle(std::size_t level) const {
+    return arena ? lodHandles[level] : arenaHandle;
+}
+
+void Mesh::setLodLevels(const std::vector<LodLevel>& levels) {
+    if (levels.empty()) {
+        throw std::runtime_error("Mesh: no LOD levels");
+    }
+    for (const LodLevel& level : levels) {
+        if (level.indexCount == 0 || level.indexCount % 3 != 0 ||
+            std::size_t(level.firstIndex) + level.indexCount > indexCount) {
+            throw std::runtime_error("Mesh: invalid LOD level " +
+                                     std::to_string(level.firstIndex) + " + " +
+                                     std::to_string(level.indexCount));
+        }
+    }
+    lodLevels = levels;
+    
+    // 共有のバッファでは段階ごとに、頂点とインデックスの範囲を共有するハンドルを作る
+    if (arena) {
+        for (std::uint32_t handle : lodHandles) {
+            if (handle != arenaHandle) {
+                arena->remove(handle);
+            }
+        }
+        lodHandles.clear();
+        for (const LodLevel& level : lodLevels) {
+            lodHandles.push_back(arena->addView(arenaHandle, level.firstIndex,
+                                                level.indexCount));
+        }
+    }
+}
+
+std::size_t Mesh::getLodCount() const {
+    return lodLevels.size();
+}
+
+const Mesh::LodLevel& Mesh::getLodLevel(std::size_t level) const {
+    return lodLevels[level];
+}
+
+const std::vector<Mesh::LodLevel>& Mesh::getLodLevels() const {
+    return lodLevels;
+}
+
+void Mesh::setMeshlets(std::vector<Meshlet> meshlets) {
+    const LodLevel& finest = lodLevels[0];
+    for (const Meshlet& meshlet : meshlets) {
+        if (meshlet.indexCount == 0 || meshlet.indexCount % 3 != 0 ||
+            meshlet.firstIndex < finest.firstIndex ||
+            std::size_t(meshlet.firstIndex) + meshlet.indexCount >
+                std::size_t(finest.firstIndex) + finest.indexCount) {
+            throw std::runtime_error("Mesh: invalid meshlet " +
+                                     std::to_string(meshlet.firstIndex) + " + " +
+                                     std::to_string(meshlet.indexCount));
+        }
+    }
+    this->meshlets = std::move(meshlets);
+}
+
+std::size_t Mesh::getMeshletCount() const {
+    return meshlets.size();
+}
+
+const std::vector<Mesh::Meshlet>& Mesh::getMeshlets() const {
+    return meshlets;
+}
+
+const BoundingVolume& Mesh::getBounds() const {
+    return bounds;
+}
+
+void Mesh::setTriangleBvh(std::shared_ptr<const TriangleBvh> bvh) {
+    triangleBvh = std::move(bvh);
+}
+
+const TriangleBvh* Mesh::getTriangleBvh() const {
+    return triangleBvh.get();
+}
+
+BoundingVolume Mesh::computeBounds(const Vertex* vertices, std::size_t vertexCount) {
+    BoundingVolume result;
+    if (vertexCount == 0) {
+        return result;
+    }
+    
+    result.boundsMin = vertices[0].position;
+    result.boundsMax = vertices[0].position;
+    for (std::size_t i = 1; i < vertexCount; ++i) {
+        result.boundsMin = glm::min(result.boundsMin, vertices[i].position);
+        result.boundsMax = glm::max(result.boundsMax, vertices[i].position);
+    }
+    
+    // 半径はボックスの対角線の半分より小さくなることが多い
+    glm::vec3 center = result.getCenter();
+    float maxDistanceSquared = 0.0f;
+    for (std::size_t i = 0; i < vertexCount; ++i) {
+        glm::vec3 offset = vertices[i].position - center;
+        maxDistanceSquared = std::max(maxDistanceSquared, glm::dot(offset, offset));
+    }
+    result.radius = std::sqrt(maxDistanceSquared);
+    return result;
+}
+
+const void* Mesh::getIndexPointer(std::size_t level) const {
+    std::size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t)
+                                                           : sizeof(unsigned int);
+    return reinterpret_cast<const void*>(
+        static_cast<std::uintptr_t>(lodLevels[level].firstIndex * indexSize));
 }
 
-void Mesh::draw(const Shader& shader) const {
-    // VAOをバインドして描画
-    glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+std::size_t Mesh::indexSizeFor(std::size_t vertexCount) {
+    return vertexCount <= MAX_16BIT_INDEX_VERTICES ? sizeof(std::uint16_t) : sizeof(unsigned int);
 }
 
 } // namespace claude_gl
\ No newline at end of file
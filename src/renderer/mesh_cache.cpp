@@ -0,0 +1,371 @@
+#include "renderer/mesh_cache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "utils/mapped_file.h"
+
+namespace claude_gl {
+
+/**
+ * @brief キャッシュファイルのヘッダー
+ */
+struct MeshCache::Header {
+    std::uint32_t magic;            ///< 識別子（MESH_CACHE_MAGIC）
+    std::uint32_t formatVersion;    ///< ファイル形式のバージョン
+    std::uint32_t importerVersion;  ///< インポーターのバージョン
+    std::uint32_t settingsKey;      ///< 読み込み設定の識別値
+    std::uint64_t sourceHash;       ///< ソースファイルの内容ハッシュ
+    std::uint32_t vertexStride;     ///< 頂点1つのバイト数
+    std::uint32_t submeshCount;     ///< サブメッシュ数
+    std::uint64_t vertexCount;      ///< 全体の頂点数
+    std::uint64_t indexCount;       ///< 全体のインデックス数
+    std::uint64_t lodCount;         ///< 全体の段階数
+    std::uint64_t meshletCount;     ///< 全体のクラスタ数
+    std::uint64_t submeshOffset;    ///< サブメッシュ表のファイル内オフセット
+    std::uint64_t vertexOffset;     ///< 頂点配列のファイル内オフセット
+    std::uint64_t indexOffset;      ///< インデックス配列のファイル内オフセット
+    std::uint64_t lodOffset;        ///< 段階表のファイル内オフセット
+    std::uint64_t meshletOffset;    ///< クラスタ表のファイル内オフセット
+    float boundsMin[3];             ///< 全体のバウンディングボックスの最小点
+    float boundsMax[3];             ///< 全体のバウンディングボックスの最大点
+};
+
+namespace {
+
+// ファイル先頭の識別子 "CGLM"（エンディアンが異なる環境で作られたファイルも弾ける）
+constexpr std::uint32_t MESH_CACHE_MAGIC = 0x4D4C4743u;
+
+// 各領域の配置境界
+constexpr std::size_t SECTION_ALIGNMENT = 16;
+
+// キャッシュファイルの拡張子
+const char* const CACHE_EXTENSION = ".meshcache";
+
+static_assert(sizeof(MeshCache::Submesh) == 64, "Submesh must have a fixed on-disk layout");
+static_assert(sizeof(Mesh::LodLevel) == 12, "LodLevel must have a fixed on-disk layout");
+static_assert(sizeof(Mesh::Meshlet) == 40, "Meshlet must have a fixed on-disk layout");
+
+/**
+ * @brief 配置境界に切り上げる
+ */
+std::uint64_t alignOffset(std::uint64_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+/**
+ * @brief 領域が配置境界に揃い、ファイル内に収まっているか確認する
+ *
+ * 要素数とオフセットはファイルから読んだ値のため、積や和が桁あふれしないよう
+ * 残りのバイト数を要素の大きさで割って比較する。
+ */
+bool isValidSection(std::uint64_t fileSize, std::uint64_t offset, std::uint64_t count,
+                    std::size_t elementSize) {
+    return offset % SECTION_ALIGNMENT == 0 && offset <= fileSize &&
+           count <= (fileSize - offset) / elementSize;
+}
+
+/**
+ * @brief 指定位置までゼロで埋める
+ */
+void writePadding(std::ofstream& stream, std::uint64_t current, std::uint64_t target) {
+    static const char ZEROS[SECTION_ALIGNMENT] = {};
+    if (target > current) {
+        stream.write(ZEROS, static_cast<std::streamsize>(target - current));
+    }
+}
+
+// ハッシュ計算用の定数（xxHash64と同じ素数）
+constexpr std::uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+constexpr std::uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+constexpr std::uint64_t PRIME3 = 0x165667B19E3779F9ull;
+
+inline std::uint64_t rotateLeft(std::uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline std::uint64_t hashRound(std::uint64_t accumulator, std::uint64_t input) {
+    accumulator += input * PRIME2;
+    accumulator = rotateLeft(accumulator, 31);
+    return accumulator * PRIME1;
+}
+
+inline std::uint64_t readWord(const unsigned char* p) {
+    std::uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+} // namespace
+
+std::string MeshCache::cachePathFor(const std::string& sourcePath) {
+    return sourcePath + CACHE_EXTENSION;
+}
+
+std::uint64_t MeshCache::hashFile(const std::string& sourcePath) {
+    MappedFile file(sourcePath);
+    return hashData(file.data(), file.size());
+}
+
+std::uint64_t MeshCache::hashData(const void* data, std::size_t size) {
+    // xxHash64風の4レーン並列ハッシュ（1バイトずつ処理するハッシュより大幅に高速）
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + size;
+
+    std::uint64_t lanes[4] = {PRIME1 + PRIME2, PRIME2, 0, 0 - PRIME1};
+    while (end - p >= 32) {
+        for (int lane = 0; lane < 4; ++lane) {
+            lanes[lane] = hashRound(lanes[lane], readWord(p + lane * 8));
+        }
+        p += 32;
+    }
+
+    std::uint64_t hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) +
+                         rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+    hash += static_cast<std::uint64_t>(size);
+
+    while (end - p >= 8) {
+        hash ^= hashRound(0, readWord(p));
+        hash = rotateLeft(hash, 27) * PRIME1 + PRIME3;
+        p += 8;
+    }
+    while (p < end) {
+        hash ^= static_cast<std::uint64_t>(*p) * PRIME3;
+        hash = rotateLeft(hash, 11) * PRIME1;
+        ++p;
+    }
+
+    // 最終的な撹拌
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+bool MeshCache::write(const std::string& cachePath, std::uint64_t sourceHash,
+                      std::uint32_t settingsKey, const std::vector<Mesh::Vertex>& vertices,
+                      const std::vector<unsigned int>& indices,
+                      const std::vector<Submesh>& submeshes,
+                      const std::vector<Mesh::LodLevel>& lodLevels,
+                      const std::vector<Mesh::Meshlet>& meshlets) {
+    Header header{};
+    header.magic = MESH_CACHE_MAGIC;
+    header.formatVersion = FORMAT_VERSION;
+    header.importerVersion = IMPORTER_VERSION;
+    header.settingsKey = settingsKey;
+    header.sourceHash = sourceHash;
+    header.vertexStride = static_cast<std::uint32_t>(sizeof(Mesh::Vertex));
+    header.submeshCount = static_cast<std::uint32_t>(submeshes.size());
+    header.vertexCount = vertices.size();
+    header.indexCount = indices.size();
+    header.lodCount = lodLevels.size();
+    header.meshletCount = meshlets.size();
+    header.submeshOffset = alignOffset(sizeof(Header));
+    header.vertexOffset = alignOffset(header.submeshOffset + submeshes.size() * sizeof(Submesh));
+    header.indexOffset = alignOffset(header.vertexOffset + vertices.size() * sizeof(Mesh::Vertex));
+    header.lodOffset = alignOffset(header.indexOffset + indices.size() * sizeof(unsigned int));
+    header.meshletOffset =
+        alignOffset(header.lodOffset + lodLevels.size() * sizeof(Mesh::LodLevel));
+
+    // 全体のバウンディングボックスはサブメッシュのものを統合する
+    glm::vec3 boundsMin(0.0f);
+    glm::vec3 boundsMax(0.0f);
+    for (std::size_t i = 0; i < submeshes.size(); ++i) {
+        boundsMin = i == 0 ? submeshes[i].boundsMin : glm::min(boundsMin, submeshes[i].boundsMin);
+        boundsMax = i == 0 ? submeshes[i].boundsMax : glm::max(boundsMax, submeshes[i].boundsMax);
+    }
+    std::memcpy(header.boundsMin, &boundsMin.x, sizeof(header.boundsMin));
+    std::memcpy(header.boundsMax, &boundsMax.x, sizeof(header.boundsMax));
+
+    // 一時ファイルに書き出してから置き換える
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        if (!stream) {
+            std::cerr << "Warning: cannot write mesh cache " << tempPath << std::endl;
+            return false;
+        }
+
+        std::uint64_t position = 0;
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        position += sizeof(Header);
+
+        writePadding(stream, position, header.submeshOffset);
+        stream.write(reinterpret_cast<const char*>(submeshes.data()),
+                     static_cast<std::streamsize>(submeshes.size() * sizeof(Submesh)));
+        position = header.submeshOffset + submeshes.size() * sizeof(Submesh);
+
+        writePadding(stream, position, header.vertexOffset);
+        stream.write(reinterpret_cast<const char*>(vertices.data()),
+                     static_cast<std::streamsize>(vertices.size() * sizeof(Mesh::Vertex)));
+        position = header.vertexOffset + vertices.size() * sizeof(Mesh::Vertex);
+
+        writePadding(stream, position, header.indexOffset);
+        stream.write(reinterpret_cast<const char*>(indices.data()),
+                     static_cast<std::streamsize>(indices.size() * sizeof(unsigned int)));
+        position = header.indexOffset + indices.size() * sizeof(unsigned int);
+
+        writePadding(stream, position, header.lodOffset);
+        stream.write(reinterpret_cast<const char*>(lodLevels.data()),
+                     static_cast<std::streamsize>(lodLevels.size() * sizeof(Mesh::LodLevel)));
+        position = header.lodOffset + lodLevels.size() * sizeof(Mesh::LodLevel);
+
+        writePadding(stream, position, header.meshletOffset);
+        stream.write(reinterpret_cast<const char*>(meshlets.data()),
+                     static_cast<std::streamsize>(meshlets.size() * sizeof(Mesh::Meshlet)));
+
+        if (!stream) {
+            std::cerr << "Warning: failed to write mesh cache " << tempPath << std::endl;
+            stream.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    // Windowsでは既存ファイルへの rename が失敗するため先に削除する
+    std::remove(cachePath.c_str());
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+        std::cerr << "Warning: failed to replace mesh cache " << cachePath << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<MeshCache> MeshCache::open(const std::string& cachePath, std::uint64_t sourceHash,
+                                           std::uint32_t settingsKey) {
+    std::unique_ptr<MappedFile> file;
+    try {
+        file = std::make_unique<MappedFile>(cachePath);
+    }
+    catch (const std::exception&) {
+        // キャッシュがないのは想定内（初回読み込み）
+        return nullptr;
+    }
+
+    if (file->size() < sizeof(Header)) {
+        return nullptr;
+    }
+    const Header* header = reinterpret_cast<const Header*>(file->data());
+
+    // 形式・バージョン・ソース・設定の一致を確認
+    if (header->magic != MESH_CACHE_MAGIC || header->formatVersion != FORMAT_VERSION ||
+        header->importerVersion != IMPORTER_VERSION || header->settingsKey != settingsKey ||
+        header->sourceHash != sourceHash || header->vertexStride != sizeof(Mesh::Vertex)) {
+        return nullptr;
+    }
+
+    // 各領域が配置境界に揃い、ファイル内に収まっているか確認（破損対策）
+    std::uint64_t fileSize = file->size();
+    if (!isValidSection(fileSize, header->submeshOffset, header->submeshCount, sizeof(Submesh)) ||
+        !isValidSection(fileSize, header->vertexOffset, header->vertexCount,
+                        sizeof(Mesh::Vertex)) ||
+        !isValidSection(fileSize, header->indexOffset, header->indexCount,
+                        sizeof(unsigned int)) ||
+        !isValidSection(fileSize, header->lodOffset, header->lodCount,
+                        sizeof(Mesh::LodLevel)) ||
+        !isValidSection(fileSize, header->meshletOffset, header->meshletCount,
+                        sizeof(Mesh::Meshlet))) {
+        return nullptr;
+    }
+
+    const Submesh* submeshes =
+        reinterpret_cast<const Submesh*>(file->data() + header->submeshOffset);
+    for (std::uint32_t i = 0; i < header->submeshCount; ++i) {
+        std::uint64_t submeshVertexEnd =
+            static_cast<std::uint64_t>(submeshes[i].vertexOffset) + submeshes[i].vertexCount;
+        std::uint64_t submeshIndexEnd =
+            static_cast<std::uint64_t>(submeshes[i].indexOffset) + submeshes[i].indexCount;
+        std::uint64_t submeshLodEnd =
+            static_cast<std::uint64_t>(submeshes[i].lodOffset) + submeshes[i].lodCount;
+        std::uint64_t submeshMeshletEnd =
+            static_cast<std::uint64_t>(submeshes[i].meshletOffset) + submeshes[i].meshletCount;
+        if (submeshVertexEnd > header->vertexCount || submeshIndexEnd > header->indexCount ||
+            submeshLodEnd > header->lodCount || submeshMeshletEnd > header->meshletCount) {
+            return nullptr;
+        }
+
+        // 各段階と各クラスタはサブメッシュのインデックス範囲に収まっていること
+        const Mesh::LodLevel* levels =
+            reinterpret_cast<const Mesh::LodLevel*>(file->data() + header->lodOffset) +
+            submeshes[i].lodOffset;
+        for (std::uint32_t level = 0; level < submeshes[i].lodCount; ++level) {
+            std::uint64_t levelEnd =
+                static_cast<std::uint64_t>(levels[level].firstIndex) + levels[level].indexCount;
+            if (levelEnd > submeshes[i].indexCount) {
+                return nullptr;
+            }
+        }
+        const Mesh::Meshlet* meshlets =
+            reinterpret_cast<const Mesh::Meshlet*>(file->data() + header->meshletOffset) +
+            submeshes[i].meshletOffset;
+        for (std::uint32_t meshlet = 0; meshlet < submeshes[i].meshletCount; ++meshlet) {
+            std::uint64_t meshletIndexEnd = static_cast<std::uint64_t>(
+                meshlets[meshlet].firstIndex) + meshlets[meshlet].indexCount;
+            if (meshletIndexEnd > submeshes[i].indexCount) {
+                return nullptr;
+            }
+        }
+
+        // インデックスはサブメッシュの頂点を指していること（範囲外の頂点を読ませない）
+        const unsigned int* indices =
+            reinterpret_cast<const unsigned int*>(file->data() + header->indexOffset) +
+            submeshes[i].indexOffset;
+        unsigned int maxIndex = 0;
+        for (std::uint32_t index = 0; index < submeshes[i].indexCount; ++index) {
+            maxIndex = std::max(maxIndex, indices[index]);
+        }
+        if (submeshes[i].indexCount > 0 && maxIndex >= submeshes[i].vertexCount) {
+            return nullptr;
+        }
+    }
+
+    return std::unique_ptr<MeshCache>(new MeshCache(std::move(file), header));
+}
+
+MeshCache::MeshCache(std::unique_ptr<MappedFile> file, const Header* header)
+    : file(std::move(file)), header(header) {
+}
+
+MeshCache::~MeshCache() = default;
+
+const Mesh::Vertex* MeshCache::getVertices() const {
+    return reinterpret_cast<const Mesh::Vertex*>(file->data() + header->vertexOffset);
+}
+
+const unsigned int* MeshCache::getIndices() const {
+    return reinterpret_cast<const unsigned int*>(file->data() + header->indexOffset);
+}
+
+const Mesh::LodLevel* MeshCache::getLodLevels() const {
+    return reinterpret_cast<const Mesh::LodLevel*>(file->data() + header->lodOffset);
+}
+
+const Mesh::Meshlet* MeshCache::getMeshlets() const {
+    return reinterpret_cast<const Mesh::Meshlet*>(file->data() + header->meshletOffset);
+}
+
+const MeshCache::Submesh* MeshCache::getSubmeshes() const {
+    return reinterpret_cast<const Submesh*>(file->data() + header->submeshOffset);
+}
+
+std::size_t MeshCache::getSubmeshCount() const {
+    return header->submeshCount;
+}
+
+glm::vec3 MeshCache::getBoundsMin() const {
+    return glm::vec3(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]);
+}
+
+glm::vec3 MeshCache::getBoundsMax() const {
+    return glm::vec3(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]);
+}
+
+std::size_t MeshCache::getFileSize() const {
+    return file->size();
+}
+
+} // namespace claude_gl
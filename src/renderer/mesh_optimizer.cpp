@@ -0,0 +1,465 @@
+#include "renderer/mesh_optimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <glm/glm.hpp>
+
+namespace claude_gl {
+
+namespace {
+
+// オーバードロー計測に使う深度バッファの解像度
+constexpr int OVERDRAW_GRID_SIZE = 256;
+
+// オーバードロー最適化で分割するクラスタの最小三角形数
+constexpr std::size_t MIN_CLUSTER_TRIANGLES = 8;
+
+// 未割り当ての頂点番号
+constexpr unsigned int INVALID_INDEX = std::numeric_limits<unsigned int>::max();
+
+/**
+ * @brief タイムスタンプ方式のFIFO頂点キャッシュシミュレーター
+ *
+ * 頂点ごとにキャッシュへ入った時刻を記録し、直近cacheSize回の挿入に含まれていればヒットとします。
+ */
+class FifoCache {
+public:
+    FifoCache(std::size_t vertexCount, unsigned int cacheSize)
+        : timestamps(vertexCount, 0), time(cacheSize + 1), cacheSize(cacheSize) {
+    }
+
+    /**
+     * @brief 頂点を参照する
+     * @return キャッシュミスした場合はtrue
+     */
+    bool access(unsigned int vertex) {
+        if (time - timestamps[vertex] > cacheSize) {
+            timestamps[vertex] = time++;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief キャッシュを空にする
+     */
+    void reset() {
+        time += cacheSize + 1;
+    }
+
+private:
+    std::vector<std::uint64_t> timestamps;
+    std::uint64_t time;
+    std::uint64_t cacheSize;
+};
+
+/**
+ * @brief 頂点から隣接三角形を引くための隣接リスト（CSR形式）
+ */
+struct TriangleAdjacency {
+    std::vector<unsigned int> offsets;    ///< 頂点ごとの開始位置（頂点数 + 1）
+    std::vector<unsigned int> triangles;  ///< 隣接三角形の番号
+
+    TriangleAdjacency(const std::vector<unsigned int>& indices, std::size_t vertexCount)
+        : offsets(vertexCount + 1, 0), triangles(indices.size()) {
+        for (unsigned int index : indices) {
+            ++offsets[index + 1];
+        }
+        for (std::size_t v = 0; v < vertexCount; ++v) {
+            offsets[v + 1] += offsets[v];
+        }
+
+        std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            triangles[cursor[indices[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+    }
+};
+
+/**
+ * @brief Tipsifyで次に扇状に展開する頂点を選ぶ
+ */
+int selectNextVertex(const std::vector<unsigned int>& candidates,
+                     const std::vector<unsigned int>& liveCounts,
+                     const std::vector<std::uint64_t>& cacheTimes, std::uint64_t time,
+                     unsigned int cacheSize, std::vector<unsigned int>& deadEnds,
+                     std::size_t& scanCursor) {
+    // キャッシュに残り、かつ残りの三角形を処理してもキャッシュから追い出されない頂点を優先
+    int best = -1;
+    long long bestPriority = -1;
+    for (unsigned int vertex : candidates) {
+        if (liveCounts[vertex] == 0) {
+            continue;
+        }
+        long long priority = 0;
+        long long age = static_cast<long long>(time - cacheTimes[vertex]);
+        if (age + 2 * static_cast<long long>(liveCounts[vertex]) <= cacheSize) {
+            priority = age;
+        }
+        if (priority > bestPriority) {
+            bestPriority = priority;
+            best = static_cast<int>(vertex);
+        }
+    }
+    if (best >= 0) {
+        return best;
+    }
+
+    // 行き止まりの場合は最近出力した頂点から未処理の三角形を持つものを探す
+    while (!deadEnds.empty()) {
+        unsigned int vertex = deadEnds.back();
+        deadEnds.pop_back();
+        if (liveCounts[vertex] > 0) {
+            return static_cast<int>(vertex);
+        }
+    }
+
+    // それもなければ頂点番号順に未処理の頂点を探す
+    while (scanCursor < liveCounts.size()) {
+        if (liveCounts[scanCursor] > 0) {
+            return static_cast<int>(scanCursor);
+        }
+        ++scanCursor;
+    }
+    return -1;
+}
+
+/**
+ * @brief 三角形を低解像度の深度バッファに描画し、深度テストを通過したフラグメント数を返す
+ */
+std::size_t rasterizeTriangle(std::vector<float>& depthBuffer, const glm::vec3& a,
+                              const glm::vec3& b, const glm::vec3& c) {
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (area == 0.0f) {
+        return 0;
+    }
+
+    constexpr int GRID_MAX = OVERDRAW_GRID_SIZE - 1;
+    int minX = std::max(0, static_cast<int>(std::floor(std::min({a.x, b.x, c.x}))));
+    int maxX = std::min(GRID_MAX, static_cast<int>(std::ceil(std::max({a.x, b.x, c.x}))));
+    int minY = std::max(0, static_cast<int>(std::floor(std::min({a.y, b.y, c.y}))));
+    int maxY = std::min(GRID_MAX, static_cast<int>(std::ceil(std::max({a.y, b.y, c.y}))));
+
+    // 面の向きによらず描画する（カリングなし）
+    float inverseArea = 1.0f / area;
+    std::size_t shaded = 0;
+    for (int y = minY; y <= maxY; ++y) {
+        float py = static_cast<float>(y) + 0.5f;
+        for (int x = minX; x <= maxX; ++x) {
+            float px = static_cast<float>(x) + 0.5f;
+
+            // 重心座標（面積で正規化するため巻き方向に依存しない）
+            float w0 = ((b.x - px) * (c.y - py) - (b.y - py) * (c.x - px)) * inverseArea;
+            float w1 = ((c.x - px) * (a.y - py) - (c.y - py) * (a.x - px)) * inverseArea;
+            float w2 = 1.0f - w0 - w1;
+            if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+                continue;
+            }
+
+            float depth = w0 * a.z + w1 * b.z + w2 * c.z;
+            float& stored = depthBuffer[static_cast<std::size_t>(y) * OVERDRAW_GRID_SIZE + x];
+            if (depth < stored) {
+                stored = depth;
+                ++shaded;
+            }
+        }
+    }
+    return shaded;
+}
+
+} // namespace
+
+MeshOptimizer::Stats MeshOptimizer::optimize(std::vector<Mesh::Vertex>& vertices,
+                                             std::vector<unsigned int>& indices,
+                                             unsigned int cacheSize, float overdrawThreshold,
+                                             bool analyzeOverdraw) {
+    Stats stats;
+    stats.cacheBefore = analyzeVertexCache(indices, vertices.size(), cacheSize);
+    if (analyzeOverdraw) {
+        stats.overdrawBefore = MeshOptimizer::analyzeOverdraw(indices, vertices);
+    }
+
+    optimizeVertexCache(indices, vertices.size(), cacheSize);
+    stats.clusterCount = optimizeOverdraw(indices, vertices, cacheSize, overdrawThreshold);
+    optimizeVertexFetch(vertices, indices);
+
+    stats.cacheAfter = analyzeVertexCache(indices, vertices.size(), cacheSize);
+    if (analyzeOverdraw) {
+        stats.overdrawAfter = MeshOptimizer::analyzeOverdraw(indices, vertices);
+    }
+    return stats;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int>& indices,
+                                        std::size_t vertexCount, unsigned int cacheSize) {
+    std::size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) {
+        return;
+    }
+
+    TriangleAdjacency adjacency(indices, vertexCount);
+
+    // 頂点ごとの未処理三角形数
+    std::vector<unsigned int> liveCounts(vertexCount);
+    for (std::size_t v = 0; v < vertexCount; ++v) {
+        liveCounts[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+    }
+
+    std::vector<std::uint64_t> cacheTimes(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<unsigned int> deadEnds;
+    std::vector<unsigned int> candidates;
+    std::vector<unsigned int> output;
+    output.reserve(triangleCount * 3);
+
+    std::uint64_t time = cacheSize + 1;
+    std::size_t scanCursor = 0;
+    int fanVertex = selectNextVertex(candidates, liveCounts, cacheTimes, time, cacheSize,
+                                     deadEnds, scanCursor);
+
+    while (fanVertex >= 0) {
+        candidates.clear();
+
+        // 扇の中心頂点に隣接する未処理の三角形をすべて出力
+        unsigned int adjacencyEnd = adjacency.offsets[fanVertex + 1];
+        for (unsigned int k = adjacency.offsets[fanVertex]; k < adjacencyEnd; ++k) {
+            unsigned int triangle = adjacency.triangles[k];
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = true;
+
+            for (unsigned int corner = 0; corner < 3; ++corner) {
+                unsigned int vertex = indices[triangle * 3 + corner];
+                output.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                --liveCounts[vertex];
+
+                // キャッシュミスなら新たにキャッシュへ入れる
+                if (time - cacheTimes[vertex] > cacheSize) {
+                    cacheTimes[vertex] = time++;
+                }
+            }
+        }
+
+        fanVertex = selectNextVertex(candidates, liveCounts, cacheTimes, time, cacheSize,
+                                     deadEnds, scanCursor);
+    }
+
+    indices.swap(output);
+}
+
+std::size_t MeshOptimizer::optimizeOverdraw(std::vector<unsigned int>& indices,
+                                            const std::vector<Mesh::Vertex>& vertices,
+                                            unsigned int cacheSize, float threshold) {
+    std::size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return 0;
+    }
+
+    // ハード境界: 3頂点ともキャッシュミスする三角形（Tipsifyの行き止まり）でクラスタを区切る
+    std::vector<std::size_t> hardBounds;
+    {
+        FifoCache cache(vertices.size(), cacheSize);
+        for (std::size_t t = 0; t < triangleCount; ++t) {
+            int misses = 0;
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+                misses += cache.access(indices[t * 3 + corner]) ? 1 : 0;
+            }
+            if (t == 0 || misses == 3) {
+                hardBounds.push_back(t);
+            }
+        }
+        hardBounds.push_back(triangleCount);
+    }
+
+    // ソフト境界: キャッシュ効率が元のクラスタのthreshold倍以内に収まる位置でさらに分割する
+    std::vector<std::size_t> bounds;
+    FifoCache cache(vertices.size(), cacheSize);
+    for (std::size_t c = 0; c + 1 < hardBounds.size(); ++c) {
+        std::size_t begin = hardBounds[c];
+        std::size_t end = hardBounds[c + 1];
+
+        cache.reset();
+        std::size_t clusterMisses = 0;
+        for (std::size_t i = begin * 3; i < end * 3; ++i) {
+            clusterMisses += cache.access(indices[i]) ? 1 : 0;
+        }
+        float clusterAcmr = static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+        cache.reset();
+        bounds.push_back(begin);
+        std::size_t subBegin = begin;
+        std::size_t subMisses = 0;
+        for (std::size_t t = begin; t < end; ++t) {
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+                subMisses += cache.access(indices[t * 3 + corner]) ? 1 : 0;
+            }
+
+            std::size_t subCount = t + 1 - subBegin;
+            float subAcmr = static_cast<float>(subMisses) / static_cast<float>(subCount);
+            if (subCount >= MIN_CLUSTER_TRIANGLES && t + 1 < end &&
+                subAcmr <= clusterAcmr * threshold) {
+                cache.reset();
+                subBegin = t + 1;
+                subMisses = 0;
+                bounds.push_back(subBegin);
+            }
+        }
+    }
+    bounds.push_back(triangleCount);
+    std::size_t clusterCount = bounds.size() - 1;
+
+    // メッシュ全体の重心（面積加重）
+    std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3(0.0f));
+    std::vector<float> clusterAreas(clusterCount, 0.0f);
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+
+    for (std::size_t c = 0; c < clusterCount; ++c) {
+        for (std::size_t t = bounds[c]; t < bounds[c + 1]; ++t) {
+            const glm::vec3& p0 = vertices[indices[t * 3 + 0]].position;
+            const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+
+            // 外積の長さは三角形面積の2倍なので、そのまま重みとして使う
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(normal);
+            glm::vec3 centroid = (p0 + p1 + p2) * (area / 3.0f);
+
+            clusterCentroids[c] += centroid;
+            clusterNormals[c] += normal;
+            clusterAreas[c] += area;
+            meshCentroid += centroid;
+            meshArea += area;
+        }
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid /= meshArea;
+    }
+
+    // 中心から外向きに離れたクラスタほど手前を覆いやすいので先に描画する
+    std::vector<float> sortKeys(clusterCount, 0.0f);
+    for (std::size_t c = 0; c < clusterCount; ++c) {
+        float normalLength = glm::length(clusterNormals[c]);
+        if (clusterAreas[c] <= 0.0f || normalLength <= 0.0f) {
+            continue;
+        }
+        glm::vec3 centroid = clusterCentroids[c] / clusterAreas[c];
+        sortKeys[c] = glm::dot(centroid - meshCentroid, clusterNormals[c] / normalLength);
+    }
+
+    std::vector<std::size_t> order(clusterCount);
+    for (std::size_t c = 0; c < clusterCount; ++c) {
+        order[c] = c;
+    }
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](std::size_t lhs, std::size_t rhs) {
+        return sortKeys[lhs] > sortKeys[rhs];
+    });
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    for (std::size_t c : order) {
+        output.insert(output.end(), indices.begin() + bounds[c] * 3,
+                      indices.begin() + bounds[c + 1] * 3);
+    }
+    indices.swap(output);
+    return clusterCount;
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<Mesh::Vertex>& vertices,
+                                        std::vector<unsigned int>& indices) {
+    std::vector<unsigned int> remap(vertices.size(), INVALID_INDEX);
+    std::vector<Mesh::Vertex> output;
+    output.reserve(vertices.size());
+
+    // 最初に参照された順に新しい頂点番号を割り当てる
+    for (unsigned int& index : indices) {
+        if (remap[index] == INVALID_INDEX) {
+            remap[index] = static_cast<unsigned int>(output.size());
+            output.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    vertices.swap(output);
+}
+
+MeshOptimizer::VertexCacheStats MeshOptimizer::analyzeVertexCache(
+    const std::vector<unsigned int>& indices, std::size_t vertexCount, unsigned int cacheSize) {
+    VertexCacheStats stats;
+    std::size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) {
+        return stats;
+    }
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    std::size_t uniqueVertices = 0;
+    for (unsigned int index : indices) {
+        stats.vertexTransforms += cache.access(index) ? 1 : 0;
+        if (!referenced[index]) {
+            referenced[index] = true;
+            ++uniqueVertices;
+        }
+    }
+
+    stats.acmr = static_cast<float>(stats.vertexTransforms) / static_cast<float>(triangleCount);
+    stats.atvr = static_cast<float>(stats.vertexTransforms) / static_cast<float>(uniqueVertices);
+    return stats;
+}
+
+MeshOptimizer::OverdrawStats MeshOptimizer::analyzeOverdraw(
+    const std::vector<unsigned int>& indices, const std::vector<Mesh::Vertex>& vertices) {
+    OverdrawStats stats;
+    if (indices.size() < 3 || vertices.empty()) {
+        return stats;
+    }
+
+    // バウンディングボックスの最大辺を深度バッファの解像度に合わせる
+    glm::vec3 minBounds = vertices[0].position;
+    glm::vec3 maxBounds = vertices[0].position;
+    for (const Mesh::Vertex& vertex : vertices) {
+        minBounds = glm::min(minBounds, vertex.position);
+        maxBounds = glm::max(maxBounds, vertex.position);
+    }
+    glm::vec3 extent = maxBounds - minBounds;
+    float maxExtent = std::max({extent.x, extent.y, extent.z});
+    float scale = maxExtent > 0.0f ? static_cast<float>(OVERDRAW_GRID_SIZE) / maxExtent : 0.0f;
+
+    std::vector<float> depthBuffer(OVERDRAW_GRID_SIZE * OVERDRAW_GRID_SIZE);
+    std::vector<glm::vec3> projected(vertices.size());
+
+    for (int axis = 0; axis < 3; ++axis) {
+        for (float direction : {1.0f, -1.0f}) {
+            // 視線方向の軸を深度、残りの2軸をスクリーン座標とする正射影
+            int axisU = (axis + 1) % 3;
+            int axisV = (axis + 2) % 3;
+            for (std::size_t v = 0; v < vertices.size(); ++v) {
+                glm::vec3 local = (vertices[v].position - minBounds) * scale;
+                projected[v] = glm::vec3(local[axisU], local[axisV], local[axis] * direction);
+            }
+
+            std::fill(depthBuffer.begin(), depthBuffer.end(), std::numeric_limits<float>::max());
+            for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+                stats.pixelsShaded += rasterizeTriangle(depthBuffer, projected[indices[i]],
+                                                        projected[indices[i + 1]],
+                                                        projected[indices[i + 2]]);
+            }
+            for (float depth : depthBuffer) {
+                stats.pixelsCovered += depth < std::numeric_limits<float>::max() ? 1 : 0;
+            }
+        }
+    }
+
+    if (stats.pixelsCovered > 0) {
+        stats.overdraw = static_cast<float>(stats.pixelsShaded) /
+                         static_cast<float>(stats.pixelsCovered);
+    }
+    return stats;
+}
+
+} // namespace claude_gl
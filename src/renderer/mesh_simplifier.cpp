@@ -0,0 +1,511 @@
+#include "renderer/mesh_simplifier.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+
+namespace claude_gl {
+
+namespace {
+
+// 開いた縁に垂直な平面の二次形式の重み（縁の長さの2乗に掛ける）
+constexpr double BORDER_WEIGHT = 10.0;
+
+// 縮約後の三角形の法線が元の法線となす角の余弦の下限（これより向きが変わる縮約はしない）
+constexpr double MIN_NORMAL_COSINE = 0.25;
+
+// 1回の簡略化で繰り返す走査の上限
+constexpr int MAX_PASSES = 64;
+
+/**
+ * @brief 頂点の動かし方の種類
+ */
+enum class VertexKind : unsigned char {
+    Manifold,  ///< 内部の頂点（どの隣接頂点へも寄せられる）
+    Border,    ///< 開いた縁の頂点（縁に沿ってのみ寄せられる）
+    Locked,    ///< 動かさない頂点（継ぎ目・非多様体・縁の固定）
+};
+
+/**
+ * @brief 平面からの距離の2乗の和を表す二次形式（対称行列 A、ベクトル b、定数 c）
+ */
+struct Quadric {
+    double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+    double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+    double c = 0.0;
+    double weight = 0.0;  ///< 重みの合計（誤差を距離の2乗に戻すのに使う）
+
+    /**
+     * @brief 平面 dot(n, p) + d = 0 を重み付きで加える（n は単位ベクトル）
+     */
+    void addPlane(const glm::dvec3& n, double d, double w) {
+        a00 += w * n.x * n.x;
+        a01 += w * n.x * n.y;
+        a02 += w * n.x * n.z;
+        a11 += w * n.y * n.y;
+        a12 += w * n.y * n.z;
+        a22 += w * n.z * n.z;
+        b0 += w * n.x * d;
+        b1 += w * n.y * d;
+        b2 += w * n.z * d;
+        c += w * d * d;
+        weight += w;
+    }
+
+    /**
+     * @brief 二次形式を加える
+     */
+    void add(const Quadric& q) {
+        a00 += q.a00;
+        a01 += q.a01;
+        a02 += q.a02;
+        a11 += q.a11;
+        a12 += q.a12;
+        a22 += q.a22;
+        b0 += q.b0;
+        b1 += q.b1;
+        b2 += q.b2;
+        c += q.c;
+        weight += q.weight;
+    }
+
+    /**
+     * @brief 点での値（重み付きの距離の2乗の和）を求める
+     */
+    double evaluate(const glm::vec3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double value = a00 * x * x + a11 * y * y + a22 * z * z +
+                       2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                       2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return std::max(value, 0.0);
+    }
+};
+
+/**
+ * @brief 縮約の候補（from を to へ寄せる）
+ */
+struct Collapse {
+    float cost;         ///< 誤差（距離の2乗）
+    unsigned int from;  ///< 寄せる頂点
+    unsigned int to;    ///< 寄せ先の頂点
+};
+
+/**
+ * @brief 辺の両端の番号から順序によらないキーを作る
+ */
+std::uint64_t edgeKey(unsigned int a, unsigned int b) {
+    return a < b ? (std::uint64_t(a) << 32) | b : (std::uint64_t(b) << 32) | a;
+}
+
+/**
+ * @brief 位置が同じ頂点に同じ番号（最初の頂点の番号）を割り当てる
+ */
+std::vector<unsigned int> buildPositionIds(const Mesh::Vertex* vertices, std::size_t vertexCount) {
+    std::vector<unsigned int> order(vertexCount);
+    std::iota(order.begin(), order.end(), 0u);
+    auto less = [vertices](unsigned int a, unsigned int b) {
+        const glm::vec3& p = vertices[a].position;
+        const glm::vec3& q = vertices[b].position;
+        if (p.x != q.x) return p.x < q.x;
+        if (p.y != q.y) return p.y < q.y;
+        if (p.z != q.z) return p.z < q.z;
+        return a < b;
+    };
+    std::sort(order.begin(), order.end(), less);
+
+    std::vector<unsigned int> positionIds(vertexCount);
+    for (std::size_t i = 0; i < vertexCount; ++i) {
+        bool same = i > 0 && vertices[order[i]].position == vertices[order[i - 1]].position;
+        positionIds[order[i]] = same ? positionIds[order[i - 1]] : order[i];
+    }
+    return positionIds;
+}
+
+/**
+ * @brief 頂点ごとに動かし方の種類を決める
+ *
+ * 縁の判定は位置の番号で行い、テクスチャの継ぎ目で分かれた頂点を縁と見なさないようにします。
+ */
+std::vector<VertexKind> classifyVertices(std::size_t vertexCount, const unsigned int* indices,
+                                         std::size_t indexCount,
+                                         const std::vector<unsigned int>& positionIds,
+                                         bool lockBorder) {
+    // 位置ごとに、参照される頂点が複数あれば属性の継ぎ目
+    std::vector<unsigned int> firstVertex(vertexCount, 0xFFFFFFFFu);
+    std::vector<VertexKind> positionKinds(vertexCount, VertexKind::Manifold);
+    for (std::size_t i = 0; i < indexCount; ++i) {
+        unsigned int vertex = indices[i];
+        unsigned int position = positionIds[vertex];
+        if (firstVertex[position] == 0xFFFFFFFFu) {
+            firstVertex[position] = vertex;
+        }
+        else if (firstVertex[position] != vertex) {
+            positionKinds[position] = VertexKind::Locked;
+        }
+    }
+
+    // 1つの三角形だけが使う辺は開いた縁、3つ以上が使う辺は非多様体
+    std::unordered_map<std::uint64_t, unsigned int> edgeUses;
+    edgeUses.reserve(indexCount);
+    for (std::size_t i = 0; i < indexCount; i += 3) {
+        for (int k = 0; k < 3; ++k) {
+            unsigned int a = positionIds[indices[i + k]];
+            unsigned int b = positionIds[indices[i + (k + 1) % 3]];
+            ++edgeUses[edgeKey(a, b)];
+        }
+    }
+    for (const auto& edge : edgeUses) {
+        unsigned int ends[2] = {static_cast<unsigned int>(edge.first >> 32),
+                                static_cast<unsigned int>(edge.first & 0xFFFFFFFFu)};
+        for (unsigned int position : ends) {
+            if (edge.second > 2 || (edge.second == 1 && lockBorder)) {
+                positionKinds[position] = VertexKind::Locked;
+            }
+            else if (edge.second == 1 && positionKinds[position] == VertexKind::Manifold) {
+                positionKinds[position] = VertexKind::Border;
+            }
+        }
+    }
+
+    std::vector<VertexKind> kinds(vertexCount);
+    for (std::size_t v = 0; v < vertexCount; ++v) {
+        kinds[v] = positionKinds[positionIds[v]];
+    }
+    return kinds;
+}
+
+/**
+ * @brief 頂点ごとに、三角形の平面と開いた縁の平面の二次形式を求める
+ */
+std::vector<Quadric> buildQuadrics(const Mesh::Vertex* vertices, std::size_t vertexCount,
+                                   const unsigned int* indices, std::size_t indexCount,
+                                   const std::vector<unsigned int>& positionIds) {
+    std::vector<Quadric> quadrics(vertexCount);
+    std::unordered_map<std::uint64_t, unsigned int> edgeUses;
+    edgeUses.reserve(indexCount);
+    for (std::size_t i = 0; i < indexCount; i += 3) {
+        for (int k = 0; k < 3; ++k) {
+            ++edgeUses[edgeKey(positionIds[indices[i + k]],
+                               positionIds[indices[i + (k + 1) % 3]])];
+        }
+    }
+
+    for (std::size_t i = 0; i < indexCount; i += 3) {
+        glm::dvec3 p[3];
+        for (int k = 0; k < 3; ++k) {
+            p[k] = glm::dvec3(vertices[indices[i + k]].position);
+        }
+        glm::dvec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+        double length = glm::length(normal);
+        if (length <= 0.0) {
+            continue;
+        }
+        normal /= length;
+
+        // 面積で重み付けした三角形の平面
+        Quadric plane;
+        plane.addPlane(normal, -glm::dot(normal, p[0]), length * 0.5);
+        for (int k = 0; k < 3; ++k) {
+            quadrics[indices[i + k]].add(plane);
+        }
+
+        // 開いた縁は、縁を含み三角形に垂直な平面で縁の外への移動を抑える
+        for (int k = 0; k < 3; ++k) {
+            unsigned int a = indices[i + k];
+            unsigned int b = indices[i + (k + 1) % 3];
+            if (edgeUses[edgeKey(positionIds[a], positionIds[b])] != 1) {
+                continue;
+            }
+            glm::dvec3 edge = p[(k + 1) % 3] - p[k];
+            glm::dvec3 side = glm::cross(edge, normal);
+            double sideLength = glm::length(side);
+            if (sideLength <= 0.0) {
+                continue;
+            }
+            side /= sideLength;
+            Quadric border;
+            border.addPlane(side, -glm::dot(side, p[k]), glm::dot(edge, edge) * BORDER_WEIGHT);
+            quadrics[a].add(border);
+            quadrics[b].add(border);
+        }
+    }
+    return quadrics;
+}
+
+} // namespace
+
+float MeshSimplifier::simplify(const Mesh::Vertex* vertices, std::size_t vertexCount,
+                               const unsigned int* indices, std::size_t indexCount,
+                               std::size_t targetIndexCount, float maxError,
+                               std::vector<unsigned int>& output, const Options& options) {
+    output.assign(indices, indices + indexCount);
+    if (indexCount <= targetIndexCount || vertexCount == 0) {
+        return 0.0f;
+    }
+
+    std::vector<unsigned int> positionIds = buildPositionIds(vertices, vertexCount);
+    std::vector<VertexKind> kinds =
+        classifyVertices(vertexCount, indices, indexCount, positionIds, options.lockBorder);
+    std::vector<Quadric> quadrics =
+        buildQuadrics(vertices, vertexCount, indices, indexCount, positionIds);
+
+    double normalWeight = double(options.normalWeight) * options.normalWeight;
+    double texCoordWeight = double(options.texCoordWeight) * options.texCoordWeight;
+    double maxErrorSquared = double(maxError) * maxError;
+    double resultErrorSquared = 0.0;
+
+    // 寄せた頂点の誤差（位置の二次形式と、寄せ先との属性の差）
+    auto collapseCost = [&](unsigned int from, unsigned int to) {
+        Quadric q = quadrics[from];
+        q.add(quadrics[to]);
+        double cost = q.weight > 0.0 ? q.evaluate(vertices[to].position) / q.weight : 0.0;
+        glm::vec3 normalDelta = vertices[from].normal - vertices[to].normal;
+        glm::vec2 texCoordDelta = vertices[from].texCoords - vertices[to].texCoords;
+        cost += normalWeight * glm::dot(normalDelta, normalDelta) +
+                texCoordWeight * glm::dot(texCoordDelta, texCoordDelta);
+        return cost;
+    };
+
+    std::vector<unsigned int> triangleOffsets(vertexCount + 1);
+    std::vector<unsigned int> vertexTriangles;
+    std::vector<Collapse> collapses;
+    std::vector<unsigned int> remap(vertexCount);
+    std::vector<unsigned char> locked(vertexCount);
+    std::vector<unsigned int> marks(vertexCount, 0);
+    unsigned int mark = 0;
+
+    std::size_t triangleCount = indexCount / 3;
+    std::size_t targetTriangles = targetIndexCount / 3;
+    for (int pass = 0; pass < MAX_PASSES && triangleCount > targetTriangles; ++pass) {
+        // 頂点ごとの三角形の一覧（前の走査の縮約を反映したインデックスから作る）
+        std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0u);
+        for (unsigned int vertex : output) {
+            ++triangleOffsets[vertex + 1];
+        }
+        for (std::size_t v = 0; v < vertexCount; ++v) {
+            triangleOffsets[v + 1] += triangleOffsets[v];
+        }
+        vertexTriangles.resize(output.size());
+        std::vector<unsigned int> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+        for (std::size_t i = 0; i < output.size(); ++i) {
+            vertexTriangles[cursor[output[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+
+        // 縁の頂点は、同じ位置の頂点と縁の辺でつながる場合のみ寄せられる
+        auto isBorderEdge = [&](unsigned int from, unsigned int to) {
+            unsigned int uses = 0;
+            for (unsigned int t = triangleOffsets[from]; t < triangleOffsets[from + 1]; ++t) {
+                const unsigned int* triangle = &output[vertexTriangles[t] * 3];
+                for (int k = 0; k < 3; ++k) {
+                    uses += positionIds[triangle[k]] == positionIds[to] ? 1 : 0;
+                }
+            }
+            return uses == 1;
+        };
+
+        // 辺ごとに誤差の小さい向きの縮約を候補にする（両側の三角形から重複して入るが、
+        // 2回目は頂点が使用済みになるため縮約されない）
+        collapses.clear();
+        for (std::size_t i = 0; i < output.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                unsigned int a = output[i + k];
+                unsigned int b = output[i + (k + 1) % 3];
+                Collapse best{FLT_MAX, a, b};
+                for (int direction = 0; direction < 2; ++direction) {
+                    unsigned int from = direction == 0 ? a : b;
+                    unsigned int to = direction == 0 ? b : a;
+                    if (kinds[from] == VertexKind::Locked ||
+                        (kinds[from] == VertexKind::Border &&
+                         (kinds[to] == VertexKind::Manifold || !isBorderEdge(from, to)))) {
+                        continue;
+                    }
+                    float cost = static_cast<float>(collapseCost(from, to));
+                    if (cost < best.cost) {
+                        best = {cost, from, to};
+                    }
+                }
+                if (best.cost <= maxErrorSquared) {
+                    collapses.push_back(best);
+                }
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+        // 誤差の小さい順に、近傍が重ならない縮約だけを行う
+        std::iota(remap.begin(), remap.end(), 0u);
+        std::fill(locked.begin(), locked.end(), 0);
+        std::size_t collapsed = 0;
+        for (const Collapse& collapse : collapses) {
+            if (triangleCount <= targetTriangles) {
+                break;
+            }
+            unsigned int from = collapse.from;
+            unsigned int to = collapse.to;
+            if (locked[from] || locked[to]) {
+                continue;
+            }
+
+            // 消える三角形（辺を共有する三角形）と、向きが変わる三角形を調べる
+            glm::vec3 target = vertices[to].position;
+            std::size_t removed = 0;
+            bool flipped = false;
+            ++mark;
+            for (unsigned int t = triangleOffsets[from]; t < triangleOffsets[from + 1]; ++t) {
+                const unsigned int* triangle = &output[vertexTriangles[t] * 3];
+                int corner = triangle[0] == from ? 0 : (triangle[1] == from ? 1 : 2);
+                unsigned int b = triangle[(corner + 1) % 3];
+                unsigned int c = triangle[(corner + 2) % 3];
+                marks[b] = mark;
+                marks[c] = mark;
+                if (b == to || c == to) {
+                    ++removed;
+                    continue;
+                }
+                glm::vec3 p0 = vertices[from].position;
+                glm::vec3 p1 = vertices[b].position;
+                glm::vec3 p2 = vertices[c].position;
+                glm::dvec3 before = glm::cross(glm::dvec3(p1 - p0), glm::dvec3(p2 - p0));
+                glm::dvec3 after = glm::cross(glm::dvec3(p1 - target), glm::dvec3(p2 - target));
+                if (glm::dot(before, after) <=
+                    MIN_NORMAL_COSINE * glm::length(before) * glm::length(after)) {
+                    flipped = true;
+                    break;
+                }
+            }
+            if (flipped || removed == 0) {
+                continue;
+            }
+
+            // 両端に共通の隣接頂点が消える三角形より多いと、縮約で面が重なる（リンク条件）
+            std::size_t shared = 0;
+            for (unsigned int t = triangleOffsets[to]; t < triangleOffsets[to + 1]; ++t) {
+                const unsigned int* triangle = &output[vertexTriangles[t] * 3];
+                for (int k = 0; k < 3; ++k) {
+                    unsigned int v = triangle[k];
+                    if (v != to && v != from && marks[v] == mark) {
+                        marks[v] = 0;
+                        ++shared;
+                    }
+                }
+            }
+            if (shared > removed) {
+                continue;
+            }
+
+            // 縮約する（変わる三角形の頂点はこの走査では使わない）
+            for (unsigned int t = triangleOffsets[from]; t < triangleOffsets[from + 1]; ++t) {
+                const unsigned int* triangle = &output[vertexTriangles[t] * 3];
+                locked[triangle[0]] = 1;
+                locked[triangle[1]] = 1;
+                locked[triangle[2]] = 1;
+            }
+            remap[from] = to;
+            quadrics[to].add(quadrics[from]);
+            triangleCount -= removed;
+            resultErrorSquared = std::max(resultErrorSquared, double(collapse.cost));
+            ++collapsed;
+        }
+        if (collapsed == 0) {
+            break;
+        }
+
+        // 縮約を反映し、2頂点が重なった三角形を除く
+        std::size_t write = 0;
+        for (std::size_t i = 0; i < output.size(); i += 3) {
+            unsigned int a = remap[output[i]];
+            unsigned int b = remap[output[i + 1]];
+            unsigned int c = remap[output[i + 2]];
+            if (a != b && b != c && c != a) {
+                output[write++] = a;
+                output[write++] = b;
+                output[write++] = c;
+            }
+        }
+        output.resize(write);
+        triangleCount = write / 3;
+    }
+    return static_cast<float>(std::sqrt(resultErrorSquared));
+}
+
+std::vector<Mesh::LodLevel> MeshSimplifier::buildLodChain(const Mesh::Vertex* vertices,
+                                                          std::size_t vertexCount,
+                                                          std::vector<unsigned int>& indices,
+                                                          const LodOptions& options) {
+    std::vector<Mesh::LodLevel> levels;
+    levels.push_back({0, static_cast<std::uint32_t>(indices.size()), 0.0f});
+
+    std::vector<unsigned int> previous(indices);
+    std::vector<unsigned int> simplified;
+    float error = 0.0f;
+    for (unsigned int level = 1; level < options.levelCount; ++level) {
+        std::size_t targetTriangles =
+            static_cast<std::size_t>(previous.size() / 3 * double(options.reduction));
+        if (targetTriangles < options.minTriangles) {
+            break;
+        }
+        float levelError = simplify(vertices, vertexCount, previous.data(), previous.size(),
+                                    targetTriangles * 3, options.maxError, simplified,
+                                    options.simplify);
+
+        // 誤差の上限や動かせない頂点で目標の半分も減らせなければ打ち切る
+        double reached = double(simplified.size()) / double(previous.size());
+        if (simplified.empty() || reached > (1.0 + options.reduction) * 0.5) {
+            break;
+        }
+        error += levelError;
+        levels.push_back({static_cast<std::uint32_t>(indices.size()),
+                          static_cast<std::uint32_t>(simplified.size()), error});
+        indices.insert(indices.end(), simplified.begin(), simplified.end());
+        previous.swap(simplified);
+    }
+    return levels;
+}
+
+std::size_t MeshSimplifier::selectLod(const Mesh::LodLevel* levels, std::size_t levelCount,
+                                      float pixelsPerUnit, std::size_t current,
+                                      float thresholdPixels, float hysteresis) {
+    if (levelCount == 0) {
+        return 0;
+    }
+    current = std::min(current, levelCount - 1);
+
+    // 誤差は段階とともに増えるので、閾値以下の最後の段階が最も粗い
+    float relaxedThreshold = thresholdPixels * (1.0f - hysteresis);
+    std::size_t target = 0;
+    std::size_t relaxed = 0;
+    for (std::size_t i = 1; i < levelCount; ++i) {
+        float pixels = levels[i].error * pixelsPerUnit;
+        if (pixels <= thresholdPixels) {
+            target = i;
+        }
+        if (pixels <= relaxedThreshold) {
+            relaxed = i;
+        }
+    }
+
+    // 細かい段階へはすぐに戻し、粗い段階へは余裕がある分だけ進める
+    if (target <= current) {
+        return target;
+    }
+    return std::max(current, relaxed);
+}
+
+float MeshSimplifier::getPixelsPerUnit(const LodView& view, const glm::mat4& world,
+                                       const BoundingVolume& bounds) {
+    if (view.projectionScale <= 0.0f) {
+        return FLT_MAX;
+    }
+    glm::vec3 center = glm::vec3(world * glm::vec4(bounds.getCenter(), 1.0f));
+    float scale = std::max(glm::length(glm::vec3(world[0])),
+                           std::max(glm::length(glm::vec3(world[1])),
+                                    glm::length(glm::vec3(world[2]))));
+    float distance = glm::length(center - view.cameraPosition) - bounds.radius * scale;
+    if (distance <= 0.0f) {
+        return FLT_MAX;
+    }
+    return view.projectionScale * scale / distance;
+}
+
+} // namespace claude_gl
@@ -0,0 +1,244 @@
+#include "renderer/meshlet_builder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace claude_gl {
+
+namespace {
+
+// 番号の配列で「なし」を表す値
+constexpr std::uint32_t NONE = 0xFFFFFFFFu;
+
+// 法線の和がこれより短いクラスタは向きが定まらないため錐を作らない
+constexpr float MIN_CONE_AXIS_LENGTH = 1e-6f;
+
+/**
+ * @brief 三角形の単位法線を求める（面積が0の三角形は零ベクトル）
+ */
+glm::vec3 getTriangleNormal(const Mesh::Vertex* vertices, const unsigned int* triangle) {
+    glm::vec3 a = vertices[triangle[0]].position;
+    glm::vec3 normal = glm::cross(vertices[triangle[1]].position - a,
+                                  vertices[triangle[2]].position - a);
+    float length = glm::length(normal);
+    return length > 0.0f ? normal / length : glm::vec3(0.0f);
+}
+
+} // namespace
+
+std::vector<Mesh::Meshlet> MeshletBuilder::build(const Mesh::Vertex* vertices,
+                                                 std::size_t vertexCount, unsigned int* indices,
+                                                 std::size_t indexCount, const Options& options) {
+    if (options.maxVertices < 3 || options.maxTriangles == 0) {
+        throw std::runtime_error("MeshletBuilder: invalid limits " +
+                                 std::to_string(options.maxVertices) + " vertices, " +
+                                 std::to_string(options.maxTriangles) + " triangles");
+    }
+    if (indexCount % 3 != 0) {
+        throw std::runtime_error("MeshletBuilder: index count " + std::to_string(indexCount) +
+                                 " is not a multiple of 3");
+    }
+    for (std::size_t i = 0; i < indexCount; ++i) {
+        if (indices[i] >= vertexCount) {
+            throw std::runtime_error("MeshletBuilder: index " + std::to_string(indices[i]) +
+                                     " out of range");
+        }
+    }
+    std::size_t triangleCount = indexCount / 3;
+
+    // 頂点ごとの隣接する三角形（CSR）と、まだクラスタに入っていない三角形の数
+    std::vector<std::uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (std::size_t i = 0; i < indexCount; ++i) {
+        ++adjacencyOffsets[indices[i] + 1];
+    }
+    for (std::size_t v = 0; v < vertexCount; ++v) {
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    }
+    std::vector<std::uint32_t> adjacency(indexCount);
+    std::vector<std::uint32_t> liveTriangles(vertexCount);
+    for (std::size_t v = 0; v < vertexCount; ++v) {
+        liveTriangles[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+    }
+    {
+        std::vector<std::uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (std::size_t i = 0; i < indexCount; ++i) {
+            adjacency[cursor[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+        }
+    }
+
+    // 三角形の重心と単位法線
+    std::vector<glm::vec3> centroids(triangleCount);
+    std::vector<glm::vec3> normals(triangleCount);
+    for (std::size_t t = 0; t < triangleCount; ++t) {
+        const unsigned int* triangle = indices + t * 3;
+        centroids[t] = (vertices[triangle[0]].position + vertices[triangle[1]].position +
+                        vertices[triangle[2]].position) / 3.0f;
+        normals[t] = getTriangleNormal(vertices, triangle);
+    }
+
+    // 頂点と候補の三角形は、最後に加えたクラスタの番号で印を付けて重複を除く
+    std::vector<std::uint8_t> emitted(triangleCount, 0);
+    std::vector<std::uint32_t> vertexMark(vertexCount, NONE);
+    std::vector<std::uint32_t> candidateMark(triangleCount, NONE);
+    std::vector<std::uint32_t> candidates;
+    std::vector<unsigned int> reordered;
+    reordered.reserve(indexCount);
+    std::vector<Mesh::Meshlet> meshlets;
+
+    std::size_t emittedCount = 0;
+    std::size_t seedCursor = 0;
+    std::uint32_t seed = NONE;
+    while (emittedCount < triangleCount) {
+        // 前のクラスタから続く候補がなければ、元の順で最初の残った三角形から始める
+        if (seed == NONE) {
+            while (emitted[seedCursor]) {
+                ++seedCursor;
+            }
+            seed = static_cast<std::uint32_t>(seedCursor);
+        }
+
+        std::uint32_t mark = static_cast<std::uint32_t>(meshlets.size());
+        Mesh::Meshlet meshlet;
+        meshlet.firstIndex = static_cast<std::uint32_t>(reordered.size());
+        std::size_t meshletVertices = 0;
+        std::size_t meshletTriangles = 0;
+        glm::vec3 centroidSum(0.0f);
+        glm::vec3 normalSum(0.0f);
+        candidates.clear();
+
+        for (std::uint32_t next = seed; next != NONE;) {
+            // 三角形をクラスタに加え、新しい頂点に隣接する三角形を候補にする
+            emitted[next] = 1;
+            ++emittedCount;
+            ++meshletTriangles;
+            centroidSum += centroids[next];
+            normalSum += normals[next];
+            for (int k = 0; k < 3; ++k) {
+                unsigned int v = indices[next * 3 + k];
+                reordered.push_back(v);
+                --liveTriangles[v];
+                if (vertexMark[v] == mark) {
+                    continue;
+                }
+                vertexMark[v] = mark;
+                ++meshletVertices;
+                for (std::uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a) {
+                    std::uint32_t triangle = adjacency[a];
+                    if (!emitted[triangle] && candidateMark[triangle] != mark) {
+                        candidateMark[triangle] = mark;
+                        candidates.push_back(triangle);
+                    }
+                }
+            }
+            if (meshletTriangles == options.maxTriangles) {
+                break;
+            }
+
+            // 新しい頂点が最も少なく、中心に近く向きが揃う候補を選ぶ（収まらない候補は除く）
+            glm::vec3 center = centroidSum / static_cast<float>(meshletTriangles);
+            float axisLength = glm::length(normalSum);
+            glm::vec3 axis = axisLength > 0.0f ? normalSum / axisLength : glm::vec3(0.0f);
+            next = NONE;
+            int bestExtra = 4;
+            float bestScore = 0.0f;
+            std::size_t kept = 0;
+            for (std::uint32_t candidate : candidates) {
+                if (emitted[candidate]) {
+                    continue;
+                }
+                candidates[kept++] = candidate;
+                const unsigned int* triangle = indices + candidate * 3;
+                int extra = (vertexMark[triangle[0]] != mark ? 1 : 0) +
+                            (vertexMark[triangle[1]] != mark ? 1 : 0) +
+                            (vertexMark[triangle[2]] != mark ? 1 : 0);
+                if (meshletVertices + extra > options.maxVertices || extra > bestExtra) {
+                    continue;
+                }
+                float spread = 1.0f - glm::dot(normals[candidate], axis);
+                float score = glm::length(centroids[candidate] - center) *
+                              (1.0f + options.coneWeight * spread);
+                if (extra < bestExtra || score < bestScore) {
+                    next = candidate;
+                    bestExtra = extra;
+                    bestScore = score;
+                }
+            }
+            candidates.resize(kept);
+        }
+
+        meshlet.indexCount = static_cast<std::uint32_t>(reordered.size()) - meshlet.firstIndex;
+        computeBounds(vertices, reordered.data(), meshlet);
+        meshlets.push_back(meshlet);
+
+        // 次のクラスタは残った候補のうち、周りに残る三角形が最も少ないもの（縁）から始める
+        seed = NONE;
+        std::uint32_t fewestLive = NONE;
+        for (std::uint32_t candidate : candidates) {
+            if (emitted[candidate]) {
+                continue;
+            }
+            const unsigned int* triangle = indices + candidate * 3;
+            std::uint32_t live = liveTriangles[triangle[0]] + liveTriangles[triangle[1]] +
+                                 liveTriangles[triangle[2]];
+            if (live < fewestLive) {
+                seed = candidate;
+                fewestLive = live;
+            }
+        }
+    }
+
+    std::copy(reordered.begin(), reordered.end(), indices);
+    return meshlets;
+}
+
+void MeshletBuilder::computeBounds(const Mesh::Vertex* vertices, const unsigned int* indices,
+                                   Mesh::Meshlet& meshlet) {
+    const unsigned int* first = indices + meshlet.firstIndex;
+    std::size_t indexCount = meshlet.indexCount;
+    if (indexCount == 0) {
+        return;
+    }
+
+    // 境界球（中心はボックスの中心、半径は最も遠い頂点まで）
+    glm::vec3 boundsMin = vertices[first[0]].position;
+    glm::vec3 boundsMax = boundsMin;
+    for (std::size_t i = 1; i < indexCount; ++i) {
+        boundsMin = glm::min(boundsMin, vertices[first[i]].position);
+        boundsMax = glm::max(boundsMax, vertices[first[i]].position);
+    }
+    meshlet.center = (boundsMin + boundsMax) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (std::size_t i = 0; i < indexCount; ++i) {
+        glm::vec3 offset = vertices[first[i]].position - meshlet.center;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+    meshlet.radius = std::sqrt(radiusSquared);
+
+    // 法線の錐（軸は単位法線の平均、閾値は軸から最も離れた法線の角度の余角の余弦）
+    glm::vec3 normalSum(0.0f);
+    for (std::size_t i = 0; i < indexCount; i += 3) {
+        normalSum += getTriangleNormal(vertices, first + i);
+    }
+    float axisLength = glm::length(normalSum);
+    meshlet.coneAxis = glm::vec3(0.0f);
+    meshlet.coneCutoff = 1.0f;
+    if (axisLength < MIN_CONE_AXIS_LENGTH) {
+        return;
+    }
+    glm::vec3 axis = normalSum / axisLength;
+    float minDot = 1.0f;
+    for (std::size_t i = 0; i < indexCount; i += 3) {
+        glm::vec3 normal = getTriangleNormal(vertices, first + i);
+        if (normal != glm::vec3(0.0f)) {
+            minDot = std::min(minDot, glm::dot(normal, axis));
+        }
+    }
+    meshlet.coneAxis = axis;
+    if (minDot > 0.0f) {
+        meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+} // namespace claude_gl
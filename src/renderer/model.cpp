@@ -1,27 +1,310 @@
 #include "renderer/model.h"
-#include <fstream>
-#include <sstream>
-#include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
 #include <glm/gtc/matrix_transform.hpp>
+#include "renderer/geometry_arena.h"
+#include "renderer/mesh_cache.h"
+#include "renderer/mesh_optimizer.h"
+#include "renderer/obj_parser.h"
+#include "renderer/transform_system.h"
 
 namespace claude_gl {
 
-Model::Model(const std::string& filepath)
-    : modelMatrix(1.0f) {
+namespace {
+
+constexpr UniformName MODEL("model");
+constexpr UniformName NORMAL_MATRIX("normalMatrix");
+
+// 簡略化で法線・テクスチャ座標の差1を位置の誤差に換算する重み（メッシュの半径に対する比）
+constexpr float LOD_ATTRIBUTE_WEIGHT = 0.02f;
+
+/**
+ * @brief 浮動小数点数のビット列を取得する（キャッシュの設定の識別値用）
+ */
+std::uint32_t floatBits(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+} // namespace
+
+Model::Model(const std::string& filepath, const ModelLoadOptions& options)
+    : modelMatrix(1.0f), loadOptions(options) {
     loadModel(filepath);
 }
 
+Model::Model(const ModelLoadOptions& options)
+    : modelMatrix(1.0f), loadOptions(options) {
+}
+
+Model::~Model() = default;
+
+std::shared_ptr<Model> Model::prepare(const std::string& filepath,
+                                      const ModelLoadOptions& options) {
+    std::shared_ptr<Model> model(new Model(options));
+    model->prepareModel(filepath);
+    return model;
+}
+
+bool Model::hasPendingUploads() const {
+    return nextUpload < pendingMeshes.size();
+}
+
+std::size_t Model::getPendingUploadCount() const {
+    return pendingMeshes.size() - nextUpload;
+}
+
+std::size_t Model::getNextUploadBytes() const {
+    return hasPendingUploads() ? pendingMeshes[nextUpload].getUploadBytes() : 0;
+}
+
+std::size_t Model::getPendingUploadBytes() const {
+    std::size_t bytes = 0;
+    for (std::size_t i = nextUpload; i < pendingMeshes.size(); ++i) {
+        bytes += pendingMeshes[i].getUploadBytes();
+    }
+    return bytes;
+}
+
+std::size_t Model::uploadNext() {
+    if (!hasPendingUploads()) {
+        return 0;
+    }
+    const PreparedMesh& prepared = pendingMeshes[nextUpload];
+    std::size_t bytes = prepared.getUploadBytes();
+    meshes.push_back(createMesh(prepared));
+    ++nextUpload;
+    
+    // 全メッシュを転送したら、転送元の頂点・インデックスとキャッシュのマップ領域を解放する
+    if (!hasPendingUploads()) {
+        pendingMeshes.clear();
+        pendingMeshes.shrink_to_fit();
+        nextUpload = 0;
+        sourceVertices = std::vector<Mesh::Vertex>();
+        sourceIndices = std::vector<unsigned int>();
+        sourceCache.reset();
+    }
+    return bytes;
+}
+
 void Model::draw(const Shader& shader) const {
-    // モデル行列をシェーダーに設定
-    shader.setMat4("model", modelMatrix);
+    // モデル行列と法線行列をシェーダーに設定
+    shader.setMat4(MODEL, modelMatrix);
+    shader.setMat3(NORMAL_MATRIX, TransformSystem::computeNormalMatrix(modelMatrix));
     
     // 全てのメッシュを描画
+    drawMeshes(shader, nullptr, 0);
+}
+
+void Model::draw(const Shader& shader, const LodView& view) const {
+    shader.setMat4(MODEL, modelMatrix);
+    shader.setMat3(NORMAL_MATRIX, TransformSystem::computeNormalMatrix(modelMatrix));
+    
+    // 前回の段階を起点に選ぶため、段階はメッシュごとに保持する
+    drawLevels.resize(meshes.size(), 0);
+    selectLods(view, modelMatrix, drawLevels.data());
+    drawMeshes(shader, nullptr, 0, drawLevels.data());
+}
+
+void Model::drawDepthOnly(const Shader& shader) const {
+    shader.setMat4(MODEL, modelMatrix);
+    for (const auto& mesh : meshes) {
+        mesh->drawDepthOnly(shader);
+    }
+}
+
+std::size_t Model::drawInstanced(const Shader& shader, const InstanceBuffer& instances) const {
+    if (instances.getCount() == 0) {
+        return 0;
+    }
+    
+    // モデル行列はインスタンスストリームから読むため、メッシュごとに1回の描画呼び出しになる
     for (const auto& mesh : meshes) {
-        mesh->draw(shader);
+        mesh->drawInstanced(shader, instances);
+    }
+    return meshes.size();
+}
+
+std::size_t Model::addToCuller(FrustumCuller& culler, const glm::mat4& world) const {
+    std::size_t firstIndex = culler.getObjectCount();
+    for (const auto& mesh : meshes) {
+        culler.addObject(mesh->getBounds(), world);
+    }
+    return firstIndex;
+}
+
+void Model::drawVisible(const Shader& shader, const FrustumCuller& culler, std::size_t firstIndex,
+                        const glm::mat4& world, const glm::mat3& normalMatrix) const {
+    shader.setMat4(MODEL, world);
+    shader.setMat3(NORMAL_MATRIX, normalMatrix);
+    
+    // 視錐台と交差するメッシュのみ描画
+    drawMeshes(shader, &culler, firstIndex);
+}
+
+std::size_t Model::submitVisible(RenderQueue& queue, const Shader& shader,
+                                 const Material& material, const FrustumCuller& culler,
+                                 std::size_t firstIndex, std::uint32_t transform,
+                                 const std::uint8_t* levels, ClusterCuller* clusters) const {
+    std::size_t submitted = 0;
+    for (std::size_t i = 0; i < meshes.size(); ++i) {
+        if (culler.isVisible(firstIndex + i)) {
+            submitted += submitMesh(queue, i, shader, material, transform,
+                                    levels ? levels[i] : 0, clusters, false);
+        }
+    }
+    return submitted;
+}
+
+std::size_t Model::submit(RenderQueue& queue, const Shader& shader, const Material& material,
+                          std::uint32_t transform, const std::uint8_t* levels,
+                          bool splitClusters) const {
+    std::size_t submitted = 0;
+    for (std::size_t i = 0; i < meshes.size(); ++i) {
+        submitted += submitMesh(queue, i, shader, material, transform, levels ? levels[i] : 0,
+                                nullptr, splitClusters);
+    }
+    return submitted;
+}
+
+std::size_t Model::selectLods(const LodView& view, const glm::mat4& world,
+                              std::uint8_t* levels) const {
+    std::size_t triangles = 0;
+    for (std::size_t i = 0; i < meshes.size(); ++i) {
+        const Mesh& mesh = *meshes[i];
+        float pixelsPerUnit = MeshSimplifier::getPixelsPerUnit(view, world, mesh.getBounds());
+        std::size_t level = MeshSimplifier::selectLod(mesh.getLodLevels().data(),
+                                                      mesh.getLodCount(), pixelsPerUnit,
+                                                      levels[i], view.thresholdPixels,
+                                                      view.hysteresis);
+        levels[i] = static_cast<std::uint8_t>(level);
+        triangles += mesh.getLodLevel(level).indexCount / 3;
+    }
+    return triangles;
+}
+
+std::size_t Model::submitMesh(RenderQueue& queue, std::size_t mesh, const Shader& shader,
+                              const Material& material, std::uint32_t transform,
+                              std::size_t level, ClusterCuller* clusters,
+                              bool splitClusters) const {
+    const Mesh& target = *meshes[mesh];
+    std::size_t meshletCount = target.getMeshletCount();
+    if (level != 0 || meshletCount == 0 || (!clusters && !splitClusters)) {
+        queue.submit(target, shader, material, transform, level);
+        return 1;
+    }
+    
+    if (clusters) {
+        // 全クラスタが残る場合は1回の描画で済むようメッシュ全体として投入する
+        std::size_t visible = clusters->cull(target.getMeshlets().data(), meshletCount,
+                                             clusterIds);
+        if (visible == 0) {
+            return 0;
+        }
+        if (visible == meshletCount) {
+            queue.submit(target, shader, material, transform);
+            return 1;
+        }
+    }
+    else {
+        // GPUで判定する場合は全クラスタをそれぞれ1回の描画として投入する
+        clusterIds.resize(meshletCount);
+        for (std::size_t i = 0; i < meshletCount; ++i) {
+            clusterIds[i] = static_cast<std::uint32_t>(i);
+        }
+    }
+    queue.submit(target, shader, material, transform, 0, clusterIds.data(), clusterIds.size());
+    return 1;
+}
+
+std::size_t Model::getMeshCount() const {
+    return meshes.size();
+}
+
+bool Model::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                    const glm::mat4& world, RayHit& hit) const {
+    // レイをモデル空間に変換する（アフィン変換では距離のパラメータが変わらない）
+    glm::mat4 inverseWorld = glm::inverse(world);
+    glm::vec3 localOrigin = glm::vec3(inverseWorld * glm::vec4(origin, 1.0f));
+    glm::vec3 localDirection = glm::vec3(inverseWorld * glm::vec4(direction, 0.0f));
+    
+    bool found = false;
+    for (std::size_t i = 0; i < meshes.size(); ++i) {
+        const TriangleBvh* bvh = meshes[i]->getTriangleBvh();
+        TriangleBvh::Hit triangleHit;
+        if (bvh && bvh->intersect(localOrigin, localDirection, maxDistance, triangleHit)) {
+            maxDistance = triangleHit.distance;
+            hit.distance = triangleHit.distance;
+            hit.mesh = i;
+            hit.triangle = triangleHit.triangle;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void Model::drawMeshes(const Shader& shader, const FrustumCuller* culler, std::size_t firstIndex,
+                       const std::uint8_t* levels) const {
+    // 同じ共有のバッファのメッシュは変換行列も同じなので glMultiDrawElementsBaseVertex にまとめる
+    const Mesh* arenaMesh = nullptr;
+    arenaHandles.clear();
+    for (std::size_t i = 0; i < meshes.size(); ++i) {
+        if (culler && !culler->isVisible(firstIndex + i)) {
+            continue;
+        }
+        const Mesh& mesh = *meshes[i];
+        std::size_t level = levels ? levels[i] : 0;
+        if (mesh.getArena() && (!arenaMesh || mesh.getArena() == arenaMesh->getArena())) {
+            arenaMesh = &mesh;
+            arenaHandles.push_back(mesh.getArenaHandle(level));
+        }
+        else {
+            mesh.draw(shader, level);
+        }
+    }
+    if (arenaMesh) {
+        arenaMesh->bind(shader);
+        arenaMesh->getArena()->drawMulti(arenaHandles.data(), arenaHandles.size());
     }
 }
 
+bool Model::hasTriangleBvh() const {
+    for (const auto& mesh : meshes) {
+        if (mesh->getTriangleBvh()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+BoundingVolume Model::getBounds() const {
+    BoundingVolume bounds;
+    if (meshes.empty()) {
+        return bounds;
+    }
+
+    bounds.boundsMin = glm::vec3(INFINITY);
+    bounds.boundsMax = glm::vec3(-INFINITY);
+    for (const auto& mesh : meshes) {
+        bounds.boundsMin = glm::min(bounds.boundsMin, mesh->getBounds().boundsMin);
+        bounds.boundsMax = glm::max(bounds.boundsMax, mesh->getBounds().boundsMax);
+    }
+
+    // 各メッシュの球を包む球（中心はボックスの中心）
+    glm::vec3 center = bounds.getCenter();
+    for (const auto& mesh : meshes) {
+        const BoundingVolume& meshBounds = mesh->getBounds();
+        float reach = glm::length(meshBounds.getCenter() - center) + meshBounds.radius;
+        bounds.radius = std::max(bounds.radius, reach);
+    }
+    return bounds;
+}
+
 void Model::setModelMatrix(const glm::mat4& model) {
     modelMatrix = model;
 }
@@ -44,125 +327,345 @@ void Model::rotateZ(float angle) {
 
 void Model::loadModel(const std::string& filepath) {
     try {
-        processObjFile(filepath);
+        prepareModel(filepath);
+        
+        auto start = std::chrono::steady_clock::now();
+        std::size_t meshCount = getPendingUploadCount();
+        std::size_t bytes = 0;
+        while (hasPendingUploads()) {
+            bytes += uploadNext();
+        }
+        double milliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "Uploaded " << meshCount << " meshes (" << bytes << " bytes) in "
+                  << milliseconds << " ms" << std::endl;
     }
     catch (const std::exception& e) {
         std::cerr << "Error loading model " << filepath << ": " << e.what() << std::endl;
     }
 }
 
-void Model::processObjFile(const std::string& filepath) {
-    // OBJファイルを読み込むための一時データ構造
-    std::vector<glm::vec3> positions;
-    std::vector<glm::vec3> normals;
-    std::vector<glm::vec2> texCoords;
-    std::vector<Mesh::Vertex> vertices;
-    std::vector<unsigned int> indices;
+void Model::prepareModel(const std::string& filepath) {
+    auto start = std::chrono::steady_clock::now();
     
-    // OBJファイルを開く
-    std::ifstream file(filepath);
-    if (!file) {
-        throw std::runtime_error("Failed to open file: " + filepath);
+    // ソースの内容ハッシュと設定が一致するキャッシュがあれば、解析せずにそのまま使う
+    std::uint64_t sourceHash = 0;
+    std::string cachePath;
+    if (loadOptions.useMeshCache) {
+        sourceHash = MeshCache::hashFile(filepath);
+        cachePath = MeshCache::cachePathFor(filepath);
+        if (prepareFromCache(cachePath, sourceHash)) {
+            double milliseconds = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            std::cout << "Prepared " << filepath << " from mesh cache in " << milliseconds
+                      << " ms" << std::endl;
+            return;
+        }
     }
     
-    std::string line;
-    unsigned int index = 0;
+    processObjFile(filepath, sourceVertices, sourceIndices);
+    if (sourceVertices.empty() || sourceIndices.empty()) {
+        return;
+    }
+    
+    BoundingVolume bounds = Mesh::computeBounds(sourceVertices.data(), sourceVertices.size());
+    pendingMeshes.push_back(prepareMesh(sourceVertices.data(), sourceVertices.size(),
+                                        sourceIndices.data(), sourceIndices.size(), bounds));
+    
+    // 次回の起動用に、並べ替え・連結したインデックスと段階表・クラスタ表をキャッシュに書き出す
+    if (loadOptions.useMeshCache) {
+        const PreparedMesh& prepared = pendingMeshes.back();
+        const std::vector<unsigned int>& indices =
+            prepared.indices.empty() ? sourceIndices : prepared.indices;
+        MeshCache::Submesh submesh{};
+        submesh.vertexCount = static_cast<std::uint32_t>(sourceVertices.size());
+        submesh.indexCount = static_cast<std::uint32_t>(indices.size());
+        submesh.boundsMin = bounds.boundsMin;
+        submesh.boundsMax = bounds.boundsMax;
+        submesh.boundsRadius = bounds.radius;
+        submesh.lodCount = static_cast<std::uint32_t>(prepared.lodLevels.size());
+        submesh.meshletCount = static_cast<std::uint32_t>(prepared.meshlets.size());
+        if (MeshCache::write(cachePath, sourceHash, getCacheSettingsKey(), sourceVertices,
+                             indices, {submesh}, prepared.lodLevels, prepared.meshlets)) {
+            std::cout << "Wrote mesh cache " << cachePath << std::endl;
+        }
+    }
+    
+    double milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "Prepared " << filepath << " from source in " << milliseconds << " ms"
+              << std::endl;
+}
+
+bool Model::prepareFromCache(const std::string& cachePath, std::uint64_t sourceHash) {
+    sourceCache = MeshCache::open(cachePath, sourceHash, getCacheSettingsKey());
+    if (!sourceCache) {
+        return false;
+    }
+    
+    // 転送まではマップ領域を参照し、全メッシュを転送したら解除する
+    // （段階とクラスタはキャッシュに保存済みのため生成し直さない）
+    const MeshCache::Submesh* submeshes = sourceCache->getSubmeshes();
+    for (std::size_t i = 0; i < sourceCache->getSubmeshCount(); ++i) {
+        const MeshCache::Submesh& submesh = submeshes[i];
+        PreparedMesh prepared;
+        prepared.vertices = sourceCache->getVertices() + submesh.vertexOffset;
+        prepared.vertexCount = submesh.vertexCount;
+        prepared.sourceIndices = sourceCache->getIndices() + submesh.indexOffset;
+        prepared.indexCount = submesh.indexCount;
+        prepared.bounds.boundsMin = submesh.boundsMin;
+        prepared.bounds.boundsMax = submesh.boundsMax;
+        prepared.bounds.radius = submesh.boundsRadius;
+        const Mesh::LodLevel* levels = sourceCache->getLodLevels() + submesh.lodOffset;
+        prepared.lodLevels.assign(levels, levels + submesh.lodCount);
+        const Mesh::Meshlet* meshlets = sourceCache->getMeshlets() + submesh.meshletOffset;
+        prepared.meshlets.assign(meshlets, meshlets + submesh.meshletCount);
+        std::size_t baseIndexCount = prepared.lodLevels.empty() ? prepared.indexCount
+                                                                : prepared.lodLevels[0].indexCount;
+        prepareVertices(prepared, baseIndexCount);
+        pendingMeshes.push_back(std::move(prepared));
+    }
+    return true;
+}
+
+Model::PreparedMesh Model::prepareMesh(const Mesh::Vertex* vertices, std::size_t vertexCount,
+                                       const unsigned int* indices, std::size_t indexCount,
+                                       const BoundingVolume& bounds) const {
+    PreparedMesh prepared;
+    prepared.vertices = vertices;
+    prepared.vertexCount = vertexCount;
+    prepared.sourceIndices = indices;
+    prepared.indexCount = indexCount;
+    prepared.bounds = bounds;
+    
+    // クラスタは元のインデックスを並べ替えた範囲、詳細度の段階はその後ろに連結した範囲とし、
+    // 頂点は全段階で共有する（連結したインデックスと段階表・クラスタ表はキャッシュに保存する）
+    bool splitMeshlets = loadOptions.buildMeshlets && indexCount > 0;
+    bool buildLodLevels = loadOptions.lodLevels > 1 && indexCount > 0;
+    if (splitMeshlets || buildLodLevels) {
+        prepared.indices.assign(indices, indices + indexCount);
+    }
+    if (splitMeshlets) {
+        prepared.meshlets = buildMeshlets(vertices, vertexCount, prepared.indices.data(),
+                                          indexCount);
+    }
+    if (buildLodLevels) {
+        prepared.lodLevels = buildLods(vertices, vertexCount, prepared.indices, bounds);
+    }
+    if (!prepared.indices.empty()) {
+        prepared.indexCount = prepared.indices.size();
+    }
+    prepareVertices(prepared, indexCount);
+    return prepared;
+}
+
+void Model::prepareVertices(PreparedMesh& prepared, std::size_t baseIndexCount) const {
+    const Mesh::Vertex* vertices = prepared.vertices;
+    std::size_t vertexCount = prepared.vertexCount;
+    
+    if (loadOptions.quantizeVertices) {
+        // キャッシュは元の精度で保持し、GPUへ転送する直前に量子化する
+        prepared.quantized =
+            VertexQuantizer::quantize(vertices, vertexCount, loadOptions.vertexFormat);
+        VertexQuantizer::Stats stats =
+            VertexQuantizer::measure(vertices, prepared.quantized, prepared.indexCount);
+        std::cout << "Quantized vertices: " << sizeof(Mesh::Vertex) << " -> "
+                  << prepared.quantized.stride << " bytes/vertex, "
+                  << Mesh::indexSizeFor(vertexCount) * 8 << "-bit indices, "
+                  << (stats.sourceVertexBytes + stats.sourceIndexBytes) << " -> "
+                  << (stats.vertexBytes + stats.indexBytes) << " bytes ("
+                  << stats.savedRatio() * 100.0 << "% saved)" << std::endl;
+        std::cout << "Quantization error: position " << stats.maxPositionError << ", normal "
+                  << stats.maxNormalErrorDegrees << " deg, texcoord " << stats.maxTexCoordError
+                  << std::endl;
+    }
+    
+    // レイキャスト用の三角形BVH（量子化の有無に関わらず元の精度の位置で構築する）
+    if (loadOptions.buildTriangleBvh && vertexCount > 0) {
+        auto start = std::chrono::steady_clock::now();
+        auto bvh = std::make_shared<TriangleBvh>();
+        bvh->build(&vertices[0].position, sizeof(Mesh::Vertex), vertexCount,
+                   prepared.getIndices(), baseIndexCount);
+        double milliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "Built triangle BVH: " << bvh->getTriangleCount() << " triangles, "
+                  << bvh->getNodeCount() << " nodes, " << bvh->getMemoryBytes() / 1024
+                  << " KB in " << milliseconds << " ms" << std::endl;
+        prepared.triangleBvh = std::move(bvh);
+    }
+}
+
+const unsigned int* Model::PreparedMesh::getIndices() const {
+    return indices.empty() ? sourceIndices : indices.data();
+}
+
+std::size_t Model::PreparedMesh::getUploadBytes() const {
+    std::size_t vertexBytes = quantized.vertexCount > 0 ? quantized.data.size()
+                                                        : vertexCount * sizeof(Mesh::Vertex);
+    return vertexBytes + indexCount * Mesh::indexSizeFor(vertexCount);
+}
+
+std::shared_ptr<Mesh> Model::createMesh(const PreparedMesh& prepared) const {
+    const unsigned int* indices = prepared.getIndices();
+    std::shared_ptr<Mesh> mesh;
+    if (loadOptions.geometryArena && !loadOptions.quantizeVertices &&
+        !loadOptions.splitPositions && GeometryArena::canStore(prepared.vertexCount)) {
+        // 共有のバッファに格納する（65536頂点を超えるメッシュは自身のバッファを持つ）
+        mesh = std::make_shared<Mesh>(loadOptions.geometryArena, prepared.vertices,
+                                      prepared.vertexCount, indices, prepared.indexCount);
+    }
+    else if (!loadOptions.quantizeVertices) {
+        Mesh::StreamLayout streamLayout = loadOptions.splitPositions
+            ? Mesh::StreamLayout::SplitPosition : Mesh::StreamLayout::Interleaved;
+        mesh = std::make_shared<Mesh>(prepared.vertices, prepared.vertexCount, indices,
+                                      prepared.indexCount, streamLayout);
+    }
+    else {
+        mesh = std::make_shared<Mesh>(prepared.quantized, indices, prepared.indexCount);
+    }
+    mesh->setBounds(prepared.bounds);
+    if (!prepared.lodLevels.empty()) {
+        mesh->setLodLevels(prepared.lodLevels);
+    }
+    if (!prepared.meshlets.empty()) {
+        mesh->setMeshlets(prepared.meshlets);
+    }
+    if (prepared.triangleBvh) {
+        mesh->setTriangleBvh(prepared.triangleBvh);
+    }
+    return mesh;
+}
+
+std::vector<Mesh::LodLevel> Model::buildLods(const Mesh::Vertex* vertices, std::size_t vertexCount,
+                                             std::vector<unsigned int>& indices,
+                                             const BoundingVolume& bounds) const {
+    auto start = std::chrono::steady_clock::now();
+    MeshSimplifier::LodOptions options;
+    options.levelCount = loadOptions.lodLevels;
+    options.reduction = loadOptions.lodReduction;
+    options.maxError = loadOptions.lodMaxError * bounds.radius;
+    options.simplify.normalWeight = LOD_ATTRIBUTE_WEIGHT * bounds.radius;
+    options.simplify.texCoordWeight = LOD_ATTRIBUTE_WEIGHT * bounds.radius;
+    std::vector<Mesh::LodLevel> levels =
+        MeshSimplifier::buildLodChain(vertices, vertexCount, indices, options);
+    
+    // 簡略化した段階も頂点キャッシュの順に並べ直す（頂点は共有するため並べ替えない）
+    if (loadOptions.optimizeMesh) {
+        std::vector<unsigned int> levelIndices;
+        for (std::size_t i = 1; i < levels.size(); ++i) {
+            auto first = indices.begin() + levels[i].firstIndex;
+            levelIndices.assign(first, first + levels[i].indexCount);
+            MeshOptimizer::optimizeVertexCache(levelIndices, vertexCount);
+            std::copy(levelIndices.begin(), levelIndices.end(), first);
+        }
+    }
+    
+    double milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "Built " << levels.size() << " LOD levels (triangles";
+    for (const Mesh::LodLevel& level : levels) {
+        std::cout << " " << level.indexCount / 3;
+    }
+    std::cout << ", max error " << levels.back().error << ") in " << milliseconds << " ms"
+              << std::endl;
+    return levels;
+}
+
+std::vector<Mesh::Meshlet> Model::buildMeshlets(const Mesh::Vertex* vertices,
+                                                std::size_t vertexCount, unsigned int* indices,
+                                                std::size_t indexCount) const {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Mesh::Meshlet> meshlets = MeshletBuilder::build(vertices, vertexCount, indices,
+                                                                indexCount,
+                                                                loadOptions.meshletOptions);
+    
+    // クラスタの中も頂点キャッシュの順に並べ直す（クラスタの範囲と境界は変わらない）。
+    // 分割は三角形を隣接順にたどるため、最適化したオーバードローの順序は一部失われる
+    // （クラスタを外向きの順に並べ直しても改善しなかったため、クラスタの順序はそのまま）
+    if (loadOptions.optimizeMesh) {
+        std::vector<unsigned int> meshletIndices;
+        for (const Mesh::Meshlet& meshlet : meshlets) {
+            unsigned int* first = indices + meshlet.firstIndex;
+            meshletIndices.assign(first, first + meshlet.indexCount);
+            MeshOptimizer::optimizeVertexCache(meshletIndices, vertexCount);
+            std::copy(meshletIndices.begin(), meshletIndices.end(), first);
+        }
+    }
+    
+    double milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "Built " << meshlets.size() << " meshlets (" << indexCount / 3 << " triangles, "
+              << "at most " << loadOptions.meshletOptions.maxVertices << " vertices / "
+              << loadOptions.meshletOptions.maxTriangles << " triangles each) in "
+              << milliseconds << " ms" << std::endl;
+    return meshlets;
+}
+
+std::uint32_t Model::getCacheSettingsKey() const {
+    // キャッシュの内容に影響する設定のみを並べ、そのハッシュを識別値とする
+    // （段階の設定は簡略化の既定値と属性の重みも含める）
+    MeshSimplifier::LodOptions lodDefaults;
+    bool buildLodLevels = loadOptions.lodLevels > 1;
+    bool buildMeshlets = loadOptions.buildMeshlets;
+    std::uint32_t settings[] = {
+        loadOptions.weldVertices ? 1u : 0u,
+        loadOptions.optimizeMesh ? 1u : 0u,
+        buildMeshlets ? 1u : 0u,
+        buildLodLevels ? loadOptions.lodLevels : 1u,
+        buildLodLevels ? floatBits(loadOptions.lodReduction) : 0u,
+        buildLodLevels ? floatBits(loadOptions.lodMaxError) : 0u,
+        buildLodLevels ? static_cast<std::uint32_t>(lodDefaults.minTriangles) : 0u,
+        buildLodLevels ? floatBits(LOD_ATTRIBUTE_WEIGHT) : 0u,
+        buildLodLevels && lodDefaults.simplify.lockBorder ? 1u : 0u,
+        buildMeshlets ? static_cast<std::uint32_t>(loadOptions.meshletOptions.maxVertices) : 0u,
+        buildMeshlets ? static_cast<std::uint32_t>(loadOptions.meshletOptions.maxTriangles) : 0u,
+        buildMeshlets ? floatBits(loadOptions.meshletOptions.coneWeight) : 0u,
+    };
+    std::uint64_t hash = MeshCache::hashData(settings, sizeof(settings));
+    return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+}
+
+void Model::processObjFile(const std::string& filepath, std::vector<Mesh::Vertex>& vertices,
+                           std::vector<unsigned int>& indices) {
+    // OBJファイルをメモリマップして解析（大きいファイルは区間ごとに並列解析）
+    ObjParser parser(loadOptions.importThreads);
+    ObjData data = parser.parseFile(filepath);
+    
+    // 解析結果から描画用の頂点データを生成（同一頂点は溶接して共有）
+    ObjParser::BuildStats buildStats =
+        ObjParser::buildVertices(data, vertices, indices, loadOptions.weldVertices);
     
-    // ファイルを1行ずつ読み込み
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string prefix;
-        iss >> prefix;
-        
-        if (prefix == "v") {
-            // 頂点位置
-            glm::vec3 position;
-            iss >> position.x >> position.y >> position.z;
-            positions.push_back(position);
-        }
-        else if (prefix == "vn") {
-            // 頂点法線
-            glm::vec3 normal;
-            iss >> normal.x >> normal.y >> normal.z;
-            normals.push_back(normal);
-        }
-        else if (prefix == "vt") {
-            // テクスチャ座標
-            glm::vec2 texCoord;
-            iss >> texCoord.x >> texCoord.y;
-            texCoords.push_back(texCoord);
-        }
-        else if (prefix == "f") {
-            // 面情報（頂点インデックス）
-            std::string v1, v2, v3;
-            iss >> v1 >> v2 >> v3;
-            
-            std::array<std::string, 3> vertexData = { v1, v2, v3 };
-            for (const auto& vertex : vertexData) {
-                // 頂点情報を「/」で分割
-                std::vector<std::string> tokens;
-                std::istringstream tokenStream(vertex);
-                std::string token;
-                
-                while (std::getline(tokenStream, token, '/')) {
-                    tokens.push_back(token);
-                }
-                
-                // OBJファイルのフォーマットに応じて処理
-                // f v1/vt1/vn1 v2/vt2/vn2 v3/vt3/vn3
-                unsigned int posIndex = 0, texIndex = 0, normIndex = 0;
-                
-                if (tokens.size() >= 1 && !tokens[0].empty()) {
-                    posIndex = std::stoi(tokens[0]) - 1; // OBJファイルは1から始まるインデックス
-                }
-                
-                if (tokens.size() >= 2 && !tokens[1].empty()) {
-                    texIndex = std::stoi(tokens[1]) - 1;
-                }
-                
-                if (tokens.size() >= 3 && !tokens[2].empty()) {
-                    normIndex = std::stoi(tokens[2]) - 1;
-                }
-                
-                Mesh::Vertex meshVertex;
-                
-                // インデックスが有効範囲内かチェック
-                if (posIndex < positions.size()) {
-                    meshVertex.position = positions[posIndex];
-                }
-                
-                if (texIndex < texCoords.size()) {
-                    meshVertex.texCoords = texCoords[texIndex];
-                }
-                else {
-                    // テクスチャ座標がない場合はデフォルト値
-                    meshVertex.texCoords = glm::vec2(0.0f, 0.0f);
-                }
-                
-                if (normIndex < normals.size()) {
-                    meshVertex.normal = normals[normIndex];
-                }
-                else {
-                    // 法線がない場合はデフォルト値
-                    meshVertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
-                }
-                
-                vertices.push_back(meshVertex);
-                indices.push_back(index++);
-            }
-        }
-    }
-    
-    // 読み込んだデータからメッシュを作成
     if (!vertices.empty() && !indices.empty()) {
-        meshes.push_back(std::make_shared<Mesh>(vertices, indices));
+        if (loadOptions.optimizeMesh) {
+            optimizeMesh(vertices, indices);
+        }
+        const ObjParser::Stats& stats = parser.getStats();
         std::cout << "Loaded mesh with " << vertices.size() << " vertices and " 
                   << indices.size() << " indices from " << filepath << std::endl;
-        std::cout << "Normals count in OBJ: " << normals.size() << std::endl;
+        std::cout << "Normals count in OBJ: " << data.normals.size() << std::endl;
+        std::cout << "Parsed " << stats.fileBytes << " bytes in " << stats.parseSeconds * 1000.0
+                  << " ms (" << stats.megabytesPerSecond() << " MB/s, " << stats.threadCount
+                  << " threads, " << stats.chunkCount << " chunks)" << std::endl;
+        if (loadOptions.weldVertices) {
+            std::cout << "Welded " << buildStats.cornerCount << " face corners into "
+                      << buildStats.vertexCount << " vertices (" << buildStats.reductionRatio()
+                      << "x, VBO " << buildStats.unweldedBytes() << " -> "
+                      << buildStats.vertexBytes() << " bytes)" << std::endl;
+        }
     }
     else {
         std::cerr << "Warning: No geometry data loaded from " << filepath << std::endl;
     }
 }
 
+void Model::optimizeMesh(std::vector<Mesh::Vertex>& vertices, std::vector<unsigned int>& indices) {
+    MeshOptimizer::Stats stats = MeshOptimizer::optimize(vertices, indices);
+    
+    std::cout << "Optimized mesh: ACMR " << stats.cacheBefore.acmr << " -> "
+              << stats.cacheAfter.acmr << ", ATVR " << stats.cacheBefore.atvr << " -> "
+              << stats.cacheAfter.atvr << ", overdraw " << stats.overdrawBefore.overdraw << " -> "
+              << stats.overdrawAfter.overdraw << " (" << stats.clusterCount << " clusters)"
+              << std::endl;
+}
+
 } // namespace claude_gl
\ No newline at end of file
@@ -0,0 +1,688 @@
+#include "renderer/obj_parser.h"
+#include <algorithm>
+#include <chrono>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <system_error>
+#include "utils/mapped_file.h"
+#include "utils/thread_pool.h"
+
+namespace claude_gl {
+
+namespace {
+
+// 並列解析時のスレッドあたりの区間数（区間ごとの負荷の偏りを均すため）
+constexpr std::size_t CHUNKS_PER_THREAD = 4;
+
+// 並列解析する区間の最小バイト数（小さいファイルは逐次解析する）
+constexpr std::size_t MIN_CHUNK_BYTES = 1024 * 1024;
+
+// 浮動小数点数版の std::from_chars が使える標準ライブラリか（libc++は未対応の版がある）
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+constexpr bool HAS_FLOAT_FROM_CHARS = true;
+#else
+constexpr bool HAS_FLOAT_FROM_CHARS = false;
+#endif
+
+/**
+ * @brief 改行以外の空白文字か判定する
+ */
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief 空白を読み飛ばす
+ */
+inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && isBlank(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+/**
+ * @brief 行内に次のトークンがあるか判定する（コメントは行末扱い）
+ */
+inline bool hasToken(const char* p, const char* end) {
+    return p < end && *p != '#';
+}
+
+/**
+ * @brief 浮動小数点数の自前変換（浮動小数点数版 std::from_chars がない環境用）
+ *
+ * 有効桁数15桁程度までの一般的なOBJの数値は倍精度で正確に計算してから単精度に丸めます。
+ * それを超える桁数や指数の場合は std::pow による近似になります。
+ */
+const char* parseFloatFallback(const char* p, const char* end, float& value) {
+    static constexpr double POW10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    constexpr int MAX_EXACT_POW10 = 22;
+    constexpr int MAX_MANTISSA_DIGITS = 19;
+    constexpr std::uint64_t MAX_EXACT_MANTISSA = std::uint64_t(1) << 53;
+
+    bool negative = false;
+    if (p < end && *p == '-') {
+        negative = true;
+        ++p;
+    }
+
+    std::uint64_t mantissa = 0;
+    int mantissaDigits = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+
+    // 整数部
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (mantissaDigits < MAX_MANTISSA_DIGITS) {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+            if (mantissa != 0) {
+                ++mantissaDigits;
+            }
+        }
+        else {
+            ++exponent;
+        }
+        anyDigits = true;
+        ++p;
+    }
+
+    // 小数部
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (mantissaDigits < MAX_MANTISSA_DIGITS) {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+                if (mantissa != 0) {
+                    ++mantissaDigits;
+                }
+                --exponent;
+            }
+            anyDigits = true;
+            ++p;
+        }
+    }
+
+    if (!anyDigits) {
+        return nullptr;
+    }
+
+    // 指数部（数字が続く場合のみ消費する）
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool negativeExponent = false;
+        if (q < end && (*q == '+' || *q == '-')) {
+            negativeExponent = (*q == '-');
+            ++q;
+        }
+        if (q < end && *q >= '0' && *q <= '9') {
+            int explicitExponent = 0;
+            while (q < end && *q >= '0' && *q <= '9') {
+                if (explicitExponent < 10000) {
+                    explicitExponent = explicitExponent * 10 + (*q - '0');
+                }
+                ++q;
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+            p = q;
+        }
+    }
+
+    double result = static_cast<double>(mantissa);
+    bool exactExponent = exponent >= -MAX_EXACT_POW10 && exponent <= MAX_EXACT_POW10;
+    if (mantissa <= MAX_EXACT_MANTISSA && exactExponent) {
+        result = exponent < 0 ? result / POW10[-exponent] : result * POW10[exponent];
+    }
+    else if (mantissa != 0) {
+        result *= std::pow(10.0, exponent);
+    }
+
+    value = static_cast<float>(negative ? -result : result);
+    return p;
+}
+
+/**
+ * @brief 浮動小数点数を変換する
+ * @return 変換後の位置、失敗した場合はnullptr
+ */
+inline const char* parseFloat(const char* p, const char* end, float& value) {
+    // std::from_chars は先頭の '+' を受け付けない
+    if (p < end && *p == '+') {
+        ++p;
+    }
+
+    if constexpr (HAS_FLOAT_FROM_CHARS) {
+        std::from_chars_result result = std::from_chars(p, end, value);
+        return result.ec == std::errc() ? result.ptr : nullptr;
+    }
+    else {
+        return parseFloatFallback(p, end, value);
+    }
+}
+
+/**
+ * @brief 行内の浮動小数点数を最大count個読み込む（足りない要素は0のまま）
+ */
+inline void parseFloats(const char* p, const char* end, float* values, int count) {
+    for (int i = 0; i < count; ++i) {
+        p = skipBlanks(p, end);
+        if (!hasToken(p, end)) {
+            return;
+        }
+        p = parseFloat(p, end, values[i]);
+        if (!p) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 区間ごとの解析結果
+ *
+ * 正のインデックスはファイル全体での絶対位置なので解析時に確定します。
+ * 負の相対インデックスは区間内の要素数を基準に解決しておき、
+ * マージ時に先行区間の要素数（プレフィックス和）を加算して確定します。
+ */
+struct ObjChunk {
+    ObjData data;                              ///< 区間内の要素と面頂点
+    std::vector<std::uint32_t> relativeRefs;   ///< 補正が必要な要素（面頂点番号 * 3 + 属性番号）
+};
+
+/**
+ * @brief 属性番号（0: 位置, 1: テクスチャ座標, 2: 法線）に対応するインデックスを取得する
+ */
+inline int& cornerAttribute(ObjCorner& corner, std::uint32_t attribute) {
+    switch (attribute) {
+        case 0: return corner.position;
+        case 1: return corner.texCoord;
+        default: return corner.normal;
+    }
+}
+
+/**
+ * @brief 相対インデックスを含むかを記録した面頂点
+ */
+struct ParsedCorner {
+    ObjCorner corner;
+    std::uint32_t relativeMask;  ///< 相対インデックスだった属性のビットマスク
+};
+
+/**
+ * @brief OBJインデックスを0始まりに解決する
+ * @param p インデックス文字列の先頭
+ * @param end トークンの終端
+ * @param count 区間内でその時点までに定義された要素数（負の相対インデックス用）
+ * @param index 解決したインデックスの格納先（空の場合は0、0の場合は-1）
+ * @param relative 負の相対インデックスだった場合にtrue
+ * @return 読み込み後の位置
+ */
+inline const char* parseIndex(const char* p, const char* end, std::size_t count, int& index,
+                              bool& relative) {
+    // 空のインデックス（v//vn の vt など）は旧実装と同じく先頭の要素を指す
+    index = 0;
+    relative = false;
+    if (p < end && *p == '+') {
+        ++p;
+    }
+
+    int value = 0;
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        return p;
+    }
+
+    if (value > 0) {
+        // OBJファイルは1から始まるインデックス
+        index = value - 1;
+    }
+    else if (value == 0) {
+        index = -1;
+    }
+    else {
+        // 負のインデックスは直前に定義された要素からの相対指定
+        // 区間の先頭より前を指す場合は負のままにしておき、マージ時に確定する
+        index = static_cast<int>(static_cast<long long>(count) + value);
+        relative = true;
+    }
+    return result.ptr;
+}
+
+/**
+ * @brief 面の1頂点（v, v/vt, v//vn, v/vt/vn）を読み込む
+ */
+inline const char* parseCorner(const char* p, const char* end, const ObjData& data,
+                               ParsedCorner& parsed) {
+    const char* tokenEnd = p;
+    while (tokenEnd < end && !isBlank(*tokenEnd) && *tokenEnd != '#') {
+        ++tokenEnd;
+    }
+
+    ObjCorner& corner = parsed.corner;
+    corner.texCoord = 0;
+    corner.normal = 0;
+    parsed.relativeMask = 0;
+
+    bool relative = false;
+    p = parseIndex(p, tokenEnd, data.positions.size(), corner.position, relative);
+    parsed.relativeMask |= relative ? 1u : 0u;
+
+    p = static_cast<const char*>(std::memchr(p, '/', static_cast<std::size_t>(tokenEnd - p)));
+    if (p) {
+        p = parseIndex(p + 1, tokenEnd, data.texCoords.size(), corner.texCoord, relative);
+        parsed.relativeMask |= relative ? 2u : 0u;
+        p = static_cast<const char*>(std::memchr(p, '/', static_cast<std::size_t>(tokenEnd - p)));
+        if (p) {
+            parseIndex(p + 1, tokenEnd, data.normals.size(), corner.normal, relative);
+            parsed.relativeMask |= relative ? 4u : 0u;
+        }
+    }
+    return tokenEnd;
+}
+
+/**
+ * @brief 面頂点を追加し、相対インデックスの補正対象を記録する
+ */
+inline void pushCorner(ObjChunk& chunk, const ParsedCorner& parsed) {
+    std::uint32_t cornerIndex = static_cast<std::uint32_t>(chunk.data.corners.size());
+    chunk.data.corners.push_back(parsed.corner);
+    for (std::uint32_t attribute = 0; attribute < 3; ++attribute) {
+        if (parsed.relativeMask & (1u << attribute)) {
+            chunk.relativeRefs.push_back(cornerIndex * 3 + attribute);
+        }
+    }
+}
+
+/**
+ * @brief 面を読み込み、先頭の3頂点を1つの三角形として追加する
+ *
+ * 旧実装と同じ出力にするため、4頂点目以降は読み捨て、足りない頂点は
+ * すべての属性が先頭の要素を指すものとして扱います。
+ */
+inline void parseFace(const char* p, const char* end, ObjChunk& chunk) {
+    for (int i = 0; i < 3; ++i) {
+        ParsedCorner corner{{0, 0, 0}, 0};
+        p = skipBlanks(p, end);
+        if (hasToken(p, end)) {
+            p = parseCorner(p, end, chunk.data, corner);
+        }
+        pushCorner(chunk, corner);
+    }
+}
+
+/**
+ * @brief テキストの一区間を行単位で解析する
+ */
+void parseChunk(const char* begin, const char* end, ObjChunk& chunk) {
+    ObjData& data = chunk.data;
+    const char* p = begin;
+
+    while (p < end) {
+        // 行末を探す
+        const char* lineEnd =
+            static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+
+        // 行頭のキーワードを判定
+        p = skipBlanks(p, lineEnd);
+        const char* keyword = p;
+        while (p < lineEnd && !isBlank(*p)) {
+            ++p;
+        }
+        std::size_t keywordLength = static_cast<std::size_t>(p - keyword);
+
+        if (keywordLength == 1 && keyword[0] == 'v') {
+            // 頂点位置
+            glm::vec3 position(0.0f);
+            parseFloats(p, lineEnd, &position.x, 3);
+            data.positions.push_back(position);
+        }
+        else if (keywordLength == 2 && keyword[0] == 'v' && keyword[1] == 'n') {
+            // 頂点法線
+            glm::vec3 normal(0.0f);
+            parseFloats(p, lineEnd, &normal.x, 3);
+            data.normals.push_back(normal);
+        }
+        else if (keywordLength == 2 && keyword[0] == 'v' && keyword[1] == 't') {
+            // テクスチャ座標
+            glm::vec2 texCoord(0.0f);
+            parseFloats(p, lineEnd, &texCoord.x, 2);
+            data.texCoords.push_back(texCoord);
+        }
+        else if (keywordLength == 1 && keyword[0] == 'f') {
+            // 面情報（頂点インデックス）
+            parseFace(p, lineEnd, chunk);
+        }
+
+        p = lineEnd < end ? lineEnd + 1 : end;
+    }
+}
+
+/**
+ * @brief 区間の相対インデックスを先行区間の要素数で補正する
+ * @param chunk 区間の解析結果
+ * @param corners 補正対象の面頂点（区間の先頭要素）
+ * @param bases 先行区間の要素数（位置, テクスチャ座標, 法線）
+ */
+void resolveRelativeRefs(const ObjChunk& chunk, ObjCorner* corners, const long long bases[3]) {
+    for (std::uint32_t ref : chunk.relativeRefs) {
+        std::uint32_t attribute = ref % 3;
+        int& index = cornerAttribute(corners[ref / 3], attribute);
+        long long resolved = bases[attribute] + index;
+        index = resolved >= 0 ? static_cast<int>(resolved) : -1;
+    }
+}
+
+/**
+ * @brief テキストを行境界で区間に分割する
+ * @param begin テキストの先頭
+ * @param end テキストの終端
+ * @param count 目標の区間数
+ * @return 区間の境界（count + 1個以下、先頭と終端を含む）
+ */
+std::vector<const char*> splitAtLines(const char* begin, const char* end, std::size_t count) {
+    std::vector<const char*> bounds;
+    bounds.push_back(begin);
+
+    std::size_t total = static_cast<std::size_t>(end - begin);
+    for (std::size_t i = 1; i < count; ++i) {
+        const char* target = begin + total / count * i;
+        if (target <= bounds.back()) {
+            continue;
+        }
+        // 区間の境界を次の行頭に合わせる
+        std::size_t remaining = static_cast<std::size_t>(end - target);
+        const char* lineEnd = static_cast<const char*>(std::memchr(target, '\n', remaining));
+        if (!lineEnd) {
+            break;
+        }
+        bounds.push_back(lineEnd + 1);
+    }
+
+    if (bounds.back() != end) {
+        bounds.push_back(end);
+    }
+    return bounds;
+}
+
+/**
+ * @brief 区間をスレッドプールで並列に解析し、1つの解析結果にマージする
+ * @param bounds 区間の境界
+ * @param threads ワーカースレッド数
+ * @param data 解析結果の格納先
+ */
+void parseParallel(const std::vector<const char*>& bounds, unsigned int threads, ObjData& data) {
+    std::size_t chunkCount = bounds.size() - 1;
+    std::vector<ObjChunk> chunks(chunkCount);
+    ThreadPool pool(threads);
+
+    // 各区間を並列に解析
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(chunkCount);
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+        tasks.push_back(pool.submit([&chunks, &bounds, i]() {
+            parseChunk(bounds[i], bounds[i + 1], chunks[i]);
+        }));
+    }
+    for (std::future<void>& task : tasks) {
+        task.get();
+    }
+
+    // 要素数のプレフィックス和から各区間の書き込み先を決定
+    struct ChunkOffsets {
+        std::size_t positions, texCoords, normals, corners;
+    };
+    std::vector<ChunkOffsets> offsets(chunkCount);
+    ChunkOffsets total{0, 0, 0, 0};
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+        offsets[i] = total;
+        total.positions += chunks[i].data.positions.size();
+        total.texCoords += chunks[i].data.texCoords.size();
+        total.normals += chunks[i].data.normals.size();
+        total.corners += chunks[i].data.corners.size();
+    }
+
+    data.positions.resize(total.positions);
+    data.texCoords.resize(total.texCoords);
+    data.normals.resize(total.normals);
+    data.corners.resize(total.corners);
+
+    // 各区間の結果を並列にコピーし、相対インデックスを全体のインデックスに補正
+    tasks.clear();
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+        tasks.push_back(pool.submit([&chunks, &offsets, &data, i]() {
+            ObjChunk& chunk = chunks[i];
+            const ChunkOffsets& offset = offsets[i];
+            std::copy(chunk.data.positions.begin(), chunk.data.positions.end(),
+                      data.positions.begin() + offset.positions);
+            std::copy(chunk.data.texCoords.begin(), chunk.data.texCoords.end(),
+                      data.texCoords.begin() + offset.texCoords);
+            std::copy(chunk.data.normals.begin(), chunk.data.normals.end(),
+                      data.normals.begin() + offset.normals);
+            std::copy(chunk.data.corners.begin(), chunk.data.corners.end(),
+                      data.corners.begin() + offset.corners);
+
+            long long bases[3] = {
+                static_cast<long long>(offset.positions),
+                static_cast<long long>(offset.texCoords),
+                static_cast<long long>(offset.normals)
+            };
+            resolveRelativeRefs(chunk, data.corners.data() + offset.corners, bases);
+
+            // 不要になった区間のメモリを早めに解放
+            chunk = ObjChunk();
+        }));
+    }
+    for (std::future<void>& task : tasks) {
+        task.get();
+    }
+}
+
+/**
+ * @brief 解決済みインデックスが有効範囲内か判定する
+ */
+inline bool isValidIndex(int index, std::size_t count) {
+    return index >= 0 && static_cast<std::size_t>(index) < count;
+}
+
+// 溶接用ハッシュテーブルの空きスロット
+constexpr unsigned int EMPTY_SLOT = 0xFFFFFFFFu;
+
+static_assert(sizeof(Mesh::Vertex) == 8 * sizeof(float),
+              "Mesh::Vertex must be tightly packed for bitwise welding");
+
+/**
+ * @brief 面頂点から描画用の頂点を生成する
+ */
+inline Mesh::Vertex makeVertex(const ObjData& data, const ObjCorner& corner) {
+    Mesh::Vertex meshVertex;
+
+    // インデックスが有効範囲内かチェック
+    if (isValidIndex(corner.position, data.positions.size())) {
+        meshVertex.position = data.positions[corner.position];
+    }
+    else {
+        meshVertex.position = glm::vec3(0.0f);
+    }
+
+    if (isValidIndex(corner.texCoord, data.texCoords.size())) {
+        meshVertex.texCoords = data.texCoords[corner.texCoord];
+    }
+    else {
+        // テクスチャ座標がない場合はデフォルト値
+        meshVertex.texCoords = glm::vec2(0.0f, 0.0f);
+    }
+
+    if (isValidIndex(corner.normal, data.normals.size())) {
+        meshVertex.normal = data.normals[corner.normal];
+    }
+    else {
+        // 法線がない場合はデフォルト値
+        meshVertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+    }
+
+    return meshVertex;
+}
+
+/**
+ * @brief 頂点のビット列からハッシュ値を計算する
+ */
+inline std::size_t hashVertex(const Mesh::Vertex& vertex) {
+    std::uint32_t words[8];
+    std::memcpy(words, &vertex, sizeof(words));
+
+    std::uint64_t hash = 0;
+    for (std::uint32_t word : words) {
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 29;
+    }
+    return static_cast<std::size_t>(hash);
+}
+
+} // namespace
+
+double ObjParser::Stats::megabytesPerSecond() const {
+    if (parseSeconds <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(fileBytes) / (1024.0 * 1024.0) / parseSeconds;
+}
+
+ObjParser::ObjParser(unsigned int threadCount)
+    : threadCount(threadCount) {
+}
+
+void ObjParser::setThreadCount(unsigned int count) {
+    threadCount = count;
+}
+
+ObjData ObjParser::parseFile(const std::string& filepath) {
+    auto start = std::chrono::steady_clock::now();
+
+    MappedFile file(filepath);
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+
+    unsigned int threads = threadCount != 0 ? threadCount : ThreadPool::defaultThreadCount();
+    std::size_t chunkTarget = std::min<std::size_t>(threads * CHUNKS_PER_THREAD,
+                                                    file.size() / MIN_CHUNK_BYTES);
+
+    ObjData data;
+    if (threads <= 1 || chunkTarget <= 1) {
+        parseText(begin, end, data);
+        stats.threadCount = 1;
+        stats.chunkCount = 1;
+    }
+    else {
+        std::vector<const char*> bounds = splitAtLines(begin, end, chunkTarget);
+        std::size_t chunkCount = bounds.size() - 1;
+        threads = static_cast<unsigned int>(std::min<std::size_t>(threads, chunkCount));
+        parseParallel(bounds, threads, data);
+        stats.threadCount = threads;
+        stats.chunkCount = chunkCount;
+    }
+
+    auto finish = std::chrono::steady_clock::now();
+    stats.fileBytes = file.size();
+    stats.parseSeconds = std::chrono::duration<double>(finish - start).count();
+    return data;
+}
+
+void ObjParser::parseText(const char* begin, const char* end, ObjData& data) {
+    // 追記の場合は既存の要素も区間の一部として扱い、相対インデックスを解決する
+    ObjChunk chunk;
+    chunk.data = std::move(data);
+
+    long long bases[3] = {0, 0, 0};
+    parseChunk(begin, end, chunk);
+    resolveRelativeRefs(chunk, chunk.data.corners.data(), bases);
+
+    data = std::move(chunk.data);
+}
+
+std::size_t ObjParser::BuildStats::unweldedBytes() const {
+    return cornerCount * sizeof(Mesh::Vertex);
+}
+
+std::size_t ObjParser::BuildStats::vertexBytes() const {
+    return vertexCount * sizeof(Mesh::Vertex);
+}
+
+double ObjParser::BuildStats::reductionRatio() const {
+    if (vertexCount == 0) {
+        return 1.0;
+    }
+    return static_cast<double>(cornerCount) / static_cast<double>(vertexCount);
+}
+
+ObjParser::BuildStats ObjParser::buildVertices(const ObjData& data,
+                                               std::vector<Mesh::Vertex>& vertices,
+                                               std::vector<unsigned int>& indices, bool weld) {
+    vertices.clear();
+    indices.clear();
+    indices.reserve(data.corners.size());
+    if (!weld) {
+        vertices.reserve(data.corners.size());
+    }
+
+    // 溶接用のオープンアドレス法ハッシュテーブル（値は vertices の添字）
+    std::vector<unsigned int> slots;
+    std::size_t slotMask = 0;
+    if (weld) {
+        std::size_t capacity = 16;
+        while (capacity < data.corners.size() + data.corners.size() / 2) {
+            capacity *= 2;
+        }
+        slots.assign(capacity, EMPTY_SLOT);
+        slotMask = capacity - 1;
+    }
+
+    for (const ObjCorner& corner : data.corners) {
+        Mesh::Vertex meshVertex = makeVertex(data, corner);
+
+        if (!weld) {
+            indices.push_back(static_cast<unsigned int>(vertices.size()));
+            vertices.push_back(meshVertex);
+            continue;
+        }
+
+        // 同じ値の頂点が既にあれば共有し、なければ追加する（線形探索）
+        std::size_t slot = hashVertex(meshVertex) & slotMask;
+        while (true) {
+            unsigned int existing = slots[slot];
+            if (existing == EMPTY_SLOT) {
+                existing = static_cast<unsigned int>(vertices.size());
+                slots[slot] = existing;
+                vertices.push_back(meshVertex);
+                indices.push_back(existing);
+                break;
+            }
+            if (std::memcmp(&vertices[existing], &meshVertex, sizeof(Mesh::Vertex)) == 0) {
+                indices.push_back(existing);
+                break;
+            }
+            slot = (slot + 1) & slotMask;
+        }
+    }
+
+    if (weld) {
+        vertices.shrink_to_fit();
+    }
+
+    BuildStats buildStats;
+    buildStats.cornerCount = data.corners.size();
+    buildStats.vertexCount = vertices.size();
+    return buildStats;
+}
+
+const ObjParser::Stats& ObjParser::getStats() const {
+    return stats;
+}
+
+} // namespace claude_gl
@@ -0,0 +1,463 @@
+#include "renderer/occlusion_culler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include "utils/thread_pool.h"
+
+namespace claude_gl {
+
+namespace {
+
+// 全ピクセルを覆うマスクの行
+constexpr std::uint32_t FULL_ROW = 0xFFFFFFFFu;
+
+// 近クリップ面に掛かる三角形は最大で4頂点になる
+constexpr int MAX_CLIPPED_VERTICES = 4;
+
+/**
+ * @brief 行の列 first..last（タイル内の位置、範囲外は切り詰める）のビットを立てたマスクを作る
+ */
+inline std::uint32_t spanMask(int first, int last) {
+    first = std::max(first, 0);
+    last = std::min(last, OcclusionCuller::TILE_WIDTH - 1);
+    if (first > last) {
+        return 0;
+    }
+    std::uint32_t upper = last == 31 ? FULL_ROW : (1u << (last + 1)) - 1u;
+    return upper & ~((1u << first) - 1u);
+}
+
+/**
+ * @brief 画面の座標を整数へ変換できる範囲 [-1, size] に収める
+ */
+inline float clampToScreen(float value, int size) {
+    return std::min(std::max(value, -1.0f), static_cast<float>(size));
+}
+
+/**
+ * @brief 多角形を近クリップ面（z >= -w）の内側に切り取る（Sutherland-Hodgman）
+ * @return 切り取った後の頂点数（0, 3, 4）
+ */
+int clipNear(const glm::vec4 input[3], glm::vec4 output[MAX_CLIPPED_VERTICES]) {
+    int count = 0;
+    for (int i = 0; i < 3; ++i) {
+        const glm::vec4& current = input[i];
+        const glm::vec4& next = input[(i + 1) % 3];
+        float currentDistance = current.z + current.w;
+        float nextDistance = next.z + next.w;
+        if (currentDistance >= 0.0f) {
+            output[count++] = current;
+        }
+        if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+            float t = currentDistance / (currentDistance - nextDistance);
+            output[count++] = current + (next - current) * t;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+OccluderMesh OccluderMesh::makeBox(const Aabb& box) {
+    OccluderMesh mesh;
+    const glm::vec3& a = box.boundsMin;
+    const glm::vec3& b = box.boundsMax;
+    mesh.positions = {
+        {a.x, a.y, a.z}, {b.x, a.y, a.z}, {b.x, b.y, a.z}, {a.x, b.y, a.z},
+        {a.x, a.y, b.z}, {b.x, a.y, b.z}, {b.x, b.y, b.z}, {a.x, b.y, b.z},
+    };
+    // 外から見て反時計回り（-Z, +Z, -X, +X, -Y, +Y）
+    mesh.indices = {
+        0, 2, 1, 0, 3, 2,  4, 5, 6, 4, 6, 7,  0, 4, 7, 0, 7, 3,
+        1, 2, 6, 1, 6, 5,  0, 1, 5, 0, 5, 4,  3, 7, 6, 3, 6, 2,
+    };
+    return mesh;
+}
+
+OcclusionCuller::OcclusionCuller(int width, int height, unsigned int threadCount)
+    : width((std::max(width, 1) + TILE_WIDTH - 1) / TILE_WIDTH * TILE_WIDTH),
+      height((std::max(height, 1) + TILE_HEIGHT - 1) / TILE_HEIGHT * TILE_HEIGHT),
+      threadCount(threadCount != 0 ? threadCount : ThreadPool::defaultThreadCount()) {
+    tilesX = this->width / TILE_WIDTH;
+    tilesY = this->height / TILE_HEIGHT;
+    tiles.resize(static_cast<std::size_t>(tilesX) * tilesY);
+    // 呼び出し元も1つの範囲を受け持つため、ワーカーは1つ少なくてよい
+    if (this->threadCount > 1) {
+        pool = std::make_unique<ThreadPool>(this->threadCount - 1);
+    }
+    binnedTriangles.resize(this->threadCount);
+    beginFrame(glm::mat4(1.0f));
+}
+
+OcclusionCuller::~OcclusionCuller() = default;
+
+template <typename F>
+void OcclusionCuller::runTasks(std::size_t taskCount, F&& task) {
+    if (!pool || taskCount <= 1) {
+        for (std::size_t i = 0; i < taskCount; ++i) {
+            task(i);
+        }
+        return;
+    }
+    // 最初の範囲は呼び出し元で処理し、残りをワーカーへ投入する
+    std::vector<std::future<void>> futures;
+    futures.reserve(taskCount - 1);
+    for (std::size_t i = 1; i < taskCount; ++i) {
+        futures.push_back(pool->submit([&task, i]() { task(i); }));
+    }
+    task(0);
+    for (std::future<void>& future : futures) {
+        future.get();
+    }
+}
+
+void OcclusionCuller::beginFrame(const glm::mat4& viewProjection) {
+    this->viewProjection = viewProjection;
+    occluders.clear();
+    triangleCount = 0;
+    stats = Stats();
+    // 遮蔽物がないまま判定してもすべて見えるよう、描く前の深度バッファは空にしておく
+    for (Tile& tile : tiles) {
+        std::fill(std::begin(tile.mask), std::end(tile.mask), 0u);
+        tile.farDepth = 1.0f;
+        tile.maskDepth = 0.0f;
+    }
+}
+
+void OcclusionCuller::addOccluder(const OccluderMesh& mesh, const glm::mat4& world) {
+    occluders.push_back({&mesh, world, triangleCount});
+    triangleCount += mesh.indices.size() / 3;
+}
+
+void OcclusionCuller::render() {
+    auto start = std::chrono::steady_clock::now();
+    stats.occluderTriangles = triangleCount;
+
+    // 三角形を等分した範囲ごとに変換・クリップする（範囲の順に並べれば追加順が保たれる）
+    std::size_t setupTasks = std::min<std::size_t>(threadCount, std::max<std::size_t>(
+                                                                    triangleCount, 1));
+    runTasks(setupTasks, [&](std::size_t task) {
+        binnedTriangles[task].clear();
+        setupTriangles(triangleCount * task / setupTasks, triangleCount * (task + 1) / setupTasks,
+                       binnedTriangles[task]);
+    });
+    for (std::size_t task = setupTasks; task < binnedTriangles.size(); ++task) {
+        binnedTriangles[task].clear();
+    }
+
+    // タイルの行を帯に分け、帯ごとに全三角形を追加順に描く
+    std::size_t bands = std::min<std::size_t>(threadCount, static_cast<std::size_t>(tilesY));
+    runTasks(bands, [&](std::size_t band) {
+        int firstTileY = static_cast<int>(tilesY * band / bands);
+        int lastTileY = static_cast<int>(tilesY * (band + 1) / bands) - 1;
+        for (const std::vector<ScreenTriangle>& triangles : binnedTriangles) {
+            for (const ScreenTriangle& triangle : triangles) {
+                rasterize(triangle, firstTileY, lastTileY);
+            }
+        }
+    });
+
+    for (const std::vector<ScreenTriangle>& triangles : binnedTriangles) {
+        stats.rasterizedTriangles += triangles.size();
+    }
+    stats.renderMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+}
+
+bool OcclusionCuller::isVisible(const Aabb& box) const {
+    // 8頂点を投影して画面の矩形と最も手前の深度を求める
+    glm::vec2 screenMin(INFINITY);
+    glm::vec2 screenMax(-INFINITY);
+    float nearestDepth = 1.0f;
+    for (int i = 0; i < 8; ++i) {
+        glm::vec4 corner((i & 1) ? box.boundsMax.x : box.boundsMin.x,
+                         (i & 2) ? box.boundsMax.y : box.boundsMin.y,
+                         (i & 4) ? box.boundsMax.z : box.boundsMin.z, 1.0f);
+        glm::vec4 clip = viewProjection * corner;
+        // 近クリップ面に掛かる場合は矩形が求まらないため見えるものとする
+        if (clip.z < -clip.w || clip.w <= 0.0f) {
+            return true;
+        }
+        float inverseW = 1.0f / clip.w;
+        glm::vec2 screen((clip.x * inverseW * 0.5f + 0.5f) * width,
+                         (clip.y * inverseW * 0.5f + 0.5f) * height);
+        screenMin = glm::min(screenMin, screen);
+        screenMax = glm::max(screenMax, screen);
+        nearestDepth = std::min(nearestDepth, clip.z * inverseW * 0.5f + 0.5f);
+    }
+
+    // 矩形が少しでも掛かるピクセルをすべて調べる（画面外は視錐台カリングに任せる）
+    int minX = std::max(static_cast<int>(std::floor(clampToScreen(screenMin.x, width))), 0);
+    int maxX = std::min(static_cast<int>(std::floor(clampToScreen(screenMax.x, width))), width - 1);
+    int minY = std::max(static_cast<int>(std::floor(clampToScreen(screenMin.y, height))), 0);
+    int maxY =
+        std::min(static_cast<int>(std::floor(clampToScreen(screenMax.y, height))), height - 1);
+    if (minX > maxX || minY > maxY) {
+        return true;
+    }
+
+    for (int tileY = minY / TILE_HEIGHT; tileY <= maxY / TILE_HEIGHT; ++tileY) {
+        int rowBase = tileY * TILE_HEIGHT;
+        int firstRow = std::max(minY - rowBase, 0);
+        int lastRow = std::min(maxY - rowBase, TILE_HEIGHT - 1);
+        for (int tileX = minX / TILE_WIDTH; tileX <= maxX / TILE_WIDTH; ++tileX) {
+            const Tile& tile = tiles[static_cast<std::size_t>(tileY) * tilesX + tileX];
+            // 2層目は1層目より手前なので、1層目より奥ならタイル全体で遮蔽されている
+            if (nearestDepth >= tile.farDepth) {
+                continue;
+            }
+            int columnBase = tileX * TILE_WIDTH;
+            std::uint32_t columns = spanMask(minX - columnBase, maxX - columnBase);
+            for (int row = firstRow; row <= lastRow; ++row) {
+                if ((columns & ~tile.mask[row]) != 0 ||
+                    ((columns & tile.mask[row]) != 0 && nearestDepth < tile.maskDepth)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+std::size_t OcclusionCuller::testBoxes(const Aabb* boxes, std::size_t count,
+                                       std::uint8_t* visibility) {
+    auto start = std::chrono::steady_clock::now();
+    std::size_t tasks = std::min<std::size_t>(threadCount, std::max<std::size_t>(count, 1));
+    std::vector<std::size_t> visibleCounts(tasks, 0);
+    runTasks(tasks, [&](std::size_t task) {
+        std::size_t visible = 0;
+        for (std::size_t i = count * task / tasks; i < count * (task + 1) / tasks; ++i) {
+            visibility[i] = isVisible(boxes[i]) ? 1 : 0;
+            visible += visibility[i];
+        }
+        visibleCounts[task] = visible;
+    });
+
+    std::size_t visible = 0;
+    for (std::size_t taskVisible : visibleCounts) {
+        visible += taskVisible;
+    }
+    stats.tested += count;
+    stats.occluded += count - visible;
+    stats.testMilliseconds +=
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+    return visible;
+}
+
+float OcclusionCuller::getDepth(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        return 1.0f;
+    }
+    const Tile& tile =
+        tiles[static_cast<std::size_t>(y / TILE_HEIGHT) * tilesX + x / TILE_WIDTH];
+    bool masked = (tile.mask[y % TILE_HEIGHT] >> (x % TILE_WIDTH)) & 1u;
+    return masked ? tile.maskDepth : tile.farDepth;
+}
+
+int OcclusionCuller::getWidth() const {
+    return width;
+}
+
+int OcclusionCuller::getHeight() const {
+    return height;
+}
+
+unsigned int OcclusionCuller::getThreadCount() const {
+    return threadCount;
+}
+
+const OcclusionCuller::Stats& OcclusionCuller::getStats() const {
+    return stats;
+}
+
+void OcclusionCuller::setupTriangles(std::size_t first, std::size_t last,
+                                     std::vector<ScreenTriangle>& output) const {
+    if (first >= last) {
+        return;
+    }
+    // 範囲の最初の三角形を含む遮蔽物から順に進む
+    auto occluder = std::upper_bound(occluders.begin(), occluders.end(), first,
+                                     [](std::size_t triangle, const Occluder& candidate) {
+                                         return triangle < candidate.firstTriangle;
+                                     }) - 1;
+    std::size_t triangle = first;
+    while (triangle < last) {
+        const OccluderMesh& mesh = *occluder->mesh;
+        glm::mat4 transform = viewProjection * occluder->world;
+        std::size_t meshTriangles = mesh.indices.size() / 3;
+        std::size_t end = std::min(meshTriangles, last - occluder->firstTriangle);
+        for (std::size_t i = triangle - occluder->firstTriangle; i < end; ++i) {
+            glm::vec4 clip[3];
+            for (int corner = 0; corner < 3; ++corner) {
+                clip[corner] = transform * glm::vec4(mesh.positions[mesh.indices[i * 3 + corner]],
+                                                     1.0f);
+            }
+            glm::vec4 clipped[MAX_CLIPPED_VERTICES];
+            int clippedCount = clipNear(clip, clipped);
+
+            // 切り取った多角形を扇形に分けて投影する
+            glm::vec3 screen[MAX_CLIPPED_VERTICES];
+            for (int v = 0; v < clippedCount; ++v) {
+                float inverseW = 1.0f / clipped[v].w;
+                screen[v] = glm::vec3((clipped[v].x * inverseW * 0.5f + 0.5f) * width,
+                                      (clipped[v].y * inverseW * 0.5f + 0.5f) * height,
+                                      std::min(clipped[v].z * inverseW * 0.5f + 0.5f, 1.0f));
+            }
+            for (int v = 2; v < clippedCount; ++v) {
+                const glm::vec3& a = screen[0];
+                const glm::vec3& b = screen[v - 1];
+                const glm::vec3& c = screen[v];
+                // 裏面と面積0の三角形は描かない
+                float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+                if (!(area > 0.0f)) {
+                    continue;
+                }
+
+                // ピクセルの中心を含みうる範囲
+                ScreenTriangle result;
+                float minX = clampToScreen(std::min({a.x, b.x, c.x}), width);
+                float maxX = clampToScreen(std::max({a.x, b.x, c.x}), width);
+                float minY = clampToScreen(std::min({a.y, b.y, c.y}), height);
+                float maxY = clampToScreen(std::max({a.y, b.y, c.y}), height);
+                result.minX = std::max(static_cast<int>(std::ceil(minX - 0.5f)), 0);
+                result.maxX = std::min(static_cast<int>(std::floor(maxX - 0.5f)), width - 1);
+                result.minY = std::max(static_cast<int>(std::ceil(minY - 0.5f)), 0);
+                result.maxY = std::min(static_cast<int>(std::floor(maxY - 0.5f)), height - 1);
+                if (result.minX > result.maxX || result.minY > result.maxY) {
+                    continue;
+                }
+
+                // 深度は画面空間で線形なので、平面の式で表す
+                float inverseArea = 1.0f / area;
+                float depthX = ((b.z - a.z) * (c.y - a.y) - (c.z - a.z) * (b.y - a.y)) *
+                               inverseArea;
+                float depthY = ((c.z - a.z) * (b.x - a.x) - (b.z - a.z) * (c.x - a.x)) *
+                               inverseArea;
+                result.vertices[0] = glm::vec2(a.x, a.y);
+                result.vertices[1] = glm::vec2(b.x, b.y);
+                result.vertices[2] = glm::vec2(c.x, c.y);
+                result.depthPlane = glm::vec3(depthX, depthY, a.z - depthX * a.x - depthY * a.y);
+                result.maxDepth = std::max({a.z, b.z, c.z});
+                output.push_back(result);
+            }
+        }
+        triangle = occluder->firstTriangle + end;
+        ++occluder;
+    }
+}
+
+void OcclusionCuller::rasterize(const ScreenTriangle& triangle, int firstTileY, int lastTileY) {
+    int minTileY = std::max(triangle.minY / TILE_HEIGHT, firstTileY);
+    int maxTileY = std::min(triangle.maxY / TILE_HEIGHT, lastTileY);
+    if (minTileY > maxTileY) {
+        return;
+    }
+
+    // 辺の内側は A * px + B(py) >= 0 で、A は行に依らない
+    float edgeA[3];
+    float edgeSlope[3];
+    float edgeBase[3];
+    for (int i = 0; i < 3; ++i) {
+        const glm::vec2& from = triangle.vertices[i];
+        const glm::vec2& to = triangle.vertices[(i + 1) % 3];
+        edgeA[i] = from.y - to.y;
+        edgeSlope[i] = to.x - from.x;
+        edgeBase[i] = (to.y - from.y) * from.x - (to.x - from.x) * from.y;
+    }
+
+    const glm::vec3& plane = triangle.depthPlane;
+    int minTileX = triangle.minX / TILE_WIDTH;
+    int maxTileX = triangle.maxX / TILE_WIDTH;
+    for (int tileY = minTileY; tileY <= maxTileY; ++tileY) {
+        // タイルの8行それぞれで、三角形が覆うピクセルの列の範囲を求める
+        int rowBase = tileY * TILE_HEIGHT;
+        int spanFirst[TILE_HEIGHT];
+        int spanLast[TILE_HEIGHT];
+        for (int row = 0; row < TILE_HEIGHT; ++row) {
+            int y = rowBase + row;
+            float centerY = y + 0.5f;
+            float left = static_cast<float>(triangle.minX);
+            float right = static_cast<float>(triangle.maxX);
+            bool inside = y >= triangle.minY && y <= triangle.maxY;
+            for (int i = 0; i < 3; ++i) {
+                float b = edgeSlope[i] * centerY + edgeBase[i];
+                if (edgeA[i] > 0.0f) {
+                    left = std::max(left, std::ceil(-b / edgeA[i] - 0.5f));
+                }
+                else if (edgeA[i] < 0.0f) {
+                    right = std::min(right, std::floor(-b / edgeA[i] - 0.5f));
+                }
+                else {
+                    inside = inside && b >= 0.0f;
+                }
+            }
+            // 範囲が空の行は first > last にする（辺がほぼ水平でも整数の範囲に収める）
+            inside = inside && left <= right;
+            spanFirst[row] = inside ? static_cast<int>(left) : 1;
+            spanLast[row] = inside ? static_cast<int>(right) : 0;
+        }
+
+        int rowMin = std::max(triangle.minY, rowBase);
+        int rowMax = std::min(triangle.maxY, rowBase + TILE_HEIGHT - 1);
+        for (int tileX = minTileX; tileX <= maxTileX; ++tileX) {
+            int columnBase = tileX * TILE_WIDTH;
+            std::uint32_t coverage[TILE_HEIGHT];
+            for (int row = 0; row < TILE_HEIGHT; ++row) {
+                coverage[row] = spanMask(spanFirst[row] - columnBase, spanLast[row] - columnBase);
+            }
+
+            // 三角形の範囲とタイルの重なりの四隅（ピクセルの中心）で深度の最大を求める
+            float x0 = std::max(triangle.minX, columnBase) + 0.5f;
+            float x1 = std::min(triangle.maxX, columnBase + TILE_WIDTH - 1) + 0.5f;
+            float y0 = rowMin + 0.5f;
+            float y1 = rowMax + 0.5f;
+            float depth = plane.z + std::max(plane.x * x0, plane.x * x1) +
+                          std::max(plane.y * y0, plane.y * y1);
+            updateTile(tiles[static_cast<std::size_t>(tileY) * tilesX + tileX], coverage,
+                       std::min(depth, triangle.maxDepth));
+        }
+    }
+}
+
+void OcclusionCuller::updateTile(Tile& tile, const std::uint32_t coverage[TILE_HEIGHT],
+                                 float depth) {
+    std::uint32_t covered = 0;
+    for (int row = 0; row < TILE_HEIGHT; ++row) {
+        covered |= coverage[row];
+    }
+    // 覆うピクセルがないか、タイル全体の深度より奥なら更新しても情報が増えない
+    if (covered == 0 || depth >= tile.farDepth) {
+        return;
+    }
+
+    // 2層目と離れた深度の三角形は、2層目を捨てて新しい2層目にする
+    // （まとめると2層目の深度が奥へ広がり、どちらの面でも判定が甘くなるため）
+    bool empty = true;
+    for (int row = 0; row < TILE_HEIGHT; ++row) {
+        empty = empty && tile.mask[row] == 0;
+    }
+    if (empty || std::abs(depth - tile.maskDepth) > std::abs(tile.farDepth - depth)) {
+        std::fill(std::begin(tile.mask), std::end(tile.mask), 0u);
+        tile.maskDepth = depth;
+    }
+    else {
+        tile.maskDepth = std::max(tile.maskDepth, depth);
+    }
+
+    std::uint32_t full = FULL_ROW;
+    for (int row = 0; row < TILE_HEIGHT; ++row) {
+        tile.mask[row] |= coverage[row];
+        full &= tile.mask[row];
+    }
+    // すべてのピクセルが2層目に入ったら1層目にまとめる
+    if (full == FULL_ROW) {
+        tile.farDepth = tile.maskDepth;
+        tile.maskDepth = 0.0f;
+        std::fill(std::begin(tile.mask), std::end(tile.mask), 0u);
+    }
+}
+
+} // namespace claude_gl
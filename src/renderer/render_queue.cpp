@@ -0,0 +1,348 @@
+#include "renderer/render_queue.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include "renderer/geometry_arena.h"
+
+namespace claude_gl {
+
+namespace {
+
+constexpr UniformName MODEL("model");
+constexpr UniformName NORMAL_MATRIX("normalMatrix");
+
+} // namespace
+
+RenderQueue::RenderQueue() {
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    opaquePipeline = stateCache.createPipeline(PipelineState());
+    // 半透明パス: 奥から手前へ合成し、深度は書き込まない
+    PipelineState transparent;
+    transparent.depthWrite = false;
+    transparent.blend = true;
+    transparentPipeline = stateCache.createPipeline(transparent);
+}
+
+void RenderQueue::begin(const glm::mat4& view, float nearPlane, float farPlane) {
+    clear();
+    // ビュー行列の3行目（ビュー空間の z）を反転して、カメラの前方を正の奥行きにする
+    depthRow = -glm::vec4(view[0][2], view[1][2], view[2][2], view[3][2]);
+    this->nearPlane = nearPlane;
+    this->farPlane = farPlane;
+}
+
+std::uint32_t RenderQueue::addTransform(const glm::mat4& world, const glm::mat3& normalMatrix) {
+    worlds.push_back(world);
+    normalMatrices.push_back(normalMatrix);
+    return static_cast<std::uint32_t>(worlds.size() - 1);
+}
+
+void RenderQueue::submit(const Mesh& mesh, const Shader& shader, const Material& material,
+                         std::uint32_t transform, std::size_t level,
+                         const std::uint32_t* clusters, std::size_t clusterCount) {
+    if (transform >= worlds.size()) {
+        throw std::runtime_error("RenderQueue: invalid transform " + std::to_string(transform));
+    }
+    if (level >= mesh.getLodCount()) {
+        throw std::runtime_error("RenderQueue: invalid LOD level " + std::to_string(level));
+    }
+    if (clusters && (clusterCount == 0 || level != 0)) {
+        throw std::runtime_error("RenderQueue: clusters need level 0 and at least one cluster");
+    }
+    for (std::size_t i = 0; clusters && i < clusterCount; ++i) {
+        if (clusters[i] >= mesh.getMeshletCount()) {
+            throw std::runtime_error("RenderQueue: invalid cluster " + std::to_string(clusters[i]));
+        }
+    }
+    // 共有のバッファの不透明なメッシュは変換行列の原点の奥行きにして、同じモデルで隣り合わせる
+    bool transparent = material.isTransparent();
+    glm::vec4 center = mesh.getArena() && !transparent
+        ? worlds[transform][3]
+        : worlds[transform] * glm::vec4(mesh.getBounds().getCenter(), 1.0f);
+    GlStateCache::PipelineHandle pipeline =
+        getPipeline(transparent ? RenderPass::Transparent : RenderPass::Opaque);
+    std::uint32_t firstCluster = static_cast<std::uint32_t>(clusterIds.size());
+    if (clusters) {
+        clusterIds.insert(clusterIds.end(), clusters, clusters + clusterCount);
+    }
+    commands.push_back({&mesh, &shader, &material, transform, glm::dot(depthRow, center), pipeline,
+                        static_cast<std::uint32_t>(level), firstCluster,
+                        static_cast<std::uint32_t>(clusters ? clusterCount : 0)});
+}
+
+void RenderQueue::setIndirectShader(const Shader& shader, const Shader& indirectShader) {
+    indirectShaders[&shader] = &indirectShader;
+}
+
+void RenderQueue::execute(UniformRingBuffer& uniforms, IndirectDrawBuffer* indirect) {
+    stats = Stats();
+    stats.commands = commands.size();
+    if (commands.empty()) {
+        return;
+    }
+    stats.unsortedStateChanges = countUnsortedStateChanges();
+
+    // キーを生成して基数ソートする（番号は投入順に振るため、ソートでまとまりさえすればよい）
+    auto sortStart = std::chrono::steady_clock::now();
+    shaderIds.clear();
+    materialIds.clear();
+    meshIds.clear();
+    keys.resize(commands.size());
+    commandMaterials.resize(commands.size());
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        const Command& command = commands[i];
+        RenderPass pass =
+            command.material->isTransparent() ? RenderPass::Transparent : RenderPass::Opaque;
+        stats.transparentCommands += pass == RenderPass::Transparent ? 1 : 0;
+        if (command.clusterCount > 0) {
+            const Mesh::Meshlet* meshlets = command.mesh->getMeshlets().data();
+            for (std::uint32_t c = 0; c < command.clusterCount; ++c) {
+                stats.triangles += meshlets[clusterIds[command.firstCluster + c]].indexCount / 3;
+            }
+            ++stats.clusterCommands;
+            stats.clusters += command.clusterCount;
+        }
+        else {
+            stats.triangles += command.mesh->getLodLevel(command.level).indexCount / 3;
+        }
+        stats.fullDetailTriangles += command.mesh->getLodLevel(0).indexCount / 3;
+        commandMaterials[i] = getId(materialIds, command.material);
+        keys[i].key = RenderSort::makeKey(
+            pass, getId(shaderIds, command.shader), commandMaterials[i],
+            getId(meshIds, getGeometryKey(command.mesh)),
+            RenderSort::quantizeDepth(command.depth, nearPlane, farPlane));
+        keys[i].command = static_cast<std::uint32_t>(i);
+    }
+    stats.sortPasses = RenderSort::sort(keys, scratch);
+    stats.sortMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sortStart)
+            .count();
+
+    // マテリアルの定数をUBOに積み、フレームの他のブロックと一緒に転送する
+    materialRanges.resize(materialIds.size());
+    for (const auto& entry : materialIds) {
+        const Material* material = static_cast<const Material*>(entry.first);
+        materialRanges[entry.second] = uniforms.push(material->getUniforms());
+    }
+    uniforms.flush();
+
+    // 直前のコマンドと異なる状態だけを設定しながら実行する
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    GlStateCache::PipelineHandle currentPipeline = GlStateCache::INVALID_PIPELINE;
+    const Shader* currentShader = nullptr;
+    Uniform<glm::mat4> modelUniform;
+    Uniform<glm::mat3> normalMatrixUniform;
+    const Material* currentMaterial = nullptr;
+    const void* currentGeometry = nullptr;
+    std::uint32_t currentTransform = 0xFFFFFFFFu;
+    for (std::size_t k = 0; k < keys.size();) {
+        const RenderSort::Item& item = keys[k];
+        const Command& command = commands[item.command];
+
+        if (command.pipeline != currentPipeline) {
+            stateCache.bindPipeline(command.pipeline);
+            currentPipeline = command.pipeline;
+            ++stats.pipelineChanges;
+        }
+
+        // 間接描画: 同じ共有のバッファ・パス・シェーダーで隣り合うコマンドを1回で描画する
+        const Shader* indirectShader = indirect ? getIndirectShader(command) : nullptr;
+        if (indirectShader) {
+            // クラスタを指定したコマンドはクラスタごとに1つの描画にする
+            std::size_t end = k + 1;
+            std::size_t drawCount = std::max<std::size_t>(command.clusterCount, 1);
+            while (end < keys.size() && canMergeIndirect(command, commands[keys[end].command])) {
+                drawCount += std::max<std::uint32_t>(commands[keys[end].command].clusterCount, 1);
+                ++end;
+            }
+            // 今フレームの残りに収まらない場合は従来の描画で続ける
+            IndirectDrawBuffer::Batch batch = indirect->allocate(drawCount);
+            if (batch.count > 0) {
+                GeometryArena* arena = command.mesh->getArena();
+                std::size_t d = 0;
+                for (std::size_t i = k; i < end; ++i) {
+                    const Command& merged = commands[keys[i].command];
+                    const glm::mat3& normalMatrix = normalMatrices[merged.transform];
+                    IndirectDrawBuffer::DrawData draw;
+                    draw.model = worlds[merged.transform];
+                    for (int column = 0; column < 3; ++column) {
+                        draw.normalMatrix[column] = glm::vec4(normalMatrix[column], 0.0f);
+                    }
+                    draw.material = merged.material->getUniforms();
+                    IndirectDrawBuffer::Command drawCommand =
+                        arena->getDrawCommand(merged.mesh->getArenaHandle(merged.level));
+                    if (merged.clusterCount == 0) {
+                        const BoundingVolume& bounds = merged.mesh->getBounds();
+                        batch.commands[d] = drawCommand;
+                        batch.draws[d] = draw;
+                        batch.bounds[d] = IndirectDrawBuffer::CullBounds();
+                        batch.bounds[d].sphere = glm::vec4(bounds.getCenter(), bounds.radius);
+                        ++d;
+                        continue;
+                    }
+                    // クラスタの範囲は最も詳細な段階のハンドルの範囲からの位置
+                    const Mesh::Meshlet* meshlets = merged.mesh->getMeshlets().data();
+                    for (std::uint32_t c = 0; c < merged.clusterCount; ++c) {
+                        const Mesh::Meshlet& meshlet =
+                            meshlets[clusterIds[merged.firstCluster + c]];
+                        batch.commands[d] = drawCommand;
+                        batch.commands[d].firstIndex += meshlet.firstIndex;
+                        batch.commands[d].count = meshlet.indexCount;
+                        batch.draws[d] = draw;
+                        batch.bounds[d].sphere = glm::vec4(meshlet.center, meshlet.radius);
+                        batch.bounds[d].cone = glm::vec4(meshlet.coneAxis, meshlet.coneCutoff);
+                        ++d;
+                    }
+                }
+                // GPUのカリングはプログラムを切り替えるため、描画のプログラムより先に行う
+                // （詰めると順序が変わるため、奥から手前に並べた半透明はカリングしない）
+                indirect->prepare(batch, command.pipeline == opaquePipeline);
+                if (batch.culledBatch >= 0) {
+                    currentShader = nullptr;
+                }
+                if (indirectShader != currentShader) {
+                    indirectShader->use();
+                    currentShader = indirectShader;
+                    currentGeometry = nullptr;
+                    currentTransform = 0xFFFFFFFFu;
+                    ++stats.shaderChanges;
+                }
+                if (arena != currentGeometry) {
+                    arena->bind();
+                    currentGeometry = arena;
+                    ++stats.meshChanges;
+                }
+                indirect->draw(batch);
+                stats.multiDrawCommands += end - k > 1 ? end - k : 0;
+                stats.indirectCommands += end - k;
+                ++stats.drawCalls;
+                k = end;
+                continue;
+            }
+        }
+
+        if (command.shader != currentShader) {
+            // uniform はプログラムごとの状態だが、フレームとマテリアルの定数はUBOで共有する
+            command.shader->use();
+            currentShader = command.shader;
+            // コマンドごとに設定する変換行列は名前を探さずハンドルで設定する
+            modelUniform = currentShader->getUniform<glm::mat4>(MODEL);
+            normalMatrixUniform = currentShader->getUniform<glm::mat3>(NORMAL_MATRIX);
+            currentGeometry = nullptr;
+            currentTransform = 0xFFFFFFFFu;
+            ++stats.shaderChanges;
+        }
+        if (!currentMaterial || *command.material != *currentMaterial) {
+            uniforms.bind(MATERIAL_BLOCK_BINDING, materialRanges[commandMaterials[item.command]]);
+            ++stats.materialChanges;
+        }
+        currentMaterial = command.material;
+        // 同じ共有のバッファのメッシュはVAOも復元用の uniform も同じなので設定し直さない
+        if (getGeometryKey(command.mesh) != currentGeometry) {
+            command.mesh->bind(*currentShader);
+            currentGeometry = getGeometryKey(command.mesh);
+            ++stats.meshChanges;
+        }
+        if (command.transform != currentTransform) {
+            currentShader->set(modelUniform, worlds[command.transform]);
+            currentShader->set(normalMatrixUniform, normalMatrices[command.transform]);
+            currentTransform = command.transform;
+            ++stats.transformChanges;
+        }
+
+        // 状態がすべて同じで隣り合う共有のバッファのメッシュは1回の呼び出しにまとめる
+        std::size_t end = k + 1;
+        while (end < keys.size() && canMerge(command, commands[keys[end].command])) {
+            ++end;
+        }
+        if (end - k > 1) {
+            arenaHandles.clear();
+            for (std::size_t i = k; i < end; ++i) {
+                const Command& merged = commands[keys[i].command];
+                arenaHandles.push_back(merged.mesh->getArenaHandle(merged.level));
+            }
+            command.mesh->getArena()->drawMulti(arenaHandles.data(), arenaHandles.size());
+            stats.multiDrawCommands += end - k;
+        }
+        else if (command.clusterCount > 0) {
+            command.mesh->drawClusters(clusterIds.data() + command.firstCluster,
+                                       command.clusterCount);
+        }
+        else {
+            command.mesh->drawElements(command.level);
+        }
+        ++stats.drawCalls;
+        k = end;
+    }
+
+    // 以降の描画に半透明の状態を残さない（不透明と同じなら GlStateCache が省く）
+    stateCache.bindPipeline(opaquePipeline);
+    clear();
+}
+
+void RenderQueue::clear() {
+    commands.clear();
+    clusterIds.clear();
+    worlds.clear();
+    normalMatrices.clear();
+}
+
+std::size_t RenderQueue::getCommandCount() const {
+    return commands.size();
+}
+
+GlStateCache::PipelineHandle RenderQueue::getPipeline(RenderPass pass) const {
+    return pass == RenderPass::Transparent ? transparentPipeline : opaquePipeline;
+}
+
+const RenderQueue::Stats& RenderQueue::getStats() const {
+    return stats;
+}
+
+std::uint32_t RenderQueue::getId(IdMap& ids, const void* object) {
+    return ids.emplace(object, static_cast<std::uint32_t>(ids.size())).first->second;
+}
+
+const void* RenderQueue::getGeometryKey(const Mesh* mesh) {
+    GeometryArena* arena = mesh->getArena();
+    return arena ? static_cast<const void*>(arena) : static_cast<const void*>(mesh);
+}
+
+bool RenderQueue::canMerge(const Command& first, const Command& second) {
+    return first.mesh->getArena() && first.mesh->getArena() == second.mesh->getArena() &&
+           first.clusterCount == 0 && second.clusterCount == 0 &&
+           first.pipeline == second.pipeline && first.shader == second.shader &&
+           first.transform == second.transform && *first.material == *second.material;
+}
+
+const Shader* RenderQueue::getIndirectShader(const Command& command) const {
+    if (!command.mesh->getArena()) {
+        return nullptr;
+    }
+    auto it = indirectShaders.find(command.shader);
+    return it != indirectShaders.end() ? it->second : nullptr;
+}
+
+bool RenderQueue::canMergeIndirect(const Command& first, const Command& second) const {
+    return first.mesh->getArena() == second.mesh->getArena() &&
+           first.pipeline == second.pipeline && first.shader == second.shader;
+}
+
+std::size_t RenderQueue::countUnsortedStateChanges() const {
+    std::size_t changes = 0;
+    const Command* previous = nullptr;
+    for (const Command& command : commands) {
+        changes += !previous || command.pipeline != previous->pipeline ? 1 : 0;
+        bool shaderChanged = !previous || command.shader != previous->shader;
+        changes += shaderChanged ? 1 : 0;
+        changes += !previous || *command.material != *previous->material ? 1 : 0;
+        changes += shaderChanged || getGeometryKey(command.mesh) != getGeometryKey(previous->mesh)
+                       ? 1 : 0;
+        changes += shaderChanged || command.transform != previous->transform ? 1 : 0;
+        previous = &command;
+    }
+    return changes;
+}
+
+} // namespace claude_gl
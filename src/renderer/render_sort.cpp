@@ -0,0 +1,109 @@
+#include "renderer/render_sort.h"
+#include <algorithm>
+#include <utility>
+
+namespace claude_gl {
+
+namespace {
+
+constexpr unsigned DIGIT_BITS = 11;
+constexpr unsigned DIGIT_COUNT = (64 + DIGIT_BITS - 1) / DIGIT_BITS;
+constexpr std::size_t BUCKET_COUNT = std::size_t(1) << DIGIT_BITS;
+
+// これより少ない要素はヒストグラムの初期化の方が高くつくため比較ソートで並べる
+constexpr std::size_t SMALL_SORT_COUNT = 2048;
+
+/**
+ * @brief 下位 bits ビットを取り出す
+ */
+constexpr std::uint64_t lowBits(std::uint32_t value, unsigned bits) {
+    return static_cast<std::uint64_t>(value) & ((std::uint64_t(1) << bits) - 1);
+}
+
+} // namespace
+
+std::uint64_t RenderSort::makeKey(RenderPass pass, std::uint32_t shader, std::uint32_t material,
+                                  std::uint32_t mesh, std::uint32_t depth) {
+    std::uint64_t key = lowBits(static_cast<std::uint32_t>(pass), PASS_BITS);
+    std::uint64_t state = lowBits(shader, SHADER_BITS);
+    state = (state << MATERIAL_BITS) | lowBits(material, MATERIAL_BITS);
+    state = (state << MESH_BITS) | lowBits(mesh, MESH_BITS);
+
+    if (pass == RenderPass::Transparent) {
+        // 奥にあるものほど先に描画する
+        key = (key << DEPTH_BITS) | lowBits(~depth, DEPTH_BITS);
+        return (key << (SHADER_BITS + MATERIAL_BITS + MESH_BITS)) | state;
+    }
+    key = (key << (SHADER_BITS + MATERIAL_BITS + MESH_BITS)) | state;
+    return (key << DEPTH_BITS) | lowBits(depth, DEPTH_BITS);
+}
+
+RenderPass RenderSort::getPass(std::uint64_t key) {
+    return static_cast<RenderPass>(key >> (64 - PASS_BITS));
+}
+
+std::uint32_t RenderSort::quantizeDepth(float depth, float nearPlane, float farPlane) {
+    constexpr std::uint32_t MAX_DEPTH = (std::uint32_t(1) << DEPTH_BITS) - 1;
+    float t = (depth - nearPlane) / (farPlane - nearPlane);
+    // NaN も手前に丸める
+    if (!(t > 0.0f)) {
+        return 0;
+    }
+    if (t >= 1.0f) {
+        return MAX_DEPTH;
+    }
+    return static_cast<std::uint32_t>(t * static_cast<float>(MAX_DEPTH));
+}
+
+unsigned RenderSort::sort(std::vector<Item>& items, std::vector<Item>& scratch) {
+    const std::size_t count = items.size();
+    if (count < SMALL_SORT_COUNT) {
+        std::stable_sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+            return a.key < b.key;
+        });
+        return 0;
+    }
+
+    // 全桁のヒストグラムを1回の走査で求める
+    std::uint32_t histograms[DIGIT_COUNT][BUCKET_COUNT] = {};
+    for (const Item& item : items) {
+        for (unsigned digit = 0; digit < DIGIT_COUNT; ++digit) {
+            ++histograms[digit][(item.key >> (digit * DIGIT_BITS)) & (BUCKET_COUNT - 1)];
+        }
+    }
+
+    scratch.resize(count);
+    Item* source = items.data();
+    Item* destination = scratch.data();
+    unsigned passes = 0;
+    for (unsigned digit = 0; digit < DIGIT_COUNT; ++digit) {
+        std::uint32_t* histogram = histograms[digit];
+        unsigned shift = digit * DIGIT_BITS;
+
+        // 全要素が同じ値の桁は並びが変わらないので飛ばす
+        if (histogram[(source[0].key >> shift) & (BUCKET_COUNT - 1)] == count) {
+            continue;
+        }
+
+        std::uint32_t offset = 0;
+        for (std::size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+            std::uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            const Item& item = source[i];
+            destination[histogram[(item.key >> shift) & (BUCKET_COUNT - 1)]++] = item;
+        }
+        std::swap(source, destination);
+        ++passes;
+    }
+
+    // 奇数回の並べ替えで結果が作業領域にある場合は入れ替える
+    if (source != items.data()) {
+        items.swap(scratch);
+    }
+    return passes;
+}
+
+} // namespace claude_gl
@@ -0,0 +1,334 @@
+#include "renderer/scene.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "renderer/transform_system.h"
+
+namespace claude_gl {
+
+Scene::InstanceId Scene::addInstance(std::shared_ptr<const Model> model,
+                                     const glm::mat4& transform) {
+    if (!model) {
+        throw std::runtime_error("Scene: cannot add an instance without a model");
+    }
+
+    InstanceId id;
+    if (!freeInstances.empty()) {
+        id = freeInstances.back();
+        freeInstances.pop_back();
+    }
+    else {
+        id = static_cast<InstanceId>(instances.size());
+        instances.emplace_back();
+    }
+
+    Instance& instance = instances[id];
+    instance.localBounds = model->getBounds().getBox();
+    instance.model = std::move(model);
+    instance.transform = transform;
+    instance.leaf = bvh.insert(Aabb::transform(instance.localBounds, transform), id);
+    return id;
+}
+
+void Scene::removeInstance(InstanceId id) {
+    getInstance(id);
+    Instance& instance = instances[id];
+    bvh.remove(instance.leaf);
+    if (instance.node != TransformHierarchy::INVALID_NODE) {
+        nodeInstances[instance.node] = INVALID_INSTANCE;
+    }
+    instance = Instance();
+    freeInstances.push_back(id);
+}
+
+void Scene::setTransform(InstanceId id, const glm::mat4& transform) {
+    getInstance(id);
+    Instance& instance = instances[id];
+    instance.transform = transform;
+    bvh.update(instance.leaf, Aabb::transform(instance.localBounds, transform));
+}
+
+const glm::mat4& Scene::getTransform(InstanceId id) const {
+    return getInstance(id).transform;
+}
+
+void Scene::setMaterial(InstanceId id, const Material& material) {
+    getInstance(id);
+    instances[id].material = material;
+}
+
+const Material& Scene::getMaterial(InstanceId id) const {
+    return getInstance(id).material;
+}
+
+void Scene::attachNode(InstanceId id, TransformHierarchy::NodeId node) {
+    getInstance(id);
+    Instance& instance = instances[id];
+    if (instance.node != TransformHierarchy::INVALID_NODE) {
+        nodeInstances[instance.node] = INVALID_INSTANCE;
+    }
+    instance.node = node;
+    if (node == TransformHierarchy::INVALID_NODE) {
+        return;
+    }
+
+    if (node >= nodeInstances.size()) {
+        nodeInstances.resize(static_cast<std::size_t>(node) + 1, INVALID_INSTANCE);
+    }
+    // 1つのノードに追従できるインスタンスは1つ（以前のインスタンスは解除する）
+    if (nodeInstances[node] != INVALID_INSTANCE) {
+        instances[nodeInstances[node]].node = TransformHierarchy::INVALID_NODE;
+    }
+    nodeInstances[node] = id;
+}
+
+void Scene::setOccluder(InstanceId id, std::shared_ptr<const OccluderMesh> occluder) {
+    getInstance(id);
+    instances[id].occluder = std::move(occluder);
+}
+
+std::size_t Scene::syncTransforms(const TransformHierarchy& hierarchy) {
+    std::size_t updated = 0;
+    for (TransformHierarchy::NodeId node : hierarchy.getChangedNodes()) {
+        if (node >= nodeInstances.size() || nodeInstances[node] == INVALID_INSTANCE) {
+            continue;
+        }
+        setTransform(nodeInstances[node], hierarchy.getWorldMatrix(node));
+        ++updated;
+    }
+    return updated;
+}
+
+const Aabb& Scene::getWorldBounds(InstanceId id) const {
+    return bvh.getBox(getInstance(id).leaf);
+}
+
+std::size_t Scene::getInstanceCount() const {
+    return bvh.getLeafCount();
+}
+
+void Scene::rebuild() {
+    bvh.rebuild();
+}
+
+void Scene::queryFrustum(const glm::mat4& viewProjection, std::vector<InstanceId>& result) const {
+    glm::vec4 planes[6];
+    FrustumCuller::extractPlanes(viewProjection, planes);
+    bvh.queryFrustum(planes, [&](std::uint32_t id) { result.push_back(id); });
+}
+
+void Scene::queryAabb(const Aabb& box, std::vector<InstanceId>& result) const {
+    bvh.queryAabb(box, [&](std::uint32_t id) { result.push_back(id); });
+}
+
+bool Scene::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                    RayHit& hit) const {
+    hit = RayHit();
+    glm::vec3 inverseDirection = 1.0f / direction;
+
+    // 葉では三角形BVHがあれば三角形と、なければインスタンスの境界と判定する
+    float distance = bvh.raycast(origin, direction, maxDistance,
+                                 [&](std::uint32_t id, float currentMax) {
+        const Instance& instance = instances[id];
+        if (instance.model->hasTriangleBvh()) {
+            Model::RayHit modelHit;
+            if (!instance.model->raycast(origin, direction, currentMax, instance.transform,
+                                         modelHit)) {
+                return currentMax;
+            }
+            hit.instance = id;
+            hit.triangleHit = true;
+            hit.mesh = modelHit.mesh;
+            hit.triangle = modelHit.triangle;
+            return modelHit.distance;
+        }
+
+        const Aabb& box = bvh.getBox(instance.leaf);
+        glm::vec3 t0 = (box.boundsMin - origin) * inverseDirection;
+        glm::vec3 t1 = (box.boundsMax - origin) * inverseDirection;
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+        float entry = std::fmax(std::fmax(tNear.x, tNear.y), std::fmax(tNear.z, 0.0f));
+        float exit = std::fmin(std::fmin(tFar.x, tFar.y), tFar.z);
+        if (entry > exit || entry >= currentMax) {
+            return currentMax;
+        }
+        hit.instance = id;
+        hit.triangleHit = false;
+        return entry;
+    });
+
+    hit.distance = distance;
+    return hit.instance != INVALID_INSTANCE;
+}
+
+void Scene::draw(const Shader& shader, const glm::mat4& viewProjection, FrustumCuller& culler) {
+    gatherVisible(viewProjection, culler);
+    for (std::size_t i = 0; i < visibleInstances.size(); ++i) {
+        const Instance& instance = instances[visibleInstances[i]];
+        instance.model->drawVisible(shader, culler, firstCullerIndices[i], visibleTransforms[i],
+                                    visibleNormalMatrices[i]);
+    }
+}
+
+std::size_t Scene::submit(RenderQueue& queue, const Shader& shader,
+                          const glm::mat4& viewProjection, FrustumCuller& culler,
+                          OcclusionCuller* occlusion, const LodView* lod,
+                          ClusterCuller* clusters) {
+    gatherVisible(viewProjection, culler, occlusion);
+    std::size_t submitted = 0;
+    for (std::size_t i = 0; i < visibleInstances.size(); ++i) {
+        Instance& instance = instances[visibleInstances[i]];
+        std::uint32_t transform =
+            queue.addTransform(visibleTransforms[i], visibleNormalMatrices[i]);
+        const std::uint8_t* levels = selectLods(instance, visibleTransforms[i], lod);
+        // 半透明は裏面も見えるため、面の向きで除かないようクラスタに分けない
+        ClusterCuller* instanceClusters =
+            clusters && !instance.material.isTransparent() ? clusters : nullptr;
+        if (instanceClusters) {
+            instanceClusters->beginInstance(visibleTransforms[i]);
+        }
+        submitted += instance.model->submitVisible(queue, shader, instance.material, culler,
+                                                   firstCullerIndices[i], transform, levels,
+                                                   instanceClusters);
+    }
+    return submitted;
+}
+
+std::size_t Scene::submitAll(RenderQueue& queue, const Shader& shader, const LodView* lod,
+                             bool splitClusters) {
+    visibleInstances.clear();
+    visibleTransforms.clear();
+    for (std::size_t id = 0; id < instances.size(); ++id) {
+        if (instances[id].model) {
+            visibleInstances.push_back(static_cast<InstanceId>(id));
+            visibleTransforms.push_back(instances[id].transform);
+        }
+    }
+    stats.instanceCount = bvh.getLeafCount();
+    stats.visibleInstances = visibleInstances.size();
+    stats.nodesVisited = 0;
+    stats.occludedInstances = 0;
+
+    visibleNormalMatrices.resize(visibleTransforms.size());
+    TransformSystem::computeNormalMatrices(visibleTransforms.data(), visibleNormalMatrices.data(),
+                                           visibleTransforms.size());
+    std::size_t submitted = 0;
+    for (std::size_t i = 0; i < visibleInstances.size(); ++i) {
+        Instance& instance = instances[visibleInstances[i]];
+        std::uint32_t transform =
+            queue.addTransform(visibleTransforms[i], visibleNormalMatrices[i]);
+        const std::uint8_t* levels = selectLods(instance, visibleTransforms[i], lod);
+        bool split = splitClusters && !instance.material.isTransparent();
+        submitted += instance.model->submit(queue, shader, instance.material, transform, levels,
+                                            split);
+    }
+    return submitted;
+}
+
+const std::uint8_t* Scene::selectLods(Instance& instance, const glm::mat4& world,
+                                      const LodView* lod) {
+    if (!lod) {
+        return nullptr;
+    }
+    // 段階は前フレームの段階を起点に選ぶため、インスタンスごとに保持する
+    instance.lodLevels.resize(instance.model->getMeshCount(), 0);
+    instance.model->selectLods(*lod, world, instance.lodLevels.data());
+    return instance.lodLevels.data();
+}
+
+const DynamicBvh& Scene::getBvh() const {
+    return bvh;
+}
+
+const Scene::Stats& Scene::getStats() const {
+    return stats;
+}
+
+const Scene::Instance& Scene::getInstance(InstanceId id) const {
+    if (id >= instances.size() || !instances[id].model) {
+        throw std::runtime_error("Scene: invalid instance " + std::to_string(id));
+    }
+    return instances[id];
+}
+
+void Scene::gatherVisible(const glm::mat4& viewProjection, FrustumCuller& culler,
+                          OcclusionCuller* occlusion) {
+    // BVHで視錐台と交差するインスタンスを絞り込む
+    glm::vec4 planes[6];
+    FrustumCuller::extractPlanes(viewProjection, planes);
+    visibleInstances.clear();
+    stats.instanceCount = bvh.getLeafCount();
+    stats.nodesVisited = bvh.queryFrustum(planes, [&](std::uint32_t id) {
+        visibleInstances.push_back(id);
+    });
+    stats.occludedInstances = 0;
+    if (occlusion) {
+        removeOccluded(viewProjection, *occlusion);
+    }
+    stats.visibleInstances = visibleInstances.size();
+
+    // 残ったインスタンスのメッシュをまとめて判定する
+    culler.clear();
+    firstCullerIndices.resize(visibleInstances.size());
+    visibleTransforms.resize(visibleInstances.size());
+    for (std::size_t i = 0; i < visibleInstances.size(); ++i) {
+        const Instance& instance = instances[visibleInstances[i]];
+        firstCullerIndices[i] = instance.model->addToCuller(culler, instance.transform);
+        visibleTransforms[i] = instance.transform;
+    }
+    culler.cull(viewProjection);
+
+    // 法線行列は描画するインスタンスの分だけまとめて計算する（シェーダーで頂点ごとに求めない）
+    visibleNormalMatrices.resize(visibleTransforms.size());
+    TransformSystem::computeNormalMatrices(visibleTransforms.data(), visibleNormalMatrices.data(),
+                                           visibleTransforms.size());
+}
+
+void Scene::removeOccluded(const glm::mat4& viewProjection, OcclusionCuller& occlusion) {
+    // 遮蔽物は手前から描くほど後の三角形が早く捨てられるため、クリップ空間の w の順に並べる
+    glm::vec4 depthRow(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3],
+                       viewProjection[3][3]);
+    occluderOrder.clear();
+    for (InstanceId id : visibleInstances) {
+        const Instance& instance = instances[id];
+        if (instance.occluder) {
+            glm::vec4 center(bvh.getBox(instance.leaf).getCenter(), 1.0f);
+            occluderOrder.emplace_back(glm::dot(depthRow, center), id);
+        }
+    }
+    occlusion.beginFrame(viewProjection);
+    if (occluderOrder.empty()) {
+        return;
+    }
+    std::sort(occluderOrder.begin(), occluderOrder.end());
+    for (const auto& entry : occluderOrder) {
+        const Instance& instance = instances[entry.second];
+        occlusion.addOccluder(*instance.occluder, instance.transform);
+    }
+    occlusion.render();
+
+    // 遮蔽物以外のワールド空間の境界をまとめて判定し、見える可能性があるものだけ残す
+    occludeeBoxes.clear();
+    for (InstanceId id : visibleInstances) {
+        if (!instances[id].occluder) {
+            occludeeBoxes.push_back(bvh.getBox(instances[id].leaf));
+        }
+    }
+    occludeeVisibility.resize(occludeeBoxes.size());
+    occlusion.testBoxes(occludeeBoxes.data(), occludeeBoxes.size(), occludeeVisibility.data());
+
+    std::size_t kept = 0;
+    std::size_t tested = 0;
+    for (InstanceId id : visibleInstances) {
+        if (instances[id].occluder || occludeeVisibility[tested++]) {
+            visibleInstances[kept++] = id;
+        }
+    }
+    stats.occludedInstances = visibleInstances.size() - kept;
+    visibleInstances.resize(kept);
+}
+
+} // namespace claude_gl
@@ -1,23 +1,60 @@
 #include "shader.h"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <iterator>
 #include <sstream>
+#include <stdexcept>
 #include <glm/gtc/type_ptr.hpp>
+#include "renderer/gl_extensions.h"
+#include "renderer/gl_state_cache.h"
+#include "renderer/uniform_blocks.h"
 
 namespace claude_gl {
 
+namespace {
+
+/**
+ * @brief glUniform1i で設定できる型か判定する
+ */
+bool isIntegerUniform(GLenum type) {
+    switch (type) {
+        case GL_INT:
+        case GL_BOOL:
+        case GL_SAMPLER_1D:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_2D_SHADOW:
+        case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_2D_ARRAY_SHADOW:
+        case GL_SAMPLER_CUBE_SHADOW:
+        case GL_SAMPLER_2D_MULTISAMPLE:
+        case GL_SAMPLER_BUFFER:
+        case GL_INT_SAMPLER_2D:
+        case GL_UNSIGNED_INT_SAMPLER_2D:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
 Shader::Shader() : programId(0) {
 }
 
 Shader::~Shader() {
     // シェーダープログラムの削除
     if (programId != 0) {
+        GlStateCache::getInstance().forgetProgram(programId);
         glDeleteProgram(programId);
         programId = 0;
     }
 }
 
-bool Shader::loadFromFile(const std::string& vertexPath, const std::string& fragmentPath) {
+bool Shader::loadFromFile(const std::string& vertexPath, const std::string& fragmentPath,
+                          const std::vector<std::string>& defines) {
     std::string vertexCode;
     std::string fragmentCode;
     std::ifstream vShaderFile;
@@ -50,31 +87,30 @@ bool Shader::loadFromFile(const std::string& vertexPath, const std::string& frag
         return false;
     }
     
-    return loadFromString(vertexCode, fragmentCode);
+    return loadFromString(vertexCode, fragmentCode, defines);
 }
 
-bool Shader::loadFromString(const std::string& vertexSource, const std::string& fragmentSource) {
+bool Shader::loadFromString(const std::string& vertexSource, const std::string& fragmentSource,
+                            const std::vector<std::string>& defines) {
     // 以前のシェーダープログラムがあれば削除
-    if (programId != 0) {
-        glDeleteProgram(programId);
-        uniformLocationCache.clear();
-    }
+    releaseProgram();
     
     unsigned int vertexShader, fragmentShader;
     
     // 頂点シェーダーのコンパイル
-    if (!compileShader(vertexShader, GL_VERTEX_SHADER, vertexSource)) {
+    if (!compileShader(vertexShader, GL_VERTEX_SHADER, insertDefines(vertexSource, defines))) {
         return false;
     }
     
     // フラグメントシェーダーのコンパイル
-    if (!compileShader(fragmentShader, GL_FRAGMENT_SHADER, fragmentSource)) {
+    if (!compileShader(fragmentShader, GL_FRAGMENT_SHADER,
+                       insertDefines(fragmentSource, defines))) {
         glDeleteShader(vertexShader);
         return false;
     }
     
     // シェーダープログラムのリンク
-    if (!linkProgram(vertexShader, fragmentShader)) {
+    if (!linkProgram({vertexShader, fragmentShader})) {
         glDeleteShader(vertexShader);
         glDeleteShader(fragmentShader);
         return false;
@@ -84,17 +120,55 @@ bool Shader::loadFromString(const std::string& vertexSource, const std::string&
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
     
-    return true;
+    return reflectUniforms() && bindUniformBlocks();
+}
+
+bool Shader::loadComputeFromFile(const std::string& computePath,
+                                 const std::vector<std::string>& defines) {
+    std::string computeCode;
+    std::ifstream cShaderFile;
+    cShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    
+    try {
+        cShaderFile.open(computePath);
+        std::stringstream cShaderStream;
+        cShaderStream << cShaderFile.rdbuf();
+        cShaderFile.close();
+        computeCode = cShaderStream.str();
+    }
+    catch (std::ifstream::failure& e) {
+        std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
+        return false;
+    }
+    
+    return loadComputeFromString(computeCode, defines);
+}
+
+bool Shader::loadComputeFromString(const std::string& computeSource,
+                                   const std::vector<std::string>& defines) {
+    releaseProgram();
+    
+    // glad は 3.3 core で生成しているため、GL_COMPUTE_SHADER は gl_extensions.h の定義を使う
+    unsigned int computeShader;
+    if (!compileShader(computeShader, GL_COMPUTE_SHADER, insertDefines(computeSource, defines))) {
+        return false;
+    }
+    bool linked = linkProgram({computeShader});
+    glDeleteShader(computeShader);
+    
+    // uniform ブロックは使わないが、FrameData などを宣言した場合も同じ割り当てにする
+    return linked && reflectUniforms() && bindUniformBlocks();
 }
 
 void Shader::use() const {
+    // 使用中のプログラムと同じなら glUseProgram を省く
     if (programId != 0) {
-        glUseProgram(programId);
+        GlStateCache::getInstance().useProgram(programId);
     }
 }
 
 void Shader::unuse() const {
-    glUseProgram(0);
+    GlStateCache::getInstance().useProgram(0);
 }
 
 unsigned int Shader::getId() const {
@@ -111,17 +185,20 @@ bool Shader::compileShader(unsigned int& shader, GLenum type, const std::string&
     int success;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
     if (!success) {
-        checkCompileErrors(shader, type == GL_VERTEX_SHADER ? "VERTEX" : "FRAGMENT");
+        checkCompileErrors(shader, type == GL_VERTEX_SHADER     ? "VERTEX"
+                                   : type == GL_FRAGMENT_SHADER ? "FRAGMENT"
+                                                                : "COMPUTE");
         return false;
     }
     
     return true;
 }
 
-bool Shader::linkProgram(unsigned int vertexShader, unsigned int fragmentShader) {
+bool Shader::linkProgram(std::initializer_list<unsigned int> shaders) {
     programId = glCreateProgram();
-    glAttachShader(programId, vertexShader);
-    glAttachShader(programId, fragmentShader);
+    for (unsigned int shader : shaders) {
+        glAttachShader(programId, shader);
+    }
     glLinkProgram(programId);
     
     // リンクエラーのチェック
@@ -135,6 +212,16 @@ bool Shader::linkProgram(unsigned int vertexShader, unsigned int fragmentShader)
     return true;
 }
 
+void Shader::releaseProgram() {
+    if (programId != 0) {
+        GlStateCache::getInstance().forgetProgram(programId);
+        glDeleteProgram(programId);
+        programId = 0;
+        uniforms.clear();
+        reportedMissingUniforms.clear();
+    }
+}
+
 void Shader::checkCompileErrors(unsigned int shader, const std::string& type) {
     int success;
     char infoLog[1024];
@@ -155,59 +242,206 @@ void Shader::checkCompileErrors(unsigned int shader, const std::string& type) {
     }
 }
 
-int Shader::getUniformLocation(const std::string& name) const {
-    // キャッシュ内に位置があるか確認
-    auto it = uniformLocationCache.find(name);
-    if (it != uniformLocationCache.end()) {
-        return it->second;
-    }
+bool Shader::reflectUniforms() {
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(programId, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
     
-    // キャッシュになければ取得してキャッシュに保存
-    int location = glGetUniformLocation(programId, name.c_str());
-    uniformLocationCache[name] = location;
+    std::vector<GLchar> buffer(static_cast<std::size_t>(std::max(maxLength, 1)));
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(programId, static_cast<GLuint>(i), static_cast<GLsizei>(buffer.size()),
+                           &length, &size, &type, buffer.data());
+        std::string name(buffer.data(), static_cast<std::size_t>(length));
+        
+        // 配列は "name[0]" として返るため添字を除く
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            name.resize(name.size() - 3);
+        }
+        // uniform ブロックのメンバーは位置を持たない
+        GLint location = glGetUniformLocation(programId, name.c_str());
+        if (location < 0) {
+            continue;
+        }
+        if (!uniforms.add(name, location, type, size)) {
+            std::cerr << "ERROR::SHADER::UNIFORM_HASH_COLLISION: " << name << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Shader::bindUniformBlocks() {
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(programId, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    glGetProgramiv(programId, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
     
-    if (location == -1) {
-        std::cerr << "Warning: uniform '" << name << "' not found in shader program" << std::endl;
+    std::vector<GLchar> buffer(static_cast<std::size_t>(std::max(maxLength, 1)));
+    for (GLint i = 0; i < count; ++i) {
+        GLuint index = static_cast<GLuint>(i);
+        GLsizei length = 0;
+        glGetActiveUniformBlockName(programId, index, static_cast<GLsizei>(buffer.size()),
+                                    &length, buffer.data());
+        std::string name(buffer.data(), static_cast<std::size_t>(length));
+        
+        auto block = std::find_if(std::begin(UNIFORM_BLOCKS), std::end(UNIFORM_BLOCKS),
+                                  [&](const UniformBlockInfo& info) { return name == info.name; });
+        if (block == std::end(UNIFORM_BLOCKS)) {
+            std::cerr << "Warning: uniform block '" << name << "' has no binding point"
+                      << std::endl;
+            continue;
+        }
+        
+        // GLSL とC++の構造体の std140 レイアウトのずれを検出する
+        GLint dataSize = 0;
+        glGetActiveUniformBlockiv(programId, index, GL_UNIFORM_BLOCK_DATA_SIZE, &dataSize);
+        if (static_cast<std::size_t>(dataSize) > block->size) {
+            std::cerr << "ERROR::SHADER::UNIFORM_BLOCK_SIZE_MISMATCH: " << name << " (" << dataSize
+                      << " > " << block->size << " bytes)" << std::endl;
+            return false;
+        }
+        glUniformBlockBinding(programId, index, block->binding);
+    }
+    return true;
+}
+
+bool Shader::bindUniformBlock(const std::string& blockName, GLuint binding) const {
+    GLuint index = glGetUniformBlockIndex(programId, blockName.c_str());
+    if (index == GL_INVALID_INDEX) {
+        return false;
+    }
+    glUniformBlockBinding(programId, index, binding);
+    return true;
+}
+
+int Shader::getUniformLocation(UniformName name) const {
+    const UniformTable::Entry* entry = uniforms.find(name.getHash());
+    if (entry) {
+        return entry->location;
     }
     
-    return location;
+    // 存在しない uniform への設定は無視されるため、警告は名前ごとに1回だけ出力する
+    std::uint32_t hash = name.getHash();
+    if (std::find(reportedMissingUniforms.begin(), reportedMissingUniforms.end(), hash) ==
+        reportedMissingUniforms.end()) {
+        reportedMissingUniforms.push_back(hash);
+        std::cerr << "Warning: uniform '" << name.getName() << "' not found in shader program"
+                  << std::endl;
+    }
+    return -1;
+}
+
+int Shader::findUniform(UniformName name, GLenum type) const {
+    const UniformTable::Entry* entry = uniforms.find(name.getHash());
+    if (!entry) {
+        return getUniformLocation(name);
+    }
+    bool compatible = entry->type == type ||
+                      ((type == GL_INT || type == GL_BOOL) && isIntegerUniform(entry->type));
+    if (!compatible) {
+        throw std::runtime_error("Shader: uniform type mismatch " + entry->name);
+    }
+    return entry->location;
 }
 
 // Uniform設定メソッドの実装
-void Shader::setBool(const std::string& name, bool value) const {
-    glUniform1i(getUniformLocation(name), static_cast<int>(value));
+void Shader::setBool(UniformName name, bool value) const {
+    upload(getUniformLocation(name), value);
+}
+
+void Shader::setInt(UniformName name, int value) const {
+    upload(getUniformLocation(name), value);
+}
+
+void Shader::setFloat(UniformName name, float value) const {
+    upload(getUniformLocation(name), value);
+}
+
+void Shader::setVec2(UniformName name, const glm::vec2& value) const {
+    upload(getUniformLocation(name), value);
+}
+
+void Shader::setVec3(UniformName name, const glm::vec3& value) const {
+    upload(getUniformLocation(name), value);
+}
+
+void Shader::setVec4(UniformName name, const glm::vec4& value) const {
+    upload(getUniformLocation(name), value);
+}
+
+void Shader::setMat2(UniformName name, const glm::mat2& value) const {
+    upload(getUniformLocation(name), value);
+}
+
+void Shader::setMat3(UniformName name, const glm::mat3& value) const {
+    upload(getUniformLocation(name), value);
+}
+
+void Shader::setMat4(UniformName name, const glm::mat4& value) const {
+    upload(getUniformLocation(name), value);
 }
 
-void Shader::setInt(const std::string& name, int value) const {
-    glUniform1i(getUniformLocation(name), value);
+void Shader::upload(int location, bool value) {
+    glUniform1i(location, static_cast<int>(value));
 }
 
-void Shader::setFloat(const std::string& name, float value) const {
-    glUniform1f(getUniformLocation(name), value);
+void Shader::upload(int location, int value) {
+    glUniform1i(location, value);
 }
 
-void Shader::setVec2(const std::string& name, const glm::vec2& value) const {
-    glUniform2fv(getUniformLocation(name), 1, glm::value_ptr(value));
+void Shader::upload(int location, float value) {
+    glUniform1f(location, value);
 }
 
-void Shader::setVec3(const std::string& name, const glm::vec3& value) const {
-    glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(value));
+void Shader::upload(int location, const glm::vec2& value) {
+    glUniform2fv(location, 1, glm::value_ptr(value));
 }
 
-void Shader::setVec4(const std::string& name, const glm::vec4& value) const {
-    glUniform4fv(getUniformLocation(name), 1, glm::value_ptr(value));
+void Shader::upload(int location, const glm::vec3& value) {
+    glUniform3fv(location, 1, glm::value_ptr(value));
 }
 
-void Shader::setMat2(const std::string& name, const glm::mat2& value) const {
-    glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+void Shader::upload(int location, const glm::vec4& value) {
+    glUniform4fv(location, 1, glm::value_ptr(value));
 }
 
-void Shader::setMat3(const std::string& name, const glm::mat3& value) const {
-    glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+void Shader::upload(int location, const glm::mat2& value) {
+    glUniformMatrix2fv(location, 1, GL_FALSE, glm::value_ptr(value));
 }
 
-void Shader::setMat4(const std::string& name, const glm::mat4& value) const {
-    glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+void Shader::upload(int location, const glm::mat3& value) {
+    glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::upload(int location, const glm::mat4& value) {
+    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+std::string Shader::insertDefines(const std::string& source,
+                                  const std::vector<std::string>& defines) {
+    if (defines.empty()) {
+        return source;
+    }
+    
+    std::string block;
+    for (const std::string& name : defines) {
+        block += "#define " + name + "\n";
+    }
+    
+    // #version は先頭に置く必要があるため、その行の直後に挿入する
+    std::size_t versionPos = source.find("#version");
+    if (versionPos == std::string::npos) {
+        return block + source;
+    }
+    std::size_t lineEnd = source.find('\n', versionPos);
+    if (lineEnd == std::string::npos) {
+        return source + "\n" + block;
+    }
+    return source.substr(0, lineEnd + 1) + block + source.substr(lineEnd + 1);
 }
 
 } // namespace claude_gl
\ No newline at end of file
@@ -1,17 +1,64 @@
 #pragma once
 
+#include <cstdint>
+#include <initializer_list>
 #include <string>
-#include <unordered_map>
+#include <vector>
 #include <glad/gl.h>
 #include <glm/glm.hpp>
+#include "renderer/uniform_table.h"
 
 namespace claude_gl {
 
+/**
+ * @brief uniform の値の型に対応する GLSL の型
+ */
+template <typename T>
+struct UniformType;
+template <> struct UniformType<bool> { static constexpr GLenum VALUE = GL_BOOL; };
+template <> struct UniformType<int> { static constexpr GLenum VALUE = GL_INT; };
+template <> struct UniformType<float> { static constexpr GLenum VALUE = GL_FLOAT; };
+template <> struct UniformType<glm::vec2> { static constexpr GLenum VALUE = GL_FLOAT_VEC2; };
+template <> struct UniformType<glm::vec3> { static constexpr GLenum VALUE = GL_FLOAT_VEC3; };
+template <> struct UniformType<glm::vec4> { static constexpr GLenum VALUE = GL_FLOAT_VEC4; };
+template <> struct UniformType<glm::mat2> { static constexpr GLenum VALUE = GL_FLOAT_MAT2; };
+template <> struct UniformType<glm::mat3> { static constexpr GLenum VALUE = GL_FLOAT_MAT3; };
+template <> struct UniformType<glm::mat4> { static constexpr GLenum VALUE = GL_FLOAT_MAT4; };
+
+/**
+ * @brief 型付きの uniform のハンドル（Shader::getUniform() で取得する）
+ *
+ * 位置のみを保持するため、設定時に名前の探索は行いません。
+ * 取得したシェーダーを読み込み直すと無効になります。
+ */
+template <typename T>
+class Uniform {
+public:
+    /**
+     * @brief シェーダーに存在する uniform か判定する
+     * @return 存在しない場合（設定は無視される）はfalse
+     */
+    bool isValid() const {
+        return location >= 0;
+    }
+
+private:
+    friend class Shader;
+    GLint location = -1;  ///< 位置
+};
+
 /**
  * @brief OpenGLシェーダープログラムを管理するクラス
  * 
  * シェーダーのロード、コンパイル、リンク、使用を担当し、
  * uniformパラメータの設定も行う
+ *
+ * リンク時に glGetActiveUniform で uniform の一覧（UniformTable）を作成します。
+ * 名前による設定は constexpr の UniformName のハッシュ値で一覧を二分探索し、
+ * 描画ごとに設定する uniform は getUniform() で取得したハンドルを使うと探索も省けます。
+ *
+ * uniform ブロックは UNIFORM_BLOCKS（uniform_blocks.h）に従ってリンク時に
+ * バインディングポイントを割り当てるため、同じブロックは全プログラムで共有されます。
  */
 class Shader {
 public:
@@ -32,18 +79,42 @@ public:
      * 
      * @param vertexPath 頂点シェーダーのファイルパス
      * @param fragmentPath フラグメントシェーダーのファイルパス
+     * @param defines 両方のシェーダーの #version の直後に挿入する #define の名前（バリアント用）
      * @return 成功した場合はtrue、失敗した場合はfalse
      */
-    bool loadFromFile(const std::string& vertexPath, const std::string& fragmentPath);
+    bool loadFromFile(const std::string& vertexPath, const std::string& fragmentPath,
+                      const std::vector<std::string>& defines = {});
     
     /**
      * @brief 文字列から頂点シェーダーとフラグメントシェーダーをロードする
      * 
      * @param vertexSource 頂点シェーダーのソースコード
      * @param fragmentSource フラグメントシェーダーのソースコード
+     * @param defines 両方のシェーダーの #version の直後に挿入する #define の名前（バリアント用）
      * @return 成功した場合はtrue、失敗した場合はfalse
      */
-    bool loadFromString(const std::string& vertexSource, const std::string& fragmentSource);
+    bool loadFromString(const std::string& vertexSource, const std::string& fragmentSource,
+                        const std::vector<std::string>& defines = {});
+    
+    /**
+     * @brief ファイルからコンピュートシェーダーをロードする（GL 4.3 以上のコンテキストのみ）
+     * 
+     * @param computePath コンピュートシェーダーのファイルパス
+     * @param defines #version の直後に挿入する #define の名前（バリアント用）
+     * @return 成功した場合はtrue、失敗した場合はfalse
+     */
+    bool loadComputeFromFile(const std::string& computePath,
+                             const std::vector<std::string>& defines = {});
+    
+    /**
+     * @brief 文字列からコンピュートシェーダーをロードする（GL 4.3 以上のコンテキストのみ）
+     * 
+     * @param computeSource コンピュートシェーダーのソースコード
+     * @param defines #version の直後に挿入する #define の名前（バリアント用）
+     * @return 成功した場合はtrue、失敗した場合はfalse
+     */
+    bool loadComputeFromString(const std::string& computeSource,
+                               const std::vector<std::string>& defines = {});
     
     /**
      * @brief シェーダープログラムを使用する
@@ -55,13 +126,51 @@ public:
      */
     void unuse() const;
     
+    /**
+     * @brief 型付きの uniform のハンドルを取得する
+     * 
+     * 型が一致しない場合は std::runtime_error を送出し、存在しない場合は警告を1回出力して
+     * 無効なハンドルを返します。
+     * 
+     * @param name uniform変数の名前
+     * @return ハンドル
+     */
+    template <typename T>
+    Uniform<T> getUniform(UniformName name) const {
+        Uniform<T> uniform;
+        uniform.location = findUniform(name, UniformType<T>::VALUE);
+        return uniform;
+    }
+    
+    /**
+     * @brief ハンドルで uniform変数を設定する（名前の探索を行わない）
+     * 
+     * @param uniform getUniform() で取得したハンドル
+     * @param value 設定する値
+     */
+    template <typename T>
+    void set(Uniform<T> uniform, const T& value) const {
+        upload(uniform.location, value);
+    }
+    
+    /**
+     * @brief uniform ブロックにバインディングポイントを割り当てる
+     * 
+     * UNIFORM_BLOCKS にあるブロックはリンク時に割り当て済みのため、それ以外のブロックに使います。
+     * 
+     * @param blockName GLSL のブロック名
+     * @param binding バインディングポイント
+     * @return ブロックが存在しない場合はfalse
+     */
+    bool bindUniformBlock(const std::string& blockName, GLuint binding) const;
+    
     /**
      * @brief bool型のuniform変数を設定する
      * 
      * @param name uniform変数の名前
      * @param value 設定する値
      */
-    void setBool(const std::string& name, bool value) const;
+    void setBool(UniformName name, bool value) const;
     
     /**
      * @brief int型のuniform変数を設定する
@@ -69,7 +178,7 @@ public:
      * @param name uniform変数の名前
      * @param value 設定する値
      */
-    void setInt(const std::string& name, int value) const;
+    void setInt(UniformName name, int value) const;
     
     /**
      * @brief float型のuniform変数を設定する
@@ -77,7 +186,7 @@ public:
      * @param name uniform変数の名前
      * @param value 設定する値
      */
-    void setFloat(const std::string& name, float value) const;
+    void setFloat(UniformName name, float value) const;
     
     /**
      * @brief vec2型のuniform変数を設定する
@@ -85,7 +194,7 @@ public:
      * @param name uniform変数の名前
      * @param value 設定する値
      */
-    void setVec2(const std::string& name, const glm::vec2& value) const;
+    void setVec2(UniformName name, const glm::vec2& value) const;
     
     /**
      * @brief vec3型のuniform変数を設定する
@@ -93,7 +202,7 @@ public:
      * @param name uniform変数の名前
      * @param value 設定する値
      */
-    void setVec3(const std::string& name, const glm::vec3& value) const;
+    void setVec3(UniformName name, const glm::vec3& value) const;
     
     /**
      * @brief vec4型のuniform変数を設定する
@@ -101,7 +210,7 @@ public:
      * @param name uniform変数の名前
      * @param value 設定する値
      */
-    void setVec4(const std::string& name, const glm::vec4& value) const;
+    void setVec4(UniformName name, const glm::vec4& value) const;
     
     /**
      * @brief mat2型のuniform変数を設定する
@@ -109,7 +218,7 @@ public:
      * @param name uniform変数の名前
      * @param value 設定する値
      */
-    void setMat2(const std::string& name, const glm::mat2& value) const;
+    void setMat2(UniformName name, const glm::mat2& value) const;
     
     /**
      * @brief mat3型のuniform変数を設定する
@@ -117,7 +226,7 @@ public:
      * @param name uniform変数の名前
      * @param value 設定する値
      */
-    void setMat3(const std::string& name, const glm::mat3& value) const;
+    void setMat3(UniformName name, const glm::mat3& value) const;
     
     /**
      * @brief mat4型のuniform変数を設定する
@@ -125,7 +234,7 @@ public:
      * @param name uniform変数の名前
      * @param value 設定する値
      */
-    void setMat4(const std::string& name, const glm::mat4& value) const;
+    void setMat4(UniformName name, const glm::mat4& value) const;
     
     /**
      * @brief シェーダープログラムIDを取得する
@@ -138,8 +247,11 @@ private:
     // シェーダープログラムID
     unsigned int programId;
     
-    // uniform位置のキャッシュ（パフォーマンス向上のため）
-    mutable std::unordered_map<std::string, int> uniformLocationCache;
+    // リンク時に取得した uniform の一覧
+    UniformTable uniforms;
+    
+    // 存在しないことを警告済みの名前のハッシュ値（警告は名前ごとに1回）
+    mutable std::vector<std::uint32_t> reportedMissingUniforms;
     
     /**
      * @brief シェーダーをコンパイルする
@@ -154,27 +266,75 @@ private:
     /**
      * @brief シェーダープログラムをリンクする
      * 
-     * @param vertexShader 頂点シェーダーID
-     * @param fragmentShader フラグメントシェーダーID
+     * @param shaders リンクするシェーダーIDの一覧（頂点とフラグメント、またはコンピュート）
      * @return 成功した場合はtrue、失敗した場合はfalse
      */
-    bool linkProgram(unsigned int vertexShader, unsigned int fragmentShader);
+    bool linkProgram(std::initializer_list<unsigned int> shaders);
+    
+    /**
+     * @brief 以前のシェーダープログラムと uniform の一覧を破棄する
+     */
+    void releaseProgram();
     
     /**
      * @brief シェーダーのコンパイルエラーやリンクエラーをチェックする
      * 
      * @param shader シェーダーまたはプログラムID
-     * @param type "VERTEX", "FRAGMENT", "PROGRAM"のいずれか
+     * @param type "VERTEX", "FRAGMENT", "COMPUTE", "PROGRAM"のいずれか
      */
     void checkCompileErrors(unsigned int shader, const std::string& type);
     
     /**
-     * @brief uniform変数の位置を取得する（キャッシング付き）
+     * @brief リンクしたプログラムの uniform の一覧を作成する
+     * 
+     * @return 名前のハッシュ値が衝突した場合はfalse
+     */
+    bool reflectUniforms();
+    
+    /**
+     * @brief リンクしたプログラムの uniform ブロックにバインディングポイントを割り当てる
+     * 
+     * @return ブロックがC++側の構造体より大きい場合はfalse
+     */
+    bool bindUniformBlocks();
+    
+    /**
+     * @brief uniform変数の位置を取得する
      * 
      * @param name uniform変数の名前
-     * @return uniform変数の位置
+     * @return uniform変数の位置（存在しない場合は-1）
+     */
+    int getUniformLocation(UniformName name) const;
+    
+    /**
+     * @brief 型を確認して uniform変数の位置を取得する
+     * 
+     * @param name uniform変数の名前
+     * @param type 設定する値の型
+     * @return uniform変数の位置（存在しない場合は-1）
+     */
+    int findUniform(UniformName name, GLenum type) const;
+    
+    // 位置への値の設定（型ごと）
+    static void upload(int location, bool value);
+    static void upload(int location, int value);
+    static void upload(int location, float value);
+    static void upload(int location, const glm::vec2& value);
+    static void upload(int location, const glm::vec3& value);
+    static void upload(int location, const glm::vec4& value);
+    static void upload(int location, const glm::mat2& value);
+    static void upload(int location, const glm::mat3& value);
+    static void upload(int location, const glm::mat4& value);
+    
+    /**
+     * @brief ソースの #version 行の直後に #define を挿入する
+     * 
+     * @param source シェーダーのソースコード
+     * @param defines 定義する名前
+     * @return 挿入後のソースコード
      */
-    int getUniformLocation(const std::string& name) const;
+    static std::string insertDefines(const std::string& source,
+                                     const std::vector<std::string>& defines);
 };
 
 } // namespace claude_gl
\ No newline at end of file
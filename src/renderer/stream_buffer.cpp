@@ -0,0 +1,191 @@
+#include "renderer/stream_buffer.h"
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include "renderer/gl_extensions.h"
+#include "renderer/gl_state_cache.h"
+
+namespace claude_gl {
+
+namespace {
+
+// 領域の大きさの単位（UBOのオフセットのアラインメントの最大値に合わせる）
+constexpr std::size_t REGION_ALIGNMENT = 256;
+
+// フェンスを待つ1回あたりの時間（ナノ秒）
+constexpr GLuint64 FENCE_WAIT_NANOSECONDS = 1000000;
+
+/**
+ * @brief 値をアラインメントの倍数に切り上げる
+ */
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+StreamBuffer::StreamBuffer(std::size_t regionSize, std::size_t regionCount,
+                           bool allowPersistentMapping)
+    : regionSize(alignUp(regionSize, REGION_ALIGNMENT)), regionCount(regionCount),
+      fences(regionCount, nullptr), region(regionCount > 0 ? regionCount - 1 : 0) {
+    if (regionSize == 0 || regionCount == 0) {
+        throw std::runtime_error("StreamBuffer: invalid size " + std::to_string(regionSize) +
+                                 " x " + std::to_string(regionCount));
+    }
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    GLsizeiptr totalSize = static_cast<GLsizeiptr>(this->regionSize * regionCount);
+
+    glGenBuffers(1, &buffer);
+    const GlExtensions& extensions = GlExtensions::get();
+    if (allowPersistentMapping && extensions.hasBufferStorage()) {
+        // 書き込み専用・永続・コヒーレント（書いた内容は以降のGLコマンドから見える）
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        extensions.bufferStorage(GL_COPY_WRITE_BUFFER, totalSize, nullptr, flags);
+        mapped = static_cast<unsigned char*>(
+            glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, totalSize, flags));
+        if (!mapped) {
+            // 変更できない領域になっているため、作り直して orphan の方法にする
+            stateCache.forgetBuffer(buffer);
+            glDeleteBuffers(1, &buffer);
+            glGenBuffers(1, &buffer);
+        }
+    }
+    if (!mapped) {
+        stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+        staging.resize(static_cast<std::size_t>(totalSize));
+    }
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (GLsync& fence : fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    if (buffer != 0) {
+        GlStateCache& stateCache = GlStateCache::getInstance();
+        if (mapped) {
+            stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        }
+        stateCache.forgetBuffer(buffer);
+        glDeleteBuffers(1, &buffer);
+    }
+}
+
+void StreamBuffer::beginFrame() {
+    if (mapped) {
+        advanceRegion();
+    }
+    else {
+        // orphan するため、毎フレーム先頭から詰めて1回の転送にまとめる
+        region = 0;
+        orphaned = false;
+    }
+    head = 0;
+    firstRegion = region;
+    usedRegions = 1;
+    flushedEnd = region * regionSize;
+}
+
+StreamBuffer::Allocation StreamBuffer::allocate(std::size_t size, std::size_t alignment) {
+    std::size_t offset = alignUp(head, alignment);
+    if (offset + size > regionSize) {
+        if (size > regionSize || usedRegions == regionCount) {
+            throw std::runtime_error("StreamBuffer: allocation too large " +
+                                     std::to_string(size));
+        }
+        // 今フレームの割り当てを次の領域へはみ出させる
+        ++stats.overflows;
+        advanceRegion();
+        ++usedRegions;
+        offset = 0;
+    }
+    head = offset + size;
+    ++stats.allocations;
+    stats.bytes += size;
+
+    std::size_t position = region * regionSize + offset;
+    unsigned char* base = mapped ? mapped : staging.data();
+    return {base + position, static_cast<GLintptr>(position), static_cast<GLsizeiptr>(size)};
+}
+
+void StreamBuffer::flush() {
+    if (mapped) {
+        return;
+    }
+    std::size_t end = region * regionSize + head;
+    if (end <= flushedEnd) {
+        return;
+    }
+    GlStateCache::getInstance().bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    if (!orphaned) {
+        // GPUが前フレームの内容を読んでいても待たないよう、新しい記憶領域に切り替える
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(regionSize * regionCount),
+                     nullptr, GL_STREAM_DRAW);
+        orphaned = true;
+    }
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(flushedEnd),
+                    static_cast<GLsizeiptr>(end - flushedEnd), staging.data() + flushedEnd);
+    flushedEnd = end;
+}
+
+void StreamBuffer::endFrame() {
+    flush();
+    if (mapped) {
+        for (std::size_t i = 0; i < usedRegions; ++i) {
+            GLsync& fence = fences[(firstRegion + i) % regionCount];
+            if (fence) {
+                glDeleteSync(fence);
+            }
+            fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+    ++stats.frames;
+}
+
+GLuint StreamBuffer::getBuffer() const {
+    return buffer;
+}
+
+std::size_t StreamBuffer::getRegionSize() const {
+    return regionSize;
+}
+
+bool StreamBuffer::isPersistent() const {
+    return mapped != nullptr;
+}
+
+const StreamBuffer::Stats& StreamBuffer::getStats() const {
+    return stats;
+}
+
+void StreamBuffer::advanceRegion() {
+    region = (region + 1) % regionCount;
+    if (region == 0 && stats.frames > 0) {
+        ++stats.wraps;
+    }
+
+    GLsync& fence = fences[region];
+    if (!fence) {
+        return;
+    }
+    // 待たずに確認し、GPUがまだ読んでいる場合だけ時間を計って待つ
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        ++stats.stalls;
+        auto start = std::chrono::steady_clock::now();
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_NANOSECONDS);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        stats.stallMilliseconds +=
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                .count();
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+} // namespace claude_gl
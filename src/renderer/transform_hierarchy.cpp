@@ -0,0 +1,324 @@
+#include "renderer/transform_hierarchy.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "renderer/transform_system.h"
+
+namespace claude_gl {
+
+namespace {
+
+constexpr std::uint32_t NO_SLOT = TransformSystem::NO_PARENT;
+
+// 変更されたノードがこの割合を超えたら、並べ替えずに変更フラグを先頭から走査する
+constexpr std::size_t DIRTY_SCAN_RATIO = 8;
+
+} // namespace
+
+TransformHierarchy::NodeId TransformHierarchy::createNode(NodeId parent) {
+    std::uint32_t parentSlot = parent == INVALID_NODE ? NO_SLOT : getSlot(parent);
+
+    NodeId node;
+    if (!freeNodes.empty()) {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else {
+        node = static_cast<NodeId>(nodeSlots.size());
+        nodeSlots.push_back(NO_SLOT);
+        nodeParents.push_back(INVALID_NODE);
+    }
+    nodeParents[node] = parent;
+
+    // 親の部分木が末尾で終わっていれば、末尾に追加しても行きがけ順が保たれる
+    std::uint32_t slot = static_cast<std::uint32_t>(slotNodes.size());
+    if (!orderDirty && parentSlot != NO_SLOT) {
+        if (parentSlot + subtreeSizes[parentSlot] == slot) {
+            for (std::uint32_t ancestor = parentSlot; ancestor != NO_SLOT;
+                 ancestor = parentSlots[ancestor]) {
+                ++subtreeSizes[ancestor];
+            }
+        }
+        else {
+            orderDirty = true;
+        }
+    }
+
+    translations.emplace_back(0.0f);
+    rotations.emplace_back(1.0f, 0.0f, 0.0f, 0.0f);
+    scales.emplace_back(1.0f);
+    localMatrices.emplace_back(1.0f);
+    worldMatrices.emplace_back(1.0f);
+    parentSlots.push_back(parentSlot);
+    subtreeSizes.push_back(1);
+    localDirty.push_back(0);
+    slotNodes.push_back(node);
+    nodeSlots[node] = slot;
+    markDirty(slot);
+    return node;
+}
+
+void TransformHierarchy::destroyNode(NodeId node) {
+    getSlot(node);
+    if (orderDirty) {
+        // 子孫を連続した範囲として求めるため、先に並びを整える
+        rebuildOrder();
+    }
+
+    std::uint32_t slot = nodeSlots[node];
+    for (std::uint32_t i = slot; i < slot + subtreeSizes[slot]; ++i) {
+        NodeId removed = slotNodes[i];
+        if (removed == INVALID_NODE) {
+            continue;
+        }
+        nodeSlots[removed] = NO_SLOT;
+        nodeParents[removed] = INVALID_NODE;
+        freeNodes.push_back(removed);
+        slotNodes[i] = INVALID_NODE;
+        localDirty[i] = 0;
+    }
+
+    // 空いた位置は次の update() で詰める
+    orderDirty = true;
+}
+
+void TransformHierarchy::setParent(NodeId node, NodeId parent) {
+    std::uint32_t slot = getSlot(node);
+    if (parent != INVALID_NODE) {
+        getSlot(parent);
+        for (NodeId ancestor = parent; ancestor != INVALID_NODE;
+             ancestor = nodeParents[ancestor]) {
+            if (ancestor == node) {
+                throw std::runtime_error("TransformHierarchy: node " + std::to_string(node) +
+                                         " cannot be parented to its descendant " +
+                                         std::to_string(parent));
+            }
+        }
+    }
+    if (nodeParents[node] == parent) {
+        return;
+    }
+
+    nodeParents[node] = parent;
+    orderDirty = true;
+    markDirty(slot);
+}
+
+TransformHierarchy::NodeId TransformHierarchy::getParent(NodeId node) const {
+    getSlot(node);
+    return nodeParents[node];
+}
+
+void TransformHierarchy::setTranslation(NodeId node, const glm::vec3& translation) {
+    std::uint32_t slot = getSlot(node);
+    translations[slot] = translation;
+    markDirty(slot);
+}
+
+void TransformHierarchy::setRotation(NodeId node, const glm::quat& rotation) {
+    std::uint32_t slot = getSlot(node);
+    rotations[slot] = glm::normalize(rotation);
+    markDirty(slot);
+}
+
+void TransformHierarchy::setScale(NodeId node, const glm::vec3& scale) {
+    std::uint32_t slot = getSlot(node);
+    scales[slot] = scale;
+    markDirty(slot);
+}
+
+void TransformHierarchy::setLocalTransform(NodeId node, const glm::vec3& translation,
+                                           const glm::quat& rotation, const glm::vec3& scale) {
+    std::uint32_t slot = getSlot(node);
+    translations[slot] = translation;
+    rotations[slot] = glm::normalize(rotation);
+    scales[slot] = scale;
+    markDirty(slot);
+}
+
+const glm::vec3& TransformHierarchy::getTranslation(NodeId node) const {
+    return translations[getSlot(node)];
+}
+
+const glm::quat& TransformHierarchy::getRotation(NodeId node) const {
+    return rotations[getSlot(node)];
+}
+
+const glm::vec3& TransformHierarchy::getScale(NodeId node) const {
+    return scales[getSlot(node)];
+}
+
+const glm::mat4& TransformHierarchy::getWorldMatrix(NodeId node) const {
+    return worldMatrices[getSlot(node)];
+}
+
+void TransformHierarchy::update() {
+    stats = Stats();
+    changedNodes.clear();
+    if (orderDirty) {
+        rebuildOrder();
+        stats.reordered = true;
+    }
+    stats.nodeCount = getNodeCount();
+    if (dirtySlots.empty()) {
+        return;
+    }
+
+    // 変更された位置を先頭から順に並べる（多い場合はフラグの走査の方が速い）
+    const std::size_t slotCount = slotNodes.size();
+    if (dirtySlots.size() * DIRTY_SCAN_RATIO > slotCount) {
+        dirtySlots.clear();
+        for (std::uint32_t slot = 0; slot < slotCount; ++slot) {
+            if (localDirty[slot]) {
+                dirtySlots.push_back(slot);
+            }
+        }
+    }
+    else {
+        std::sort(dirtySlots.begin(), dirtySlots.end());
+    }
+
+    // ローカル行列は変更されたノードの分だけまとめて合成する
+    TransformSystem::composeMatrices(translations.data(), rotations.data(), scales.data(),
+                                     dirtySlots.data(), dirtySlots.size(), localMatrices.data());
+    stats.composedLocals = dirtySlots.size();
+
+    // 変更されたノードの部分木を先頭から順に更新する（祖先の部分木に含まれるものは飛ばす）
+    std::uint32_t rangeEnd = 0;
+    for (std::uint32_t slot : dirtySlots) {
+        localDirty[slot] = 0;
+        if (slot < rangeEnd) {
+            continue;
+        }
+        rangeEnd = slot + subtreeSizes[slot];
+        TransformSystem::computeHierarchyWorldMatrices(parentSlots.data(), localMatrices.data(),
+                                                       worldMatrices.data(), slot, rangeEnd);
+        changedNodes.insert(changedNodes.end(), slotNodes.begin() + slot,
+                            slotNodes.begin() + rangeEnd);
+        ++stats.dirtySubtrees;
+    }
+    stats.updatedNodes = changedNodes.size();
+    dirtySlots.clear();
+}
+
+const std::vector<TransformHierarchy::NodeId>& TransformHierarchy::getChangedNodes() const {
+    return changedNodes;
+}
+
+std::size_t TransformHierarchy::getNodeCount() const {
+    return nodeSlots.size() - freeNodes.size();
+}
+
+const TransformHierarchy::Stats& TransformHierarchy::getStats() const {
+    return stats;
+}
+
+std::uint32_t TransformHierarchy::getSlot(NodeId node) const {
+    if (node >= nodeSlots.size() || nodeSlots[node] == NO_SLOT) {
+        throw std::runtime_error("TransformHierarchy: invalid node " + std::to_string(node));
+    }
+    return nodeSlots[node];
+}
+
+void TransformHierarchy::markDirty(std::uint32_t slot) {
+    if (!localDirty[slot]) {
+        localDirty[slot] = 1;
+        dirtySlots.push_back(slot);
+    }
+}
+
+void TransformHierarchy::rebuildOrder() {
+    // 子の一覧（CSR形式）を現在の並び順で作る
+    const std::size_t nodeCount = nodeSlots.size();
+    std::vector<std::uint32_t> childOffsets(nodeCount + 1, 0);
+    std::vector<NodeId> roots;
+    for (NodeId node : slotNodes) {
+        if (node == INVALID_NODE) {
+            continue;
+        }
+        if (nodeParents[node] == INVALID_NODE) {
+            roots.push_back(node);
+        }
+        else {
+            ++childOffsets[nodeParents[node] + 1];
+        }
+    }
+    for (std::size_t i = 0; i < nodeCount; ++i) {
+        childOffsets[i + 1] += childOffsets[i];
+    }
+    std::vector<NodeId> children(childOffsets[nodeCount]);
+    std::vector<std::uint32_t> childCursor(childOffsets.begin(), childOffsets.end() - 1);
+    for (NodeId node : slotNodes) {
+        if (node != INVALID_NODE && nodeParents[node] != INVALID_NODE) {
+            children[childCursor[nodeParents[node]]++] = node;
+        }
+    }
+
+    // ルートごとに深さ優先の行きがけ順で新しい並びを決める
+    std::vector<NodeId> order;
+    order.reserve(getNodeCount());
+    std::vector<NodeId> stack;
+    for (NodeId root : roots) {
+        stack.push_back(root);
+        while (!stack.empty()) {
+            NodeId node = stack.back();
+            stack.pop_back();
+            order.push_back(node);
+            // 子を元の順で取り出すため逆順に積む
+            for (std::uint32_t c = childOffsets[node + 1]; c > childOffsets[node]; --c) {
+                stack.push_back(children[c - 1]);
+            }
+        }
+    }
+
+    // 配列を新しい並びに移す
+    const std::size_t count = order.size();
+    std::vector<glm::vec3> newTranslations(count);
+    std::vector<glm::quat> newRotations(count);
+    std::vector<glm::vec3> newScales(count);
+    std::vector<glm::mat4> newLocals(count);
+    std::vector<glm::mat4> newWorlds(count);
+    std::vector<std::uint8_t> newDirty(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint32_t oldSlot = nodeSlots[order[i]];
+        newTranslations[i] = translations[oldSlot];
+        newRotations[i] = rotations[oldSlot];
+        newScales[i] = scales[oldSlot];
+        newLocals[i] = localMatrices[oldSlot];
+        newWorlds[i] = worldMatrices[oldSlot];
+        newDirty[i] = localDirty[oldSlot];
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        nodeSlots[order[i]] = static_cast<std::uint32_t>(i);
+    }
+    translations.swap(newTranslations);
+    rotations.swap(newRotations);
+    scales.swap(newScales);
+    localMatrices.swap(newLocals);
+    worldMatrices.swap(newWorlds);
+    localDirty.swap(newDirty);
+    slotNodes.swap(order);
+
+    // 親の位置と部分木の大きさ（子は親より後にあるので末尾から加算する）
+    parentSlots.resize(count);
+    subtreeSizes.assign(count, 1);
+    for (std::size_t i = 0; i < count; ++i) {
+        NodeId parent = nodeParents[slotNodes[i]];
+        parentSlots[i] = parent == INVALID_NODE ? NO_SLOT : nodeSlots[parent];
+    }
+    for (std::size_t i = count; i-- > 0;) {
+        if (parentSlots[i] != NO_SLOT) {
+            subtreeSizes[parentSlots[i]] += subtreeSizes[i];
+        }
+    }
+
+    dirtySlots.clear();
+    for (std::uint32_t slot = 0; slot < count; ++slot) {
+        if (localDirty[slot]) {
+            dirtySlots.push_back(slot);
+        }
+    }
+    orderDirty = false;
+}
+
+} // namespace claude_gl
@@ -0,0 +1,350 @@
+#include "renderer/transform_system.h"
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CLAUDE_GL_TRANSFORM_SSE
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define CLAUDE_GL_TRANSFORM_NEON
+#endif
+
+namespace claude_gl {
+
+namespace {
+
+#if defined(CLAUDE_GL_TRANSFORM_SSE) || defined(CLAUDE_GL_TRANSFORM_NEON)
+
+// 4レーンのfloat演算（計算の本体はSSEとNEONで共通にする）
+#if defined(CLAUDE_GL_TRANSFORM_SSE)
+using Float4 = __m128;
+
+inline Float4 load4(const float* p) { return _mm_loadu_ps(p); }
+inline void store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 zero4() { return _mm_setzero_ps(); }
+inline Float4 splat4(float v) { return _mm_set1_ps(v); }
+inline Float4 set4(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+
+/**
+ * @brief xyz の3成分のみ書き込む（後続のデータを壊さない）
+ */
+inline void store3(float* p, Float4 v) {
+    _mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+    _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+}
+
+template <int Lane>
+inline Float4 broadcast(Float4 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+}
+
+/**
+ * @brief 各レーンの逆数を求める（0のレーンは1にする）
+ */
+inline Float4 reciprocalOrOne(Float4 v) {
+    const Float4 one = _mm_set1_ps(1.0f);
+    Float4 isZero = _mm_cmpeq_ps(v, _mm_setzero_ps());
+    return _mm_or_ps(_mm_and_ps(isZero, one), _mm_andnot_ps(isZero, _mm_div_ps(one, v)));
+}
+
+inline void transpose4(Float4& a, Float4& b, Float4& c, Float4& d) {
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+}
+#else
+using Float4 = float32x4_t;
+
+inline Float4 load4(const float* p) { return vld1q_f32(p); }
+inline void store4(float* p, Float4 v) { vst1q_f32(p, v); }
+inline Float4 add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 zero4() { return vdupq_n_f32(0.0f); }
+inline Float4 splat4(float v) { return vdupq_n_f32(v); }
+
+inline Float4 set4(float a, float b, float c, float d) {
+    const float values[4] = {a, b, c, d};
+    return vld1q_f32(values);
+}
+
+/**
+ * @brief xyz の3成分のみ書き込む（後続のデータを壊さない）
+ */
+inline void store3(float* p, Float4 v) {
+    vst1_f32(p, vget_low_f32(v));
+    vst1q_lane_f32(p + 2, v, 2);
+}
+
+template <int Lane>
+inline Float4 broadcast(Float4 v) {
+    return vdupq_laneq_f32(v, Lane);
+}
+
+/**
+ * @brief 各レーンの逆数を求める（0のレーンは1にする）
+ */
+inline Float4 reciprocalOrOne(Float4 v) {
+    const Float4 one = vdupq_n_f32(1.0f);
+    uint32x4_t isZero = vceqq_f32(v, vdupq_n_f32(0.0f));
+    return vbslq_f32(isZero, one, vdivq_f32(one, v));
+}
+
+inline void transpose4(Float4& a, Float4& b, Float4& c, Float4& d) {
+    float32x4x2_t ab = vtrnq_f32(a, b);
+    float32x4x2_t cd = vtrnq_f32(c, d);
+    a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+    b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+    c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+    d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+}
+#endif
+
+/**
+ * @brief 列優先の4x4行列の積を求める（out = a * b、glm と同じ演算順）
+ *
+ * out は a や b と同じでもよい（全列を計算してから書き込む）
+ */
+inline void multiply4x4(const float* a, const float* b, float* out) {
+    const Float4 a0 = load4(a), a1 = load4(a + 4), a2 = load4(a + 8), a3 = load4(a + 12);
+    Float4 result[4];
+    for (int c = 0; c < 4; ++c) {
+        // 結果の列 = a の列を b の列の各成分で重み付けした和
+        Float4 column = load4(b + c * 4);
+        result[c] = add(add(add(mul(a0, broadcast<0>(column)), mul(a1, broadcast<1>(column))),
+                            mul(a2, broadcast<2>(column))),
+                        mul(a3, broadcast<3>(column)));
+    }
+    for (int c = 0; c < 4; ++c) {
+        store4(out + c * 4, result[c]);
+    }
+}
+
+// composeMatrices4 はクォータニオンを (x, y, z, w) の順に並んだ float 4つとして読み込む。
+// GLM_FORCE_QUAT_DATA_WXYZ を定義すると w が先頭になり、成分を取り違えるためここで弾く
+static_assert(sizeof(glm::quat) == 4 * sizeof(float), "glm::quat must be four packed floats");
+static_assert(offsetof(glm::quat, x) == 0 && offsetof(glm::quat, w) == 3 * sizeof(float),
+              "glm::quat must be stored as x, y, z, w (GLM_FORCE_QUAT_DATA_WXYZ is unsupported)");
+
+/**
+ * @brief 4要素の平行移動・回転・拡大縮小から行列を同時に合成する
+ */
+inline void composeMatrices4(const glm::vec3* translations, const glm::quat* rotations,
+                             const glm::vec3* scales, const std::uint32_t* indices,
+                             glm::mat4* matrices) {
+    const std::uint32_t i0 = indices[0], i1 = indices[1], i2 = indices[2], i3 = indices[3];
+
+    // クォータニオン（x, y, z, w）は16バイトなのでそのまま読み込んで転置する
+    Float4 qx = load4(&rotations[i0].x), qy = load4(&rotations[i1].x);
+    Float4 qz = load4(&rotations[i2].x), qw = load4(&rotations[i3].x);
+    transpose4(qx, qy, qz, qw);
+    Float4 sx = set4(scales[i0].x, scales[i1].x, scales[i2].x, scales[i3].x);
+    Float4 sy = set4(scales[i0].y, scales[i1].y, scales[i2].y, scales[i3].y);
+    Float4 sz = set4(scales[i0].z, scales[i1].z, scales[i2].z, scales[i3].z);
+
+    // 回転行列（composeMatrix と同じ演算順）に拡大縮小を掛ける
+    const Float4 one = splat4(1.0f);
+    const Float4 two = splat4(2.0f);
+    Float4 xx = mul(qx, qx), yy = mul(qy, qy), zz = mul(qz, qz);
+    Float4 xy = mul(qx, qy), xz = mul(qx, qz), yz = mul(qy, qz);
+    Float4 wx = mul(qw, qx), wy = mul(qw, qy), wz = mul(qw, qz);
+    Float4 columns[4][4] = {
+        {mul(sub(one, mul(two, add(yy, zz))), sx), mul(mul(two, add(xy, wz)), sx),
+         mul(mul(two, sub(xz, wy)), sx), zero4()},
+        {mul(mul(two, sub(xy, wz)), sy), mul(sub(one, mul(two, add(xx, zz))), sy),
+         mul(mul(two, add(yz, wx)), sy), zero4()},
+        {mul(mul(two, add(xz, wy)), sz), mul(mul(two, sub(yz, wx)), sz),
+         mul(sub(one, mul(two, add(xx, yy))), sz), zero4()},
+        {set4(translations[i0].x, translations[i1].x, translations[i2].x, translations[i3].x),
+         set4(translations[i0].y, translations[i1].y, translations[i2].y, translations[i3].y),
+         set4(translations[i0].z, translations[i1].z, translations[i2].z, translations[i3].z),
+         one},
+    };
+
+    // 行列ごとの並びに戻して書き込む
+    for (Float4* column : columns) {
+        transpose4(column[0], column[1], column[2], column[3]);
+    }
+    float* outputs[4] = {&matrices[i0][0][0], &matrices[i1][0][0], &matrices[i2][0][0],
+                         &matrices[i3][0][0]};
+    for (int m = 0; m < 4; ++m) {
+        for (int c = 0; c < 4; ++c) {
+            store4(outputs[m] + c * 4, columns[c][m]);
+        }
+    }
+}
+
+/**
+ * @brief 成分ごとに並べた4本のベクトルの外積（glm::cross と同じ演算順）
+ */
+inline void cross4(Float4 ax, Float4 ay, Float4 az, Float4 bx, Float4 by, Float4 bz,
+                   Float4& rx, Float4& ry, Float4& rz) {
+    rx = sub(mul(ay, bz), mul(by, az));
+    ry = sub(mul(az, bx), mul(bz, ax));
+    rz = sub(mul(ax, by), mul(bx, ay));
+}
+
+/**
+ * @brief 4つのワールド行列の法線行列を同時に計算する
+ */
+inline void computeNormalMatrices4(const float* const worlds[4], float* const normals[4]) {
+    // 各行列の列0〜2を読み込み、行列をレーンとする成分ごとの並びに転置する
+    Float4 x0 = load4(worlds[0]), y0 = load4(worlds[1]), z0 = load4(worlds[2]);
+    Float4 w0 = load4(worlds[3]);
+    transpose4(x0, y0, z0, w0);
+    Float4 x1 = load4(worlds[0] + 4), y1 = load4(worlds[1] + 4), z1 = load4(worlds[2] + 4);
+    Float4 w1 = load4(worlds[3] + 4);
+    transpose4(x1, y1, z1, w1);
+    Float4 x2 = load4(worlds[0] + 8), y2 = load4(worlds[1] + 8), z2 = load4(worlds[2] + 8);
+    Float4 w2 = load4(worlds[3] + 8);
+    transpose4(x2, y2, z2, w2);
+
+    // 余因子（列の外積）と行列式
+    Float4 n0x, n0y, n0z, n1x, n1y, n1z, n2x, n2y, n2z;
+    cross4(x1, y1, z1, x2, y2, z2, n0x, n0y, n0z);
+    cross4(x2, y2, z2, x0, y0, z0, n1x, n1y, n1z);
+    cross4(x0, y0, z0, x1, y1, z1, n2x, n2y, n2z);
+    Float4 determinant = add(add(mul(x0, n0x), mul(y0, n0y)), mul(z0, n0z));
+    Float4 scale = reciprocalOrOne(determinant);
+
+    // 行列ごとの並びに戻して書き込む（w成分は0で埋める）
+    Float4 columns[3][4] = {
+        {mul(n0x, scale), mul(n0y, scale), mul(n0z, scale), zero4()},
+        {mul(n1x, scale), mul(n1y, scale), mul(n1z, scale), zero4()},
+        {mul(n2x, scale), mul(n2y, scale), mul(n2z, scale), zero4()},
+    };
+    for (Float4* column : columns) {
+        transpose4(column[0], column[1], column[2], column[3]);
+    }
+    for (int m = 0; m < 4; ++m) {
+        store3(normals[m], columns[0][m]);
+        store3(normals[m] + 3, columns[1][m]);
+        store3(normals[m] + 6, columns[2][m]);
+    }
+}
+
+#endif
+
+} // namespace
+
+void TransformSystem::computeWorldMatrices(const glm::mat4& parent, const glm::mat4* locals,
+                                           glm::mat4* worlds, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+#if defined(CLAUDE_GL_TRANSFORM_SSE) || defined(CLAUDE_GL_TRANSFORM_NEON)
+        multiply4x4(&parent[0][0], &locals[i][0][0], &worlds[i][0][0]);
+#else
+        worlds[i] = parent * locals[i];
+#endif
+    }
+}
+
+void TransformSystem::computeHierarchyWorldMatrices(const std::uint32_t* parents,
+                                                    const glm::mat4* locals, glm::mat4* worlds,
+                                                    std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        std::uint32_t parent = parents[i];
+        if (parent == NO_PARENT) {
+            worlds[i] = locals[i];
+            continue;
+        }
+#if defined(CLAUDE_GL_TRANSFORM_SSE) || defined(CLAUDE_GL_TRANSFORM_NEON)
+        multiply4x4(&worlds[parent][0][0], &locals[i][0][0], &worlds[i][0][0]);
+#else
+        worlds[i] = worlds[parent] * locals[i];
+#endif
+    }
+}
+
+void TransformSystem::composeMatrices(const glm::vec3* translations, const glm::quat* rotations,
+                                      const glm::vec3* scales, const std::uint32_t* indices,
+                                      std::size_t count, glm::mat4* matrices) {
+    std::size_t i = 0;
+#if defined(CLAUDE_GL_TRANSFORM_SSE) || defined(CLAUDE_GL_TRANSFORM_NEON)
+    for (; i + 4 <= count; i += 4) {
+        composeMatrices4(translations, rotations, scales, indices + i, matrices);
+    }
+#endif
+    for (; i < count; ++i) {
+        std::uint32_t index = indices[i];
+        matrices[index] = composeMatrix(translations[index], rotations[index], scales[index]);
+    }
+}
+
+glm::mat4 TransformSystem::composeMatrix(const glm::vec3& translation, const glm::quat& rotation,
+                                         const glm::vec3& scale) {
+    float xx = rotation.x * rotation.x, yy = rotation.y * rotation.y;
+    float zz = rotation.z * rotation.z;
+    float xy = rotation.x * rotation.y, xz = rotation.x * rotation.z;
+    float yz = rotation.y * rotation.z;
+    float wx = rotation.w * rotation.x, wy = rotation.w * rotation.y;
+    float wz = rotation.w * rotation.z;
+
+    glm::mat4 result;
+    result[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * scale.x, (2.0f * (xy + wz)) * scale.x,
+                          (2.0f * (xz - wy)) * scale.x, 0.0f);
+    result[1] = glm::vec4((2.0f * (xy - wz)) * scale.y, (1.0f - 2.0f * (xx + zz)) * scale.y,
+                          (2.0f * (yz + wx)) * scale.y, 0.0f);
+    result[2] = glm::vec4((2.0f * (xz + wy)) * scale.z, (2.0f * (yz - wx)) * scale.z,
+                          (1.0f - 2.0f * (xx + yy)) * scale.z, 0.0f);
+    result[3] = glm::vec4(translation, 1.0f);
+    return result;
+}
+
+void TransformSystem::computeNormalMatrices(const glm::mat4* worlds, std::size_t worldStride,
+                                            glm::mat3* normals, std::size_t normalStride,
+                                            std::size_t count) {
+    const unsigned char* worldBytes = reinterpret_cast<const unsigned char*>(worlds);
+    unsigned char* normalBytes = reinterpret_cast<unsigned char*>(normals);
+    std::size_t i = 0;
+
+#if defined(CLAUDE_GL_TRANSFORM_SSE) || defined(CLAUDE_GL_TRANSFORM_NEON)
+    for (; i + 4 <= count; i += 4) {
+        const float* worldPointers[4];
+        float* normalPointers[4];
+        for (int m = 0; m < 4; ++m) {
+            worldPointers[m] = reinterpret_cast<const float*>(worldBytes + (i + m) * worldStride);
+            normalPointers[m] = reinterpret_cast<float*>(normalBytes + (i + m) * normalStride);
+        }
+        computeNormalMatrices4(worldPointers, normalPointers);
+    }
+#endif
+
+    // 4つに満たない残り（スカラー版は全体）
+    for (; i < count; ++i) {
+        const glm::mat4& world =
+            *reinterpret_cast<const glm::mat4*>(worldBytes + i * worldStride);
+        *reinterpret_cast<glm::mat3*>(normalBytes + i * normalStride) = computeNormalMatrix(world);
+    }
+}
+
+void TransformSystem::computeNormalMatrices(const glm::mat4* worlds, glm::mat3* normals,
+                                            std::size_t count) {
+    computeNormalMatrices(worlds, sizeof(glm::mat4), normals, sizeof(glm::mat3), count);
+}
+
+glm::mat3 TransformSystem::computeNormalMatrix(const glm::mat4& world) {
+    glm::vec3 c0(world[0]);
+    glm::vec3 c1(world[1]);
+    glm::vec3 c2(world[2]);
+
+    // 逆転置の各列は残りの2列の外積を行列式で割ったもの
+    glm::mat3 cofactor(glm::cross(c1, c2), glm::cross(c2, c0), glm::cross(c0, c1));
+    float determinant = glm::dot(c0, cofactor[0]);
+    if (determinant == 0.0f) {
+        return cofactor;
+    }
+    return cofactor * (1.0f / determinant);
+}
+
+const char* TransformSystem::getInstructionSet() {
+#if defined(CLAUDE_GL_TRANSFORM_SSE)
+    return "SSE";
+#elif defined(CLAUDE_GL_TRANSFORM_NEON)
+    return "NEON";
+#else
+    return "Scalar";
+#endif
+}
+
+} // namespace claude_gl
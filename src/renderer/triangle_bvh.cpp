@@ -0,0 +1,614 @@
+#include "renderer/triangle_bvh.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CLAUDE_GL_RAY_SSE
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define CLAUDE_GL_RAY_NEON
+#endif
+
+namespace claude_gl {
+
+namespace {
+
+using Node = TriangleBvh::Node;
+using TrianglePacket = TriangleBvh::TrianglePacket;
+
+static_assert(sizeof(Node) == 32, "TriangleBvh::Node must be 32 bytes");
+
+constexpr int SAH_BIN_COUNT = 16;  ///< SAH構築で1軸あたりに使うビン数
+constexpr int SAH_DEPTH_LIMIT = 96;  ///< これより深いノードは重心の中央値で分割する
+// 中央値で分割すると32段以内に葉に達するため、走査スタックは深さの上限分あれば足りる
+constexpr int TRAVERSAL_STACK_SIZE = SAH_DEPTH_LIMIT + 33;
+
+/**
+ * @brief 走査中に繰り返し使うレイの情報
+ */
+struct RayData {
+    glm::vec3 origin;
+    glm::vec3 direction;
+    glm::vec3 inverseDirection;
+#if defined(CLAUDE_GL_RAY_SSE)
+    __m128 originXyz;         ///< 始点（wは0）
+    __m128 inverseXyz;        ///< 方向の逆数（wは0）
+    __m128 xyzMask;           ///< xyzレーンのみ全ビット1
+#elif defined(CLAUDE_GL_RAY_NEON)
+    float32x4_t originXyz;
+    float32x4_t inverseXyz;
+    uint32x4_t xyzMask;
+#endif
+
+    RayData(const glm::vec3& rayOrigin, const glm::vec3& rayDirection)
+        : origin(rayOrigin), direction(rayDirection),
+          inverseDirection(1.0f / rayDirection) {
+#if defined(CLAUDE_GL_RAY_SSE)
+        originXyz = _mm_setr_ps(origin.x, origin.y, origin.z, 0.0f);
+        inverseXyz = _mm_setr_ps(inverseDirection.x, inverseDirection.y, inverseDirection.z, 0.0f);
+        xyzMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+#elif defined(CLAUDE_GL_RAY_NEON)
+        const float originValues[4] = {origin.x, origin.y, origin.z, 0.0f};
+        const float inverseValues[4] = {inverseDirection.x, inverseDirection.y,
+                                        inverseDirection.z, 0.0f};
+        const std::uint32_t maskValues[4] = {0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu, 0u};
+        originXyz = vld1q_f32(originValues);
+        inverseXyz = vld1q_f32(inverseValues);
+        xyzMask = vld1q_u32(maskValues);
+#endif
+    }
+};
+
+#if defined(CLAUDE_GL_RAY_SSE)
+
+/**
+ * @brief ノードのボックスとの交差区間の入口を求める（SSE、xyzの3軸を同時に計算）
+ * @return 区間 [0, maxDistance] で交差する場合は入口の距離、しなければ無限大
+ */
+inline float intersectBox(const Node& node, const RayData& ray, float maxDistance) {
+    // wレーンには leftFirst / triangleCount が読み込まれるが、後でマスクする
+    __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&node.boundsMin.x), ray.originXyz),
+                           ray.inverseXyz);
+    __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&node.boundsMax.x), ray.originXyz),
+                           ray.inverseXyz);
+    __m128 tNear = _mm_and_ps(_mm_min_ps(t0, t1), ray.xyzMask);  // w = 0（レイの始点）
+    __m128 tFar = _mm_or_ps(_mm_and_ps(_mm_max_ps(t0, t1), ray.xyzMask),
+                            _mm_andnot_ps(ray.xyzMask, _mm_set1_ps(maxDistance)));
+
+    __m128 entry = _mm_max_ps(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(2, 3, 0, 1)));
+    entry = _mm_max_ps(entry, _mm_shuffle_ps(entry, entry, _MM_SHUFFLE(1, 0, 3, 2)));
+    __m128 exit = _mm_min_ps(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(2, 3, 0, 1)));
+    exit = _mm_min_ps(exit, _mm_shuffle_ps(exit, exit, _MM_SHUFFLE(1, 0, 3, 2)));
+
+    float entryDistance = _mm_cvtss_f32(entry);
+    return entryDistance <= _mm_cvtss_f32(exit) ? entryDistance : INFINITY;
+}
+
+/**
+ * @brief 4三角形とレイの交差を同時に判定する（SSE、Möller-Trumbore法）
+ * @param distances 各レーンの交差距離の出力先
+ * @param us 各レーンの重心座標uの出力先
+ * @param vs 各レーンの重心座標vの出力先
+ * @return maxDistance より手前で交差したレーンのビットマスク
+ */
+inline int intersectPacket(const TrianglePacket& packet, const RayData& ray, float maxDistance,
+                           float distances[4], float us[4], float vs[4]) {
+    const __m128 dx = _mm_set1_ps(ray.direction.x);
+    const __m128 dy = _mm_set1_ps(ray.direction.y);
+    const __m128 dz = _mm_set1_ps(ray.direction.z);
+    const __m128 e1x = _mm_load_ps(packet.edge1x);
+    const __m128 e1y = _mm_load_ps(packet.edge1y);
+    const __m128 e1z = _mm_load_ps(packet.edge1z);
+    const __m128 e2x = _mm_load_ps(packet.edge2x);
+    const __m128 e2y = _mm_load_ps(packet.edge2y);
+    const __m128 e2z = _mm_load_ps(packet.edge2z);
+
+    // p = d × e2、det = e1・p
+    __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)),
+                            _mm_mul_ps(e1z, pz));
+    __m128 inverseDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+    // s = o - v0、u = (s・p) / det
+    __m128 sx = _mm_sub_ps(_mm_set1_ps(ray.origin.x), _mm_load_ps(packet.v0x));
+    __m128 sy = _mm_sub_ps(_mm_set1_ps(ray.origin.y), _mm_load_ps(packet.v0y));
+    __m128 sz = _mm_sub_ps(_mm_set1_ps(ray.origin.z), _mm_load_ps(packet.v0z));
+    __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)),
+                                     _mm_mul_ps(sz, pz)), inverseDet);
+
+    // q = s × e1、v = (d・q) / det、t = (e2・q) / det
+    __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+    __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+    __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+    __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)),
+                                     _mm_mul_ps(dz, qz)), inverseDet);
+    __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)),
+                                     _mm_mul_ps(e2z, qz)), inverseDet);
+
+    const __m128 zero = _mm_setzero_ps();
+    __m128 hit = _mm_cmpneq_ps(det, zero);
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(t, zero));
+    hit = _mm_and_ps(hit, _mm_cmplt_ps(t, _mm_set1_ps(maxDistance)));
+
+    _mm_storeu_ps(distances, t);
+    _mm_storeu_ps(us, u);
+    _mm_storeu_ps(vs, v);
+    return _mm_movemask_ps(hit);
+}
+
+#elif defined(CLAUDE_GL_RAY_NEON)
+
+/**
+ * @brief ノードのボックスとの交差区間の入口を求める（NEON、xyzの3軸を同時に計算）
+ * @return 区間 [0, maxDistance] で交差する場合は入口の距離、しなければ無限大
+ */
+inline float intersectBox(const Node& node, const RayData& ray, float maxDistance) {
+    float32x4_t t0 = vmulq_f32(vsubq_f32(vld1q_f32(&node.boundsMin.x), ray.originXyz),
+                               ray.inverseXyz);
+    float32x4_t t1 = vmulq_f32(vsubq_f32(vld1q_f32(&node.boundsMax.x), ray.originXyz),
+                               ray.inverseXyz);
+    float32x4_t tNear = vbslq_f32(ray.xyzMask, vminnmq_f32(t0, t1), vdupq_n_f32(0.0f));
+    float32x4_t tFar = vbslq_f32(ray.xyzMask, vmaxnmq_f32(t0, t1), vdupq_n_f32(maxDistance));
+
+    float entryDistance = vmaxvq_f32(tNear);
+    return entryDistance <= vminvq_f32(tFar) ? entryDistance : INFINITY;
+}
+
+/**
+ * @brief 4三角形とレイの交差を同時に判定する（NEON、Möller-Trumbore法）
+ * @param distances 各レーンの交差距離の出力先
+ * @param us 各レーンの重心座標uの出力先
+ * @param vs 各レーンの重心座標vの出力先
+ * @return maxDistance より手前で交差したレーンのビットマスク
+ */
+inline int intersectPacket(const TrianglePacket& packet, const RayData& ray, float maxDistance,
+                           float distances[4], float us[4], float vs[4]) {
+    const float32x4_t dx = vdupq_n_f32(ray.direction.x);
+    const float32x4_t dy = vdupq_n_f32(ray.direction.y);
+    const float32x4_t dz = vdupq_n_f32(ray.direction.z);
+    const float32x4_t e1x = vld1q_f32(packet.edge1x);
+    const float32x4_t e1y = vld1q_f32(packet.edge1y);
+    const float32x4_t e1z = vld1q_f32(packet.edge1z);
+    const float32x4_t e2x = vld1q_f32(packet.edge2x);
+    const float32x4_t e2y = vld1q_f32(packet.edge2y);
+    const float32x4_t e2z = vld1q_f32(packet.edge2z);
+
+    // p = d × e2、det = e1・p
+    float32x4_t px = vsubq_f32(vmulq_f32(dy, e2z), vmulq_f32(dz, e2y));
+    float32x4_t py = vsubq_f32(vmulq_f32(dz, e2x), vmulq_f32(dx, e2z));
+    float32x4_t pz = vsubq_f32(vmulq_f32(dx, e2y), vmulq_f32(dy, e2x));
+    float32x4_t det = vaddq_f32(vaddq_f32(vmulq_f32(e1x, px), vmulq_f32(e1y, py)),
+                                vmulq_f32(e1z, pz));
+    float32x4_t inverseDet = vdivq_f32(vdupq_n_f32(1.0f), det);
+
+    // s = o - v0、u = (s・p) / det
+    float32x4_t sx = vsubq_f32(vdupq_n_f32(ray.origin.x), vld1q_f32(packet.v0x));
+    float32x4_t sy = vsubq_f32(vdupq_n_f32(ray.origin.y), vld1q_f32(packet.v0y));
+    float32x4_t sz = vsubq_f32(vdupq_n_f32(ray.origin.z), vld1q_f32(packet.v0z));
+    float32x4_t u = vmulq_f32(vaddq_f32(vaddq_f32(vmulq_f32(sx, px), vmulq_f32(sy, py)),
+                                        vmulq_f32(sz, pz)), inverseDet);
+
+    // q = s × e1、v = (d・q) / det、t = (e2・q) / det
+    float32x4_t qx = vsubq_f32(vmulq_f32(sy, e1z), vmulq_f32(sz, e1y));
+    float32x4_t qy = vsubq_f32(vmulq_f32(sz, e1x), vmulq_f32(sx, e1z));
+    float32x4_t qz = vsubq_f32(vmulq_f32(sx, e1y), vmulq_f32(sy, e1x));
+    float32x4_t v = vmulq_f32(vaddq_f32(vaddq_f32(vmulq_f32(dx, qx), vmulq_f32(dy, qy)),
+                                        vmulq_f32(dz, qz)), inverseDet);
+    float32x4_t t = vmulq_f32(vaddq_f32(vaddq_f32(vmulq_f32(e2x, qx), vmulq_f32(e2y, qy)),
+                                        vmulq_f32(e2z, qz)), inverseDet);
+
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    uint32x4_t hit = vmvnq_u32(vceqq_f32(det, zero));
+    hit = vandq_u32(hit, vcgeq_f32(u, zero));
+    hit = vandq_u32(hit, vcgeq_f32(v, zero));
+    hit = vandq_u32(hit, vcleq_f32(vaddq_f32(u, v), vdupq_n_f32(1.0f)));
+    hit = vandq_u32(hit, vcgeq_f32(t, zero));
+    hit = vandq_u32(hit, vcltq_f32(t, vdupq_n_f32(maxDistance)));
+
+    vst1q_f32(distances, t);
+    vst1q_f32(us, u);
+    vst1q_f32(vs, v);
+    const std::uint32_t laneBits[4] = {1u, 2u, 4u, 8u};
+    return static_cast<int>(vaddvq_u32(vandq_u32(hit, vld1q_u32(laneBits))));
+}
+
+#else
+
+/**
+ * @brief ノードのボックスとの交差区間の入口を求める（スカラー）
+ * @return 区間 [0, maxDistance] で交差する場合は入口の距離、しなければ無限大
+ */
+inline float intersectBox(const Node& node, const RayData& ray, float maxDistance) {
+    glm::vec3 t0 = (node.boundsMin - ray.origin) * ray.inverseDirection;
+    glm::vec3 t1 = (node.boundsMax - ray.origin) * ray.inverseDirection;
+    glm::vec3 tNear = glm::min(t0, t1);
+    glm::vec3 tFar = glm::max(t0, t1);
+    float entry = std::fmax(std::fmax(tNear.x, tNear.y), std::fmax(tNear.z, 0.0f));
+    float exit = std::fmin(std::fmin(tFar.x, tFar.y), std::fmin(tFar.z, maxDistance));
+    return entry <= exit ? entry : INFINITY;
+}
+
+/**
+ * @brief 4三角形とレイの交差を1つずつ判定する（スカラー、Möller-Trumbore法）
+ * @param distances 各レーンの交差距離の出力先
+ * @param us 各レーンの重心座標uの出力先
+ * @param vs 各レーンの重心座標vの出力先
+ * @return maxDistance より手前で交差したレーンのビットマスク
+ */
+inline int intersectPacket(const TrianglePacket& packet, const RayData& ray, float maxDistance,
+                           float distances[4], float us[4], float vs[4]) {
+    const glm::vec3& d = ray.direction;
+    int mask = 0;
+    for (int lane = 0; lane < 4; ++lane) {
+        glm::vec3 e1(packet.edge1x[lane], packet.edge1y[lane], packet.edge1z[lane]);
+        glm::vec3 e2(packet.edge2x[lane], packet.edge2y[lane], packet.edge2z[lane]);
+        glm::vec3 p(d.y * e2.z - d.z * e2.y, d.z * e2.x - d.x * e2.z, d.x * e2.y - d.y * e2.x);
+        float det = e1.x * p.x + e1.y * p.y + e1.z * p.z;
+        float inverseDet = 1.0f / det;
+
+        glm::vec3 s = ray.origin - glm::vec3(packet.v0x[lane], packet.v0y[lane],
+                                             packet.v0z[lane]);
+        float u = (s.x * p.x + s.y * p.y + s.z * p.z) * inverseDet;
+        glm::vec3 q(s.y * e1.z - s.z * e1.y, s.z * e1.x - s.x * e1.z, s.x * e1.y - s.y * e1.x);
+        float v = (d.x * q.x + d.y * q.y + d.z * q.z) * inverseDet;
+        float t = (e2.x * q.x + e2.y * q.y + e2.z * q.z) * inverseDet;
+
+        distances[lane] = t;
+        us[lane] = u;
+        vs[lane] = v;
+        bool hit = det != 0.0f && u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f &&
+                   t < maxDistance;
+        mask |= hit ? (1 << lane) : 0;
+    }
+    return mask;
+}
+
+#endif
+
+/**
+ * @brief 木を手前から走査する
+ * @tparam ANY_HIT trueなら最初の交差で終了する
+ * @param maxDistance 検索する最大距離（交差するたびに縮める）
+ * @param hit 最も近い交差の出力先（ANY_HIT では未使用）
+ * @return 交差した場合はtrue
+ */
+template <bool ANY_HIT>
+bool traverse(const std::vector<Node>& nodes, const std::vector<TrianglePacket>& packets,
+              const RayData& ray, float maxDistance, TriangleBvh::Hit* hit) {
+    if (nodes.empty() || intersectBox(nodes[0], ray, maxDistance) == INFINITY) {
+        return false;
+    }
+
+    struct Entry {
+        std::uint32_t node;
+        float distance;  ///< ボックスの入口の距離
+    };
+    Entry stack[TRAVERSAL_STACK_SIZE];
+    int stackSize = 0;
+    std::uint32_t current = 0;
+    bool found = false;
+
+    while (true) {
+        const Node& node = nodes[current];
+        if (node.isLeaf()) {
+            float distances[4];
+            float us[4];
+            float vs[4];
+            int mask = intersectPacket(packets[node.leftFirst], ray, maxDistance, distances, us,
+                                       vs);
+            if (mask != 0) {
+                if (ANY_HIT) {
+                    return true;
+                }
+                for (int lane = 0; lane < 4; ++lane) {
+                    if ((mask & (1 << lane)) != 0 && distances[lane] < maxDistance) {
+                        maxDistance = distances[lane];
+                        hit->distance = distances[lane];
+                        hit->triangle = packets[node.leftFirst].triangle[lane];
+                        hit->u = us[lane];
+                        hit->v = vs[lane];
+                    }
+                }
+                found = true;
+            }
+        }
+        else {
+            // 近い子から調べ、遠い子は入口の距離とともに積む
+            std::uint32_t nearChild = node.leftFirst;
+            std::uint32_t farChild = node.leftFirst + 1;
+            float nearDistance = intersectBox(nodes[nearChild], ray, maxDistance);
+            float farDistance = intersectBox(nodes[farChild], ray, maxDistance);
+            if (farDistance < nearDistance) {
+                std::swap(nearChild, farChild);
+                std::swap(nearDistance, farDistance);
+            }
+            if (nearDistance != INFINITY) {
+                if (farDistance != INFINITY) {
+                    stack[stackSize++] = {farChild, farDistance};
+                }
+                current = nearChild;
+                continue;
+            }
+        }
+
+        // 積んだノードのうち、現在の最近交差より手前にあるものを取り出す
+        bool resumed = false;
+        while (stackSize > 0) {
+            const Entry& entry = stack[--stackSize];
+            if (entry.distance < maxDistance) {
+                current = entry.node;
+                resumed = true;
+                break;
+            }
+        }
+        if (!resumed) {
+            return found;
+        }
+    }
+}
+
+} // namespace
+
+void TriangleBvh::build(const glm::vec3* positions, std::size_t positionStride,
+                        std::size_t vertexCount, const unsigned int* indices,
+                        std::size_t indexCount) {
+    nodes.clear();
+    packets.clear();
+    triangleCount = 0;
+
+    if (indexCount % 3 != 0) {
+        throw std::runtime_error("TriangleBvh: index count " + std::to_string(indexCount) +
+                                 " is not a multiple of 3");
+    }
+
+    // 三角形ごとの境界と重心を求める
+    const auto* positionBytes = reinterpret_cast<const unsigned char*>(positions);
+    auto positionAt = [&](unsigned int index) {
+        return *reinterpret_cast<const glm::vec3*>(positionBytes + index * positionStride);
+    };
+
+    std::vector<BuildTriangle> triangles(indexCount / 3);
+    glm::vec3 boundsMin(INFINITY);
+    glm::vec3 boundsMax(-INFINITY);
+    for (std::size_t i = 0; i < triangles.size(); ++i) {
+        const unsigned int* triangle = indices + i * 3;
+        if (triangle[0] >= vertexCount || triangle[1] >= vertexCount ||
+            triangle[2] >= vertexCount) {
+            throw std::runtime_error("TriangleBvh: index out of range in triangle " +
+                                     std::to_string(i));
+        }
+        glm::vec3 a = positionAt(triangle[0]);
+        glm::vec3 b = positionAt(triangle[1]);
+        glm::vec3 c = positionAt(triangle[2]);
+
+        BuildTriangle& buildTriangle = triangles[i];
+        buildTriangle.boundsMin = glm::min(a, glm::min(b, c));
+        buildTriangle.boundsMax = glm::max(a, glm::max(b, c));
+        buildTriangle.centroid = (buildTriangle.boundsMin + buildTriangle.boundsMax) * 0.5f;
+        buildTriangle.index = static_cast<std::uint32_t>(i);
+        boundsMin = glm::min(boundsMin, buildTriangle.boundsMin);
+        boundsMax = glm::max(boundsMax, buildTriangle.boundsMax);
+    }
+    if (triangles.empty()) {
+        return;
+    }
+
+    // 二分木のノード数は葉の数の2倍未満、葉は三角形1〜4個
+    nodes.reserve(triangles.size());
+    packets.reserve(triangles.size() / 2 + 1);
+    nodes.push_back({boundsMin, 0, boundsMax, 0});
+    subdivide(0, triangles, 0, triangles.size(), 0, positionBytes, positionStride, indices);
+
+    triangleCount = triangles.size();
+    nodes.shrink_to_fit();
+    packets.shrink_to_fit();
+}
+
+bool TriangleBvh::intersect(const glm::vec3& origin, const glm::vec3& direction,
+                            float maxDistance, Hit& hit) const {
+    return traverse<false>(nodes, packets, RayData(origin, direction), maxDistance, &hit);
+}
+
+bool TriangleBvh::occluded(const glm::vec3& origin, const glm::vec3& direction,
+                           float maxDistance) const {
+    return traverse<true>(nodes, packets, RayData(origin, direction), maxDistance, nullptr);
+}
+
+bool TriangleBvh::empty() const {
+    return triangleCount == 0;
+}
+
+std::size_t TriangleBvh::getTriangleCount() const {
+    return triangleCount;
+}
+
+std::size_t TriangleBvh::getNodeCount() const {
+    return nodes.size();
+}
+
+std::size_t TriangleBvh::getMemoryBytes() const {
+    return nodes.size() * sizeof(Node) + packets.size() * sizeof(TrianglePacket);
+}
+
+const char* TriangleBvh::getInstructionSet() {
+#if defined(CLAUDE_GL_RAY_SSE)
+    return "SSE";
+#elif defined(CLAUDE_GL_RAY_NEON)
+    return "NEON";
+#else
+    return "Scalar";
+#endif
+}
+
+void TriangleBvh::subdivide(std::uint32_t nodeIndex, std::vector<BuildTriangle>& triangles,
+                            std::size_t begin, std::size_t end, int depth,
+                            const unsigned char* positions, std::size_t positionStride,
+                            const unsigned int* indices) {
+    const std::size_t count = end - begin;
+
+    // 葉: 三角形をパケットに詰める（空きレーンは退化三角形のまま）
+    if (count <= MAX_LEAF_TRIANGLES) {
+        TrianglePacket packet{};
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            std::uint32_t triangle = triangles[begin + lane].index;
+            const unsigned int* triangleIndices = indices + triangle * 3;
+            glm::vec3 vertex[3];
+            for (int corner = 0; corner < 3; ++corner) {
+                vertex[corner] = *reinterpret_cast<const glm::vec3*>(
+                    positions + triangleIndices[corner] * positionStride);
+            }
+            glm::vec3 edge1 = vertex[1] - vertex[0];
+            glm::vec3 edge2 = vertex[2] - vertex[0];
+            packet.v0x[lane] = vertex[0].x;
+            packet.v0y[lane] = vertex[0].y;
+            packet.v0z[lane] = vertex[0].z;
+            packet.edge1x[lane] = edge1.x;
+            packet.edge1y[lane] = edge1.y;
+            packet.edge1z[lane] = edge1.z;
+            packet.edge2x[lane] = edge2.x;
+            packet.edge2y[lane] = edge2.y;
+            packet.edge2z[lane] = edge2.z;
+            packet.triangle[lane] = triangle;
+        }
+        nodes[nodeIndex].leftFirst = static_cast<std::uint32_t>(packets.size());
+        nodes[nodeIndex].triangleCount = static_cast<std::uint32_t>(count);
+        packets.push_back(packet);
+        return;
+    }
+
+    // 重心の範囲を求める
+    glm::vec3 centroidMin(INFINITY);
+    glm::vec3 centroidMax(-INFINITY);
+    for (std::size_t i = begin; i < end; ++i) {
+        centroidMin = glm::min(centroidMin, triangles[i].centroid);
+        centroidMax = glm::max(centroidMax, triangles[i].centroid);
+    }
+    glm::vec3 centroidExtent = centroidMax - centroidMin;
+
+    // 3軸を1回の走査でビンに分け、SAHコストが最小になる分割を探す
+    int bestAxis = -1;
+    int bestSplit = 0;
+    if (depth < SAH_DEPTH_LIMIT) {
+        struct Bin {
+            glm::vec3 boundsMin = glm::vec3(INFINITY);
+            glm::vec3 boundsMax = glm::vec3(-INFINITY);
+            std::size_t count = 0;
+        };
+        Bin bins[3][SAH_BIN_COUNT];
+        glm::vec3 binScale;
+        for (int axis = 0; axis < 3; ++axis) {
+            binScale[axis] = centroidExtent[axis] > 0.0f ? SAH_BIN_COUNT / centroidExtent[axis]
+                                                         : 0.0f;
+        }
+        for (std::size_t i = begin; i < end; ++i) {
+            const BuildTriangle& triangle = triangles[i];
+            for (int axis = 0; axis < 3; ++axis) {
+                int bin = std::min(SAH_BIN_COUNT - 1, static_cast<int>(
+                    (triangle.centroid[axis] - centroidMin[axis]) * binScale[axis]));
+                Bin& target = bins[axis][bin];
+                target.boundsMin = glm::min(target.boundsMin, triangle.boundsMin);
+                target.boundsMax = glm::max(target.boundsMax, triangle.boundsMax);
+                ++target.count;
+            }
+        }
+
+        auto halfArea = [](const glm::vec3& size) {
+            return size.x * size.y + size.y * size.z + size.z * size.x;
+        };
+        float bestCost = INFINITY;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (binScale[axis] == 0.0f) {
+                continue;
+            }
+
+            // 右側からの累積表面積を先に求め、左側を累積しながら各分割位置を評価する
+            float rightAreas[SAH_BIN_COUNT];
+            std::size_t rightCounts[SAH_BIN_COUNT];
+            glm::vec3 rightMin(INFINITY);
+            glm::vec3 rightMax(-INFINITY);
+            std::size_t rightCount = 0;
+            for (int bin = SAH_BIN_COUNT - 1; bin > 0; --bin) {
+                rightMin = glm::min(rightMin, bins[axis][bin].boundsMin);
+                rightMax = glm::max(rightMax, bins[axis][bin].boundsMax);
+                rightCount += bins[axis][bin].count;
+                rightAreas[bin] = rightCount > 0 ? halfArea(rightMax - rightMin) : 0.0f;
+                rightCounts[bin] = rightCount;
+            }
+
+            glm::vec3 leftMin(INFINITY);
+            glm::vec3 leftMax(-INFINITY);
+            std::size_t leftCount = 0;
+            for (int split = 1; split < SAH_BIN_COUNT; ++split) {
+                leftMin = glm::min(leftMin, bins[axis][split - 1].boundsMin);
+                leftMax = glm::max(leftMax, bins[axis][split - 1].boundsMax);
+                leftCount += bins[axis][split - 1].count;
+                if (leftCount == 0 || rightCounts[split] == 0) {
+                    continue;
+                }
+                float cost = leftCount * halfArea(leftMax - leftMin) +
+                             rightCounts[split] * rightAreas[split];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = split;
+                }
+            }
+        }
+    }
+
+    auto first = triangles.begin() + static_cast<std::ptrdiff_t>(begin);
+    auto last = triangles.begin() + static_cast<std::ptrdiff_t>(end);
+    std::size_t middle;
+    if (bestAxis >= 0) {
+        float axisMin = centroidMin[bestAxis];
+        float binScale = SAH_BIN_COUNT / centroidExtent[bestAxis];
+        auto split = std::partition(first, last, [&](const BuildTriangle& triangle) {
+            int bin = std::min(SAH_BIN_COUNT - 1, static_cast<int>(
+                (triangle.centroid[bestAxis] - axisMin) * binScale));
+            return bin < bestSplit;
+        });
+        middle = static_cast<std::size_t>(split - triangles.begin());
+    }
+    else {
+        // 重心が一致する場合や深さの上限を超えた場合は、最も広い軸の中央値で分割する
+        int axis = centroidExtent.x >= centroidExtent.y ? 0 : 1;
+        axis = centroidExtent[axis] >= centroidExtent.z ? axis : 2;
+        middle = begin + count / 2;
+        std::nth_element(first, triangles.begin() + static_cast<std::ptrdiff_t>(middle), last,
+                         [axis](const BuildTriangle& a, const BuildTriangle& b) {
+                             return a.centroid[axis] < b.centroid[axis];
+                         });
+    }
+
+    // 子を隣接して確保し、それぞれの境界を求めてから再帰する
+    std::uint32_t leftChild = static_cast<std::uint32_t>(nodes.size());
+    nodes.emplace_back();
+    nodes.emplace_back();
+    nodes[nodeIndex].leftFirst = leftChild;
+    nodes[nodeIndex].triangleCount = 0;
+
+    const std::size_t ranges[2][2] = {{begin, middle}, {middle, end}};
+    for (int child = 0; child < 2; ++child) {
+        glm::vec3 childMin(INFINITY);
+        glm::vec3 childMax(-INFINITY);
+        for (std::size_t i = ranges[child][0]; i < ranges[child][1]; ++i) {
+            childMin = glm::min(childMin, triangles[i].boundsMin);
+            childMax = glm::max(childMax, triangles[i].boundsMax);
+        }
+        nodes[leftChild + child] = {childMin, 0, childMax, 0};
+    }
+    subdivide(leftChild, triangles, begin, middle, depth + 1, positions, positionStride, indices);
+    subdivide(leftChild + 1, triangles, middle, end, depth + 1, positions, positionStride,
+              indices);
+}
+
+} // namespace claude_gl
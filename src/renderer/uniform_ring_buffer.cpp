@@ -0,0 +1,79 @@
+#include "renderer/uniform_ring_buffer.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "renderer/gl_state_cache.h"
+
+namespace claude_gl {
+
+namespace {
+
+/**
+ * @brief 値をアラインメントの倍数に切り上げる
+ */
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+UniformRingBuffer::UniformRingBuffer(std::size_t frameCapacity, std::size_t frameCount)
+    : stream(alignUp(frameCapacity, queryAlignment()), frameCount),
+      alignment(queryAlignment()) {
+}
+
+void UniformRingBuffer::beginFrame() {
+    stream.beginFrame();
+    lastFrameStats = frameStats;
+    frameStats = Stats();
+}
+
+void UniformRingBuffer::endFrame() {
+    stream.endFrame();
+}
+
+UniformRingBuffer::Range UniformRingBuffer::push(const void* data, std::size_t size) {
+    StreamBuffer::Allocation allocation = stream.allocate(size, alignment);
+    std::memcpy(allocation.data, data, size);
+    ++frameStats.blocks;
+    frameStats.bytes += size;
+    return {allocation.offset, allocation.size};
+}
+
+void UniformRingBuffer::flush() {
+    stream.flush();
+}
+
+void UniformRingBuffer::bind(GLuint binding, const Range& range) {
+    if (range.offset < 0 || range.size <= 0) {
+        throw std::runtime_error("UniformRingBuffer: invalid range " +
+                                 std::to_string(range.offset));
+    }
+    GlStateCache::getInstance().bindBufferRange(GL_UNIFORM_BUFFER, binding, stream.getBuffer(),
+                                                range.offset, range.size);
+}
+
+std::size_t UniformRingBuffer::getFrameCapacity() const {
+    return stream.getRegionSize();
+}
+
+const UniformRingBuffer::Stats& UniformRingBuffer::getFrameStats() const {
+    return lastFrameStats;
+}
+
+const StreamBuffer::Stats& UniformRingBuffer::getStreamStats() const {
+    return stream.getStats();
+}
+
+bool UniformRingBuffer::isPersistent() const {
+    return stream.isPersistent();
+}
+
+std::size_t UniformRingBuffer::queryAlignment() {
+    GLint offsetAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    return static_cast<std::size_t>(std::max(offsetAlignment, 1));
+}
+
+} // namespace claude_gl
@@ -0,0 +1,50 @@
+#include "renderer/uniform_table.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace claude_gl {
+
+bool UniformTable::add(const std::string& name, std::int32_t location, std::uint32_t type,
+                       std::int32_t count) {
+    std::uint32_t hash = UniformName::hashName(name.c_str());
+    auto position = std::lower_bound(hashes.begin(), hashes.end(), hash);
+    std::size_t index = static_cast<std::size_t>(position - hashes.begin());
+    if (position != hashes.end() && *position == hash) {
+        // 同じ名前の再登録は上書きし、異なる名前の衝突は呼び出し側に知らせる
+        if (entries[index].name != name) {
+            return false;
+        }
+        entries[index] = {name, location, type, count};
+        return true;
+    }
+    hashes.insert(position, hash);
+    entries.insert(entries.begin() + static_cast<std::ptrdiff_t>(index),
+                   Entry{name, location, type, count});
+    return true;
+}
+
+void UniformTable::clear() {
+    hashes.clear();
+    entries.clear();
+}
+
+const UniformTable::Entry* UniformTable::find(std::uint32_t hash) const {
+    auto position = std::lower_bound(hashes.begin(), hashes.end(), hash);
+    if (position == hashes.end() || *position != hash) {
+        return nullptr;
+    }
+    return &entries[static_cast<std::size_t>(position - hashes.begin())];
+}
+
+std::size_t UniformTable::getCount() const {
+    return entries.size();
+}
+
+const UniformTable::Entry& UniformTable::getEntry(std::size_t index) const {
+    if (index >= entries.size()) {
+        throw std::runtime_error("UniformTable: invalid index " + std::to_string(index));
+    }
+    return entries[index];
+}
+
+} // namespace claude_gl
@@ -0,0 +1,331 @@
+#include "renderer/vertex_quantizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace claude_gl {
+
+namespace {
+
+// 16ビット符号なし正規化整数の最大値（位置）
+constexpr float UNORM16_MAX = 65535.0f;
+
+// 16ビット符号付き正規化整数の最大値（八面体法線）
+constexpr float SNORM16_MAX = 32767.0f;
+
+// 10ビット符号付き正規化整数の最大値（10_10_10_2法線）
+constexpr float SNORM10_MAX = 511.0f;
+
+/**
+ * @brief 単精度浮動小数点数を半精度に変換する（最近接偶数丸め）
+ */
+std::uint16_t floatToHalf(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    std::uint32_t sign = (bits >> 16) & 0x8000u;
+    std::uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+    if (magnitude >= 0x7F800000u) {
+        // 無限大とNaN
+        return static_cast<std::uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u));
+    }
+    if (magnitude >= 0x477FF000u) {
+        // 65520以上は半精度で表せないため無限大
+        return static_cast<std::uint16_t>(sign | 0x7C00u);
+    }
+    if (magnitude < 0x38800000u) {
+        // 半精度の非正規化数（2^-14未満）は2^-24単位に丸める
+        float absolute;
+        std::memcpy(&absolute, &magnitude, sizeof(absolute));
+        std::uint32_t half = static_cast<std::uint32_t>(std::nearbyint(absolute * 16777216.0f));
+        return static_cast<std::uint16_t>(sign | half);
+    }
+
+    // 指数のバイアスを127から15に付け替え、仮数の下位13ビットを最近接偶数で丸める
+    std::uint32_t half = magnitude - 0x38000000u;
+    half += 0x0FFFu + ((half >> 13) & 1u);
+    return static_cast<std::uint16_t>(sign | (half >> 13));
+}
+
+/**
+ * @brief 半精度浮動小数点数を単精度に変換する
+ */
+float halfToFloat(std::uint16_t half) {
+    std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000u) << 16;
+    std::uint32_t exponent = (half >> 10) & 0x1Fu;
+    std::uint32_t mantissa = half & 0x3FFu;
+
+    if (exponent == 0) {
+        float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign != 0 ? -magnitude : magnitude;
+    }
+
+    std::uint32_t bits = exponent == 0x1Fu
+        ? sign | 0x7F800000u | (mantissa << 13)
+        : sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief 16ビット符号付き正規化整数を復元する（GL 4.2以降の変換規則）
+ */
+float decodeSnorm16(std::int16_t value) {
+    return std::max(static_cast<float>(value) / SNORM16_MAX, -1.0f);
+}
+
+/**
+ * @brief 単位ベクトルを八面体マッピングで2次元に写す
+ */
+glm::vec2 octahedralProject(const glm::vec3& normal) {
+    float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (l1 == 0.0f) {
+        return glm::vec2(0.0f);
+    }
+    glm::vec2 p(normal.x / l1, normal.y / l1);
+    if (normal.z < 0.0f) {
+        // 下半球は対角線で折り返す
+        glm::vec2 folded(1.0f - std::abs(p.y), 1.0f - std::abs(p.x));
+        p.x = p.x >= 0.0f ? folded.x : -folded.x;
+        p.y = p.y >= 0.0f ? folded.y : -folded.y;
+    }
+    return p;
+}
+
+/**
+ * @brief 八面体マッピングの2次元座標から単位ベクトルを復元する（basic.vs と同じ処理）
+ */
+glm::vec3 octahedralDecode(float x, float y) {
+    glm::vec3 n(x, y, 1.0f - std::abs(x) - std::abs(y));
+    float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+/**
+ * @brief 法線を八面体マッピングの16ビット整数2つに変換する
+ *
+ * 切り上げ・切り捨ての4通りから、復元後の向きが最も近いものを選びます。
+ */
+void encodeOctahedral(const glm::vec3& normal, std::int16_t out[2]) {
+    glm::vec2 p = octahedralProject(normal) * SNORM16_MAX;
+    glm::vec3 target = glm::normalize(normal);
+
+    float bestDot = -2.0f;
+    for (int i = 0; i < 4; ++i) {
+        float qx = (i & 1) ? std::ceil(p.x) : std::floor(p.x);
+        float qy = (i & 2) ? std::ceil(p.y) : std::floor(p.y);
+        qx = std::clamp(qx, -SNORM16_MAX, SNORM16_MAX);
+        qy = std::clamp(qy, -SNORM16_MAX, SNORM16_MAX);
+        float d = glm::dot(octahedralDecode(qx / SNORM16_MAX, qy / SNORM16_MAX), target);
+        if (d > bestDot) {
+            bestDot = d;
+            out[0] = static_cast<std::int16_t>(qx);
+            out[1] = static_cast<std::int16_t>(qy);
+        }
+    }
+}
+
+/**
+ * @brief 法線を GL_INT_2_10_10_10_REV 形式に詰める（wは0）
+ */
+std::uint32_t packNormal1010102(const glm::vec3& normal) {
+    glm::vec3 n = glm::normalize(normal);
+    std::uint32_t packed = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        int q = static_cast<int>(std::lround(std::clamp(n[axis], -1.0f, 1.0f) * SNORM10_MAX));
+        packed |= (static_cast<std::uint32_t>(q) & 0x3FFu) << (axis * 10);
+    }
+    return packed;
+}
+
+/**
+ * @brief GL_INT_2_10_10_10_REV 形式の法線を復元する
+ */
+glm::vec3 unpackNormal1010102(std::uint32_t packed) {
+    glm::vec3 n;
+    for (int axis = 0; axis < 3; ++axis) {
+        // 10ビットの符号拡張
+        int q = static_cast<int>((packed >> (axis * 10)) & 0x3FFu);
+        q = q >= 512 ? q - 1024 : q;
+        n[axis] = std::max(static_cast<float>(q) / SNORM10_MAX, -1.0f);
+    }
+    return n;
+}
+
+/**
+ * @brief 2つのベクトルのなす角を度で求める（小さい角度でも精度が落ちない atan2 版）
+ */
+double angleDegrees(const glm::vec3& a, const glm::vec3& b) {
+    double ax = a.x, ay = a.y, az = a.z;
+    double bx = b.x, by = b.y, bz = b.z;
+    double cx = ay * bz - az * by;
+    double cy = az * bx - ax * bz;
+    double cz = ax * by - ay * bx;
+    double crossLength = std::sqrt(cx * cx + cy * cy + cz * cz);
+    double dot = ax * bx + ay * by + az * bz;
+    return std::atan2(crossLength, dot) * 180.0 / 3.14159265358979323846;
+}
+
+} // namespace
+
+double VertexQuantizer::Stats::savedRatio() const {
+    std::size_t before = sourceVertexBytes + sourceIndexBytes;
+    std::size_t after = vertexBytes + indexBytes;
+    return before > 0 ? 1.0 - static_cast<double>(after) / static_cast<double>(before) : 0.0;
+}
+
+QuantizedVertices VertexQuantizer::quantize(const Mesh::Vertex* vertices,
+                                            std::size_t vertexCount,
+                                            const VertexFormat& format) {
+    QuantizedVertices result;
+    result.format = format;
+    result.vertexCount = vertexCount;
+
+    // 属性の配置を決める（各属性は4バイト境界に揃う）
+    result.positionOffset = 0;
+    result.normalOffset = format.quantizePositions ? 8 : 12;
+    result.texCoordOffset =
+        result.normalOffset + (format.normalEncoding == NormalEncoding::Float ? 12 : 4);
+    result.stride = result.texCoordOffset + (format.halfTexCoords ? 4 : 8);
+
+    // 位置の量子化範囲（AABB）
+    if (format.quantizePositions && vertexCount > 0) {
+        glm::vec3 boundsMin = vertices[0].position;
+        glm::vec3 boundsMax = vertices[0].position;
+        for (std::size_t i = 1; i < vertexCount; ++i) {
+            boundsMin = glm::min(boundsMin, vertices[i].position);
+            boundsMax = glm::max(boundsMax, vertices[i].position);
+        }
+        result.positionBias = boundsMin;
+        result.positionScale = boundsMax - boundsMin;
+    }
+
+    result.data.assign(vertexCount * result.stride, 0);
+    for (std::size_t i = 0; i < vertexCount; ++i) {
+        const Mesh::Vertex& vertex = vertices[i];
+        std::uint8_t* out = result.data.data() + i * result.stride;
+
+        // 位置
+        if (format.quantizePositions) {
+            std::uint16_t q[4] = {0, 0, 0, 0};
+            for (int axis = 0; axis < 3; ++axis) {
+                float extent = result.positionScale[axis];
+                float t = extent > 0.0f
+                    ? (vertex.position[axis] - result.positionBias[axis]) / extent : 0.0f;
+                q[axis] = static_cast<std::uint16_t>(
+                    std::lround(std::clamp(t, 0.0f, 1.0f) * UNORM16_MAX));
+            }
+            std::memcpy(out + result.positionOffset, q, sizeof(q));
+        }
+        else {
+            std::memcpy(out + result.positionOffset, &vertex.position, sizeof(glm::vec3));
+        }
+
+        // 法線
+        switch (format.normalEncoding) {
+            case NormalEncoding::Float:
+                std::memcpy(out + result.normalOffset, &vertex.normal, sizeof(glm::vec3));
+                break;
+            case NormalEncoding::Octahedral: {
+                std::int16_t q[2] = {0, 0};
+                encodeOctahedral(vertex.normal, q);
+                std::memcpy(out + result.normalOffset, q, sizeof(q));
+                break;
+            }
+            case NormalEncoding::Packed1010102: {
+                std::uint32_t packed = packNormal1010102(vertex.normal);
+                std::memcpy(out + result.normalOffset, &packed, sizeof(packed));
+                break;
+            }
+        }
+
+        // テクスチャ座標
+        if (format.halfTexCoords) {
+            std::uint16_t q[2] = {floatToHalf(vertex.texCoords.x), floatToHalf(vertex.texCoords.y)};
+            std::memcpy(out + result.texCoordOffset, q, sizeof(q));
+        }
+        else {
+            std::memcpy(out + result.texCoordOffset, &vertex.texCoords, sizeof(glm::vec2));
+        }
+    }
+    return result;
+}
+
+VertexQuantizer::Stats VertexQuantizer::measure(const Mesh::Vertex* vertices,
+                                                const QuantizedVertices& quantized,
+                                                std::size_t indexCount) {
+    Stats stats;
+    stats.vertexCount = quantized.vertexCount;
+    stats.sourceVertexBytes = quantized.vertexCount * sizeof(Mesh::Vertex);
+    stats.vertexBytes = quantized.data.size();
+    stats.sourceIndexBytes = indexCount * sizeof(unsigned int);
+    stats.indexBytes = indexCount * Mesh::indexSizeFor(quantized.vertexCount);
+
+    const VertexFormat& format = quantized.format;
+    double maxNormalError = 0.0;
+    for (std::size_t i = 0; i < quantized.vertexCount; ++i) {
+        const Mesh::Vertex& vertex = vertices[i];
+        const std::uint8_t* in = quantized.data.data() + i * quantized.stride;
+
+        // 位置（シェーダーと同じ式で復元）
+        glm::vec3 position;
+        if (format.quantizePositions) {
+            std::uint16_t q[4];
+            std::memcpy(q, in + quantized.positionOffset, sizeof(q));
+            for (int axis = 0; axis < 3; ++axis) {
+                position[axis] = quantized.positionBias[axis] +
+                                 static_cast<float>(q[axis]) / UNORM16_MAX *
+                                 quantized.positionScale[axis];
+            }
+        }
+        else {
+            std::memcpy(&position, in + quantized.positionOffset, sizeof(position));
+        }
+        stats.maxPositionError =
+            std::max(stats.maxPositionError, glm::length(position - vertex.position));
+
+        // 法線（長さが0の法線は比較しない）
+        glm::vec3 normal;
+        switch (format.normalEncoding) {
+            case NormalEncoding::Float:
+                std::memcpy(&normal, in + quantized.normalOffset, sizeof(normal));
+                break;
+            case NormalEncoding::Octahedral: {
+                std::int16_t q[2];
+                std::memcpy(q, in + quantized.normalOffset, sizeof(q));
+                normal = octahedralDecode(decodeSnorm16(q[0]), decodeSnorm16(q[1]));
+                break;
+            }
+            case NormalEncoding::Packed1010102: {
+                std::uint32_t packed;
+                std::memcpy(&packed, in + quantized.normalOffset, sizeof(packed));
+                normal = unpackNormal1010102(packed);
+                break;
+            }
+        }
+        if (glm::dot(vertex.normal, vertex.normal) > 0.0f) {
+            maxNormalError = std::max(maxNormalError, angleDegrees(normal, vertex.normal));
+        }
+
+        // テクスチャ座標
+        glm::vec2 texCoords;
+        if (format.halfTexCoords) {
+            std::uint16_t q[2];
+            std::memcpy(q, in + quantized.texCoordOffset, sizeof(q));
+            texCoords = glm::vec2(halfToFloat(q[0]), halfToFloat(q[1]));
+        }
+        else {
+            std::memcpy(&texCoords, in + quantized.texCoordOffset, sizeof(texCoords));
+        }
+        glm::vec2 texCoordError = glm::abs(texCoords - vertex.texCoords);
+        stats.maxTexCoordError =
+            std::max(stats.maxTexCoordError, std::max(texCoordError.x, texCoordError.y));
+    }
+    stats.maxNormalErrorDegrees = static_cast<float>(maxNormalError);
+    return stats;
+}
+
+} // namespace claude_gl
@@ -0,0 +1,166 @@
+#include "utils/mapped_file.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace claude_gl {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filepath)
+    : mappedData(nullptr), mappedSize(0), fileHandle(nullptr), mappingHandle(nullptr) {
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file: " + filepath);
+    }
+    fileHandle = file;
+    
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        release();
+        throw std::runtime_error("Failed to query file size: " + filepath);
+    }
+    mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+    
+    // 空ファイルはマップできないため、空の領域として扱う
+    if (mappedSize == 0) {
+        return;
+    }
+    
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle) {
+        release();
+        throw std::runtime_error("Failed to map file: " + filepath);
+    }
+    
+    mappedData = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!mappedData) {
+        release();
+        throw std::runtime_error("Failed to map file: " + filepath);
+    }
+}
+
+void MappedFile::release() {
+    if (mappedData) {
+        UnmapViewOfFile(mappedData);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle) {
+        CloseHandle(fileHandle);
+    }
+    mappedData = nullptr;
+    mappedSize = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mappedData(other.mappedData), mappedSize(other.mappedSize),
+      fileHandle(other.fileHandle), mappingHandle(other.mappingHandle) {
+    other.mappedData = nullptr;
+    other.mappedSize = 0;
+    other.fileHandle = nullptr;
+    other.mappingHandle = nullptr;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        std::swap(mappedData, other.mappedData);
+        std::swap(mappedSize, other.mappedSize);
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+    }
+    return *this;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filepath)
+    : mappedData(nullptr), mappedSize(0) {
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + filepath);
+    }
+    
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        throw std::runtime_error("Failed to query file size: " + filepath);
+    }
+    mappedSize = static_cast<std::size_t>(fileStat.st_size);
+    
+    // 空ファイルはマップできないため、空の領域として扱う
+    if (mappedSize == 0) {
+        close(fd);
+        return;
+    }
+    
+    void* address = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    // マップ後はファイルディスクリプタを閉じても領域は有効
+    close(fd);
+    if (address == MAP_FAILED) {
+        mappedSize = 0;
+        throw std::runtime_error("Failed to map file: " + filepath);
+    }
+    
+    // 先頭から順に読むことをカーネルに伝え、先読みを促す
+    madvise(address, mappedSize, MADV_SEQUENTIAL);
+    mappedData = static_cast<const char*>(address);
+}
+
+void MappedFile::release() {
+    if (mappedData) {
+        munmap(const_cast<char*>(mappedData), mappedSize);
+    }
+    mappedData = nullptr;
+    mappedSize = 0;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mappedData(other.mappedData), mappedSize(other.mappedSize) {
+    other.mappedData = nullptr;
+    other.mappedSize = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        std::swap(mappedData, other.mappedData);
+        std::swap(mappedSize, other.mappedSize);
+    }
+    return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+const char* MappedFile::data() const {
+    return mappedData;
+}
+
+std::size_t MappedFile::size() const {
+    return mappedSize;
+}
+
+} // namespace claude_gl
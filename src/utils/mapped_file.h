@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace claude_gl {
+
+/**
+ * @brief 読み取り専用のメモリマップドファイル
+ * 
+ * ファイル全体をプロセスのアドレス空間にマップし、コピーせずに内容を参照できるようにします。
+ * マップはデストラクタで解除されます（RAII）。
+ */
+class MappedFile {
+public:
+    /**
+     * @brief ファイルを読み取り専用でマップする
+     * @param filepath マップするファイルのパス
+     * @throw std::runtime_error ファイルを開けない、またはマップできない場合
+     */
+    explicit MappedFile(const std::string& filepath);
+    
+    /**
+     * @brief デストラクタ（マップを解除する）
+     */
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    /**
+     * @brief ムーブコンストラクタ
+     */
+    MappedFile(MappedFile&& other) noexcept;
+    
+    /**
+     * @brief ムーブ代入演算子
+     */
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    
+    /**
+     * @brief マップされた内容の先頭を取得する
+     * @return 先頭へのポインタ（空ファイルの場合はnullptr）
+     */
+    const char* data() const;
+    
+    /**
+     * @brief マップされた内容のバイト数を取得する
+     * @return バイト数
+     */
+    std::size_t size() const;
+    
+private:
+    const char* mappedData;  ///< マップされた領域の先頭
+    std::size_t mappedSize;  ///< マップされた領域のバイト数
+    
+#ifdef _WIN32
+    void* fileHandle;        ///< ファイルハンドル
+    void* mappingHandle;     ///< ファイルマッピングハンドル
+#endif
+    
+    /**
+     * @brief マップを解除し、ハンドルを閉じる
+     */
+    void release();
+};
+
+} // namespace claude_gl
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace claude_gl {
+
+/**
+ * @brief 固定数のワーカースレッドでタスクを実行するスレッドプール
+ * 
+ * submit() で投入したタスクはFIFO順にワーカーへ割り当てられ、結果は std::future で受け取ります。
+ * デストラクタは投入済みのタスクをすべて実行してからスレッドを終了します。
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief コンストラクタ
+     * @param threadCount ワーカースレッド数（0の場合はハードウェアスレッド数）
+     */
+    explicit ThreadPool(unsigned int threadCount = 0);
+    
+    /**
+     * @brief デストラクタ（残りのタスクを実行してからスレッドを終了する）
+     */
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    /**
+     * @brief タスクを投入する
+     * @param task 実行する関数オブジェクト
+     * @return タスクの戻り値を受け取るfuture
+     */
+    template <typename F>
+    std::future<std::invoke_result_t<std::decay_t<F>>> submit(F&& task);
+    
+    /**
+     * @brief ワーカースレッド数を取得する
+     * @return スレッド数
+     */
+    unsigned int getThreadCount() const;
+    
+    /**
+     * @brief 既定のワーカースレッド数を取得する
+     * @return ハードウェアスレッド数（取得できない場合は1）
+     */
+    static unsigned int defaultThreadCount();
+    
+private:
+    std::vector<std::thread> workers;          ///< ワーカースレッド
+    std::queue<std::function<void()>> tasks;   ///< 実行待ちタスク
+    std::mutex mutex;                          ///< タスクキューの排他制御
+    std::condition_variable condition;         ///< タスク投入・終了の通知
+    bool stopping;                             ///< 終了処理中かどうか
+    
+    /**
+     * @brief ワーカースレッドのメインループ
+     */
+    void workerLoop();
+};
+
+template <typename F>
+std::future<std::invoke_result_t<std::decay_t<F>>> ThreadPool::submit(F&& task) {
+    using Result = std::invoke_result_t<std::decay_t<F>>;
+    
+    // std::function はコピー可能である必要があるため、packaged_task は共有ポインタで保持する
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+    std::future<Result> result = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.emplace([packaged]() { (*packaged)(); });
+    }
+    condition.notify_one();
+    return result;
+}
+
+} // namespace claude_gl
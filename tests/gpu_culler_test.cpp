@@ -0,0 +1,371 @@
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "renderer/gl_extensions.h"
+#include "renderer/gl_state_cache.h"
+#include "renderer/gpu_culler.h"
+#include "renderer/indirect_draw_buffer.h"
+#include "renderer/shader.h"
+#include "renderer/uniform_blocks.h"
+#include "test_check.h"
+
+// glad（GL 3.3）に含まれない KHR_debug の定義
+#ifndef GL_DEBUG_OUTPUT
+#define GL_DEBUG_OUTPUT 0x92E0
+#endif
+#ifndef GL_DEBUG_OUTPUT_SYNCHRONOUS
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#endif
+#ifndef GL_DEBUG_TYPE_ERROR
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#endif
+#ifndef GL_DEBUG_SEVERITY_NOTIFICATION
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#endif
+
+namespace {
+
+using namespace claude_gl;
+
+// EGLのコンテキストを作れない環境では ctest でスキップにする（SKIP_RETURN_CODE）
+constexpr int SKIP_RETURN_CODE = 77;
+
+/**
+ * @brief KHR_debug のコールバックで受け取ったエラーの数
+ */
+int debugErrorCount = 0;
+
+using DebugProc = void(GLAD_API_PTR*)(GLenum, GLenum, GLuint, GLenum, GLsizei, const GLchar*,
+                                      const void*);
+using DebugMessageCallbackFunction = void(GLAD_API_PTR*)(DebugProc, const void*);
+
+void GLAD_API_PTR onDebugMessage(GLenum, GLenum type, GLuint, GLenum severity, GLsizei,
+                                 const GLchar* message, const void*) {
+    if (severity == GL_DEBUG_SEVERITY_NOTIFICATION) {
+        return;
+    }
+    if (type == GL_DEBUG_TYPE_ERROR) {
+        ++debugErrorCount;
+    }
+    std::cerr << "KHR_debug: " << message << std::endl;
+}
+
+GLADapiproc getProcAddress(const char* name) {
+    return reinterpret_cast<GLADapiproc>(eglGetProcAddress(name));
+}
+
+/**
+ * @brief ウィンドウなしで、アプリケーションと同じく GL 3.3 のコアプロファイルを要求する
+ * @return 作れた場合はtrue
+ */
+bool createContext() {
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    EGLDisplay display =
+        getPlatformDisplay
+            ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+            : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr) ||
+        !eglBindAPI(EGL_OPENGL_API)) {
+        return false;
+    }
+    const EGLint attributes[] = {EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+                                 EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                                 EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_CONTEXT_OPENGL_DEBUG,
+                                 EGL_TRUE, EGL_NONE};
+    EGLContext context = eglCreateContext(display, nullptr, EGL_NO_CONTEXT, attributes);
+    return context != EGL_NO_CONTEXT &&
+           eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context) &&
+           gladLoadGL(getProcAddress) != 0;
+}
+
+/**
+ * @brief 既定のフレームバッファの代わりに、ウィンドウと同じ RGBA8 と D24S8 の描画先を作る
+ */
+void createFramebuffer(int width, int height) {
+    GLuint framebuffer = 0;
+    GLuint renderbuffers[2] = {};
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(2, renderbuffers);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                              renderbuffers[0]);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                              renderbuffers[1]);
+    CHECK(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    glViewport(0, 0, width, height);
+}
+
+/**
+ * @brief 立方体を2つ並べたバッファを作る（位置・法線・テクスチャ座標、GL_UNSIGNED_SHORT）
+ *
+ * 2つ目は大きさ0.8で、頂点とインデックスを1つ目の後ろに置く（firstIndex と baseVertex の確認用）。
+ *
+ * @return 1つの立方体のインデックス数
+ */
+GLsizei createCubes() {
+    std::vector<float> vertices;
+    std::vector<GLushort> indices;
+    for (int face = 0; face < 12; ++face) {
+        int axis = face % 6 / 2;
+        float size = face < 6 ? 1.0f : 0.8f;
+        glm::vec3 normal(0.0f);
+        normal[axis] = face % 2 == 0 ? -1.0f : 1.0f;
+        glm::vec3 tangent(0.0f);
+        tangent[(axis + 1) % 3] = 1.0f;
+        glm::vec3 bitangent = glm::cross(normal, tangent);
+        GLushort base = static_cast<GLushort>(face % 6 * 4);
+        for (int corner = 0; corner < 4; ++corner) {
+            glm::vec3 position = (normal * 0.5f + tangent * ((corner & 1) != 0 ? 0.5f : -0.5f) +
+                                  bitangent * ((corner & 2) != 0 ? 0.5f : -0.5f)) *
+                                 size;
+            float vertex[8] = {position.x, position.y, position.z, normal.x,
+                               normal.y,   normal.z,   0.0f,       0.0f};
+            vertices.insert(vertices.end(), vertex, vertex + 8);
+        }
+        for (GLushort index : {0, 1, 3, 0, 3, 2}) {
+            indices.push_back(static_cast<GLushort>(base + index));
+        }
+    }
+    GLuint vertexArray = 0;
+    GLuint buffers[2] = {};
+    glGenVertexArrays(1, &vertexArray);
+    GlStateCache::getInstance().bindVertexArray(vertexArray);
+    glGenBuffers(2, buffers);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() * sizeof(float)),
+                 vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 static_cast<GLsizeiptr>(indices.size() * sizeof(GLushort)), indices.data(),
+                 GL_STATIC_DRAW);
+    const GLint sizes[3] = {3, 3, 2};
+    std::size_t offset = 0;
+    for (GLuint attribute = 0; attribute < 3; ++attribute) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribPointer(attribute, sizes[attribute], GL_FLOAT, GL_FALSE, 8 * sizeof(float),
+                              reinterpret_cast<const void*>(offset * sizeof(float)));
+        offset += static_cast<std::size_t>(sizes[attribute]);
+    }
+    return static_cast<GLsizei>(indices.size() / 2);
+}
+
+/**
+ * @brief 描画する立方体
+ */
+struct Object {
+    glm::vec3 position;  ///< 中心
+    glm::vec3 scale;     ///< 大きさ
+};
+
+/**
+ * @brief 判定する場面: 画面を覆う壁の手前に16個、奥に64個、視錐台の外に16個
+ */
+std::vector<Object> makeScene() {
+    std::vector<Object> objects;
+    objects.push_back({glm::vec3(0.0f, 0.0f, -5.0f), glm::vec3(20.0f, 20.0f, 0.2f)});
+    for (int i = 0; i < 16; ++i) {
+        objects.push_back({glm::vec3(-1.5f + i % 4, -1.5f + i / 4, -3.0f), glm::vec3(0.3f)});
+    }
+    for (int i = 0; i < 64; ++i) {
+        objects.push_back(
+            {glm::vec3(-7.0f + 2.0f * (i % 8), -7.0f + 2.0f * (i / 8), -20.0f), glm::vec3(1.0f)});
+    }
+    for (int i = 0; i < 16; ++i) {
+        objects.push_back({glm::vec3(100.0f + i, 0.0f, -10.0f), glm::vec3(1.0f)});
+    }
+    return objects;
+}
+
+/**
+ * @brief 描画コマンド・描画ごとのデータ・境界を書き込む
+ */
+void fillBatch(IndirectDrawBuffer::Batch& batch, const std::vector<Object>& objects,
+               GLsizei indexCount) {
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        // 奇数番目は2つ目の立方体を描く
+        IndirectDrawBuffer::Command command;
+        command.count = static_cast<GLuint>(indexCount);
+        command.firstIndex = i % 2 == 0 ? 0 : static_cast<GLuint>(indexCount);
+        command.baseVertex = i % 2 == 0 ? 0 : 24;
+        batch.commands[i] = command;
+        IndirectDrawBuffer::DrawData& draw = batch.draws[i];
+        draw.model = glm::scale(glm::translate(glm::mat4(1.0f), objects[i].position),
+                                objects[i].scale);
+        for (int column = 0; column < 3; ++column) {
+            draw.normalMatrix[column] = glm::vec4(0.0f);
+            draw.normalMatrix[column][column] = 1.0f;
+        }
+        draw.material = {glm::vec3(1.0f, 0.5f, 0.2f), 1.0f, 0.2f, 0.5f, 32.0f, 0.0f};
+        batch.bounds[i] = IndirectDrawBuffer::CullBounds();
+        batch.bounds[i].sphere = glm::vec4(0.0f, 0.0f, 0.0f, std::sqrt(3.0f) * 0.5f);
+    }
+}
+
+/**
+ * @brief 描画先の色を読み出す
+ */
+std::vector<unsigned char> readColor(int width, int height) {
+    std::vector<unsigned char> pixels(static_cast<std::size_t>(width) * height * 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+}
+
+/**
+ * @brief 1つの描画先の大きさで、間接描画とGPUのカリングの結果を確認する
+ *
+ * 深度のピラミッドは奇数の大きさで端の3列（行）をまとめるため、偶数と奇数の両方で確かめる。
+ */
+void testViewport(int width, int height, const Shader& drawShader, const Shader& cullShader,
+                  const Shader& depthReduceShader) {
+    createFramebuffer(width, height);
+    GLsizei indexCount = createCubes();
+    std::vector<Object> objects = makeScene();
+
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f),
+                                            static_cast<float>(width) / height, 0.1f, 100.0f);
+    FrameUniforms frame;
+    frame.view = view;
+    frame.projection = projection;
+    frame.viewPos = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    frame.lightPos = glm::vec4(0.0f, 5.0f, 5.0f, 1.0f);
+    frame.lightColor = glm::vec4(1.0f);
+    GLuint frameBuffer = 0;
+    glGenBuffers(1, &frameBuffer);
+    GlStateCache& stateCache = GlStateCache::getInstance();
+    stateCache.bindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(frame), &frame, GL_STATIC_DRAW);
+    stateCache.bindBufferRange(GL_UNIFORM_BUFFER, FRAME_BLOCK_BINDING, frameBuffer, 0,
+                               sizeof(frame));
+    glEnable(GL_DEPTH_TEST);
+
+    IndirectDrawBuffer indirect;
+    GpuCuller culler(cullShader, depthReduceShader);
+    indirect.setCuller(&culler);
+
+    // 比較用: 描画ごとにSSBOの範囲を動かし、gl_DrawIDARB が0の通常の描画で1つずつ描く
+    std::vector<IndirectDrawBuffer::Command> commands(objects.size());
+    std::vector<IndirectDrawBuffer::DrawData> draws(objects.size());
+    std::vector<IndirectDrawBuffer::CullBounds> bounds(objects.size());
+    IndirectDrawBuffer::Batch local;
+    local.commands = commands.data();
+    local.draws = draws.data();
+    local.bounds = bounds.data();
+    fillBatch(local, objects, indexCount);
+    GLuint drawBuffer = 0;
+    glGenBuffers(1, &drawBuffer);
+    stateCache.bindBuffer(GL_SHADER_STORAGE_BUFFER, drawBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER,
+                 static_cast<GLsizeiptr>(draws.size() * sizeof(IndirectDrawBuffer::DrawData)),
+                 draws.data(), GL_STATIC_DRAW);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    drawShader.use();
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        stateCache.bindBufferRange(
+            GL_SHADER_STORAGE_BUFFER, IndirectDrawBuffer::DRAW_DATA_BINDING, drawBuffer,
+            static_cast<GLintptr>(i * sizeof(IndirectDrawBuffer::DrawData)),
+            sizeof(IndirectDrawBuffer::DrawData));
+        const IndirectDrawBuffer::Command& command = commands[i];
+        glDrawElementsBaseVertex(
+            GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT,
+            reinterpret_cast<const void*>(command.firstIndex * sizeof(GLushort)),
+            command.baseVertex);
+    }
+    std::vector<unsigned char> reference = readColor(width, height);
+    stateCache.forgetBuffer(drawBuffer);
+    glDeleteBuffers(1, &drawBuffer);
+
+    // 1フレームを描く（cull が false の場合は詰めずに全てを描く）
+    auto drawFrame = [&](bool cull) {
+        indirect.beginFrame();
+        culler.beginFrame(projection * view, glm::vec3(0.0f));
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        IndirectDrawBuffer::Batch batch = indirect.allocate(objects.size());
+        CHECK(batch.count == objects.size());
+        fillBatch(batch, objects, indexCount);
+        indirect.prepare(batch, cull);
+        CHECK((batch.culledBatch >= 0) == cull);
+        drawShader.use();
+        indirect.draw(batch);
+        std::vector<unsigned char> pixels = readColor(width, height);
+        culler.endFrame();
+        indirect.endFrame();
+        glFinish();
+        return pixels;
+    };
+
+    // 詰めない間接描画は1つずつの描画と同じ画像になる
+    CHECK(drawFrame(false) == reference);
+
+    // 1フレーム目はピラミッドがないため視錐台だけ、2フレーム目から奥の64個が遮蔽で除かれる
+    // （除かれるのは見えないものだけなので、画像は変わらない）
+    for (int i = 0; i < 4; ++i) {
+        CHECK(drawFrame(true) == reference);
+    }
+    // 判定の数は完了を確認してから次の beginFrame() で読む
+    culler.beginFrame(projection * view, glm::vec3(0.0f));
+    const GpuCuller::Stats& stats = culler.getStats();
+    std::cout << width << "x" << height << ": tested " << stats.tested << ", visible "
+              << stats.visible << ", frustum " << stats.frustumCulled << ", occlusion "
+              << stats.occlusionCulled << std::endl;
+    CHECK(stats.tested == objects.size());
+    CHECK(stats.visible == 17);
+    CHECK(stats.frustumCulled == 16);
+    CHECK(stats.occlusionCulled == 64);
+    CHECK(stats.backfaceCulled == 0);
+    stateCache.forgetBuffer(frameBuffer);
+    glDeleteBuffers(1, &frameBuffer);
+}
+
+} // namespace
+
+int main() {
+    if (!createContext()) {
+        std::cout << "gpu_culler_test: skipped (no EGL context)" << std::endl;
+        return SKIP_RETURN_CODE;
+    }
+    auto debugMessageCallback = reinterpret_cast<DebugMessageCallbackFunction>(
+        eglGetProcAddress("glDebugMessageCallback"));
+    if (debugMessageCallback) {
+        glEnable(GL_DEBUG_OUTPUT);
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        debugMessageCallback(onDebugMessage, nullptr);
+    }
+    GlExtensions::load(getProcAddress);
+    const GlExtensions& extensions = GlExtensions::get();
+    std::cout << glGetString(GL_RENDERER) << " (GL " << extensions.getVersion()
+              << ", indirect count: " << (extensions.hasIndirectCount() ? "yes" : "no") << ")"
+              << std::endl;
+    if (!GpuCuller::isSupported()) {
+        std::cout << "gpu_culler_test: skipped (no compute shader or indirect draw)" << std::endl;
+        return SKIP_RETURN_CODE;
+    }
+
+    Shader drawShader;
+    Shader cullShader;
+    Shader depthReduceShader;
+    bool loaded = drawShader.loadFromFile("assets/shaders/indirect.vs", "assets/shaders/basic.fs",
+                                          {"INDIRECT_DRAW"}) &&
+                  cullShader.loadComputeFromFile("assets/shaders/cull.comp") &&
+                  depthReduceShader.loadComputeFromFile("assets/shaders/depth_reduce.comp");
+    CHECK(loaded);
+    if (loaded) {
+        testViewport(256, 256, drawShader, cullShader, depthReduceShader);
+        testViewport(255, 201, drawShader, cullShader, depthReduceShader);
+    }
+    CHECK(debugErrorCount == 0);
+    return claude_gl::test::report("gpu_culler_test");
+}
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <random>
+#include <tuple>
+#include <vector>
+#include <glm/glm.hpp>
+#include "renderer/mesh_optimizer.h"
+#include "test_check.h"
+
+namespace {
+
+using namespace claude_gl;
+
+constexpr unsigned int CACHE_SIZE = MeshOptimizer::DEFAULT_CACHE_SIZE;
+
+/**
+ * @brief FIFOの頂点キャッシュのシミュレーションの結果（MeshOptimizer とは別に実装する）
+ */
+struct CacheResult {
+    float acmr;  ///< 三角形あたりのキャッシュミス数
+    float atvr;  ///< 参照された頂点あたりの変換回数
+};
+
+/**
+ * @brief FIFOの頂点キャッシュをシミュレーションする
+ */
+CacheResult simulateCache(const std::vector<unsigned int>& indices, unsigned int cacheSize) {
+    std::deque<unsigned int> cache;
+    std::vector<unsigned int> referenced(indices);
+    std::sort(referenced.begin(), referenced.end());
+    referenced.erase(std::unique(referenced.begin(), referenced.end()), referenced.end());
+    std::size_t misses = 0;
+    for (unsigned int index : indices) {
+        if (std::find(cache.begin(), cache.end(), index) != cache.end()) {
+            continue;
+        }
+        ++misses;
+        cache.push_back(index);
+        if (cache.size() > cacheSize) {
+            cache.pop_front();
+        }
+    }
+    return {static_cast<float>(misses) / static_cast<float>(indices.size() / 3),
+            static_cast<float>(misses) / static_cast<float>(referenced.size())};
+}
+
+/**
+ * @brief 起伏のある格子を作り、三角形と頂点の順序をばらばらにする
+ */
+void makeShuffledGrid(int size, std::vector<Mesh::Vertex>& vertices,
+                      std::vector<unsigned int>& indices) {
+    vertices.clear();
+    indices.clear();
+    for (int y = 0; y <= size; ++y) {
+        for (int x = 0; x <= size; ++x) {
+            Mesh::Vertex vertex;
+            float u = static_cast<float>(x) / size;
+            float v = static_cast<float>(y) / size;
+            vertex.position = glm::vec3(u, v, 0.1f * std::sin(u * 12.0f) * std::cos(v * 9.0f));
+            vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+            vertex.texCoords = glm::vec2(u, v);
+            vertices.push_back(vertex);
+        }
+    }
+    std::vector<std::array<unsigned int, 3>> triangles;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            unsigned int i0 = static_cast<unsigned int>(y * (size + 1) + x);
+            unsigned int i1 = i0 + 1;
+            unsigned int i2 = i0 + static_cast<unsigned int>(size + 1);
+            unsigned int i3 = i2 + 1;
+            triangles.push_back({i0, i1, i3});
+            triangles.push_back({i0, i3, i2});
+        }
+    }
+
+    // 頂点の番号と三角形の順序を固定の種で並べ替える
+    std::mt19937 random(42);
+    std::vector<unsigned int> remap(vertices.size());
+    for (std::size_t i = 0; i < remap.size(); ++i) {
+        remap[i] = static_cast<unsigned int>(i);
+    }
+    std::shuffle(remap.begin(), remap.end(), random);
+    std::vector<Mesh::Vertex> shuffled(vertices.size());
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        shuffled[remap[i]] = vertices[i];
+    }
+    vertices.swap(shuffled);
+    std::shuffle(triangles.begin(), triangles.end(), random);
+    for (const std::array<unsigned int, 3>& triangle : triangles) {
+        for (unsigned int index : triangle) {
+            indices.push_back(remap[index]);
+        }
+    }
+}
+
+using VertexKey = std::tuple<float, float, float, float, float, float, float, float>;
+
+/**
+ * @brief 頂点のデータを比較できる値にする
+ */
+VertexKey getKey(const Mesh::Vertex& vertex) {
+    return {vertex.position.x, vertex.position.y, vertex.position.z, vertex.normal.x,
+            vertex.normal.y,   vertex.normal.z,   vertex.texCoords.x, vertex.texCoords.y};
+}
+
+/**
+ * @brief 三角形を頂点のデータで表し、向きを保ったまま最小の頂点が先頭になるよう回した一覧
+ */
+std::vector<std::array<VertexKey, 3>> getTriangles(const std::vector<Mesh::Vertex>& vertices,
+                                                   const std::vector<unsigned int>& indices) {
+    std::vector<std::array<VertexKey, 3>> triangles;
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+        std::array<VertexKey, 3> triangle = {getKey(vertices[indices[i]]),
+                                             getKey(vertices[indices[i + 1]]),
+                                             getKey(vertices[indices[i + 2]])};
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()),
+                    triangle.end());
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+/**
+ * @brief ばらばらの格子を最適化すると、頂点キャッシュのミスが減る
+ */
+void testCacheEfficiency() {
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<unsigned int> indices;
+    makeShuffledGrid(64, vertices, indices);
+    CacheResult before = simulateCache(indices, CACHE_SIZE);
+
+    MeshOptimizer::Stats stats = MeshOptimizer::optimize(vertices, indices);
+    CacheResult after = simulateCache(indices, CACHE_SIZE);
+
+    CHECK(after.acmr < before.acmr);
+    CHECK(after.atvr < before.atvr);
+    // 格子は1三角形あたり約0.5頂点のため、並べ替えた後は1.0を下回る
+    CHECK(after.acmr < 1.0f);
+    CHECK(before.acmr > 2.0f);
+    // 最適化の統計は独立したシミュレーションと一致する
+    CHECK(std::fabs(stats.cacheBefore.acmr - before.acmr) < 1e-4f);
+    CHECK(std::fabs(stats.cacheAfter.acmr - after.acmr) < 1e-4f);
+    CHECK(std::fabs(stats.cacheAfter.atvr - after.atvr) < 1e-4f);
+}
+
+/**
+ * @brief 並べ替えと頂点の付け替えの後も三角形の集合と頂点のデータは変わらない
+ */
+void testPreservesTriangles() {
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<unsigned int> indices;
+    makeShuffledGrid(32, vertices, indices);
+    // 参照されない頂点を1つ加え、頂点フェッチの最適化で取り除かれることも確認する
+    Mesh::Vertex unused;
+    unused.position = glm::vec3(5.0f);
+    vertices.push_back(unused);
+    std::vector<Mesh::Vertex> originalVertices = vertices;
+    std::vector<unsigned int> originalIndices = indices;
+
+    MeshOptimizer::optimize(vertices, indices);
+
+    CHECK(indices.size() == originalIndices.size());
+    CHECK(vertices.size() == originalVertices.size() - 1);
+    bool inRange = true;
+    for (unsigned int index : indices) {
+        inRange = inRange && index < vertices.size();
+    }
+    CHECK(inRange);
+    if (!inRange) {
+        return;
+    }
+    CHECK(getTriangles(vertices, indices) == getTriangles(originalVertices, originalIndices));
+
+    // 頂点の並べ替えは参照された頂点のデータをそのまま保つ
+    std::vector<VertexKey> keys;
+    for (const Mesh::Vertex& vertex : vertices) {
+        keys.push_back(getKey(vertex));
+    }
+    std::vector<VertexKey> originalKeys;
+    for (std::size_t i = 0; i + 1 < originalVertices.size(); ++i) {
+        originalKeys.push_back(getKey(originalVertices[i]));
+    }
+    std::sort(keys.begin(), keys.end());
+    std::sort(originalKeys.begin(), originalKeys.end());
+    CHECK(keys == originalKeys);
+
+    // 頂点はインデックスの初出の順に並ぶ
+    unsigned int next = 0;
+    bool fetchOrder = true;
+    for (unsigned int index : indices) {
+        if (index == next) {
+            ++next;
+        }
+        fetchOrder = fetchOrder && index < next;
+    }
+    CHECK(fetchOrder);
+}
+
+} // namespace
+
+int main() {
+    testCacheEfficiency();
+    testPreservesTriangles();
+    return claude_gl::test::report("mesh_optimizer_test");
+}
@@ -0,0 +1,180 @@
+#include <array>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "renderer/obj_parser.h"
+#include "test_check.h"
+
+namespace {
+
+using namespace claude_gl;
+
+/**
+ * @brief ObjParser に置き換える前の Model::processObjFile の読み込みループ（比較用にそのまま残す）
+ */
+std::vector<Mesh::Vertex> parseWithStringStreams(const std::string& text) {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<Mesh::Vertex> vertices;
+
+    std::istringstream file(text);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string prefix;
+        iss >> prefix;
+
+        if (prefix == "v") {
+            glm::vec3 position;
+            iss >> position.x >> position.y >> position.z;
+            positions.push_back(position);
+        }
+        else if (prefix == "vn") {
+            glm::vec3 normal;
+            iss >> normal.x >> normal.y >> normal.z;
+            normals.push_back(normal);
+        }
+        else if (prefix == "vt") {
+            glm::vec2 texCoord;
+            iss >> texCoord.x >> texCoord.y;
+            texCoords.push_back(texCoord);
+        }
+        else if (prefix == "f") {
+            std::string v1, v2, v3;
+            iss >> v1 >> v2 >> v3;
+
+            std::array<std::string, 3> vertexData = { v1, v2, v3 };
+            for (const auto& vertex : vertexData) {
+                std::vector<std::string> tokens;
+                std::istringstream tokenStream(vertex);
+                std::string token;
+                while (std::getline(tokenStream, token, '/')) {
+                    tokens.push_back(token);
+                }
+
+                unsigned int posIndex = 0, texIndex = 0, normIndex = 0;
+                if (tokens.size() >= 1 && !tokens[0].empty()) {
+                    posIndex = std::stoi(tokens[0]) - 1;
+                }
+                if (tokens.size() >= 2 && !tokens[1].empty()) {
+                    texIndex = std::stoi(tokens[1]) - 1;
+                }
+                if (tokens.size() >= 3 && !tokens[2].empty()) {
+                    normIndex = std::stoi(tokens[2]) - 1;
+                }
+
+                Mesh::Vertex meshVertex;
+                if (posIndex < positions.size()) {
+                    meshVertex.position = positions[posIndex];
+                }
+                if (texIndex < texCoords.size()) {
+                    meshVertex.texCoords = texCoords[texIndex];
+                }
+                else {
+                    meshVertex.texCoords = glm::vec2(0.0f, 0.0f);
+                }
+                if (normIndex < normals.size()) {
+                    meshVertex.normal = normals[normIndex];
+                }
+                else {
+                    meshVertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+                }
+                vertices.push_back(meshVertex);
+            }
+        }
+    }
+    return vertices;
+}
+
+/**
+ * @brief ObjParser の出力が旧実装の出力とビット単位で一致するか確認する
+ */
+void checkMatchesStringStreams(const std::string& text) {
+    std::vector<Mesh::Vertex> expected = parseWithStringStreams(text);
+
+    ObjData data;
+    ObjParser::parseText(text.data(), text.data() + text.size(), data);
+
+    // 溶接なしは面頂点ごとに1頂点
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<unsigned int> indices;
+    ObjParser::buildVertices(data, vertices, indices, false);
+    CHECK(vertices.size() == expected.size());
+    if (vertices.size() == expected.size()) {
+        CHECK(std::memcmp(vertices.data(), expected.data(),
+                          expected.size() * sizeof(Mesh::Vertex)) == 0);
+    }
+
+    // 溶接ありはインデックスで展開すると同じ列になる
+    ObjParser::buildVertices(data, vertices, indices, true);
+    CHECK(indices.size() == expected.size());
+    if (indices.size() == expected.size()) {
+        bool same = true;
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            same = same && std::memcmp(&vertices[indices[i]], &expected[i],
+                                       sizeof(Mesh::Vertex)) == 0;
+        }
+        CHECK(same);
+    }
+}
+
+const char* const ATTRIBUTES =
+    "v 0.0 0.0 0.0\n"
+    "v 1.5 0.0 -0.25\n"
+    "v 1.0 1.0 3.0e-2\n"
+    "v -0.125 1.0 0.7\n"
+    "v 0.3 0.6 0.9\n"
+    "vt 0.25 0.75\n"
+    "vt 1.0 0.0\n"
+    "vt 0.5 0.5\n"
+    "vt 0.1 0.9\n"
+    "vn 0.0 1.0 0.0\n"
+    "vn 0.0 0.0 -1.0\n"
+    "vn 0.6 0.8 0.0\n";
+
+/**
+ * @brief 三角形の面（v/vt/vn）
+ */
+void testTriangles() {
+    checkMatchesStringStreams(std::string(ATTRIBUTES) +
+                              "f 1/1/1 2/2/2 3/3/3\n"
+                              "f 1/4/3 3/3/2 4/1/1\n");
+}
+
+/**
+ * @brief 四角形と五角形の面（先頭の3頂点だけが使われる）
+ */
+void testQuads() {
+    checkMatchesStringStreams(std::string(ATTRIBUTES) +
+                              "f 1/1/1 2/2/2 3/3/3 4/4/1\n"
+                              "f 2/1/2 3/2/3 4/3/1 1/4/2\n"
+                              "f 1//1 2//2 3//3 4//1\n"
+                              "f 1 2 3 4 5\n");
+}
+
+/**
+ * @brief テクスチャ座標や法線を指定しない面（先頭の要素が使われる）
+ */
+void testFacesWithoutTexCoords() {
+    checkMatchesStringStreams(std::string(ATTRIBUTES) +
+                              "f 1//1 2//2 3//3\n"
+                              "f 2//3 4//2 5//1\n"
+                              "f 1 2 3\n"
+                              "f 3/2 4/3 5/4\n"
+                              "f 1/2/ 2/3/ 3/4/\n");
+
+    // ファイルにテクスチャ座標も法線もない場合は既定値
+    checkMatchesStringStreams("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\nf 3//1 2//1 1//1\n");
+}
+
+} // namespace
+
+int main() {
+    testTriangles();
+    testQuads();
+    testFacesWithoutTexCoords();
+    return claude_gl::test::report("obj_parser_test");
+}
@@ -0,0 +1,182 @@
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "renderer/occlusion_culler.h"
+#include "test_check.h"
+
+namespace {
+
+using namespace claude_gl;
+
+// スレッド数に依らず同じ結果になることを、コア数に関係なく固定のスレッド数で確認する
+constexpr unsigned int THREAD_COUNTS[] = {1, 4, 7};
+
+/**
+ * @brief 1つのシーンを判定した結果
+ */
+struct Result {
+    std::vector<std::uint8_t> visibility;  ///< testBoxes() の結果
+    std::vector<bool> isVisible;           ///< isVisible() の結果
+    std::vector<float> depths;             ///< 全ピクセルの深度の上限
+    OcclusionCuller::Stats stats;          ///< 統計情報
+};
+
+/**
+ * @brief 原点から +Z を向くカメラのビュー・プロジェクション行列
+ */
+glm::mat4 getViewProjection() {
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+    return glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f) * view;
+}
+
+/**
+ * @brief 遮蔽物を描いてボックスを判定する
+ */
+Result run(unsigned int threadCount, const std::vector<OccluderMesh>& occluders,
+           const std::vector<Aabb>& boxes) {
+    OcclusionCuller culler(320, 192, threadCount);
+    CHECK(culler.getThreadCount() == threadCount);
+    culler.beginFrame(getViewProjection());
+    for (const OccluderMesh& occluder : occluders) {
+        culler.addOccluder(occluder, glm::mat4(1.0f));
+    }
+    culler.render();
+
+    Result result;
+    result.visibility.resize(boxes.size());
+    culler.testBoxes(boxes.data(), boxes.size(), result.visibility.data());
+    for (const Aabb& box : boxes) {
+        result.isVisible.push_back(culler.isVisible(box));
+    }
+    for (int y = 0; y < culler.getHeight(); ++y) {
+        for (int x = 0; x < culler.getWidth(); ++x) {
+            result.depths.push_back(culler.getDepth(x, y));
+        }
+    }
+    result.stats = culler.getStats();
+    return result;
+}
+
+/**
+ * @brief 全てのスレッド数で判定し、1スレッドと同じ結果であることを確認する
+ * @return 1スレッドの結果
+ */
+Result runAll(const std::vector<OccluderMesh>& occluders, const std::vector<Aabb>& boxes) {
+    Result single = run(THREAD_COUNTS[0], occluders, boxes);
+    for (std::size_t i = 0; i < boxes.size(); ++i) {
+        CHECK((single.visibility[i] != 0) == single.isVisible[i]);
+    }
+    for (unsigned int threadCount : THREAD_COUNTS) {
+        Result result = run(threadCount, occluders, boxes);
+        CHECK(result.visibility == single.visibility);
+        CHECK(result.isVisible == single.isVisible);
+        CHECK(result.depths == single.depths);
+        CHECK(result.stats.rasterizedTriangles == single.stats.rasterizedTriangles);
+        CHECK(result.stats.occluded == single.stats.occluded);
+    }
+    return single;
+}
+
+/**
+ * @brief 中心と半分の大きさからボックスを作る
+ */
+Aabb makeBox(const glm::vec3& center, const glm::vec3& extents) {
+    return {center - extents, center + extents};
+}
+
+/**
+ * @brief 画面全体を覆う壁（z = 10）
+ */
+OccluderMesh makeWall() {
+    return OccluderMesh::makeBox(
+        {glm::vec3(-40.0f, -40.0f, 10.0f), glm::vec3(40.0f, 40.0f, 10.5f)});
+}
+
+/**
+ * @brief 遮蔽物が完全に覆うボックスは見えない
+ */
+void testFullyCovered() {
+    Aabb center = makeBox(glm::vec3(0.0f, 0.0f, 30.0f), glm::vec3(1.0f));
+    Aabb justBehind = makeBox(glm::vec3(5.0f, -2.0f, 12.0f), glm::vec3(0.5f));
+    Result result = runAll({makeWall()}, {center, justBehind});
+    CHECK(result.visibility[0] == 0);
+    CHECK(result.visibility[1] == 0);
+    CHECK(result.stats.occluded == 2);
+    CHECK(result.stats.rasterizedTriangles > 0);
+}
+
+/**
+ * @brief 一部が遮蔽物より手前にあるボックスや、一部が覆われていないボックスは見える
+ */
+void testPartlyInFront() {
+    // 壁を貫くボックス（手前の部分が見える）
+    Aabb crossing = {glm::vec3(-1.0f, -1.0f, 8.0f), glm::vec3(1.0f, 1.0f, 12.0f)};
+    // 壁の手前にあるボックス
+    Aabb inFront = makeBox(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.5f));
+    Result result = runAll({makeWall()}, {crossing, inFront});
+    CHECK(result.visibility[0] != 0);
+    CHECK(result.visibility[1] != 0);
+
+    // 画面の左半分だけを覆う壁では、中央をまたぐ奥のボックスは見える
+    OccluderMesh halfWall =
+        OccluderMesh::makeBox({glm::vec3(0.0f, -40.0f, 10.0f), glm::vec3(40.0f, 40.0f, 10.5f)});
+    Aabb straddling = makeBox(glm::vec3(0.0f, 0.0f, 30.0f), glm::vec3(2.0f));
+    Aabb covered = makeBox(glm::vec3(20.0f, 0.0f, 30.0f), glm::vec3(1.0f));
+    result = runAll({halfWall}, {straddling, covered});
+    CHECK(result.visibility[0] != 0);
+    CHECK(result.visibility[1] == 0);
+}
+
+/**
+ * @brief 近クリップ面に掛かるボックスは遮蔽物の有無に関わらず見える
+ */
+void testNearPlaneCrossing() {
+    Aabb aroundCamera = makeBox(glm::vec3(0.0f), glm::vec3(1.0f));
+    Aabb touchingNear = {glm::vec3(-0.5f, -0.5f, 0.05f), glm::vec3(0.5f, 0.5f, 0.2f)};
+    Aabb behind = makeBox(glm::vec3(0.0f, 0.0f, -5.0f), glm::vec3(1.0f));
+    Result result = runAll({makeWall()}, {aroundCamera, touchingNear, behind});
+    CHECK(result.visibility[0] != 0);
+    CHECK(result.visibility[1] != 0);
+    CHECK(result.visibility[2] != 0);
+
+    // 近クリップ面を横切る傾いた遮蔽物も、クリップした残りで奥のボックスを隠す
+    OccluderMesh slope;
+    slope.positions = {glm::vec3(-40.0f, -40.0f, -2.0f), glm::vec3(40.0f, -40.0f, -2.0f),
+                       glm::vec3(40.0f, 40.0f, 20.0f), glm::vec3(-40.0f, 40.0f, 20.0f)};
+    // 表裏のどちらを向いても描かれるよう、両方の向きの三角形を入れる
+    slope.indices = {0, 1, 2, 0, 2, 3, 0, 2, 1, 0, 3, 2};
+    Aabb farBox = makeBox(glm::vec3(0.0f, 0.0f, 30.0f), glm::vec3(1.0f));
+    result = runAll({slope}, {farBox, aroundCamera});
+    CHECK(result.visibility[0] == 0);
+    CHECK(result.visibility[1] != 0);
+}
+
+/**
+ * @brief 遮蔽物がない場合は深度が全て1で、全てのボックスが見える
+ */
+void testEmptyOccluders() {
+    std::vector<Aabb> boxes = {makeBox(glm::vec3(0.0f, 0.0f, 30.0f), glm::vec3(1.0f)),
+                               makeBox(glm::vec3(0.0f, 0.0f, 199.0f), glm::vec3(0.1f))};
+    Result result = runAll({}, boxes);
+    CHECK(result.visibility[0] != 0);
+    CHECK(result.visibility[1] != 0);
+    CHECK(result.stats.occluderTriangles == 0);
+    CHECK(result.stats.occluded == 0);
+    bool cleared = true;
+    for (float depth : result.depths) {
+        cleared = cleared && depth == 1.0f;
+    }
+    CHECK(cleared);
+}
+
+} // namespace
+
+int main() {
+    testFullyCovered();
+    testPartlyInFront();
+    testNearPlaneCrossing();
+    testEmptyOccluders();
+    return claude_gl::test::report("occlusion_culler_test");
+}
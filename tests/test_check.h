@@ -0,0 +1,40 @@
+#pragma once
+
+#include <iostream>
+
+namespace claude_gl {
+namespace test {
+
+/**
+ * @brief 失敗した確認の数（main() の戻り値に使う）
+ */
+inline int& getFailureCount() {
+    static int failureCount = 0;
+    return failureCount;
+}
+
+/**
+ * @brief 条件を確認し、満たさない場合は場所を出力して失敗を数える
+ */
+inline void check(bool condition, const char* expression, const char* file, int line) {
+    if (!condition) {
+        std::cerr << file << ":" << line << ": CHECK failed: " << expression << std::endl;
+        ++getFailureCount();
+    }
+}
+
+/**
+ * @brief 全ての確認の結果を出力する
+ * @return 失敗がなければ0
+ */
+inline int report(const char* name) {
+    int failureCount = getFailureCount();
+    std::cout << name << ": " << (failureCount == 0 ? "passed" : "FAILED") << " ("
+              << failureCount << " failures)" << std::endl;
+    return failureCount == 0 ? 0 : 1;
+}
+
+} // namespace test
+} // namespace claude_gl
+
+#define CHECK(condition) ::claude_gl::test::check((condition), #condition, __FILE__, __LINE__)